@@ -2,9 +2,21 @@
 
 #include <glibmm/markup.h>
 #include <gtkmm/label.h>
+#include <gtkmm/tooltip.h>
 #include <json/json.h>
 
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string_view>
+
 #include "AModule.hpp"
+#include "util/compiled_format.hpp"
+
+namespace waybar::util {
+class IntervalWorker;
+}
 
 namespace waybar {
 
@@ -27,6 +39,100 @@ class ALabel : public AModule {
 
   virtual bool handleToggle(GdkEventButton *const &e);
   virtual std::string getState(uint8_t value, bool lesser = false);
+  /// Diffing setters: skip the Pango markup re-parse and tooltip property
+  /// notification when the rendered text did not change since the last update.
+  /// Changed text goes straight to the GTK C API — the formatted bytes are
+  /// UTF-8 already, the gtkmm wrappers would copy them into a Glib::ustring
+  /// and revalidate on every tick.
+  void setMarkup(std::string_view markup);
+  void setTooltipText(std::string_view tooltip);
+  /// Deferred tooltips: `generator` runs on GTK query-tooltip, so the
+  /// formatting cost is only paid while the pointer actually rests on the
+  /// module. Returning an empty string suppresses the tooltip. Don't mix
+  /// with setTooltipText().
+  void setTooltipGenerator(std::function<std::string()> generator, bool markup = false);
+  /// "format-<state>" lookup materialized once; update() paths stay clear of jsoncpp.
+  const std::string &getFormatForState(const std::string &state);
+  /// Same variant selection as getFormatForState(), but returning the
+  /// precompiled template. All variants — default, alt and per-state
+  /// overrides — live in an indexed slot table, so neither toggling
+  /// format-alt nor a state transition ever re-parses a template.
+  const util::CompiledFormat &getCompiledFormatForState(const std::string &state);
+  /// Adaptive polling ("adaptive-interval" config, max seconds): after a few
+  /// renders in a row where setMarkup() saw no change, the worker's interval
+  /// doubles up to the cap; any change — or the pointer entering the module —
+  /// snaps it back to the base interval. No-op unless configured.
+  void enableAdaptiveInterval(util::IntervalWorker &worker);
+  /// Peek: stretch the interval worker to the background cadence while the
+  /// bar is hidden; restores the regular (or adaptive) pace on reveal.
+  void onPeek(bool peek, std::chrono::seconds cadence) override;
+  /// Liveness check for a format placeholder: true when "{field" appears in
+  /// any configured format/tooltip-format variant or in the default format.
+  /// Lets modules skip collecting data nothing will render; callers with a
+  /// built-in default tooltip must account for its fields themselves.
+  bool formatFieldReferenced(std::string_view field) const;
+
+ private:
+  struct StateThreshold {
+    std::string name;
+    uint8_t threshold;
+  };
+
+  /// Width stabilization ("width-hysteresis"): quantize the rendered width to
+  /// digit cells and never let the size request shrink until content has
+  /// stayed narrower for a whole hysteresis window. Keeps per-tick numeric
+  /// jitter from relayouting the bar boxes on every update.
+  void stabilizeWidth();
+
+  void adaptiveTick(bool changed);
+
+  void ensureStateThresholds();
+  /// Resolve the style for every configured state class once against the
+  /// widget's real path, so the first flip of each state in getState() reuses
+  /// GTK's cached computed style instead of running a selector re-match
+  /// inside an update.
+  void prewarmStateStyles();
+
+  bool onQueryTooltip(int, int, bool, const Glib::RefPtr<Gtk::Tooltip> &tooltip);
+
+  // "format-alt" toggle resolved at construction; 0 means no toggle button
+  uint format_alt_click_ = 0;
+  std::string format_alt_;
+
+  std::function<std::string()> tooltip_generator_;
+  bool tooltip_generator_markup_ = false;
+  bool tooltip_query_connected_ = false;
+  /// Format variants stored as {normal, alt} slot pairs: pair 0 is the
+  /// stateless format, further pairs are materialized on the first lookup of
+  /// each "format-<state>" override (states without one share pair 0). After
+  /// that, selecting a variant is an index computation over precompiled
+  /// slots — no config access, no string building, no template parse.
+  struct FormatSlot {
+    std::string text;
+    util::CompiledFormat compiled;
+  };
+  size_t formatSlotPair(const std::string &state);
+  size_t addFormatSlotPair(const std::optional<std::string> &state_format);
+  std::deque<FormatSlot> format_slots_;
+  std::map<std::string, size_t> format_slot_index_;
+  std::string last_markup_;
+  std::string last_tooltip_;
+  // "states" config materialized once, ascending by threshold for binary search
+  std::optional<std::vector<StateThreshold>> state_thresholds_;
+  int current_state_ = -1;
+  bool state_applied_ = false;
+  bool states_prewarmed_ = false;
+  util::IntervalWorker *adaptive_worker_ = nullptr;
+  std::chrono::seconds adaptive_cap_{0};
+  std::chrono::seconds adaptive_current_{0};
+  int unchanged_streak_ = 0;
+  bool peeking_ = false;
+
+  const bool width_hysteresis_;
+  std::chrono::seconds width_relax_{30};
+  int stable_width_ = 0;
+  int digit_width_ = 0;  // widest digit in the label font; measured lazily
+  std::chrono::steady_clock::time_point narrower_since_{};
 };
 
 }  // namespace waybar
@@ -5,7 +5,10 @@
 #include <gtkmm/eventbox.h>
 #include <json/json.h>
 
+#include <chrono>
+
 #include "IModule.hpp"
+#include "util/string_pool.hpp"
 
 namespace waybar {
 
@@ -15,7 +18,23 @@ class AModule : public IModule {
           bool enable_scroll = false);
   virtual ~AModule();
   virtual auto update() -> void;
+  /// External refresh request (RTMIN signal or control socket); 0 is an
+  /// unconditional request. The default redraws from current state.
+  virtual void refresh(int /*signal*/) { dp.emit(); }
   virtual operator Gtk::Widget &();
+  /// Pause background work while no surface shows this module (hidden bar);
+  /// an update requested while suspended is replayed once on resume.
+  void setSuspended(bool suspended);
+  bool isSuspended() const { return suspended_; }
+  /// Peek support ("peek-interval" bar option): keep the module warm while
+  /// its bar is hidden instead of suspending it. Updates keep flowing so the
+  /// widgets stay pre-rendered and the reveal is a pure surface map; modules
+  /// with interval workers stretch their cadence to `cadence` meanwhile.
+  void setPeek(bool peek, std::chrono::seconds cadence);
+  void deferRefresh() { refresh_deferred_ = true; }
+  /// Entry point for events the Bar routed here via its hit-test index
+  /// (events that landed on the bar background, not this module's window).
+  bool routeScroll(GdkEventScroll *e) { return handleScroll(e); }
 
   Glib::Dispatcher dp;
 
@@ -25,33 +44,57 @@ class AModule : public IModule {
   SCROLL_DIR getScrollDir(GdkEventScroll *e);
   bool tooltipEnabled();
 
-  const std::string name_;
+  // interned: every bar/instance of e.g. "cpu" shares the same storage
+  const std::string &name_;
   const Json::Value &config_;
+  // snapshot of config values hit from update() paths; avoids per-tick jsoncpp lookups
+  const bool tooltip_enabled_;
   Gtk::EventBox event_box_;
 
   virtual bool handleToggle(GdkEventButton *const &ev);
   virtual bool handleScroll(GdkEventScroll *);
+  /// Net scroll applied once per frame window. `steps` is positive for up.
+  /// The default spawns the bound on-scroll command a single time; modules
+  /// that can apply a magnitude natively (e.g. volume) override this.
+  virtual void applyScroll(int steps);
+  /// Hook for modules to pause their pollers/workers.
+  virtual void onSuspended(bool) {}
+  /// Hook for modules to slow their pollers to a background cadence while the
+  /// bar peeks; event-driven modules simply keep updating.
+  virtual void onPeek(bool /*peek*/, std::chrono::seconds /*cadence*/) {}
 
  private:
+  // One configured "on-click*" handler, resolved from config at construction.
+  // A click is then a scan over the configured handful instead of a map
+  // lookup with pair comparisons and string copies per event.
+  struct ClickAction {
+    uint button;
+    GdkEventType type;
+    std::string command;
+  };
+
+  void resolveClickActions();
+  void flushScroll();
+
+  // Scroll batching: high-resolution touchpads deliver dozens of events per
+  // flick; steps are accumulated and applied once per frame window.
+  static constexpr unsigned SCROLL_FLUSH_MS = 16;
+  int scroll_steps_ = 0;
+  bool scroll_flush_pending_ = false;
+  sigc::connection scroll_flush_timer_;
+
+  bool suspended_ = false;
+  bool refresh_deferred_ = false;
   std::vector<int> pid_;
+  std::vector<ClickAction> click_actions_;
+  // scroll/update commands and the smooth-scroll threshold, likewise
+  // resolved once so the input handlers never consult the config
+  std::string on_scroll_up_;
+  std::string on_scroll_down_;
+  std::string on_update_;
+  gdouble smooth_scrolling_threshold_ = 0.0;
   gdouble distance_scrolled_y_;
   gdouble distance_scrolled_x_;
-  static const inline std::map<std::pair<uint, GdkEventType>, std::string> eventMap_{
-      {std::make_pair(1, GdkEventType::GDK_BUTTON_PRESS), "on-click"},
-      {std::make_pair(1, GdkEventType::GDK_2BUTTON_PRESS), "on-double-click"},
-      {std::make_pair(1, GdkEventType::GDK_3BUTTON_PRESS), "on-triple-click"},
-      {std::make_pair(2, GdkEventType::GDK_BUTTON_PRESS), "on-click-middle"},
-      {std::make_pair(2, GdkEventType::GDK_2BUTTON_PRESS), "on-double-click-middle"},
-      {std::make_pair(2, GdkEventType::GDK_3BUTTON_PRESS), "on-triple-click-middle"},
-      {std::make_pair(3, GdkEventType::GDK_BUTTON_PRESS), "on-click-right"},
-      {std::make_pair(3, GdkEventType::GDK_2BUTTON_PRESS), "on-double-click-right"},
-      {std::make_pair(3, GdkEventType::GDK_3BUTTON_PRESS), "on-triple-click-right"},
-      {std::make_pair(8, GdkEventType::GDK_BUTTON_PRESS), "on-click-backward"},
-      {std::make_pair(8, GdkEventType::GDK_2BUTTON_PRESS), "on-double-click-backward"},
-      {std::make_pair(8, GdkEventType::GDK_2BUTTON_PRESS), "on-triple-click-backward"},
-      {std::make_pair(9, GdkEventType::GDK_BUTTON_PRESS), "on-click-forward"},
-      {std::make_pair(9, GdkEventType::GDK_2BUTTON_PRESS), "on-double-click-forward"},
-      {std::make_pair(9, GdkEventType::GDK_2BUTTON_PRESS), "on-triple-click-forward"}};
 };
 
 }  // namespace waybar
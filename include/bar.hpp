@@ -17,6 +17,7 @@
 namespace waybar {
 
 class Factory;
+class Group;
 struct waybar_output {
   Glib::RefPtr<Gdk::Monitor> monitor;
   std::string name;
@@ -63,6 +64,8 @@ class BarSurface {
   virtual void setPassThrough(bool enable) = 0;
   virtual void setPosition(const std::string_view &position) = 0;
   virtual void setSize(uint32_t width, uint32_t height) = 0;
+  /// Re-target an unmapped surface at another output (hotplug re-attach).
+  virtual void setOutput(struct waybar_output &) {}
   virtual void commit(){};
 
   virtual ~BarSurface() = default;
@@ -82,7 +85,14 @@ class Bar {
   void setMode(const std::string_view &);
   void setVisible(bool visible);
   void toggle();
-  void handleSignal(int);
+  /// Move this bar (window, surface, modules) to another output; the window
+  /// must be hidden. Used to survive output hotplug without a rebuild.
+  void setOutput(struct waybar_output *w_output);
+  /// Apply a freshly parsed config: modules whose settings are unchanged keep
+  /// their instance (threads, caches, widget); only changed ones are rebuilt.
+  void reloadConfig(Json::Value new_config);
+  /// Look up a module instance by its config name ("network", "custom/foo").
+  AModule *getModule(const std::string &name);
 
   struct waybar_output *output;
   Json::Value config;
@@ -98,14 +108,23 @@ class Bar {
  private:
   void onMap(GdkEventAny *);
   auto setupWidgets() -> void;
-  void getModules(const Factory &, const std::string &, Gtk::Box *);
-  void setupAltFormatKeyForModule(const std::string &module_name);
-  void setupAltFormatKeyForModuleList(const char *module_list_name);
+  void getModules(const Factory &, const std::string &, Group *);
+  void packModules();
+  /// Module whose extent along the bar axis contains `pos` (window
+  /// coordinates), via the flat hit-test index; nullptr between modules.
+  AModule *moduleAt(int pos);
+  bool handleBackgroundScroll(GdkEventScroll *);
+  static void setupAltFormatKeyForModule(Json::Value &conf, const std::string &module_name);
+  static void setupAltFormatKeyForModuleList(Json::Value &conf, const char *module_list_name);
   void setMode(const bar_mode &);
 
   /* Copy initial set of modes to allow customization */
   bar_mode_map configured_modes = PRESET_MODES;
   std::string last_mode_{MODE_DEFAULT};
+  // "peek-interval": background cadence (seconds) modules keep while the bar
+  // is hidden, so a hotkey reveal maps an already-rendered surface. 0 keeps
+  // the default suspend-on-hide behavior.
+  std::chrono::seconds peek_cadence_{0};
 
   std::unique_ptr<BarSurface> surface_impl_;
   Gtk::Box left_;
@@ -115,11 +134,26 @@ class Bar {
   std::vector<std::shared_ptr<waybar::AModule>> modules_left_;
   std::vector<std::shared_ptr<waybar::AModule>> modules_center_;
   std::vector<std::shared_ptr<waybar::AModule>> modules_right_;
+  // name -> instance, for config-reload diffing
+  std::map<std::string, std::shared_ptr<waybar::AModule>> modules_by_name_;
+  // instances carried over from the previous config during a reload
+  std::map<std::string, std::shared_ptr<waybar::AModule>> recycled_;
 #ifdef HAVE_SWAY
   using BarIpcClient = modules::sway::BarIpcClient;
   std::unique_ptr<BarIpcClient> _ipc_client;
 #endif
   std::vector<std::shared_ptr<waybar::AModule>> modules_all_;
+
+  // Flat sorted-interval hit-test index: module extents along the bar axis in
+  // window coordinates. Rebuilt lazily after any relayout; lookups are a
+  // binary search over a contiguous array instead of a widget-tree pick.
+  struct HitInterval {
+    int start;
+    int end;
+    AModule *module;
+  };
+  std::vector<HitInterval> hit_index_;
+  bool hit_index_dirty_ = true;
 };
 
 }  // namespace waybar
@@ -5,8 +5,12 @@
 #include <gdk/gdkwayland.h>
 #include <wayland-client.h>
 
+#include <chrono>
+#include <set>
+
 #include "bar.hpp"
 #include "config.hpp"
+#include "control_server.hpp"
 
 struct zwlr_layer_shell_v1;
 struct zwp_idle_inhibitor_v1;
@@ -48,11 +52,54 @@ class Client {
   static void handleOutputDescription(void *, struct zxdg_output_v1 *, const char *);
   void handleMonitorAdded(Glib::RefPtr<Gdk::Monitor> monitor);
   void handleMonitorRemoved(Glib::RefPtr<Gdk::Monitor> monitor);
-  void handleDeferredMonitorRemoval(Glib::RefPtr<Gdk::Monitor> monitor);
+  void setupConfigWatch();
+  bool onConfigDirEvent(Glib::IOCondition cond);
+  void reloadConfig(const std::set<std::string> &changed_files = {});
+  void reloadCss();
+  void reconcileOutputs();
+  bool reattachBars(struct waybar_output &output);
+  void pruneDetachedBars();
+
+  /// A bar whose output disappeared, parked (hidden, modules suspended)
+  /// awaiting the same output's return instead of being torn down.
+  struct detached_bar {
+    std::unique_ptr<Bar> bar;
+    std::string output_name;
+    std::string output_identifier;
+    // keeps the stale outputs_ entry alive until re-attach or pruning, since
+    // the parked bar's modules still point at it
+    Glib::RefPtr<Gdk::Monitor> old_monitor;
+    std::chrono::steady_clock::time_point detached_at;
+  };
+
+  // reconcile a burst of hotplug events (docking) in one pass
+  static constexpr std::chrono::milliseconds hotplug_debounce_{500};
+  // how long a detached bar waits for its output to come back
+  static constexpr std::chrono::seconds detach_retention_{10};
 
   Glib::RefPtr<Gtk::StyleContext> style_context_;
   Glib::RefPtr<Gtk::CssProvider> css_provider_;
   std::list<struct waybar_output> outputs_;
+  std::vector<Glib::RefPtr<Gdk::Monitor>> pending_removals_;
+  std::vector<detached_bar> detached_bars_;
+  sigc::connection hotplug_timer_;
+
+  // config hot-reload: parent directories of every source file are watched,
+  // since editors replace files and an inode watch would be dropped
+  std::string config_opt_;
+  std::string css_file_;
+  int config_inotify_fd_ = -1;
+  std::map<int, std::string> config_watch_dirs_;
+  std::set<std::string> config_watch_files_;
+  sigc::connection config_io_watch_;
+  sigc::connection config_reload_timer_;
+  bool config_dirty_ = false;
+  bool css_dirty_ = false;
+  // which source files the pending reload is for; fragment-only changes take
+  // the partial re-merge path in Config::reloadFile()
+  std::set<std::string> dirty_config_files_;
+
+  std::unique_ptr<ControlServer> control_server_;
 };
 
 }  // namespace waybar
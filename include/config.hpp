@@ -2,6 +2,7 @@
 
 #include <json/json.h>
 
+#include <map>
 #include <optional>
 #include <string>
 
@@ -23,16 +24,37 @@ class Config {
 
   void load(const std::string &config);
 
+  /// Re-merge after a change to one already-loaded source file: only `path`
+  /// is re-read from disk, every other fragment is replayed from the parse
+  /// cache in the original include order, so precedence is unchanged.
+  /// Returns false when the file is unknown or no parses are held (the tree
+  /// came from the binary cache); the caller then does a full load().
+  bool reloadFile(const std::string &path);
+
   Json::Value &getConfig() { return config_; }
 
+  /// Top-level key → source file that first defined it (object configs only).
+  const std::map<std::string, std::string> &getKeySources() const { return key_sources_; }
+
+  /// Every file the current tree was built from (main config first).
+  const std::vector<std::string> &getSourceFiles() const { return source_files_; }
+  const std::string &getConfigFile() const { return config_file_; }
+
   std::vector<Json::Value> getOutputConfigs(const std::string &name, const std::string &identifier);
 
  private:
   void setupConfig(Json::Value &dst, const std::string &config_file, int depth);
   void resolveConfigIncludes(Json::Value &config, int depth);
   void mergeConfig(Json::Value &a_config_, Json::Value &b_config_);
+  Json::Value parseSourceFile(const std::string &config_file);
 
   std::string config_file_;
+  // every file the merged tree was built from; keys the binary cache
+  std::vector<std::string> source_files_;
+  // pristine parse of each source file, so reloadFile() can replay the merge
+  // without touching the unchanged fragments
+  std::map<std::string, Json::Value> parsed_cache_;
+  std::map<std::string, std::string> key_sources_;
 
   Json::Value config_;
 };
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <glibmm/main.h>
+#include <sigc++/connection.h>
+
+#include <map>
+#include <string>
+
+namespace waybar {
+
+/**
+ * Line-oriented unix control socket for targeted actions on a running bar:
+ * refreshing a single module, toggling bar or module visibility, switching
+ * bar modes. Lets automation address one module (`waybar ctl refresh network`)
+ * instead of broadcasting an RTMIN signal that wakes every module.
+ *
+ * Protocol: one command per connection, newline-terminated; the reply is
+ * either "ok" or "error: <reason>".
+ */
+class ControlServer {
+ public:
+  ControlServer();
+  ~ControlServer();
+
+  static std::string socketPath();
+  /// `waybar ctl <command...>`: send one command, print the reply.
+  static int clientMain(int argc, char *argv[]);
+
+ private:
+  bool onConnect(Glib::IOCondition cond);
+  bool onData(Glib::IOCondition cond, int fd);
+  void closeConnection(int fd);
+  std::string handleCommand(const std::string &line);
+
+  struct connection {
+    std::string buffer;
+    sigc::connection watch;
+  };
+
+  int fd_ = -1;
+  sigc::connection accept_watch_;
+  std::map<int, connection> connections_;
+};
+
+}  // namespace waybar
@@ -30,6 +30,9 @@
 #include "modules/memory.hpp"
 #endif
 #include "modules/disk.hpp"
+#include "modules/mpris.hpp"
+#include "modules/perf.hpp"
+#include "modules/systemd_failed_units.hpp"
 #ifdef HAVE_DBUSMENU
 #include "modules/sni/tray.hpp"
 #endif
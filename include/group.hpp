@@ -1,9 +1,13 @@
 #pragma once
 
 #include <gtkmm/box.h>
+#include <gtkmm/revealer.h>
 #include <gtkmm/widget.h>
 #include <json/json.h>
 
+#include <memory>
+#include <vector>
+
 #include "AModule.hpp"
 #include "bar.hpp"
 #include "factory.hpp"
@@ -16,7 +20,25 @@ class Group : public AModule {
   ~Group() = default;
   auto update() -> void;
   operator Gtk::Widget&();
+  /// Called by the Bar while populating the group. In drawer mode the first
+  /// child stays visible as the handle and the rest sit in a collapsed
+  /// revealer with their workers suspended until the group is expanded.
+  void addChild(const std::shared_ptr<AModule>& child);
   Gtk::Box box;
+
+ protected:
+  void onSuspended(bool) override;
+
+ private:
+  void setExpanded(bool expanded);
+
+  // drawer mode ("drawer": true): children after the first are hidden and
+  // suspended until the handle is clicked
+  bool drawer_ = false;
+  bool expanded_ = false;
+  Gtk::Revealer revealer_;
+  Gtk::Box drawer_box_;
+  std::vector<std::shared_ptr<AModule>> children_;
 };
 
 }  // namespace waybar
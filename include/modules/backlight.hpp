@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -7,7 +8,6 @@
 
 #include "ALabel.hpp"
 #include "util/json.hpp"
-#include "util/sleeper_thread.hpp"
 
 struct udev;
 struct udev_device;
@@ -48,14 +48,13 @@ class Backlight : public ALabel {
   static void enumerate_devices(ForwardIt first, ForwardIt last, Inserter inserter, udev *udev);
 
   const std::string preferred_device_;
-  static constexpr int EPOLL_MAX_EVENTS = 16;
 
   std::optional<BacklightDev> previous_best_;
   std::string previous_format_;
 
-  std::mutex udev_thread_mutex_;
+  // guards devices_ between the UdevWatcher callback and update()
+  std::mutex udev_mutex_;
   std::vector<BacklightDev> devices_;
-  // thread must destruct before shared data
-  util::SleeperThread udev_thread_;
+  int udev_token_ = -1;
 };
 }  // namespace waybar::modules
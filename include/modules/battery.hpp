@@ -9,12 +9,21 @@
 #include <sys/inotify.h>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <fstream>
+#include <map>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "ALabel.hpp"
+#include "util/fd_reactor.hpp"
+#include "util/pollable_file.hpp"
 #include "util/sleeper_thread.hpp"
+#include "util/timer_scheduler.hpp"
 
 namespace waybar::modules {
 
@@ -33,22 +42,83 @@ class Battery : public ALabel {
  private:
   static inline const fs::path data_dir_ = "/sys/class/power_supply/";
 
+  /// One tracked battery: its inotify watch plus a cached fd on the
+  /// consolidated uevent file, which carries every key we need in one read.
+  struct BatterySource {
+    BatterySource(const fs::path& path, int wd) : wd(wd), uevent((path / "uevent").string()) {}
+    int wd;
+    util::PollableFile uevent;
+  };
+
+  /// All uevent keys consumed by getInfos(), parsed in a single pass.
+  /// Missing numeric keys stay at -1.
+  struct UeventValues {
+    std::string status = "Unknown";
+    int64_t capacity = -1;
+    int64_t voltage_now = -1;
+    int64_t voltage_avg = -1;
+    int64_t current_now = -1;
+    int64_t current_avg = -1;
+    int64_t charge_now = -1;
+    int64_t charge_full = -1;
+    int64_t charge_full_design = -1;
+    int64_t energy_now = -1;
+    int64_t energy_full = -1;
+    int64_t energy_full_design = -1;
+    int64_t power_now = -1;
+  };
+
+  static UeventValues parseUevent(std::string_view contents);
+
   void refreshBatteries();
   void worker();
   const std::string getAdapterStatus(uint8_t capacity) const;
   const std::tuple<uint8_t, float, std::string, float> getInfos();
   const std::string formatTimeRemaining(float hoursRemaining);
+  const std::string& getStatusFormat(const std::string& status, const std::string& state);
+
+  /// Values the tooltip needs, captured per update; the tooltip itself is
+  /// only formatted on hover.
+  struct TooltipContext {
+    uint8_t capacity = 0;
+    float time_remaining = 0;
+    std::string status;
+    std::string status_pretty;
+    std::string state;
+    std::string time_formatted;
+  };
 
   int global_watch;
-  std::map<fs::path, int> batteries_;
+  TooltipContext tooltip_ctx_;
+  std::map<fs::path, std::unique_ptr<BatterySource>> batteries_;
   fs::path adapter_;
   int battery_watch_fd_;
   int global_watch_fd_;
   std::mutex battery_list_mutex_;
   std::string old_status_;
+  // "format-<status>-<state>" → "format-<status>" → "format-<state>" fallback
+  // chain, resolved once per (status, state) pair so update() never rebuilds
+  // the key strings or touches the config; nullopt falls through to format_
+  std::map<std::string, std::map<std::string, std::optional<std::string>>> status_format_cache_;
+  // when getInfos() last touched the uevent files; used to filter out the
+  // IN_ACCESS events our own reads generate
+  std::atomic<std::chrono::steady_clock::rep> last_uevent_read_{0};
+
+  /// Time constant of the exponential average the {time} estimate divides
+  /// by; instantaneous draw swings far too much to be shown directly.
+  static constexpr float power_smoothing_tau_ = 300.0f;  // seconds
+  float smoothed_power_ = -1.0f;  // μW, < 0 until the first sample
+  std::string smoothed_status_;
+  std::chrono::steady_clock::time_point last_power_sample_{};
+  // persisted slots so a restart (or config reload) resumes the smoothing
+  // instead of starting cold; direction is 1 discharging, 2 charging
+  double* power_ema_slot_ = nullptr;
+  double* power_ema_dir_slot_ = nullptr;
+  // set from the scheduler's resume listener; the next getInfos() restarts
+  // the smoothing instead of averaging across the suspend gap
+  std::atomic<bool> resumed_{false};
+  util::TimerScheduler::ResumeListenerId resume_listener_ = 0;
 
-  util::SleeperThread thread_;
-  util::SleeperThread thread_battery_update_;
   util::SleeperThread thread_timer_;
 };
 
@@ -1,18 +1,52 @@
 #pragma once
 
+#include <gio/gio.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
 #include "ALabel.hpp"
 #include "util/rfkill.hpp"
 
 namespace waybar::modules {
 
+/**
+ * Bluetooth status. Soft-block state still comes from rfkill, but connection
+ * info is kept in a device table fed by BlueZ's ObjectManager and
+ * PropertiesChanged signals: one GetManagedObjects at startup, incremental
+ * updates afterwards, no polling.
+ */
 class Bluetooth : public ALabel {
  public:
   Bluetooth(const std::string&, const Json::Value&);
-  ~Bluetooth() = default;
+  ~Bluetooth();
   auto update() -> void;
 
  private:
+  struct Device {
+    bool connected = false;
+    int battery = -1;  // percentage, -1 when the device exposes none
+    std::string alias;
+  };
+
+  static void onManagedObjects(::GObject* source, ::GAsyncResult* result, void* data);
+  static void onInterfacesAdded(::GDBusConnection*, const gchar*, const gchar*, const gchar*,
+                                const gchar*, ::GVariant* params, void* data);
+  static void onInterfacesRemoved(::GDBusConnection*, const gchar*, const gchar*, const gchar*,
+                                  const gchar*, ::GVariant* params, void* data);
+  static void onPropertiesChanged(::GDBusConnection*, const gchar*, const gchar* object_path,
+                                  const gchar*, const gchar*, ::GVariant* params, void* data);
+  /// Merge one interface's property dict into the table; true if display-relevant.
+  bool applyProperties(const char* path, const char* interface, ::GVariant* props);
+
   util::Rfkill rfkill_;
+  ::GDBusConnection* bus_ = nullptr;  // borrowed from the shared manager
+  ::GCancellable* cancellable_ = nullptr;
+  std::vector<guint> signal_subs_;
+  // keyed by BlueZ object path
+  std::map<std::string, Device> devices_;
+  std::string status_class_;
 };
 
 }  // namespace waybar::modules
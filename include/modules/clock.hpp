@@ -2,6 +2,9 @@
 
 #include <date/tz.h>
 
+#include <array>
+#include <map>
+
 #include "ALabel.hpp"
 #include "util/sleeper_thread.hpp"
 
@@ -11,8 +14,9 @@ struct waybar_time;
 
 namespace modules {
 
-const std::string kCalendarPlaceholder = "calendar";
-const std::string KTimezonedTimeListPlaceholder = "timezoned_time_list";
+// inline: one instance program-wide instead of a copy per including TU
+inline const std::string kCalendarPlaceholder = "calendar";
+inline const std::string KTimezonedTimeListPlaceholder = "timezoned_time_list";
 
 class Clock : public ALabel {
  public:
@@ -21,20 +25,36 @@ class Clock : public ALabel {
   auto update() -> void;
 
  private:
+  /// A month grid rendered without the "today" highlight, plus the byte span
+  /// of every day cell so the highlight can be spliced in per day.
+  struct CachedMonth {
+    std::string grid;
+    std::array<std::pair<uint16_t, uint16_t>, 31> day_spans;
+  };
+
   util::SleeperThread thread_;
   std::locale locale_;
+  // configured zone names ("" = local); pointers resolved lazily after the
+  // background tzdata warm-up
+  std::vector<std::string> time_zone_names_;
   std::vector<const date::time_zone*> time_zones_;
+  const date::time_zone* local_zone_ = nullptr;
   int current_time_zone_idx_;
   date::year_month_day cached_calendar_ymd_ = date::January / 1 / 0;
   std::string cached_calendar_text_;
+  std::map<date::year_month, CachedMonth> month_cache_;
   bool is_calendar_in_tooltip_;
   bool is_timezoned_list_in_tooltip_;
 
   bool handleScroll(GdkEventScroll* e);
 
+  auto tooltip_text() -> std::string;
   auto calendar_text(const waybar_time& wtime) -> std::string;
+  auto cached_month(const date::year_month& ym) -> const CachedMonth&;
+  auto render_month(const date::year_month& ym) -> CachedMonth;
   auto weekdays_header(const date::weekday& first_dow, std::ostream& os) -> void;
   auto first_day_of_week() -> date::weekday;
+  const date::time_zone* zone_at(size_t idx);
   const date::time_zone* current_timezone();
   bool is_timezone_fixed();
   auto timezones_text(std::chrono::system_clock::time_point* now) -> std::string;
@@ -4,13 +4,15 @@
 
 #include <cstdint>
 #include <fstream>
+#include <memory>
 #include <numeric>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "ALabel.hpp"
-#include "util/sleeper_thread.hpp"
+#include "util/proc_sampler.hpp"
+#include "util/timer_scheduler.hpp"
 
 namespace waybar::modules {
 
@@ -21,6 +23,7 @@ class Cpu : public ALabel {
   auto update() -> void;
 
  private:
+  void onSuspended(bool) override;
   double getCpuLoad();
   std::tuple<std::vector<uint16_t>, std::string> getCpuUsage();
   std::tuple<float, float, float> getCpuFrequency();
@@ -28,8 +31,18 @@ class Cpu : public ALabel {
   std::vector<float> parseCpuFrequencies();
 
   std::vector<std::tuple<size_t, size_t>> prev_times_;
-
-  util::SleeperThread thread_;
+  // flat ring buffer of overall-usage samples, aggregated incrementally
+  std::vector<uint16_t> usage_history_;
+  size_t history_pos_ = 0;
+  size_t history_len_ = 0;
+  uint32_t history_sum_ = 0;
+  // cached per-core cpufreq/scaling_cur_freq fds, enumerated on first use
+  std::vector<std::unique_ptr<util::PollableFile>> freq_files_;
+  bool freq_files_init_ = false;
+  // frequency parsing is skipped when no format references a *_frequency field
+  bool wants_frequency_ = true;
+
+  util::IntervalWorker worker_;
 };
 
 }  // namespace waybar::modules
@@ -8,6 +8,9 @@
 #include "ALabel.hpp"
 #include "util/command.hpp"
 #include "util/json.hpp"
+#include "util/json_sax.hpp"
+#include "util/native_expr.hpp"
+#include "util/script_poller.hpp"
 #include "util/sleeper_thread.hpp"
 
 namespace waybar::modules {
@@ -17,13 +20,16 @@ class Custom : public ALabel {
   Custom(const std::string&, const std::string&, const Json::Value&);
   ~Custom();
   auto update() -> void;
-  void refresh(int /*signal*/);
+  void refresh(int /*signal*/) override;
 
  private:
+  void onSuspended(bool) override;
   void delayWorker();
   void continuousWorker();
+  bool getLineBounded(std::string& line);
   void parseOutputRaw();
   void parseOutputJson();
+  void parseOutputJsonDom();
   void handleEvent();
   bool handleScroll(GdkEventScroll* e);
   bool handleToggle(GdkEventButton* const& e);
@@ -35,9 +41,21 @@ class Custom : public ALabel {
   std::vector<std::string> class_;
   int percentage_;
   FILE* fp_;
+  // persistent getline() buffer for continuousWorker; grows once and is reused
+  char* buff_ = nullptr;
+  size_t buff_len_ = 0;
+  // hard cap on a single line from a continuous script ("max-output-bytes");
+  // 0 disables the cap
+  size_t max_line_bytes_;
+  uint64_t truncated_lines_ = 0;
   int pid_;
   util::command::res output_;
   util::JsonParser parser_;
+  // "exec-native" expression, evaluated in-process instead of spawning a shell
+  std::unique_ptr<util::NativeExpr> native_;
+  // interval scripts run on a poller shared between bars with the same config
+  std::shared_ptr<util::ScriptPoller> poller_;
+  util::ScriptPoller::Subscription subscription_ = 0;
 
   util::SleeperThread thread_;
 };
@@ -3,23 +3,68 @@
 #include <fmt/format.h>
 #include <sys/statvfs.h>
 
+#include <atomic>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include "ALabel.hpp"
 #include "util/format.hpp"
-#include "util/sleeper_thread.hpp"
+#include "util/timer_scheduler.hpp"
 
 namespace waybar::modules {
 
 class Disk : public ALabel {
  public:
   Disk(const std::string&, const Json::Value&);
-  ~Disk() = default;
+  ~Disk();
   auto update() -> void;
 
  private:
-  util::SleeperThread thread_;
-  std::string path_;
+  /// Result slot for one async probe pass over every configured path. The
+  /// probe thread only ever touches this shared block, never the module, so a
+  /// call stuck on a dead NFS server cannot outlive-and-crash us. Paths on
+  /// the same filesystem share one statvfs call; `primary` marks the first
+  /// path of each filesystem, so aggregates don't double-count.
+  struct Probe {
+    std::atomic<bool> done{false};
+    std::vector<int> errs;
+    std::vector<struct statvfs> stats;
+    std::vector<bool> primary;
+  };
+
+  /// Keeps the completion eventfd alive until the last probe thread is done
+  /// writing to it.
+  struct Notifier {
+    int fd;
+    ~Notifier();
+  };
+
+  // render from last-known-good this long after an unanswered probe
+  static constexpr std::chrono::seconds probe_timeout_{5};
+
+  void onSuspended(bool) override;
+  void startProbe();
+  bool onProbeDone(Glib::IOCondition cond);
+  bool onMountsChanged(Glib::IOCondition cond);
+
+  util::IntervalWorker worker_;
+  std::vector<std::string> paths_;  // first entry drives state and the plain fields
+
+  std::mutex mutex_;
+  std::shared_ptr<Probe> probe_;
+  std::shared_ptr<Notifier> notifier_;
+  std::chrono::steady_clock::time_point probe_started_;
+  std::vector<int> errs_;
+  std::vector<struct statvfs> stats_;
+  std::vector<bool> primary_;
+  bool has_stats_ = false;
+  bool stale_ = false;
+
+  int mounts_fd_ = -1;
+  sigc::connection probe_watch_;
+  sigc::connection mounts_watch_;
 };
 
 }  // namespace waybar::modules
@@ -5,6 +5,7 @@
 #include "ALabel.hpp"
 #include "bar.hpp"
 #include "client.hpp"
+#include "util/idle_inhibit_manager.hpp"
 
 namespace waybar::modules {
 
@@ -13,14 +14,12 @@ class IdleInhibitor : public ALabel {
   IdleInhibitor(const std::string&, const waybar::Bar&, const Json::Value&);
   ~IdleInhibitor();
   auto update() -> void;
-  static std::list<waybar::AModule*> modules;
-  static bool status;
 
  private:
   bool handleToggle(GdkEventButton* const& e);
 
   const Bar& bar_;
-  struct zwp_idle_inhibitor_v1* idle_inhibitor_;
+  int subscription_;
   int pid_;
 };
 
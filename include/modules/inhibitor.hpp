@@ -2,8 +2,6 @@
 
 #include <gio/gio.h>
 
-#include <memory>
-
 #include "ALabel.hpp"
 #include "bar.hpp"
 
@@ -18,10 +16,13 @@ class Inhibitor : public ALabel {
 
  private:
   auto handleToggle(::GdkEventButton* const& e) -> bool;
+  static void onInhibitReady(::GObject* source, ::GAsyncResult* result, void* data);
 
-  const std::unique_ptr<::GDBusConnection, void (*)(::GDBusConnection*)> dbus_;
   const std::string inhibitors_;
   int handle_ = -1;
+  // an Inhibit call is in flight; further clicks are ignored until it lands
+  bool pending_ = false;
+  ::GCancellable* cancellable_ = nullptr;
 };
 
 }  // namespace waybar::modules
@@ -8,9 +8,10 @@
 #endif
 #include <gtkmm/label.h>
 
+#include <glibmm/main.h>
+
 #include "AModule.hpp"
 #include "bar.hpp"
-#include "util/sleeper_thread.hpp"
 
 extern "C" {
 #include <libevdev/libevdev.h>
@@ -30,17 +31,20 @@ class KeyboardState : public AModule {
   Gtk::Label capslock_label_;
   Gtk::Label scrolllock_label_;
 
+  /// Locate a device exposing the lock LEDs and start watching its fd.
+  void findDevice();
+  /// Drop a vanished device and retry until it (or a replacement) shows up.
+  void reacquireDevice();
+
   std::string numlock_format_;
   std::string capslock_format_;
   std::string scrolllock_format_;
-  const std::chrono::seconds interval_;
   std::string icon_locked_;
   std::string icon_unlocked_;
 
   int fd_;
   libevdev* dev_;
-
-  util::SleeperThread thread_;
+  sigc::connection retry_timer_;
 };
 
 }  // namespace waybar::modules
@@ -3,10 +3,10 @@
 #include <fmt/format.h>
 
 #include <fstream>
-#include <unordered_map>
 
 #include "ALabel.hpp"
-#include "util/sleeper_thread.hpp"
+#include "util/proc_sampler.hpp"
+#include "util/timer_scheduler.hpp"
 
 namespace waybar::modules {
 
@@ -17,11 +17,28 @@ class Memory : public ALabel {
   auto update() -> void;
 
  private:
+  void onSuspended(bool) override;
   void parseMeminfo();
 
-  std::unordered_map<std::string, unsigned long> meminfo_;
-
-  util::SleeperThread thread_;
+  // Only the fields update() consumes; filled by a single allocation-free
+  // pass over the meminfo snapshot. Values are in kB.
+  struct MemInfo {
+    unsigned long mem_total = 0;
+    unsigned long mem_free = 0;
+    unsigned long mem_available = 0;
+    bool has_mem_available = false;
+    unsigned long swap_total = 0;
+    unsigned long swap_free = 0;
+    unsigned long buffers = 0;
+    unsigned long cached = 0;
+    unsigned long s_reclaimable = 0;
+    unsigned long shmem = 0;
+    unsigned long zfs_size = 0;
+  };
+
+  MemInfo meminfo_;
+
+  util::IntervalWorker worker_;
 };
 
 }  // namespace waybar::modules
@@ -52,7 +52,7 @@ class MPD : public ALabel {
   // MPD-side, Non-GUI methods.
   void tryConnect();
   void checkErrors(mpd_connection* conn);
-  void fetchState();
+  void fetchState(enum mpd_idle events = static_cast<enum mpd_idle>(-1));
   void queryMPD();
 
   inline bool stopped() const { return connection_ && state_ == MPD_STATE_STOP; }
@@ -45,15 +45,15 @@ class State {
  public:
   virtual ~State() noexcept = default;
 
-  virtual void entry() noexcept { spdlog::debug("mpd: ignore entry action"); }
-  virtual void exit() noexcept { spdlog::debug("mpd: ignore exit action"); }
+  virtual void entry() noexcept { SPDLOG_DEBUG("mpd: ignore entry action"); }
+  virtual void exit() noexcept { SPDLOG_DEBUG("mpd: ignore exit action"); }
 
-  virtual void play() { spdlog::debug("mpd: ignore play state transition"); }
-  virtual void stop() { spdlog::debug("mpd: ignore stop state transition"); }
-  virtual void pause() { spdlog::debug("mpd: ignore pause state transition"); }
+  virtual void play() { SPDLOG_DEBUG("mpd: ignore play state transition"); }
+  virtual void stop() { SPDLOG_DEBUG("mpd: ignore stop state transition"); }
+  virtual void pause() { SPDLOG_DEBUG("mpd: ignore pause state transition"); }
 
   /// Request state update the GUI.
-  virtual void update() noexcept { spdlog::debug("mpd: ignoring update method request"); }
+  virtual void update() noexcept { SPDLOG_DEBUG("mpd: ignoring update method request"); }
 };
 
 class Idle : public State {
@@ -148,6 +148,8 @@ class Stopped : public State {
 class Disconnected : public State {
   Context* const ctx_;
   sigc::connection timer_connection_;
+  // consecutive failed connection attempts, drives the backoff
+  unsigned retries_ = 0;
 
  public:
   Disconnected(Context* const ctx) : ctx_{ctx} {}
@@ -197,7 +199,7 @@ class Context {
   void checkErrors(mpd_connection*) const;
   void do_update();
   void queryMPD() const;
-  void fetchState() const;
+  void fetchState(enum mpd_idle events = static_cast<enum mpd_idle>(-1)) const;
   constexpr mpd_state state() const;
   void emit() const;
   [[nodiscard]] unique_connection& connection();
@@ -16,7 +16,7 @@ inline void Context::do_update() { mpd_module_->setLabel(); }
 
 inline void Context::checkErrors(mpd_connection* conn) const { mpd_module_->checkErrors(conn); }
 inline void Context::queryMPD() const { mpd_module_->queryMPD(); }
-inline void Context::fetchState() const { mpd_module_->fetchState(); }
+inline void Context::fetchState(enum mpd_idle events) const { mpd_module_->fetchState(events); }
 inline void Context::emit() const { mpd_module_->emit(); }
 
 }  // namespace detail
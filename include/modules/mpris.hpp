@@ -0,0 +1,64 @@
+#pragma once
+
+#include <giomm/dbusconnection.h>
+#include <giomm/dbusproxy.h>
+
+#include <string>
+#include <vector>
+
+#include "AIconLabel.hpp"
+#include "util/pango_escape.hpp"
+
+namespace waybar::modules {
+
+/**
+ * Native MPRIS media display. Entirely event-driven: player arrivals are
+ * tracked through NameOwnerChanged, metadata through the shared player proxy's
+ * PropertiesChanged cache, so nothing is spawned or polled between track
+ * changes. With "icon" enabled the album art is shown next to the label,
+ * decoded once per file through the shared icon cache.
+ */
+class Mpris : public AIconLabel {
+ public:
+  Mpris(const std::string &, const Json::Value &);
+  ~Mpris();
+  auto update() -> void;
+  bool handleToggle(GdkEventButton *const &);
+
+ private:
+  void onNameOwnerChanged(const Glib::RefPtr<Gio::DBus::Connection> &, const Glib::ustring &,
+                          const Glib::ustring &, const Glib::ustring &, const Glib::ustring &,
+                          const Glib::VariantContainerBase &);
+  void addPlayer(const Glib::ustring &name);
+  void removePlayer(const Glib::ustring &name);
+  void selectPlayer();
+  void attachPlayer();
+  void detachPlayer();
+  /// Re-read the proxy's property cache; true if anything the bar shows changed.
+  bool readPlayer();
+  void updateArt();
+
+  Glib::RefPtr<Gio::DBus::Connection> connection_;
+  Glib::RefPtr<Gio::DBus::Proxy> player_proxy_;
+  sigc::connection props_conn_;
+  guint name_owner_sub_ = 0;
+
+  const std::string preferred_player_;
+  const std::string tooltip_format_;
+  // bus names of running players, in order of appearance
+  std::vector<Glib::ustring> players_;
+  Glib::ustring current_player_;
+
+  std::string status_;
+  std::string artist_;
+  std::string title_;
+  std::string album_;
+  std::string art_url_;
+  // CSS class currently applied for the playback status
+  std::string status_class_;
+  util::PangoEscapeCache artist_escape_;
+  util::PangoEscapeCache title_escape_;
+  util::PangoEscapeCache album_escape_;
+};
+
+}  // namespace waybar::modules
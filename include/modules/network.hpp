@@ -8,10 +8,14 @@
 #include <netlink/netlink.h>
 #include <sys/epoll.h>
 
+#include <array>
+#include <atomic>
 #include <optional>
+#include <vector>
 
 #include "ALabel.hpp"
 #include "util/sleeper_thread.hpp"
+#include "util/timer_scheduler.hpp"
 #ifdef WANT_RFKILL
 #include "util/rfkill.hpp"
 #endif
@@ -34,6 +38,40 @@ class Network : public ALabel {
 
   void askForStateDump(void);
 
+  // A default route from the main table, mirrored from RTM_NEWROUTE /
+  // RTM_DELROUTE multicast events so a dead route can be replaced by a
+  // table lookup instead of a fresh RTM_GETROUTE dump.
+  struct DefaultRoute {
+    int ifindex;
+    uint32_t priority;
+    std::string gwaddr;
+  };
+
+  // Smoothed view over the per-interval bandwidth deltas: an EWMA plus a
+  // fixed-size ring of recent samples for the peak and sparkline fields.
+  // push() is O(1) per sample (the ring size is a small constant).
+  struct BandwidthHistory {
+    static constexpr size_t RING_SIZE = 16;
+    // EWMA weight for the newest sample; ~2/(N+1) for an N=8 sample window
+    static constexpr double ALPHA = 0.22;
+
+    void push(unsigned long long sample);
+    std::string sparkline() const;
+
+    double ewma = 0.0;
+    bool primed = false;
+    unsigned long long peak = 0;
+    std::array<unsigned long long, RING_SIZE> ring{};
+    size_t head = 0;
+    size_t count = 0;
+  };
+
+  void cacheRoute(int ifindex, uint32_t priority, const std::string& gwaddr);
+  void uncacheRoute(int ifindex, uint32_t priority);
+  void forgetRoutes(int ifindex);
+  void adoptRoute(int ifindex, uint32_t priority, const std::string& gwaddr);
+  bool selectBestRoute();
+
   void worker();
   void createInfoSocket();
   void createEventSocket();
@@ -42,11 +80,13 @@ class Network : public ALabel {
   void parseFreq(struct nlattr**);
   bool associatedOrJoined(struct nlattr**);
   bool checkInterface(std::string name);
+  bool formatNeedsWifiInfo() const;
   auto getInfo() -> void;
   const std::string getNetworkState() const;
   void clearIface();
   bool wildcardMatch(const std::string& pattern, const std::string& text) const;
   std::optional<std::pair<unsigned long long, unsigned long long>> readBandwidthUsage();
+  std::optional<std::pair<unsigned long long, unsigned long long>> readNetlinkStats();
 
   int ifid_;
   sa_family_t family_;
@@ -55,7 +95,18 @@ class Network : public ALabel {
   struct nl_sock* ev_sock_ = nullptr;
   int efd_;
   int ev_fd_;
+  // cached blocking NETLINK_ROUTE socket for IFLA_STATS64 bandwidth queries
+  int stats_fd_ = -1;
+  unsigned int stats_seq_ = 0;
   int nl80211_id_;
+  // prebuilt NL80211_CMD_GET_SCAN request, reused across polls until the
+  // selected interface changes
+  struct nl_msg* scan_msg_ = nullptr;
+  int scan_msg_ifid_ = -1;
+  // whether any configured format references wifi fields; decided once at
+  // construction, skips the nl80211 round trip entirely when false
+  bool wants_wifi_info_;
+  bool wants_bandwidth_;
   std::mutex mutex_;
 
   bool want_route_dump_;
@@ -65,6 +116,13 @@ class Network : public ALabel {
 
   unsigned long long bandwidth_down_total_;
   unsigned long long bandwidth_up_total_;
+  BandwidthHistory bandwidth_down_history_;
+  BandwidthHistory bandwidth_up_history_;
+  // set from the scheduler's resume listener; the next update() takes fresh
+  // totals as the new baseline instead of charging the whole suspend gap to
+  // one interval
+  std::atomic<bool> rebaseline_bandwidth_{false};
+  util::TimerScheduler::ResumeListenerId resume_listener_ = 0;
 
   std::string state_;
   std::string essid_;
@@ -79,6 +137,7 @@ class Network : public ALabel {
   std::string signal_strength_app_;
   float frequency_;
   uint32_t route_priority;
+  std::vector<DefaultRoute> default_routes_;
 
   util::SleeperThread thread_;
   util::SleeperThread thread_timer_;
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <fmt/format.h>
+
+#include "ALabel.hpp"
+#include "util/timer_scheduler.hpp"
+
+namespace waybar::modules {
+
+/**
+ * Surfaces waybar's own perf counters (see util/perf_counters.hpp): which
+ * module has the slowest updates, how often the bar redraws. The full
+ * histogram dump is available through `waybar ctl perf`.
+ */
+class Perf : public ALabel {
+ public:
+  Perf(const std::string&, const Json::Value&);
+  auto update() -> void;
+
+ private:
+  void onSuspended(bool) override;
+
+  util::IntervalWorker worker_;
+};
+
+}  // namespace waybar::modules
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 
 #include "ALabel.hpp"
 
@@ -25,8 +26,10 @@ class Pulseaudio : public ALabel {
   static void serverInfoCb(pa_context*, const pa_server_info*, void*);
   static void volumeModifyCb(pa_context*, int, void*);
 
-  bool handleScroll(GdkEventScroll* e);
+  void applyScroll(int steps) override;
   const std::vector<std::string> getPulseIcon() const;
+  // collapse subscription storms: only the first event after a render queues a dispatch
+  void emitUpdate();
 
   pa_threaded_mainloop* mainloop_;
   pa_mainloop_api* mainloop_api_;
@@ -49,6 +52,10 @@ class Pulseaudio : public ALabel {
   std::string source_port_name_;
   std::string source_desc_;
   std::string default_source_name_;
+  std::atomic<bool> update_pending_{false};
+  // snapshot of the inputs of the last render, to skip the format path entirely
+  // when a burst of events settles on the same state
+  std::string last_render_key_;
 };
 
 }  // namespace waybar::modules
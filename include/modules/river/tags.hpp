@@ -29,10 +29,17 @@ class Tags : public waybar::AModule {
   struct wl_seat *seat_;
 
  private:
+  void apply_tags_delta(uint32_t tags, uint32_t &cached, const char *class_name);
+
   const waybar::Bar &bar_;
   Gtk::Box box_;
   std::vector<Gtk::Button> buttons_;
   struct zriver_output_status_v1 *output_status_;
+  // last rendered masks; river resends full state on every change, so styling
+  // only touches the buttons whose bit flipped
+  uint32_t focused_tags_ = 0;
+  uint32_t occupied_tags_ = 0;
+  uint32_t urgent_tags_ = 0;
 };
 
 } /* namespace waybar::modules::river */
@@ -5,7 +5,7 @@
 #include <vector>
 
 #include "ALabel.hpp"
-#include "util/sleeper_thread.hpp"
+#include "util/timer_scheduler.hpp"
 
 namespace waybar::modules {
 
@@ -21,9 +21,19 @@ class Sndio : public ALabel {
 
  private:
   auto connect_to_sndio() -> void;
-  util::SleeperThread thread_;
+  auto disconnect() -> void;
+  void onReady();
+  void tryReconnect();
+
   struct sioctl_hdl *hdl_;
   std::vector<struct pollfd> pfds_;
+  // fds currently registered with the FdReactor
+  std::vector<int> reactor_fds_;
+  // sndiod restarts are retried with exponential backoff: the timer ticks at
+  // its base interval and attempts are skipped until the backoff elapsed
+  util::IntervalWorker reconnect_timer_;
+  unsigned int backoff_ticks_ = 1;
+  unsigned int backoff_skip_ = 0;
   unsigned int addr_;
   unsigned int volume_, old_volume_, maxval_;
   bool muted_;
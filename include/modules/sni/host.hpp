@@ -31,8 +31,27 @@ class Host {
 
   std::tuple<std::string, std::string> getBusNameAndObjectPath(const std::string);
   void addRegisteredItem(std::string service);
+  void onInitialStatus(const std::string& bus_name, const std::string& object_path,
+                       Glib::RefPtr<Gio::AsyncResult>& result);
+  void onPendingStatusChanged(const Glib::RefPtr<Gio::DBus::Connection>&,
+                              const Glib::ustring& sender, const Glib::ustring& object_path,
+                              const Glib::ustring& interface, const Glib::ustring& signal,
+                              const Glib::VariantContainerBase& params);
+  void deferItem(const std::string& bus_name, const std::string& object_path);
+  void materializeItem(const std::string& bus_name, const std::string& object_path);
+  void dropPendingItems();
+
+  // Registrations whose Status was Passive at registration time; no widget or
+  // icon work is done for these until a NewStatus signal wakes them up.
+  struct PendingItem {
+    std::string bus_name;
+    std::string object_path;
+    guint signal_id;
+  };
 
   std::vector<std::unique_ptr<Item>> items_;
+  std::vector<PendingItem> pending_;
+  Glib::RefPtr<Gio::DBus::Connection> conn_;
   const std::string bus_name_;
   const std::string object_path_;
   std::size_t bus_name_id_;
@@ -46,11 +46,20 @@ class Watcher {
   static void gfWatchFree(gpointer data);
 
   void updateRegisteredItems(SnWatcher *obj);
+  void scheduleFlush();
+  static gboolean flushRegistrations(gpointer data);
 
   uint32_t bus_name_id_;
   GSList *hosts_ = nullptr;
   GSList *items_ = nullptr;
   SnWatcher *watcher_ = nullptr;
+  // registration burst state, drained by one idle flush: name-owner watches
+  // not yet started, ItemRegistered emissions not yet sent, and whether the
+  // RegisteredItems property needs one rebuild
+  GSList *pending_watches_ = nullptr;  // GfWatch*, borrowed from hosts_/items_
+  GSList *pending_registered_ = nullptr;  // owned strings
+  guint flush_idle_id_ = 0;
+  bool items_dirty_ = false;
 };
 
 }  // namespace waybar::modules::SNI
@@ -5,9 +5,12 @@
 #include <sys/un.h>
 #include <unistd.h>
 
+#include <condition_variable>
 #include <cstring>
 #include <memory>
 #include <mutex>
+#include <utility>
+#include <vector>
 
 #include "ipc.hpp"
 #include "util/sleeper_thread.hpp"
@@ -30,22 +33,49 @@ class Ipc {
 
   void sendCmd(uint32_t type, const std::string &payload = "");
   void subscribe(const std::string &payload);
-  void handleEvent();
-  void setWorker(std::function<void()> &&func);
 
  protected:
   static inline const std::string ipc_magic_ = "i3-ipc";
   static inline const size_t ipc_header_size_ = ipc_magic_.size() + 8;
 
-  const std::string getSocketPath() const;
-  int open(const std::string &) const;
-  struct ipc_response send(int fd, uint32_t type, const std::string &payload = "");
-  struct ipc_response recv(int fd);
+  /*
+   * One socket pair and one reader thread shared by every Ipc instance in the
+   * process. Commands from all modules are serialized over the command fd;
+   * events arrive on the event fd and get dispatched to the instances whose
+   * subscription mask covers them. Before this, each sway module opened its
+   * own pair of connections and parked its own thread in recv().
+   */
+  struct Connection {
+    Connection();
+    ~Connection();
 
-  int fd_;
-  int fd_event_;
-  std::mutex mutex_;
-  util::SleeperThread thread_;
+    const std::string getSocketPath() const;
+    int open(const std::string &) const;
+    void sendRequest(int fd, uint32_t type, const std::string &payload);
+    struct ipc_response send(int fd, uint32_t type, const std::string &payload);
+    struct ipc_response recv(int fd);
+    void subscribe(Ipc *client, const std::string &payload);
+    void handleEvent();
+
+    int fd_;
+    int fd_event_;
+    std::mutex mutex_;
+
+    std::mutex clients_mutex_;
+    std::vector<std::pair<Ipc *, uint32_t>> clients_;
+
+    // Hands SUBSCRIBE acks read by the reader thread back to subscribe().
+    std::mutex sub_mutex_;
+    std::condition_variable sub_cv_;
+    std::unique_ptr<struct ipc_response> sub_reply_;
+    uint32_t subscriptions_ = 0;
+
+    util::SleeperThread thread_;
+  };
+
+  static std::shared_ptr<Connection> getConnection();
+
+  std::shared_ptr<Connection> conn_;
 };
 
 }  // namespace waybar::modules::sway
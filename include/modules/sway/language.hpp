@@ -5,6 +5,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include "ALabel.hpp"
 #include "bar.hpp"
@@ -49,12 +50,17 @@ class Language : public ALabel, public sigc::trackable {
 
   auto set_current_layout(std::string current_layout) -> void;
   auto init_layouts_map(const std::vector<std::string>& used_layouts) -> void;
+  /// The xkb rules registry parsed once per session and shared between
+  /// instances; rxkb parsing is far too expensive to redo per layout change.
+  static const std::vector<Layout>& registryLayouts();
 
   const static std::string XKB_LAYOUT_NAMES_KEY;
   const static std::string XKB_ACTIVE_LAYOUT_NAME_KEY;
 
   Layout layout_;
   std::string tooltip_format_ = "";
+  // "keyboard-name": only this input identifier is tracked when set
+  std::string keyboard_name_;
   std::map<std::string, Layout> layouts_map_;
   bool is_variant_displayed;
   std::byte displayed_short_flag = static_cast<std::byte>(DispayedShortFlag::None);
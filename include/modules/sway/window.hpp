@@ -2,20 +2,23 @@
 
 #include <fmt/format.h>
 
+#include <regex>
 #include <tuple>
+#include <vector>
 
 #include "AIconLabel.hpp"
 #include "bar.hpp"
 #include "client.hpp"
 #include "modules/sway/ipc/client.hpp"
 #include "util/json.hpp"
+#include "util/pango_escape.hpp"
 
 namespace waybar::modules::sway {
 
 class Window : public AIconLabel, public sigc::trackable {
  public:
   Window(const std::string&, const waybar::Bar&, const Json::Value&);
-  ~Window() = default;
+  ~Window();
   auto update() -> void;
 
  private:
@@ -25,6 +28,7 @@ class Window : public AIconLabel, public sigc::trackable {
                                                                         std::string& output);
   void getTree();
   std::string rewriteTitle(const std::string& title);
+  const std::string& rewriteTitleCached(const std::string& title);
   void updateAppIcon();
 
   const Bar& bar_;
@@ -33,6 +37,17 @@ class Window : public AIconLabel, public sigc::trackable {
   std::string app_id_;
   std::string old_app_id_;
   std::size_t app_nb_;
+  // the focused title rarely changes between tree events; memoized escape
+  util::PangoEscapeCache title_escape_;
+  // "rewrite" rules compiled once at construction instead of per update
+  std::vector<std::pair<std::regex, std::string>> rewrite_rules_;
+  std::string rewrite_input_;
+  std::string rewrite_output_;
+  bool rewrite_cached_ = false;
+  // "debounce": coalesce a burst of title events into a single tree fetch
+  unsigned debounce_ms_ = 0;
+  bool tree_pending_ = false;
+  sigc::connection debounce_timer_;
   util::JsonParser parser_;
   std::mutex mutex_;
   Ipc ipc_;
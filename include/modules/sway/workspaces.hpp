@@ -4,7 +4,9 @@
 #include <gtkmm/button.h>
 #include <gtkmm/label.h>
 
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "AModule.hpp"
 #include "bar.hpp"
@@ -25,10 +27,20 @@ class Workspaces : public AModule, public sigc::trackable {
 
   static int convertWorkspaceNameToNum(std::string name);
 
+  // A workspace button plus the state it was last rendered with, so update()
+  // only touches the widget when a property actually changed. Recycled through
+  // button_pool_ instead of being destroyed on workspace close.
+  struct WorkspaceButton {
+    std::unique_ptr<Gtk::Button> button;
+    sigc::connection handler;
+    std::string label;
+    bool markup = false;
+  };
+
   void onCmd(const struct Ipc::ipc_response&);
   void onEvent(const struct Ipc::ipc_response&);
   bool filterButtons();
-  Gtk::Button& addButton(const Json::Value&);
+  WorkspaceButton& addButton(const Json::Value&);
   void onButtonReady(const Json::Value&, Gtk::Button&);
   std::string getIcon(const std::string&, const Json::Value&);
   const std::string getCycleWorkspace(std::vector<Json::Value>::iterator, bool prev) const;
@@ -41,7 +53,8 @@ class Workspaces : public AModule, public sigc::trackable {
   std::vector<std::string> workspaces_order_;
   Gtk::Box box_;
   util::JsonParser parser_;
-  std::unordered_map<std::string, Gtk::Button> buttons_;
+  std::unordered_map<std::string, WorkspaceButton> buttons_;
+  std::vector<WorkspaceButton> button_pool_;
   std::mutex mutex_;
   Ipc ipc_;
 };
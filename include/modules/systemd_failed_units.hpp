@@ -0,0 +1,43 @@
+#pragma once
+
+#include <giomm/dbusconnection.h>
+#include <giomm/dbusproxy.h>
+
+#include <string>
+#include <vector>
+
+#include "ALabel.hpp"
+
+namespace waybar::modules {
+
+/**
+ * Failed-unit counter fed from systemd's DBus signals. Replaces the usual
+ * `custom/systemd` module running `systemctl --failed` on an interval: unit
+ * state changes invalidate the module, invalidations within one batch window
+ * collapse into a single ListUnitsFiltered round-trip, and nothing is forked.
+ */
+class SystemdFailedUnits : public ALabel {
+ public:
+  SystemdFailedUnits(const std::string &, const Json::Value &);
+  ~SystemdFailedUnits();
+  auto update() -> void;
+
+ private:
+  void invalidate();
+  void queryFailed();
+
+  // invalidations arriving within this window share one query; systemd emits
+  // bursts of JobRemoved during a transaction
+  static constexpr unsigned BATCH_MS = 1000;
+
+  const std::string format_ok_;
+  Glib::RefPtr<Gio::DBus::Connection> connection_;
+  Glib::RefPtr<Gio::DBus::Proxy> manager_proxy_;
+  std::vector<guint> signal_subs_;
+  bool query_pending_ = false;
+
+  uint32_t nr_failed_ = 0;
+  std::vector<std::string> failed_units_;
+};
+
+}  // namespace waybar::modules
@@ -3,9 +3,12 @@
 #include <fmt/format.h>
 
 #include <fstream>
+#include <memory>
+#include <vector>
 
 #include "ALabel.hpp"
-#include "util/sleeper_thread.hpp"
+#include "util/pollable_file.hpp"
+#include "util/timer_scheduler.hpp"
 
 namespace waybar::modules {
 
@@ -16,11 +19,13 @@ class Temperature : public ALabel {
   auto update() -> void;
 
  private:
-  float getTemperature();
+  void onSuspended(bool) override;
+  std::vector<float> readTemperatures();
   bool isCritical(uint16_t);
 
-  std::string file_path_;
-  util::SleeperThread thread_;
+  // cached fds for every configured hwmon input, read in one sweep per tick
+  std::vector<std::unique_ptr<util::PollableFile>> sensors_;
+  util::IntervalWorker worker_;
 };
 
 }  // namespace waybar::modules
@@ -2,7 +2,11 @@
 
 #include <libupower-glib/upower.h>
 
+#include <string>
+#include <unordered_map>
+
 #include "gtkmm/box.h"
+#include "gtkmm/image.h"
 #include "gtkmm/label.h"
 #include "gtkmm/window.h"
 
@@ -12,9 +16,26 @@ class UPowerTooltip : public Gtk::Window {
  private:
   typedef std::unordered_map<std::string, UpDevice*> Devices;
 
+  /// One widget row per device, kept across updates. A mouse reporting its
+  /// battery every few seconds then costs a label patch, not a rebuild of
+  /// the whole tree.
+  struct Row {
+    Gtk::Box* box;
+    Gtk::Image* deviceIcon;
+    Gtk::Label* modelLabel;
+    Gtk::Image* chargeIcon;
+    Gtk::Label* percentLabel;
+    std::string deviceIconName;
+    std::string chargeIconName;
+    std::string model;
+    std::string percent;
+  };
+
   const std::string getDeviceIcon(UpDeviceKind& kind);
+  Row& getRow(const std::string& objectPath);
 
   Gtk::Box* contentBox;
+  std::unordered_map<std::string, Row> rows_;
 
   uint iconSize;
   uint tooltipSpacing;
@@ -20,6 +20,7 @@
 #include "client.hpp"
 #include "giomm/desktopappinfo.h"
 #include "util/json.hpp"
+#include "util/pango_escape.hpp"
 #include "wlr-foreign-toplevel-management-unstable-v1-client-protocol.h"
 
 namespace waybar::modules::wlr {
@@ -73,6 +74,17 @@ class Task {
   std::string title_;
   std::string app_id_;
   uint32_t state_ = 0;
+  // protocol events buffered until this toplevel's `done`; the widget work
+  // runs once per atomic batch instead of once per event
+  std::string pending_title_;
+  std::string pending_app_id_;
+  std::vector<std::pair<struct wl_output *, bool>> pending_outputs_;
+  bool title_changed_ = false;
+  bool app_id_changed_ = false;
+  // markup-mode escapes memoized per field; titles repeat between updates
+  util::PangoEscapeCache title_escape_;
+  util::PangoEscapeCache name_escape_;
+  util::PangoEscapeCache app_id_escape_;
 
  private:
   std::string repr() const;
@@ -81,10 +93,14 @@ class Task {
   bool image_load_icon(Gtk::Image &image, const Glib::RefPtr<Gtk::IconTheme> &icon_theme,
                        Glib::RefPtr<Gio::DesktopAppInfo> app_info, int size);
   void hide_if_ignored();
+  void apply_app_id();
+  void apply_output_enter(struct wl_output *);
+  void apply_output_leave(struct wl_output *);
 
  public:
   /* Getter functions */
   uint32_t id() const { return id_; }
+  bool visible() const { return button_visible_; }
   std::string title() const { return title_; }
   std::string app_id() const { return app_id_; }
   uint32_t state() const { return state_; }
@@ -141,6 +157,11 @@ class Taskbar : public waybar::AModule {
 
   struct zwlr_foreign_toplevel_manager_v1 *manager_;
   struct wl_seat *seat_;
+  bool update_scheduled_ = false;
+  bool sort_by_app_id_ = false;
+  bool sort_by_title_ = false;
+
+  bool task_before(const Task &, const Task &) const;
 
  public:
   /* Callbacks for global registration */
@@ -157,6 +178,18 @@ class Taskbar : public waybar::AModule {
   void remove_button(Gtk::Button &);
   void remove_task(uint32_t);
 
+  /// Render once at the next output frame, however many toplevels finished
+  /// their batches before it.
+  void schedule_update();
+
+  bool sorting() const { return sort_by_app_id_ || sort_by_title_; }
+  /// Box slot for a button that just became visible, or -1 if the appended
+  /// position is already correct.
+  int sorted_slot(const Task &) const;
+  /// Restores the sort order after a title/app_id change. Returns the
+  /// button's new box slot, or -1 when nothing has to be reordered.
+  int reposition_task(const Task &);
+
   bool show_output(struct wl_output *) const;
   bool all_outputs() const;
 
@@ -19,6 +19,14 @@ namespace waybar::modules::wlr {
 class WorkspaceManager;
 class WorkspaceGroup;
 
+/// The widget triple backing one workspace button; recycled through the
+/// manager's free pool when workspaces come and go.
+struct ButtonBundle {
+  Gtk::Button button;
+  Gtk::Box content;
+  Gtk::Label label;
+};
+
 class Workspace {
  public:
   Workspace(const waybar::Bar &bar, const Json::Value &config, WorkspaceGroup &workspace_group,
@@ -40,7 +48,7 @@ class Workspace {
   auto handle_clicked(GdkEventButton *bt) -> bool;
   auto show() -> void;
   auto hide() -> void;
-  auto get_button_ref() -> Gtk::Button & { return button_; }
+  auto get_button_ref() -> Gtk::Button & { return bundle_->button; }
   auto get_name() -> std::string & { return name_; }
   auto get_coords() -> std::vector<uint32_t> & { return coordinates_; }
 
@@ -68,9 +76,10 @@ class Workspace {
   std::string format_;
   bool with_icon_ = false;
 
-  Gtk::Button button_;
-  Gtk::Box content_;
-  Gtk::Label label_;
+  std::unique_ptr<ButtonBundle> bundle_;
+  sigc::connection click_connection_;
+  std::string last_markup_;
+  uint32_t last_rendered_state_ = ~0u;
 };
 
 class WorkspaceGroup {
@@ -92,6 +101,7 @@ class WorkspaceGroup {
   auto set_need_to_sort() -> void { need_to_sort = true; }
   auto add_button(Gtk::Button &button) -> void;
   auto remove_button(Gtk::Button &button) -> void;
+  auto manager() -> WorkspaceManager & { return workspace_manager_; }
 
   // wlr stuff
   auto handle_workspace_create(zext_workspace_handle_v1 *workspace_handle) -> void;
@@ -131,6 +141,8 @@ class WorkspaceManager : public AModule {
 
   auto sort_workspaces() -> void;
   auto remove_workspace_group(uint32_t id_) -> void;
+  auto acquire_button() -> std::unique_ptr<ButtonBundle>;
+  auto release_button(std::unique_ptr<ButtonBundle> bundle) -> void;
 
   // wlr stuff
   auto register_manager(wl_registry *registry, uint32_t name, uint32_t version) -> void;
@@ -141,8 +153,13 @@ class WorkspaceManager : public AModule {
   auto commit() -> void;
 
  private:
+  static constexpr size_t MAX_POOLED_BUTTONS = 32;
+
   const waybar::Bar &bar_;
   Gtk::Box box_;
+  // declared before groups_ so it outlives them: their workspaces release
+  // buttons into the pool on destruction
+  std::vector<std::unique_ptr<ButtonBundle>> button_pool_;
   std::vector<std::unique_ptr<WorkspaceGroup>> groups_;
 
   // wlr stuff
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <glibmm/main.h>
+#include <sigc++/connection.h>
+
+#include <mutex>
+#include <vector>
+
+namespace waybar {
+
+class AModule;
+
+/**
+ * Routes SIGRTMIN+n straight to the modules subscribed to that offset.
+ *
+ * These signals used to be caught by async handlers that walked every module
+ * of every bar probing for a matching "signal" setting; now modules register
+ * their offset at construction and delivery is one table lookup. The whole
+ * real-time range is drained from a single signalfd on the main loop, so no
+ * work happens in async-signal context.
+ */
+class SignalRouter {
+ public:
+  static SignalRouter &instance();
+
+  /// Block the real-time signal range; must run on the main thread before any
+  /// other thread is spawned so every thread inherits the mask (a thread with
+  /// the range unblocked would steal deliveries from the signalfd).
+  void block();
+  /// Create the signalfd and attach it to the main loop.
+  void start();
+
+  void subscribe(int offset, AModule *module);
+  void unsubscribe(AModule *module);
+
+ private:
+  SignalRouter();
+  bool onSignal(Glib::IOCondition cond);
+
+  int fd_ = -1;
+  sigc::connection watch_;
+  std::mutex mutex_;
+  // offset -> subscribers, indexed directly; modules register from async
+  // construction threads, hence the lock
+  std::vector<std::vector<AModule *>> table_;
+};
+
+}  // namespace waybar
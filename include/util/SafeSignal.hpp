@@ -7,10 +7,14 @@
 #include <mutex>
 #include <queue>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 #include <tuple>
 #include <type_traits>
 #include <utility>
 
+#include "util/perf_counters.hpp"
+
 namespace waybar {
 
 /**
@@ -34,14 +38,29 @@ struct SafeSignal : sigc::signal<void(std::decay_t<Args>...)> {
        */
       signal_t::emit(std::forward<EmitArgs>(args)...);
     } else {
+      bool notify;
       {
         std::unique_lock lock(mutex_);
+        // One dispatcher wakeup drains the whole queue; only the first producer
+        // after a drain needs to write to the dispatcher pipe.
+        notify = queue_.empty();
         queue_.emplace(std::forward<EmitArgs>(args)...);
       }
-      dp_.emit();
+      if (notify) {
+        dp_.emit();
+      }
     }
   }
 
+  /**
+   * Coalesce queued events that map to the same key: on drain only the newest event per
+   * key is delivered. Useful for high-rate producers (e.g. per-toplevel title updates)
+   * where intermediate values are never rendered anyway.
+   */
+  void set_coalesce_key(std::function<size_t(const std::decay_t<Args>&...)> key) {
+    coalesce_key_ = std::move(key);
+  }
+
   template <typename... EmitArgs>
   inline void operator()(EmitArgs&&... args) {
     emit(std::forward<EmitArgs>(args)...);
@@ -56,11 +75,37 @@ struct SafeSignal : sigc::signal<void(std::decay_t<Args>...)> {
   using signal_t::make_slot;
 
   void handle_event() {
-    for (std::unique_lock lock(mutex_); !queue_.empty(); lock.lock()) {
-      auto args = queue_.front();
-      queue_.pop();
-      lock.unlock();
-      std::apply(cached_fn_, args);
+    // Swap the whole queue out under a single lock; producers enqueueing during the
+    // drain trigger a fresh dispatcher wakeup.
+    std::queue<arg_tuple_t> events;
+    {
+      std::unique_lock lock(mutex_);
+      std::swap(events, queue_);
+    }
+    util::PerfCounters::instance().gauge("safesignal/depth", events.size());
+    if (coalesce_key_ && events.size() > 1) {
+      // Keep only the newest event per key, preserving the order of last occurrence.
+      std::vector<arg_tuple_t> kept;
+      std::unordered_map<size_t, size_t> index;
+      while (!events.empty()) {
+        auto key = std::apply(coalesce_key_, events.front());
+        auto it = index.find(key);
+        if (it == index.end()) {
+          index.emplace(key, kept.size());
+          kept.push_back(std::move(events.front()));
+        } else {
+          kept[it->second] = std::move(events.front());
+        }
+        events.pop();
+      }
+      for (auto& args : kept) {
+        std::apply(cached_fn_, args);
+      }
+      return;
+    }
+    while (!events.empty()) {
+      std::apply(cached_fn_, events.front());
+      events.pop();
     }
   }
 
@@ -68,6 +113,7 @@ struct SafeSignal : sigc::signal<void(std::decay_t<Args>...)> {
   std::mutex mutex_;
   std::queue<arg_tuple_t> queue_;
   const std::thread::id main_tid_ = std::this_thread::get_id();
+  std::function<size_t(const std::decay_t<Args>&...)> coalesce_key_;
   // cache functor for signal emission to avoid recreating it on each event
   const slot_t cached_fn_ = make_slot();
 };
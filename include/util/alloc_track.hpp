@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Opt-in allocation audit (meson -Dalloc_track=enabled). The build replaces
+ * the global operator new with a counting wrapper; WAYBAR_ALLOC_SCOPE spans
+ * attribute the allocations a thread makes to the currently-updating module
+ * and publish them as "alloc/<name>" gauges on util::PerfCounters, visible
+ * in the waybar/perf tooltip and `waybar ctl perf`. The goal is per-update
+ * allocation counts of zero for the core modules; this is how we check.
+ * Disabled builds compile to nothing, including at the call sites.
+ */
+
+#ifdef HAVE_ALLOC_TRACK
+
+namespace waybar::util::alloc_track {
+
+/// Allocations made by the calling thread since it started.
+uint64_t threadAllocCount();
+
+/// RAII span: on destruction, gauges the allocations made on this thread
+/// while the span was alive under "alloc/<name>".
+class Scope {
+ public:
+  explicit Scope(std::string name);
+  ~Scope();
+
+ private:
+  std::string name_;
+  uint64_t start_;
+};
+
+}  // namespace waybar::util::alloc_track
+
+#define WAYBAR_ALLOC_SCOPE(name) ::waybar::util::alloc_track::Scope waybar_alloc_scope_(name)
+
+#else
+
+#define WAYBAR_ALLOC_SCOPE(name)
+
+#endif
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <json/json.h>
+
+#include <cstdint>
+#include <string>
+
+namespace waybar::util {
+
+/// True if the strftime-style format contains a field that changes more often
+/// than once a minute.
+inline bool clock_format_has_seconds(const std::string& format) {
+  for (size_t i = 0; i + 1 < format.size(); ++i) {
+    if (format[i] != '%') {
+      continue;
+    }
+    char c = format[i + 1];
+    ++i;
+    if ((c == 'O' || c == 'E') && i + 1 < format.size()) {
+      c = format[++i];
+    }
+    switch (c) {
+      case 'S':  // seconds
+      case 'T':  // %H:%M:%S
+      case 's':  // epoch seconds
+      case 'X':  // locale time, usually with seconds
+      case 'c':  // locale date and time
+      case 'r':  // 12-hour time with seconds
+        return true;
+      default:
+        break;
+    }
+  }
+  return false;
+}
+
+/// Default tick for a clock module derived from its formats: once a minute
+/// unless some rendered field actually shows seconds. An explicit "interval"
+/// in the config still takes precedence in ALabel.
+inline uint16_t clock_default_interval(const Json::Value& config) {
+  for (const auto* key : {"format", "format-alt", "tooltip-format"}) {
+    const auto& value = config[key];
+    if (value.isString() && clock_format_has_seconds(value.asString())) {
+      return 1;
+    }
+  }
+  return 60;
+}
+
+}  // namespace waybar::util
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <giomm.h>
+#include <spawn.h>
 #include <spdlog/spdlog.h>
 #include <sys/wait.h>
 #include <unistd.h>
@@ -16,6 +17,7 @@
 
 extern std::mutex reap_mtx;
 extern std::list<pid_t> reap;
+extern char** environ;
 
 namespace waybar::util::command {
 
@@ -24,13 +26,30 @@ struct res {
   std::string out;
 };
 
-inline std::string read(FILE* fp) {
-  std::array<char, 128> buffer = {0};
+// Reads the whole output in large chunks straight from the fd; the stdio
+// buffer is untouched at this point since nothing else reads the stream.
+// `max_output` caps what a runaway script can make us buffer; the rest is
+// dropped and the child dies on SIGPIPE once the pipe is closed.
+inline std::string read(FILE* fp, size_t max_output = (1 << 20)) {
+  const int fd = fileno(fp);
+  std::array<char, 65536> buffer;
   std::string output;
-  while (feof(fp) == 0) {
-    if (fgets(buffer.data(), 128, fp) != nullptr) {
-      output += buffer.data();
+  output.reserve(std::min(buffer.size(), max_output));
+  while (output.size() < max_output) {
+    auto n = ::read(fd, buffer.data(), std::min(buffer.size(), max_output - output.size()));
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    if (n == 0) {
+      break;
     }
+    output.append(buffer.data(), n);
+  }
+  if (output.size() == max_output) {
+    spdlog::warn("Command output truncated at {} bytes", max_output);
   }
 
   // Remove last newline
@@ -49,15 +68,15 @@ inline int close(FILE* fp, pid_t pid) {
     ret = waitpid(pid, &stat, WCONTINUED | WUNTRACED);
 
     if (WIFEXITED(stat)) {
-      spdlog::debug("Cmd exited with code {}", WEXITSTATUS(stat));
+      SPDLOG_DEBUG("Cmd exited with code {}", WEXITSTATUS(stat));
     } else if (WIFSIGNALED(stat)) {
-      spdlog::debug("Cmd killed by {}", WTERMSIG(stat));
+      SPDLOG_DEBUG("Cmd killed by {}", WTERMSIG(stat));
     } else if (WIFSTOPPED(stat)) {
-      spdlog::debug("Cmd stopped by {}", WSTOPSIG(stat));
+      SPDLOG_DEBUG("Cmd stopped by {}", WSTOPSIG(stat));
     } else if (WIFCONTINUED(stat)) {
-      spdlog::debug("Cmd continued");
+      SPDLOG_DEBUG("Cmd continued");
     } else if (ret == -1) {
-      spdlog::debug("waitpid failed: {}", strerror(errno));
+      SPDLOG_DEBUG("waitpid failed: {}", strerror(errno));
     } else {
       break;
     }
@@ -65,6 +84,12 @@ inline int close(FILE* fp, pid_t pid) {
   return stat;
 }
 
+// Spawned through posix_spawn: fork() would copy the page tables of the whole
+// GTK process for every custom-module tick, which with a large RSS costs more
+// than the script itself. posix_spawn has vfork semantics on glibc, so the
+// address space is never duplicated. There is no spawn action for
+// PR_SET_PDEATHSIG, but children are either waited on promptly or write to
+// the pipe and die on SIGPIPE once the bar is gone.
 inline FILE* open(const std::string& cmd, int& pid) {
   if (cmd == "") return nullptr;
   int fd[2];
@@ -73,39 +98,38 @@ inline FILE* open(const std::string& cmd, int& pid) {
     return nullptr;
   }
 
-  pid_t child_pid = fork();
-
-  if (child_pid < 0) {
-    spdlog::error("Unable to exec cmd {}, error {}", cmd.c_str(), strerror(errno));
-    return nullptr;
-  }
-
-  if (!child_pid) {
-    int err;
-    sigset_t mask;
-    sigfillset(&mask);
-    // Reset sigmask
-    err = pthread_sigmask(SIG_UNBLOCK, &mask, nullptr);
-    if (err != 0) spdlog::error("pthread_sigmask in open failed: {}", strerror(err));
-    // Kill child if Waybar exits
-    int deathsig = SIGTERM;
-#ifdef __linux__
-    if (prctl(PR_SET_PDEATHSIG, deathsig) != 0) {
-      spdlog::error("prctl(PR_SET_PDEATHSIG) in open failed: {}", strerror(errno));
-    }
-#endif
-#ifdef __FreeBSD__
-    if (procctl(P_PID, 0, PROC_PDEATHSIG_CTL, reinterpret_cast<void*>(&deathsig)) == -1) {
-      spdlog::error("procctl(PROC_PDEATHSIG_CTL) in open failed: {}", strerror(errno));
-    }
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_adddup2(&actions, fd[1], 1);
+  posix_spawn_file_actions_addclose(&actions, fd[0]);
+  posix_spawn_file_actions_addclose(&actions, fd[1]);
+
+  posix_spawnattr_t attr;
+  posix_spawnattr_init(&attr);
+  // Reset sigmask and put the child in its own process group, like the old
+  // fork path did by hand
+  sigset_t mask;
+  sigemptyset(&mask);
+  posix_spawnattr_setsigmask(&attr, &mask);
+  posix_spawnattr_setpgroup(&attr, 0);
+  short flags = POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETPGROUP;
+#ifdef POSIX_SPAWN_USEVFORK
+  flags |= POSIX_SPAWN_USEVFORK;
 #endif
+  posix_spawnattr_setflags(&attr, flags);
+
+  const char* argv[] = {"sh", "-c", cmd.c_str(), nullptr};
+  pid_t child_pid;
+  int err =
+      posix_spawn(&child_pid, "/bin/sh", &actions, &attr, const_cast<char**>(argv), environ);
+  posix_spawn_file_actions_destroy(&actions);
+  posix_spawnattr_destroy(&attr);
+  ::close(fd[1]);
+
+  if (err != 0) {
+    spdlog::error("Unable to exec cmd {}, error {}", cmd.c_str(), strerror(err));
     ::close(fd[0]);
-    dup2(fd[1], 1);
-    setpgid(child_pid, child_pid);
-    execlp("/bin/sh", "sh", "-c", cmd.c_str(), (char*)0);
-    exit(0);
-  } else {
-    ::close(fd[1]);
+    return nullptr;
   }
   pid = child_pid;
   return fdopen(fd[0], "r");
@@ -131,30 +155,32 @@ inline struct res execNoRead(const std::string& cmd) {
 inline int32_t forkExec(const std::string& cmd) {
   if (cmd == "") return -1;
 
-  pid_t pid = fork();
+  posix_spawnattr_t attr;
+  posix_spawnattr_init(&attr);
+  sigset_t mask;
+  sigemptyset(&mask);
+  posix_spawnattr_setsigmask(&attr, &mask);
+  posix_spawnattr_setpgroup(&attr, 0);
+  short flags = POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETPGROUP;
+#ifdef POSIX_SPAWN_USEVFORK
+  flags |= POSIX_SPAWN_USEVFORK;
+#endif
+  posix_spawnattr_setflags(&attr, flags);
+
+  const char* argv[] = {"sh", "-c", cmd.c_str(), nullptr};
+  pid_t pid;
+  int err = posix_spawn(&pid, "/bin/sh", nullptr, &attr, const_cast<char**>(argv), environ);
+  posix_spawnattr_destroy(&attr);
 
-  if (pid < 0) {
-    spdlog::error("Unable to exec cmd {}, error {}", cmd.c_str(), strerror(errno));
-    return pid;
+  if (err != 0) {
+    spdlog::error("Unable to exec cmd {}, error {}", cmd.c_str(), strerror(err));
+    return -1;
   }
 
-  // Child executes the command
-  if (!pid) {
-    int err;
-    sigset_t mask;
-    sigfillset(&mask);
-    // Reset sigmask
-    err = pthread_sigmask(SIG_UNBLOCK, &mask, nullptr);
-    if (err != 0) spdlog::error("pthread_sigmask in forkExec failed: {}", strerror(err));
-    setpgid(pid, pid);
-    execl("/bin/sh", "sh", "-c", cmd.c_str(), (char*)0);
-    exit(0);
-  } else {
-    reap_mtx.lock();
-    reap.push_back(pid);
-    reap_mtx.unlock();
-    spdlog::debug("Added child to reap list: {}", pid);
-  }
+  reap_mtx.lock();
+  reap.push_back(pid);
+  reap_mtx.unlock();
+  SPDLOG_DEBUG("Added child to reap list: {}", pid);
 
   return pid;
 }
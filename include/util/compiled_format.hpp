@@ -0,0 +1,106 @@
+#pragma once
+
+#include <fmt/format.h>
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace waybar::util {
+
+/**
+ * Format template compiled once into literal and placeholder segments.
+ *
+ * Calling fmt::format with the raw config string re-parses the template and rebuilds the
+ * argument store on every tick. CompiledFormat does the parse a single time; render()
+ * walks the segments and asks a provider callback for each placeholder, writing into a
+ * reused buffer so the steady-state path does not allocate.
+ */
+class CompiledFormat {
+ public:
+  /// Appends the value for `field` to `out`; `spec` is a ready-to-use "{:...}" format string.
+  using ArgProvider =
+      std::function<void(fmt::memory_buffer& out, const std::string& field, const char* spec)>;
+
+  CompiledFormat() = default;
+  explicit CompiledFormat(const std::string& tmpl) {
+    std::string literal;
+    for (size_t i = 0; i < tmpl.size(); ++i) {
+      if (tmpl[i] == '{' && i + 1 < tmpl.size() && tmpl[i + 1] == '{') {
+        literal += '{';
+        ++i;
+      } else if (tmpl[i] == '}' && i + 1 < tmpl.size() && tmpl[i + 1] == '}') {
+        literal += '}';
+        ++i;
+      } else if (tmpl[i] == '{') {
+        auto close = tmpl.find('}', i);
+        if (close == std::string::npos) {
+          literal += tmpl.substr(i);
+          break;
+        }
+        if (!literal.empty()) {
+          segments_.push_back({std::move(literal), "", false});
+          literal.clear();
+        }
+        auto body = tmpl.substr(i + 1, close - i - 1);
+        auto colon = body.find(':');
+        Segment seg;
+        seg.placeholder = true;
+        seg.field = body.substr(0, colon);
+        seg.text = colon == std::string::npos ? "{}" : "{:" + body.substr(colon + 1) + "}";
+        segments_.push_back(std::move(seg));
+        i = close;
+      } else {
+        literal += tmpl[i];
+      }
+    }
+    if (!literal.empty()) {
+      segments_.push_back({std::move(literal), "", false});
+    }
+  }
+
+  const std::string& render(const ArgProvider& provider) const {
+    buffer_.clear();
+    for (const auto& seg : segments_) {
+      if (seg.placeholder) {
+        provider(buffer_, seg.field, seg.text.c_str());
+      } else {
+        buffer_.append(seg.text.data(), seg.text.data() + seg.text.size());
+      }
+    }
+    rendered_.assign(buffer_.data(), buffer_.size());
+    return rendered_;
+  }
+
+ private:
+  struct Segment {
+    std::string text;  // literal text, or the "{:spec}" mini-format for placeholders
+    std::string field;
+    bool placeholder = false;
+  };
+
+  std::vector<Segment> segments_;
+  mutable fmt::memory_buffer buffer_;
+  mutable std::string rendered_;
+};
+
+/**
+ * Small cache keyed by the raw template, for modules that switch between
+ * "format", "format-alt" and per-state variants at runtime.
+ */
+class FormatCache {
+ public:
+  const CompiledFormat& get(const std::string& tmpl) {
+    auto it = cache_.find(tmpl);
+    if (it == cache_.end()) {
+      it = cache_.emplace(tmpl, CompiledFormat(tmpl)).first;
+    }
+    return it->second;
+  }
+
+ private:
+  std::unordered_map<std::string, CompiledFormat> cache_;
+};
+
+}  // namespace waybar::util
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <json/json.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace waybar::util {
+
+/**
+ * Binary cache of the merged configuration tree.
+ *
+ * Parsing JSONC, resolving `include` files and merging trees costs tens of
+ * milliseconds on a large config and is pure recomputation on every start.
+ * The merged tree is stored in a compact binary form under
+ * $XDG_CACHE_HOME/waybar/, keyed by (path, mtime, size) of every source file;
+ * a warm start deserializes it in one pass and skips parse+merge entirely.
+ * Any change to any source file invalidates the cache.
+ */
+class ConfigCache {
+ public:
+  /// Cached merged tree for `main_file`, or nullopt when stale or absent.
+  /// When `sources` is given it receives the file list the tree was built
+  /// from, so callers can watch them without re-parsing.
+  static std::optional<Json::Value> load(const std::string& main_file,
+                                         std::vector<std::string>* sources = nullptr);
+  /// Store the merged tree; `sources` lists every file it was built from,
+  /// main config first. Failures are logged and non-fatal.
+  static void store(const std::string& main_file, const std::vector<std::string>& sources,
+                    const Json::Value& config);
+
+ private:
+  static std::string cachePath(const std::string& main_file);
+};
+
+}  // namespace waybar::util
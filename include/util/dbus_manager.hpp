@@ -0,0 +1,44 @@
+#pragma once
+
+#include <giomm/dbusconnection.h>
+#include <giomm/dbusproxy.h>
+
+#include <map>
+#include <mutex>
+
+namespace waybar::util {
+
+/**
+ * Process-wide DBus access point. GIO shares one connection per bus type
+ * internally, but every module used to fetch it again with a synchronous
+ * round-trip and build its own proxies, repeating the GetAll/introspection
+ * chatter during startup. Connections are fetched once and proxies are
+ * memoized by (bus, name, path, interface); a shared proxy keeps its
+ * property cache warm for every consumer.
+ */
+class DBusManager {
+ public:
+  static DBusManager& instance();
+
+  /// The shared connection for `type`, or an empty RefPtr if the bus is
+  /// unreachable. Never close it: other modules hold the same object.
+  Glib::RefPtr<Gio::DBus::Connection> connection(Gio::DBus::BusType type);
+
+  /// C-API view of the same connection, borrowed: do not unref or close.
+  GDBusConnection* raw(Gio::DBus::BusType type);
+
+  /// Memoized proxy: callers asking for the same tuple share one instance
+  /// and its cached properties instead of re-introspecting the service.
+  Glib::RefPtr<Gio::DBus::Proxy> proxy(Gio::DBus::BusType type, const Glib::ustring& name,
+                                       const Glib::ustring& object_path,
+                                       const Glib::ustring& interface_name);
+
+ private:
+  DBusManager() = default;
+
+  std::mutex mutex_;
+  std::map<int, Glib::RefPtr<Gio::DBus::Connection>> connections_;
+  std::map<std::string, Glib::RefPtr<Gio::DBus::Proxy>> proxies_;
+};
+
+}  // namespace waybar::util
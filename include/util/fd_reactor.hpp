@@ -0,0 +1,56 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace waybar::util {
+
+/**
+ * Shared epoll reactor for modules watching file descriptors.
+ *
+ * Battery (inotify), Backlight (udev) and friends only need to block on a single fd;
+ * funnelling them through one epoll instance replaces N dedicated watcher threads with a
+ * single one. Callbacks run on the reactor thread and are expected to drain the fd and
+ * hand results to the GTK thread via SafeSignal or the module dispatcher.
+ */
+class FdReactor {
+ public:
+  using Callback = std::function<void(uint32_t revents)>;
+
+  static FdReactor& instance();
+
+  FdReactor(const FdReactor&) = delete;
+  FdReactor& operator=(const FdReactor&) = delete;
+
+  /// Watch `fd` for `events` (EPOLL* flags). The fd stays owned by the caller.
+  void add(int fd, uint32_t events, Callback callback);
+  /// Stop watching `fd`; blocks until its callback finished unless called from within one.
+  void remove(int fd);
+  /// True when the caller is the reactor thread; services layered on top of the
+  /// reactor need this for the same "don't wait on yourself" check remove() does.
+  bool onReactorThread() const { return std::this_thread::get_id() == thread_.get_id(); }
+
+ private:
+  struct Handler {
+    Callback callback;
+    bool running = false;
+  };
+
+  FdReactor();
+  ~FdReactor();
+  void run();
+
+  int epoll_fd_ = -1;
+  int wake_fd_ = -1;
+  std::mutex mutex_;
+  std::condition_variable idle_condvar_;
+  std::unordered_map<int, std::shared_ptr<Handler>> handlers_;
+  std::thread thread_;
+};
+
+}  // namespace waybar::util
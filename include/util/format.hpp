@@ -3,13 +3,16 @@
 #include <fmt/format.h>
 #include <glibmm/ustring.h>
 
+#include <string_view>
+
 class pow_format {
  public:
-  pow_format(long long val, std::string&& unit, bool binary = false)
+  // The unit is referenced, not copied; call sites pass string literals.
+  pow_format(long long val, std::string_view unit, bool binary = false)
       : val_(val), unit_(unit), binary_(binary){};
 
   long long val_;
-  std::string unit_;
+  std::string_view unit_;
   bool binary_;
 };
 
@@ -46,14 +49,35 @@ struct formatter<pow_format> {
 
   template <class FormatContext>
   auto format(const pow_format& s, FormatContext& ctx) -> decltype(ctx.out()) {
-    const char* units[] = {"", "k", "M", "G", "T", "P", nullptr};
+    // Precomputed magnitude ladders (base^1..base^5); picking the prefix is
+    // then pure comparisons with a single division at the end, instead of a
+    // divide-per-step loop.
+    static constexpr char units[] = {0, 'k', 'M', 'G', 'T', 'P'};
+    static constexpr unsigned long long decimal[] = {1000ull, 1000000ull, 1000000000ull,
+                                                     1000000000000ull, 1000000000000000ull};
+    static constexpr unsigned long long binary[] = {1024ull, 1048576ull, 1073741824ull,
+                                                    1099511627776ull, 1125899906842624ull};
+    constexpr int max_pow = 5;
 
-    auto base = s.binary_ ? 1024ull : 1000ll;
-    auto fraction = (double)s.val_;
+    const auto* ladder = s.binary_ ? binary : decimal;
+    int pow = 0;
+    if (s.val_ > 0) {
+      auto v = static_cast<unsigned long long>(s.val_);
+      while (pow < max_pow && v >= ladder[pow]) {
+        ++pow;
+      }
+    }
+    auto fraction = static_cast<double>(s.val_);
+    if (pow > 0) {
+      fraction /= static_cast<double>(ladder[pow - 1]);
+    }
 
-    int pow;
-    for (pow = 0; units[pow + 1] != nullptr && fraction / base >= 1; ++pow) {
-      fraction /= base;
+    char prefix[3] = {0, 0, 0};
+    if (pow > 0) {
+      prefix[0] = units[pow];
+      if (s.binary_) {
+        prefix[1] = 'i';
+      }
     }
 
     auto max_width = 4            // coeff in {:.3g} format
@@ -61,28 +85,27 @@ struct formatter<pow_format> {
                      + s.binary_  // for the 'i' in GiB.
                      + s.unit_.length();
 
-    const char* format;
-    std::string string;
     switch (spec) {
       case '>':
-        return format_to(ctx.out(), "{:>{}}", fmt::format("{}", s), max_width);
-      case '<':
-        return format_to(ctx.out(), "{:<{}}", fmt::format("{}", s), max_width);
+      case '<': {
+        // Render the plain form into stack storage, then pad it; no
+        // intermediate std::string.
+        basic_memory_buffer<char, 32> buf;
+        format_to(std::back_inserter(buf), "{:.3g}{}{}", fraction, prefix, s.unit_);
+        auto plain = string_view(buf.data(), buf.size());
+        return spec == '>' ? format_to(ctx.out(), "{:>{}}", plain, max_width)
+                           : format_to(ctx.out(), "{:<{}}", plain, max_width);
+      }
       case '=':
-        format = "{coefficient:<4.3g}{padding}{prefix}{unit}";
-        break;
+        return format_to(ctx.out(), "{:<4.3g}{}{}{}", fraction,
+                         pow != 0    ? ""
+                         : s.binary_ ? "  "
+                                     : " ",
+                         prefix, s.unit_);
       case 0:
       default:
-        format = "{coefficient:.3g}{prefix}{unit}";
-        break;
+        return format_to(ctx.out(), "{:.3g}{}{}", fraction, prefix, s.unit_);
     }
-    return format_to(
-        ctx.out(), format, fmt::arg("coefficient", fraction),
-        fmt::arg("prefix", std::string() + units[pow] + ((s.binary_ && pow) ? "i" : "")),
-        fmt::arg("unit", s.unit_),
-        fmt::arg("padding", pow         ? ""
-                            : s.binary_ ? "  "
-                                        : " "));
   }
 };
 
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cairomm/surface.h>
+#include <gtkmm/icontheme.h>
+
+#include <functional>
+#include <list>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+namespace waybar::util {
+
+/**
+ * Process-wide LRU cache for resolved icon pixbufs.
+ *
+ * The taskbar and the tray both resolve icon names through Gtk::IconTheme and
+ * decode the result independently, once per window/item and per bar instance.
+ * Icon decode dominates startup with a populated taskbar, so lookups are
+ * memoized here keyed on (theme, name, size). Entries are dropped when the
+ * originating theme emits changed (theme or icon install/uninstall).
+ *
+ * Main-thread only, like all Gtk::IconTheme access.
+ */
+class IconCache {
+ public:
+  using Loader = std::function<Glib::RefPtr<Gdk::Pixbuf>()>;
+
+  static IconCache& instance();
+
+  /// Cached pixbuf for (theme, name, size); on a miss `loader` resolves it.
+  /// Failed loads (empty refs) are cached too, until the theme changes.
+  Glib::RefPtr<Gdk::Pixbuf> get(const Glib::RefPtr<Gtk::IconTheme>& theme, const std::string& name,
+                                int size, const Loader& loader);
+
+  /// Same, for icons loaded straight from an image file path.
+  Glib::RefPtr<Gdk::Pixbuf> getFile(const std::string& path, int size, const Loader& loader);
+
+  /// Immutable cairo surface for a cached pixbuf at the given device scale,
+  /// converted once and shared by reference: ten windows of the same app set
+  /// the same surface on their images instead of converting (and uploading)
+  /// the pixel data ten times. The cache holds a pixbuf ref, so the surface
+  /// never outlives its source bytes.
+  Cairo::RefPtr<Cairo::Surface> surface(const Glib::RefPtr<Gdk::Pixbuf>& pixbuf, int scale);
+
+ private:
+  static constexpr size_t MAX_ENTRIES = 128;
+
+  struct Key {
+    const void* theme;  // theme gobj, nullptr for file loads
+    std::string name;
+    int size;
+
+    bool operator==(const Key& o) const {
+      return theme == o.theme && size == o.size && name == o.name;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& k) const {
+      return std::hash<std::string>{}(k.name) ^ std::hash<const void*>{}(k.theme) ^
+             std::hash<int>{}(k.size);
+    }
+  };
+
+  IconCache() = default;
+
+  Glib::RefPtr<Gdk::Pixbuf> lookup(Key key, const Loader& loader);
+  void watchTheme(const Glib::RefPtr<Gtk::IconTheme>& theme);
+  void invalidateTheme(const void* theme);
+
+  using Entry = std::pair<Key, Glib::RefPtr<Gdk::Pixbuf>>;
+  std::list<Entry> lru_;
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> entries_;
+  std::set<const void*> watched_themes_;
+
+  struct SurfaceKey {
+    const void* pixbuf;  // pixbuf gobj; the entry keeps a ref, so it stays valid
+    int scale;
+
+    bool operator==(const SurfaceKey& o) const { return pixbuf == o.pixbuf && scale == o.scale; }
+  };
+
+  struct SurfaceKeyHash {
+    size_t operator()(const SurfaceKey& k) const {
+      return std::hash<const void*>{}(k.pixbuf) ^ std::hash<int>{}(k.scale);
+    }
+  };
+
+  struct SurfaceEntry {
+    SurfaceKey key;
+    Glib::RefPtr<Gdk::Pixbuf> pixbuf;
+    Cairo::RefPtr<Cairo::Surface> surface;
+  };
+  std::list<SurfaceEntry> surface_lru_;
+  std::unordered_map<SurfaceKey, std::list<SurfaceEntry>::iterator, SurfaceKeyHash> surfaces_;
+};
+
+}  // namespace waybar::util
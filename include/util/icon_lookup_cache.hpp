@@ -0,0 +1,50 @@
+#pragma once
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace waybar::util {
+
+/**
+ * Persistent lookup cache for resolved desktop-entry and icon paths.
+ *
+ * Resolving an app_id means probing dozens of candidate desktop-file paths and
+ * walking icon theme directories; the answers barely ever change between
+ * sessions, yet every start pays the full scan again. Results are kept in
+ * $XDG_CACHE_HOME/waybar/icons.cache (one tab-separated entry per line) and
+ * validated against the resolved file's mtime on lookup, so a changed or
+ * removed desktop file simply falls back to the scan.
+ */
+class IconLookupCache {
+ public:
+  static IconLookupCache& instance();
+
+  /// Resolved path for `key` if still valid on disk.
+  std::optional<std::string> lookup(const std::string& key);
+
+  /// Record `key` -> `path`; flushed to disk periodically and on exit.
+  void store(const std::string& key, const std::string& path);
+
+ private:
+  // flush after this many new entries so a crash doesn't lose a whole session
+  static constexpr int FLUSH_THRESHOLD = 16;
+
+  IconLookupCache();
+  ~IconLookupCache();
+
+  static std::string cachePath();
+  void save();
+
+  struct Entry {
+    std::string path;
+    int64_t mtime;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+  int unsaved_ = 0;
+};
+
+}  // namespace waybar::util
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <functional>
+#include <map>
+
+struct wl_surface;
+struct zwp_idle_inhibitor_v1;
+
+namespace waybar::util {
+
+/**
+ * One logical idle-inhibition state for the whole process. The compositor
+ * only needs a single inhibitor object to keep the session awake, so the
+ * manager owns exactly one, backed by the surface of any live subscriber,
+ * and fans out state changes to the per-bar widgets. Main-thread only, like
+ * the widgets it serves.
+ */
+class IdleInhibitManager {
+ public:
+  static IdleInhibitManager& instance();
+
+  /// Register a widget: `surface` may back the protocol inhibitor and
+  /// `on_change` fires whenever the logical state flips.
+  int subscribe(struct wl_surface* surface, std::function<void()> on_change);
+  void unsubscribe(int id);
+
+  bool active() const { return active_; }
+  void toggle() { set(!active_); }
+  void set(bool active);
+
+ private:
+  IdleInhibitManager() = default;
+
+  /// Create or destroy the single protocol object to match active_.
+  void sync();
+
+  struct Subscriber {
+    struct wl_surface* surface;
+    std::function<void()> on_change;
+  };
+
+  std::map<int, Subscriber> subscribers_;
+  int next_id_ = 1;
+  bool active_ = false;
+  struct zwp_idle_inhibitor_v1* inhibitor_ = nullptr;
+  struct wl_surface* inhibitor_surface_ = nullptr;
+};
+
+}  // namespace waybar::util
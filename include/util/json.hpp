@@ -2,27 +2,33 @@
 
 #include <json/json.h>
 
+#include <memory>
+
 namespace waybar::util {
 
 struct JsonParser {
-  JsonParser() {}
+  JsonParser() : reader_(Json::CharReaderBuilder().newCharReader()) {}
 
-  const Json::Value parse(const std::string& data) const {
+  // Reuses one CharReader across parses: newCharReader() copies the builder's
+  // whole settings map, which dominated the malloc profile of steady-state
+  // sway event handling. A parser instance is therefore stateful — callers
+  // already own one per module, keep it that way.
+  Json::Value parse(const std::string& data) {
     Json::Value root(Json::objectValue);
     if (data.empty()) {
       return root;
     }
-    std::unique_ptr<Json::CharReader> const reader(builder_.newCharReader());
-    std::string err;
-    bool res = reader->parse(data.c_str(), data.c_str() + data.size(), &root, &err);
-    if (!res) throw std::runtime_error(err);
+    err_.clear();
+    bool res = reader_->parse(data.c_str(), data.c_str() + data.size(), &root, &err_);
+    if (!res) throw std::runtime_error(err_);
     return root;
   }
 
   ~JsonParser() = default;
 
  private:
-  Json::CharReaderBuilder builder_;
+  std::unique_ptr<Json::CharReader> reader_;
+  std::string err_;
 };
 
 }  // namespace waybar::util
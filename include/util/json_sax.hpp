@@ -0,0 +1,240 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace waybar::util {
+
+/**
+ * Minimal pull-style JSON cursor for payloads too large to materialize as a
+ * Json::Value DOM. The caller drives the traversal (objects, arrays, scalars)
+ * and skips whole subtrees it does not care about; nothing is allocated beyond
+ * the few strings the caller actually extracts.
+ *
+ * This is not a validating parser — on malformed input it throws
+ * std::runtime_error and callers are expected to fall back to util::JsonParser.
+ */
+class JsonCursor {
+ public:
+  explicit JsonCursor(std::string_view data) : p_(data.data()), end_(data.data() + data.size()) {}
+
+  char peek() {
+    skipWs();
+    if (p_ == end_) {
+      throw std::runtime_error("Unexpected end of JSON input");
+    }
+    return *p_;
+  }
+
+  void expect(char c) {
+    if (peek() != c) {
+      throw std::runtime_error(std::string("Expected '") + c + "' in JSON input");
+    }
+    ++p_;
+  }
+
+  bool tryConsume(char c) {
+    if (p_ != end_ && peek() == c) {
+      ++p_;
+      return true;
+    }
+    return false;
+  }
+
+  std::string parseString() {
+    expect('"');
+    std::string out;
+    while (p_ != end_ && *p_ != '"') {
+      if (*p_ == '\\') {
+        if (++p_ == end_) {
+          break;
+        }
+        switch (*p_) {
+          case 'b':
+            out += '\b';
+            break;
+          case 'f':
+            out += '\f';
+            break;
+          case 'n':
+            out += '\n';
+            break;
+          case 'r':
+            out += '\r';
+            break;
+          case 't':
+            out += '\t';
+            break;
+          case 'u':
+            appendCodepoint(out);
+            break;
+          default:
+            out += *p_;
+            break;
+        }
+        ++p_;
+      } else {
+        out += *p_++;
+      }
+    }
+    expect('"');
+    return out;
+  }
+
+  bool parseBool() {
+    if (peek() == 't') {
+      consumeLiteral("true");
+      return true;
+    }
+    consumeLiteral("false");
+    return false;
+  }
+
+  int64_t parseInt() {
+    skipWs();
+    bool negative = tryConsume('-');
+    int64_t value = 0;
+    while (p_ != end_ && *p_ >= '0' && *p_ <= '9') {
+      value = value * 10 + (*p_++ - '0');
+    }
+    // integral part is all callers need; drop any fraction/exponent
+    while (p_ != end_ && (*p_ == '.' || *p_ == 'e' || *p_ == 'E' || *p_ == '+' || *p_ == '-' ||
+                          (*p_ >= '0' && *p_ <= '9'))) {
+      ++p_;
+    }
+    return negative ? -value : value;
+  }
+
+  /// Skip any value, including nested containers.
+  void skipValue() {
+    switch (peek()) {
+      case '{':
+      case '[': {
+        size_t depth = 0;
+        do {
+          char c = *p_++;
+          if (c == '{' || c == '[') {
+            ++depth;
+          } else if (c == '}' || c == ']') {
+            --depth;
+          } else if (c == '"') {
+            --p_;
+            skipString();
+          }
+          if (p_ == end_ && depth != 0) {
+            throw std::runtime_error("Unexpected end of JSON input");
+          }
+        } while (depth != 0);
+        break;
+      }
+      case '"':
+        skipString();
+        break;
+      case 't':
+        consumeLiteral("true");
+        break;
+      case 'f':
+        consumeLiteral("false");
+        break;
+      case 'n':
+        consumeLiteral("null");
+        break;
+      default:
+        parseInt();
+        break;
+    }
+  }
+
+ private:
+  void skipWs() {
+    while (p_ != end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) {
+      ++p_;
+    }
+  }
+
+  void skipString() {
+    expect('"');
+    while (p_ != end_ && *p_ != '"') {
+      if (*p_ == '\\' && p_ + 1 != end_) {
+        ++p_;
+      }
+      ++p_;
+    }
+    expect('"');
+  }
+
+  void consumeLiteral(const char* literal) {
+    skipWs();
+    for (const char* l = literal; *l != '\0'; ++l) {
+      if (p_ == end_ || *p_++ != *l) {
+        throw std::runtime_error(std::string("Expected '") + literal + "' in JSON input");
+      }
+    }
+  }
+
+  void appendCodepoint(std::string& out) {
+    // p_ points at 'u'; four hex digits follow
+    if (end_ - p_ < 5) {
+      throw std::runtime_error("Truncated \\u escape in JSON input");
+    }
+    uint32_t cp = 0;
+    for (int i = 1; i <= 4; ++i) {
+      char c = p_[i];
+      cp <<= 4;
+      if (c >= '0' && c <= '9') {
+        cp |= c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        cp |= c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        cp |= c - 'A' + 10;
+      } else {
+        throw std::runtime_error("Invalid \\u escape in JSON input");
+      }
+    }
+    p_ += 4;
+    // surrogate pair
+    if (cp >= 0xD800 && cp <= 0xDBFF && end_ - p_ >= 7 && p_[1] == '\\' && p_[2] == 'u') {
+      uint32_t lo = 0;
+      for (int i = 3; i <= 6; ++i) {
+        char c = p_[i];
+        lo <<= 4;
+        if (c >= '0' && c <= '9') {
+          lo |= c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+          lo |= c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+          lo |= c - 'A' + 10;
+        } else {
+          lo = ~0U;
+          break;
+        }
+      }
+      if (lo >= 0xDC00 && lo <= 0xDFFF) {
+        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+        p_ += 6;
+      }
+    }
+    if (cp < 0x80) {
+      out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+      out += static_cast<char>(0xC0 | (cp >> 6));
+      out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+      out += static_cast<char>(0xE0 | (cp >> 12));
+      out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+      out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+      out += static_cast<char>(0xF0 | (cp >> 18));
+      out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+      out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+      out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+  }
+
+  const char* p_;
+  const char* end_;
+};
+
+}  // namespace waybar::util
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <memory>
+#include <regex>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "util/pollable_file.hpp"
+
+namespace waybar::util {
+
+/**
+ * Tiny in-process expression language for custom modules that would otherwise
+ * fork a shell just to cat a file or do arithmetic on a sysfs value.
+ *
+ * Grammar:
+ *   expr   := term (('+' | '-') term)*
+ *   term   := unary (('*' | '/' | '%') unary)*
+ *   unary  := '-' unary | primary
+ *   primary:= NUMBER | 'single or double quoted string' | call | '(' expr ')'
+ *   call   := IDENT '(' expr (',' expr)* ')'
+ *
+ * Functions:
+ *   file("path")                  contents of the file, trailing whitespace trimmed
+ *   regex(input, "pattern")      first capture group (or whole match) of the first hit
+ *   num(x)                       force numeric interpretation
+ *   format("fmt", args...)       fmt-style formatting, {} placeholders
+ *
+ * The expression is parsed once; literal file paths keep a cached fd and
+ * literal patterns a precompiled regex, so steady-state evaluation does not
+ * allocate or open anything.
+ */
+class NativeExpr {
+ public:
+  /// Parses `source`; throws std::runtime_error with a position on bad syntax.
+  explicit NativeExpr(const std::string& source);
+  ~NativeExpr();
+
+  NativeExpr(const NativeExpr&) = delete;
+  NativeExpr& operator=(const NativeExpr&) = delete;
+
+  /// Evaluates the expression; throws std::runtime_error on type/regex errors.
+  std::string eval();
+
+ private:
+  using Value = std::variant<double, std::string>;
+
+  struct Node {
+    enum class Kind { Number, String, BinOp, Call };
+    Kind kind;
+    double number = 0;
+    std::string text;  // literal value, or function name for Call
+    char op = 0;
+    std::vector<Node> args;
+    // static resources resolved at parse time for literal arguments
+    std::shared_ptr<PollableFile> file;
+    std::shared_ptr<std::regex> pattern;
+  };
+
+  struct Parser;
+
+  static Value evalNode(Node& node);
+  static double toNumber(const Value& value);
+  static std::string toString(const Value& value);
+
+  Node root_;
+};
+
+}  // namespace waybar::util
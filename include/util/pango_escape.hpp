@@ -0,0 +1,83 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace waybar::util {
+
+/// True if `text` contains anything Pango markup needs escaped.
+inline bool needs_pango_escape(std::string_view text) {
+  for (char c : text) {
+    if (c == '&' || c == '<' || c == '>' || c == '\'' || c == '"' ||
+        (static_cast<unsigned char>(c) < 0x20 && c != '\t' && c != '\n' && c != '\r')) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Drop-in for Glib::Markup::escape_text on hot paths. Window titles and tags
+ * rarely contain markup characters, so the common case is a single scan and a
+ * plain copy with no transformation pass or UTF-8 revalidation.
+ */
+inline std::string pango_escape(std::string_view text) {
+  if (!needs_pango_escape(text)) {
+    return std::string(text);
+  }
+  std::string out;
+  out.reserve(text.size() + 8);
+  for (char c : text) {
+    switch (c) {
+      case '&':
+        out += "&amp;";
+        break;
+      case '<':
+        out += "&lt;";
+        break;
+      case '>':
+        out += "&gt;";
+        break;
+      case '\'':
+        out += "&apos;";
+        break;
+      case '"':
+        out += "&quot;";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20 && c != '\t' && c != '\n' && c != '\r') {
+          out += "&#x";
+          constexpr char hex[] = "0123456789abcdef";
+          out += hex[(c >> 4) & 0xF];
+          out += hex[c & 0xF];
+          out += ';';
+        } else {
+          out += c;
+        }
+        break;
+    }
+  }
+  return out;
+}
+
+/**
+ * Per-call-site memo for values that repeat between updates (the focused
+ * window title, an MPD tag): escaping the same input again returns the cached
+ * result without rescanning.
+ */
+class PangoEscapeCache {
+ public:
+  const std::string& escape(std::string_view text) {
+    if (text != last_input_) {
+      last_input_ = text;
+      last_output_ = pango_escape(text);
+    }
+    return last_output_;
+  }
+
+ private:
+  std::string last_input_;
+  std::string last_output_;
+};
+
+}  // namespace waybar::util
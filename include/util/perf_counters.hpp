@@ -0,0 +1,80 @@
+#pragma once
+
+#include <json/json.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace waybar::util {
+
+/**
+ * In-process performance counters answering "which module is making the bar
+ * slow" without attaching a profiler to a user's session.
+ *
+ * Durations land in fixed log2 microsecond histograms keyed by name
+ * ("update/cpu", "worker/tick"), cheap enough to stay always-on; gauges track
+ * high-water marks such as the SafeSignal queue depth. The waybar/perf module
+ * renders a compact summary and `waybar ctl perf` dumps everything as JSON.
+ */
+class PerfCounters {
+ public:
+  static PerfCounters& instance();
+
+  void record(const std::string& key, std::chrono::nanoseconds duration);
+  /// Track a sampled value; the dump reports the last and the maximum seen.
+  void gauge(const std::string& key, uint64_t value);
+
+  /// Condensed view for the perf module label.
+  struct Snapshot {
+    std::string worst;      // key with the highest p99, minus the "update/" prefix
+    uint64_t worst_p99_us = 0;
+    uint64_t updates = 0;   // total update/* invocations
+    double rate = 0.0;      // update/* invocations per second since start
+  };
+  Snapshot snapshot() const;
+  Json::Value toJson() const;
+
+  /// RAII timer: records the scope's lifetime under `key`.
+  class Scope {
+   public:
+    Scope(std::string key) : key_(std::move(key)), start_(std::chrono::steady_clock::now()) {}
+    ~Scope() { instance().record(key_, std::chrono::steady_clock::now() - start_); }
+
+   private:
+    std::string key_;
+    std::chrono::steady_clock::time_point start_;
+  };
+
+ private:
+  PerfCounters() : started_(std::chrono::steady_clock::now()) {}
+
+  // bucket i covers [2^i, 2^(i+1)) microseconds; the last one is a catch-all
+  static constexpr size_t kBuckets = 26;
+
+  struct Histogram {
+    std::array<uint32_t, kBuckets> buckets{};
+    uint64_t count = 0;
+    uint64_t total_ns = 0;
+    uint64_t max_ns = 0;
+
+    void add(std::chrono::nanoseconds duration);
+    /// Upper bound (µs) of the bucket holding the q-th quantile.
+    uint64_t percentile_us(double q) const;
+  };
+
+  struct Gauge {
+    uint64_t last = 0;
+    uint64_t max = 0;
+  };
+
+  mutable std::mutex mutex_;
+  std::map<std::string, Histogram> histograms_;
+  std::map<std::string, Gauge> gauges_;
+  const std::chrono::steady_clock::time_point started_;
+};
+
+}  // namespace waybar::util
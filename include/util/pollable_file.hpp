@@ -0,0 +1,80 @@
+#pragma once
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace waybar::util {
+
+/**
+ * Cached-fd reader for sysfs/procfs files polled every interval.
+ *
+ * A fresh std::ifstream per tick pays path resolution, fd allocation and stream buffer
+ * construction each time. PollableFile opens the path once and re-reads it with pread()
+ * from offset 0 into a reused buffer, which is all procfs needs.
+ */
+class PollableFile {
+ public:
+  explicit PollableFile(std::string path) : path_(std::move(path)) {}
+  ~PollableFile() {
+    if (fd_ != -1) {
+      close(fd_);
+    }
+  }
+
+  PollableFile(const PollableFile&) = delete;
+  PollableFile& operator=(const PollableFile&) = delete;
+
+  /// Full contents of the file, or an empty view on error. The view is valid until the
+  /// next read() call.
+  std::string_view read() {
+    if (fd_ == -1) {
+      fd_ = open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd_ == -1) {
+        return {};
+      }
+    }
+    size_t total = 0;
+    for (;;) {
+      if (total == buf_.size()) {
+        buf_.resize(buf_.empty() ? 4096 : buf_.size() * 2);
+      }
+      auto n = pread(fd_, buf_.data() + total, buf_.size() - total, total);
+      if (n < 0) {
+        // procfs reads shouldn't fail once open; reopen on the next tick just in case
+        close(fd_);
+        fd_ = -1;
+        return {};
+      }
+      if (n == 0) {
+        break;
+      }
+      total += n;
+    }
+    return {buf_.data(), total};
+  }
+
+ private:
+  std::string path_;
+  int fd_ = -1;
+  std::vector<char> buf_;
+};
+
+/// Parse an unsigned decimal at `p`, advancing it past the digits.
+inline uint64_t parseUnsigned(const char*& p, const char* end) {
+  while (p != end && (*p == ' ' || *p == '\t')) {
+    ++p;
+  }
+  uint64_t value = 0;
+  while (p != end && *p >= '0' && *p <= '9') {
+    value = value * 10 + (*p - '0');
+    ++p;
+  }
+  return value;
+}
+
+}  // namespace waybar::util
@@ -0,0 +1,14 @@
+#pragma once
+
+namespace waybar::util {
+
+/**
+ * Fire-and-forget readahead of the files a cold start is about to block on:
+ * the config and its includes, style.css, the icon theme indexes under the
+ * XDG data dirs and tzdata. Runs on a detached worker issuing
+ * posix_fadvise(WILLNEED), so the disk reads overlap GTK initialization
+ * instead of serializing behind it.
+ */
+void prefetchStartupFiles();
+
+}  // namespace waybar::util
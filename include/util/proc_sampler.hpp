@@ -0,0 +1,46 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "util/pollable_file.hpp"
+
+namespace waybar::util {
+
+/**
+ * Shared single-pass /proc sampler.
+ *
+ * With cpu, memory and the network fallback enabled — times the number of bars on a
+ * multi-head setup — the same /proc files get read and parsed once per consumer per
+ * period. The sampler performs one batched sweep and hands out an immutable snapshot;
+ * consumers sampling within the freshness window share the result.
+ */
+class ProcSampler {
+ public:
+  struct Snapshot {
+    std::string stat;
+    std::string meminfo;
+    std::string netdev;
+    std::chrono::steady_clock::time_point taken;
+  };
+
+  static ProcSampler& instance();
+
+  /// Latest snapshot, re-swept when older than `max_age`. The default covers the
+  /// common 1s polling cadence with room for scheduler stagger.
+  std::shared_ptr<const Snapshot> sample(
+      std::chrono::milliseconds max_age = std::chrono::milliseconds(500));
+
+ private:
+  ProcSampler() = default;
+
+  std::mutex mutex_;
+  PollableFile stat_{"/proc/stat"};
+  PollableFile meminfo_{"/proc/meminfo"};
+  PollableFile netdev_{"/proc/net/dev"};
+  std::shared_ptr<const Snapshot> last_;
+};
+
+}  // namespace waybar::util
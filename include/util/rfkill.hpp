@@ -5,8 +5,35 @@
 #include <sigc++/signal.h>
 #include <sigc++/trackable.h>
 
+#include <array>
+
 namespace waybar::util {
 
+/**
+ * Shared watcher for /dev/rfkill: one fd and one IO source for the whole
+ * process, with per-type signals fanned out to subscribers. Network and
+ * bluetooth (and anything else interested in a kill switch) attach through
+ * the Rfkill facade below instead of each holding their own reader.
+ */
+class RfkillManager : public sigc::trackable {
+ public:
+  static RfkillManager& instance();
+
+  bool getState(enum rfkill_type type) const;
+  sigc::signal<void(struct rfkill_event&)>& onUpdate(enum rfkill_type type);
+
+ private:
+  RfkillManager();
+  ~RfkillManager();
+
+  bool on_event(Glib::IOCondition cond);
+
+  int fd_ = -1;
+  std::array<bool, NUM_RFKILL_TYPES> states_{};
+  std::array<sigc::signal<void(struct rfkill_event&)>, NUM_RFKILL_TYPES> signals_;
+};
+
+/// Per-module handle on the shared watcher, keeping the original interface.
 class Rfkill : public sigc::trackable {
  public:
   Rfkill(enum rfkill_type rfkill_type);
@@ -17,10 +44,7 @@ class Rfkill : public sigc::trackable {
 
  private:
   enum rfkill_type rfkill_type_;
-  bool state_ = false;
-  int fd_ = -1;
-
-  bool on_event(Glib::IOCondition cond);
+  sigc::connection connection_;
 };
 
 }  // namespace waybar::util
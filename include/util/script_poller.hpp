@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "util/command.hpp"
+#include "util/sleeper_thread.hpp"
+
+namespace waybar::util {
+
+/**
+ * One polling loop per distinct script configuration, shared across bars.
+ *
+ * Every Bar builds its own module set, so a custom module on a three-monitor
+ * setup used to spawn the same script three times per tick. Pollers are keyed
+ * by (exec, exec-if, interval): bars with an identical config share one
+ * execution and fan the result out to their widgets, making script cost O(1)
+ * in the number of outputs.
+ */
+class ScriptPoller {
+ public:
+  using Callback = std::function<void(const command::res&)>;
+  using Subscription = uint64_t;
+
+  /// Shared poller for the given script; creates one on first use. A non-zero
+  /// `exec_if_ttl` caches the exec-if verdict for that long independent of the
+  /// interval: while a cached failure is fresh, a tick spawns nothing at all.
+  /// An exec-if exit code N > 1 stretches its own failure TTL to N times the
+  /// configured one, so scripts can request longer backoff themselves.
+  static std::shared_ptr<ScriptPoller> acquire(const std::string& exec, const std::string& exec_if,
+                                               std::chrono::seconds interval,
+                                               std::chrono::seconds exec_if_ttl);
+
+  ScriptPoller(std::string exec, std::string exec_if, std::chrono::seconds interval,
+               std::chrono::seconds exec_if_ttl);
+  ~ScriptPoller() = default;
+
+  ScriptPoller(const ScriptPoller&) = delete;
+  ScriptPoller& operator=(const ScriptPoller&) = delete;
+
+  /// Register a consumer. The callback runs on the polling thread and must be
+  /// cheap (copy the result, dispatch to the main loop); it is invoked right
+  /// away with the last output when one exists, so a bar appearing on a new
+  /// output paints without waiting a full interval.
+  Subscription subscribe(Callback cb);
+  /// Blocks until the callback can no longer be invoked.
+  void unsubscribe(Subscription id);
+
+  /// Re-run the script now (signal refresh, exec-on-event clicks); also
+  /// drops a cached exec-if verdict, an explicit poke should see fresh state.
+  void wakeUp();
+  /// Park the loop for this subscriber; execution stops only once every
+  /// subscriber is suspended, since other outputs may still be visible.
+  void setSuspended(Subscription id, bool suspended);
+
+ private:
+  struct Subscriber {
+    Callback callback;
+    bool suspended = false;
+  };
+
+  void tick();
+
+  const std::string exec_;
+  const std::string exec_if_;
+  const std::chrono::seconds interval_;
+  const std::chrono::seconds exec_if_ttl_;
+
+  // exec-if verdict cache; only the polling thread reads or writes the
+  // deadline, wakeUp() invalidates through the atomic flag
+  bool verdict_ok_ = false;
+  std::chrono::steady_clock::time_point verdict_expires_{};
+  std::atomic<bool> verdict_dirty_{true};
+
+  std::mutex mutex_;
+  std::map<Subscription, Subscriber> subscribers_;
+  Subscription next_id_ = 1;
+  bool has_output_ = false;
+  command::res last_;
+  SleeperThread thread_;
+};
+
+}  // namespace waybar::util
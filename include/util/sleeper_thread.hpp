@@ -1,55 +1,47 @@
 #pragma once
 
+#include <sys/eventfd.h>
+#include <unistd.h>
+
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <ctime>
 #include <functional>
+#include <set>
 #include <thread>
 
-namespace waybar::util {
-
-/**
- * Defer pthread_cancel until the end of a current scope.
- *
- * Required to protect a scope where it's unsafe to raise `__forced_unwind` exception.
- * An example of these is a call of a method marked as `noexcept`; an attempt to cancel within such
- * a method may result in a `std::terminate` call.
- */
-class CancellationGuard {
-  int oldstate;
+#include "util/perf_counters.hpp"
+#include "util/trace.hpp"
 
- public:
-  CancellationGuard() { pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &oldstate); }
-  ~CancellationGuard() { pthread_setcancelstate(oldstate, &oldstate); }
-};
+namespace waybar::util {
 
 class SleeperThread {
  public:
-  SleeperThread() = default;
+  SleeperThread() : exit_fd_(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) {
+    std::lock_guard<std::mutex> lock(registryMutex());
+    registry().insert(this);
+  }
 
-  SleeperThread(std::function<void()> func)
-      : thread_{[this, func] {
-          while (do_run_) {
-            signal_ = false;
-            func();
-          }
-        }} {}
+  SleeperThread(std::function<void()> func) : SleeperThread() {
+    thread_ = std::thread([this, func] { loop(func); });
+  }
 
   SleeperThread& operator=(std::function<void()> func) {
-    thread_ = std::thread([this, func] {
-      while (do_run_) {
-        signal_ = false;
-        func();
-      }
-    });
+    thread_ = std::thread([this, func] { loop(func); });
     return *this;
   }
 
   bool isRunning() const { return do_run_; }
 
+  /// Pollable cancellation handle: becomes readable once stop() was called.
+  /// Workers that block in poll()/epoll_wait() on their own descriptors must
+  /// include this one in the set; there is no forced cancellation to bail
+  /// them out any more.
+  int exitFd() const { return exit_fd_; }
+
   auto sleep_for(std::chrono::system_clock::duration dur) {
     std::unique_lock lk(mutex_);
-    CancellationGuard cancel_lock;
     return condvar_.wait_for(lk, dur, [this] { return signal_ || !do_run_; });
   }
 
@@ -57,7 +49,6 @@ class SleeperThread {
       std::chrono::time_point<std::chrono::system_clock, std::chrono::system_clock::duration>
           time_point) {
     std::unique_lock lk(mutex_);
-    CancellationGuard cancel_lock;
     return condvar_.wait_until(lk, time_point, [this] { return signal_ || !do_run_; });
   }
 
@@ -69,6 +60,21 @@ class SleeperThread {
     condvar_.notify_all();
   }
 
+  /// Park the thread before its next iteration; sleeps and wake-ups are
+  /// ignored until resume().
+  auto suspend() {
+    std::lock_guard<std::mutex> lck(mutex_);
+    suspended_ = true;
+  }
+
+  auto resume() {
+    {
+      std::lock_guard<std::mutex> lck(mutex_);
+      suspended_ = false;
+    }
+    condvar_.notify_all();
+  }
+
   auto stop() {
     {
       std::lock_guard<std::mutex> lck(mutex_);
@@ -76,26 +82,79 @@ class SleeperThread {
       do_run_ = false;
     }
     condvar_.notify_all();
-    auto handle = thread_.native_handle();
-    if (handle != 0) {
-      // TODO: find a proper way to terminate thread...
-      pthread_cancel(handle);
+    if (exit_fd_ != -1) {
+      uint64_t one = 1;
+      (void)!write(exit_fd_, &one, sizeof(one));
     }
   }
 
-  ~SleeperThread() {
-    stop();
+  auto join() {
     if (thread_.joinable()) {
       thread_.join();
     }
   }
 
+  /// Signal every live worker to exit without waiting for any of them.
+  /// Destructors still join, but after this each join finds its thread
+  /// already unwinding, so tearing down N modules costs the slowest worker
+  /// instead of the sum of all of them.
+  static void stopAll() {
+    std::lock_guard<std::mutex> lock(registryMutex());
+    for (auto* thread : registry()) {
+      thread->stop();
+    }
+  }
+
+  ~SleeperThread() {
+    {
+      std::lock_guard<std::mutex> lock(registryMutex());
+      registry().erase(this);
+    }
+    stop();
+    join();
+    if (exit_fd_ != -1) {
+      close(exit_fd_);
+    }
+  }
+
  private:
+  void loop(const std::function<void()>& func) {
+    while (do_run_) {
+      {
+        std::unique_lock lk(mutex_);
+        condvar_.wait(lk, [this] { return !suspended_ || !do_run_; });
+      }
+      if (!do_run_) {
+        break;
+      }
+      signal_ = false;
+      WAYBAR_TRACE(sleeper_wakeup);
+      {
+        // NB: sleeper loops sleep inside func(), so this histogram tracks the
+        // iteration cadence (and stalls), not pure work time
+        PerfCounters::Scope perf("worker/sleeper");
+        func();
+      }
+    }
+  }
+
+  static std::mutex& registryMutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  static std::set<SleeperThread*>& registry() {
+    static std::set<SleeperThread*> threads;
+    return threads;
+  }
+
   std::thread thread_;
   std::condition_variable condvar_;
   std::mutex mutex_;
+  int exit_fd_;
   bool do_run_ = true;
   bool signal_ = false;
+  bool suspended_ = false;
 };
 
 }  // namespace waybar::util
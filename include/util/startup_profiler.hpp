@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace waybar::util {
+
+/**
+ * Startup phase instrumentation behind the --profile-startup flag.
+ *
+ * Records named spans (config parse, CSS load, per-module construction) and instant
+ * markers (first bar map) and dumps a chrome://tracing compatible JSON timeline, so a
+ * slow login can be attributed to a phase without strace archaeology.
+ */
+class StartupProfiler {
+ public:
+  using clock = std::chrono::steady_clock;
+
+  static StartupProfiler& instance();
+
+  /// RAII span; records [construction, destruction) when profiling is enabled.
+  class Scope {
+   public:
+    explicit Scope(std::string name) : name_(std::move(name)), start_(clock::now()) {}
+    ~Scope();
+
+   private:
+    std::string name_;
+    clock::time_point start_;
+  };
+
+  void enable();
+  bool enabled() const { return enabled_; }
+  /// Record a zero-duration marker (e.g. first bar map) and flush the timeline.
+  void instant(const std::string& name);
+  /// Write the collected timeline as chrome-trace JSON.
+  void dump();
+
+ private:
+  StartupProfiler() : origin_(clock::now()) {}
+  void record(const std::string& name, clock::time_point start, clock::time_point end);
+
+  struct Event {
+    std::string name;
+    int64_t ts_us;
+    int64_t dur_us;
+  };
+
+  std::mutex mutex_;
+  std::vector<Event> events_;
+  clock::time_point origin_;
+  bool enabled_ = false;
+  bool dumped_ = false;
+
+  friend class Scope;
+};
+
+}  // namespace waybar::util
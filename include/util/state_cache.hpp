@@ -0,0 +1,58 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+
+namespace waybar::util {
+
+/**
+ * Tiny persistent value store for module state that should survive restarts:
+ * smoothing averages, baselines, anything that otherwise starts cold and
+ * produces a garbage first reading.
+ *
+ * One mmap'd file of fixed-size key/value slots under the XDG cache dir.
+ * A slot is a stable double* into the mapping, so writing a value is a plain
+ * store; the mapping is msync'd periodically and on clean shutdown. Values
+ * are best effort by design — a lost write after a crash just means one cold
+ * start, which is exactly today's behaviour.
+ */
+class StateCache {
+ public:
+  static StateCache& instance();
+
+  /// Slot for `key`, allocated on first use and NaN until first written, so
+  /// callers can tell "no prior value" apart from a real one. Returns
+  /// nullptr when the cache file is unavailable or full. The pointer stays
+  /// valid for the process lifetime.
+  double* slot(const std::string& key);
+
+  /// Schedules the mapping to be written back; called periodically and from
+  /// the destructor, but available to callers with unusually precious state.
+  void flush();
+
+ private:
+  static constexpr uint32_t MAGIC = 0x57425354;  // "WBST"
+  static constexpr uint32_t VERSION = 1;
+  static constexpr size_t MAX_KEY = 55;
+  static constexpr size_t CAPACITY = 128;
+
+  struct Record {
+    char key[MAX_KEY + 1];
+    double value;
+  };
+
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+  };
+
+  StateCache();
+  ~StateCache();
+
+  std::mutex mutex_;
+  void* map_ = nullptr;
+  size_t map_size_ = 0;
+  Record* records_ = nullptr;
+};
+
+}  // namespace waybar::util
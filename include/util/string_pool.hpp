@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace waybar::util {
+
+/**
+ * Process-lifetime string intern pool. intern() returns a stable reference
+ * that never moves or goes away; interning equal contents twice returns the
+ * very same object, so pointer identity substitutes for string comparison
+ * and repeated names (module names, CSS classes, placeholder keys) are
+ * stored once no matter how many modules or bars reference them.
+ *
+ * Entries are never evicted — intern only bounded sets like config keys and
+ * module names, not user data.
+ */
+const std::string& intern(std::string_view s);
+
+/// A prehashed handle to an interned string: equality is one pointer
+/// compare, hashing is a cached value, and it converts to the underlying
+/// std::string wherever one is expected.
+class InternedString {
+ public:
+  InternedString() = default;
+  explicit InternedString(std::string_view s);
+
+  const std::string& str() const { return *str_; }
+  operator const std::string&() const { return *str_; }
+  const char* c_str() const { return str_->c_str(); }
+  bool empty() const { return str_ == nullptr || str_->empty(); }
+  std::size_t hash() const { return hash_; }
+
+  bool operator==(const InternedString& other) const { return str_ == other.str_; }
+  bool operator!=(const InternedString& other) const { return str_ != other.str_; }
+
+ private:
+  const std::string* str_ = nullptr;
+  std::size_t hash_ = 0;
+};
+
+}  // namespace waybar::util
+
+namespace std {
+template <>
+struct hash<waybar::util::InternedString> {
+  std::size_t operator()(const waybar::util::InternedString& s) const { return s.hash(); }
+};
+}  // namespace std
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace waybar::util {
+
+/**
+ * Shared deadline scheduler for interval-driven modules.
+ *
+ * Tasks are kept in a priority queue ordered by their next deadline and executed by a small
+ * fixed pool of worker threads, so the common "wake, read a file, emit dp" pattern does not
+ * require a dedicated OS thread (stack, mutex, condvar) per module.
+ */
+class TimerScheduler {
+ public:
+  using TaskId = uint64_t;
+  using clock = std::chrono::steady_clock;
+
+  static TimerScheduler& instance();
+
+  TimerScheduler(const TimerScheduler&) = delete;
+  TimerScheduler& operator=(const TimerScheduler&) = delete;
+
+  /// Register a task executed every `interval`, starting immediately.
+  TaskId repeat(clock::duration interval, std::function<void()> func);
+  /// Run the task now and rearm its interval.
+  void wakeUp(TaskId id);
+  /// Change the task's interval; applies from the next rearm, the deadline
+  /// already queued still fires on the old schedule.
+  void setInterval(TaskId id, clock::duration interval);
+  /// Stop firing the task without unregistering it.
+  void pause(TaskId id);
+  /// Undo pause(); the next tick runs one interval from now.
+  void resume(TaskId id);
+  /// Unregister a task; blocks until the task is no longer executing.
+  void cancel(TaskId id);
+
+  using ResumeListenerId = uint64_t;
+  /// Register a callback invoked after the system comes back from suspend,
+  /// with roughly how long it slept. The monotonic deadlines freeze while the
+  /// machine sleeps; modules doing delta arithmetic over counters (bandwidth
+  /// totals, battery energy) rebaseline here instead of reporting the whole
+  /// gap as one interval's worth of change. Listeners run with the scheduler
+  /// lock held — keep them trivial (set an atomic flag).
+  ResumeListenerId addResumeListener(std::function<void(std::chrono::milliseconds)> listener);
+  void removeResumeListener(ResumeListenerId id);
+
+ private:
+  TimerScheduler();
+  ~TimerScheduler();
+
+  struct Task {
+    std::function<void()> func;
+    clock::duration interval;
+    // deterministic stagger applied once on the first rearm; zero afterwards
+    clock::duration phase = clock::duration::zero();
+    // Only the queue entry matching `next` is live; earlier entries obsoleted by a
+    // wakeUp() are discarded when popped instead of being removed from the heap.
+    clock::time_point next;
+    bool cancelled = false;
+    bool paused = false;
+    bool running = false;
+  };
+
+  struct Deadline {
+    clock::time_point when;
+    TaskId id;
+    bool operator>(const Deadline& other) const { return when > other.when; }
+  };
+
+  void worker();
+  /// Suspend watch: a CLOCK_BOOTTIME timerfd armed to the earliest deadline.
+  /// The boottime clock keeps counting while the machine sleeps, so the
+  /// expiry fires right at wake; the growth of the boottime−monotonic gap is
+  /// the slept duration. Catch-up ticks are staggered and listeners notified.
+  void suspendWatch();
+  void pokeWatch();
+
+  std::mutex mutex_;
+  std::condition_variable condvar_;
+  std::condition_variable idle_condvar_;
+  std::unordered_map<TaskId, std::shared_ptr<Task>> tasks_;
+  std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>> queue_;
+  std::vector<std::thread> workers_;
+  TaskId next_id_ = 1;
+  bool do_run_ = true;
+
+  std::unordered_map<ResumeListenerId, std::function<void(std::chrono::milliseconds)>>
+      resume_listeners_;
+  ResumeListenerId next_listener_id_ = 1;
+  std::thread suspend_watch_;
+  int boottime_fd_ = -1;
+  int watch_wake_fd_ = -1;
+  // last observed CLOCK_BOOTTIME − CLOCK_MONOTONIC; only the watch thread
+  // (and the constructor) touch it
+  int64_t boot_mono_gap_ns_ = 0;
+};
+
+/**
+ * RAII registration on the shared TimerScheduler.
+ *
+ * Drop-in replacement for the typical SleeperThread usage in polling modules:
+ * assign a callback and the given interval, call wake_up() to force an immediate tick.
+ */
+class IntervalWorker {
+ public:
+  IntervalWorker() = default;
+  ~IntervalWorker() { stop(); }
+
+  IntervalWorker(const IntervalWorker&) = delete;
+  IntervalWorker& operator=(const IntervalWorker&) = delete;
+
+  void start(TimerScheduler::clock::duration interval, std::function<void()> func) {
+    stop();
+    id_ = TimerScheduler::instance().repeat(interval, std::move(func));
+  }
+
+  void wake_up() {
+    if (id_ != 0) {
+      TimerScheduler::instance().wakeUp(id_);
+    }
+  }
+
+  void set_interval(TimerScheduler::clock::duration interval) {
+    if (id_ != 0) {
+      TimerScheduler::instance().setInterval(id_, interval);
+    }
+  }
+
+  void pause() {
+    if (id_ != 0) {
+      TimerScheduler::instance().pause(id_);
+    }
+  }
+
+  void resume() {
+    if (id_ != 0) {
+      TimerScheduler::instance().resume(id_);
+    }
+  }
+
+  void stop() {
+    if (id_ != 0) {
+      TimerScheduler::instance().cancel(id_);
+      id_ = 0;
+    }
+  }
+
+ private:
+  TimerScheduler::TaskId id_ = 0;
+};
+
+}  // namespace waybar::util
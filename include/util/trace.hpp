@@ -0,0 +1,24 @@
+#pragma once
+
+/**
+ * USDT static tracepoints under the "waybar" provider.
+ *
+ * Built behind the meson 'sdt' feature; each probe compiles to a single nop
+ * until a tracer (bpftrace, perf probe, systemtap) attaches, so they are safe
+ * to keep in release builds. Correlating these with compositor frame events
+ * turns "the bar stutters on workspace switch" into a flamegraph:
+ *
+ *   bpftrace -e 'usdt:./waybar:waybar:module_update_begin { @[str(arg0)]++ }'
+ */
+
+#ifdef HAVE_SYS_SDT
+#include <sys/sdt.h>
+
+#define WAYBAR_TRACE(name) DTRACE_PROBE(waybar, name)
+#define WAYBAR_TRACE1(name, a1) DTRACE_PROBE1(waybar, name, a1)
+#define WAYBAR_TRACE2(name, a1, a2) DTRACE_PROBE2(waybar, name, a1, a2)
+#else
+#define WAYBAR_TRACE(name)
+#define WAYBAR_TRACE1(name, a1)
+#define WAYBAR_TRACE2(name, a1, a2)
+#endif
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct udev;
+struct udev_device;
+struct udev_monitor;
+
+namespace waybar::util {
+
+/**
+ * Process-wide udev monitor shared between device modules.
+ *
+ * Backlight used to own a dedicated monitor socket and watcher thread, and every
+ * further device module would have added another pair. This keeps one "udev" netlink
+ * socket on the FdReactor and fans received events out to subsystem-filtered
+ * subscribers. Callbacks run on the reactor thread and receive the whole batch that
+ * was queued on the socket, so an event storm (holding a brightness key) still
+ * results in a single publish per wakeup.
+ */
+class UdevWatcher {
+ public:
+  /// One reactor wakeup's worth of events for the subscribed subsystem. The
+  /// devices are borrowed: don't unref them or keep them past the call.
+  using Callback = std::function<void(const std::vector<udev_device*>&)>;
+
+  static UdevWatcher& instance();
+
+  UdevWatcher(const UdevWatcher&) = delete;
+  UdevWatcher& operator=(const UdevWatcher&) = delete;
+
+  /// Shared udev context, usable for enumeration from any thread.
+  struct udev* context() const { return udev_; }
+
+  /// Deliver events whose subsystem is `subsystem`; returns a token for unsubscribe().
+  int subscribe(std::string subsystem, Callback callback);
+  /// Stop delivery; blocks until a running callback finished unless called from within one.
+  void unsubscribe(int token);
+
+ private:
+  struct Subscription {
+    std::string subsystem;
+    Callback callback;
+    bool running = false;
+  };
+
+  UdevWatcher();
+  ~UdevWatcher();
+  void onEvents();
+
+  struct udev* udev_ = nullptr;
+  struct udev_monitor* mon_ = nullptr;
+  int monitor_fd_ = -1;
+  std::mutex mutex_;
+  std::condition_variable idle_condvar_;
+  int next_token_ = 1;
+  std::map<int, std::shared_ptr<Subscription>> subscriptions_;
+};
+
+}  // namespace waybar::util
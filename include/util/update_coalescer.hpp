@@ -0,0 +1,58 @@
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+
+namespace Gtk {
+class Widget;
+}
+
+namespace waybar::util {
+
+/**
+ * Main-loop batching for module updates, grouped per output.
+ *
+ * Every AModule dispatcher emission used to trigger an independent update and GTK
+ * relayout; under pulseaudio or workspace event storms that meant dozens of wakeups per
+ * frame. The coalescer collects dirty modules instead and flushes them in a single
+ * main-loop callback per frame budget, so repeated emissions for the same module
+ * collapse into one update() call.
+ *
+ * Flushes are grouped by output (the Bar passes its GdkMonitor as the group
+ * key): bars sharing a display — the usual top+bottom pair — flush in the same
+ * frame callback, so one logical change composites once instead of once per
+ * bar, and bars on different displays follow their own refresh clocks.
+ *
+ * Must only be used from the GTK main thread (which is where dispatchers deliver).
+ */
+class UpdateCoalescer {
+ public:
+  static UpdateCoalescer& instance();
+
+  /// Run `update` for `key` on the next flush of `group`; marks within one
+  /// budget window collapse.
+  void markDirty(const void* key, const void* group, std::function<void()> update);
+  /// Drop a pending update; called when its module is destroyed.
+  void discard(const void* key);
+  /// Use `widget`'s GdkFrameClock to schedule `group`'s flushes: updates then
+  /// land in the clock's update phase, one layout+paint per display refresh.
+  /// The Bar registers its window under its monitor; without a mapped driver
+  /// a timeout is used instead.
+  void setDriver(Gtk::Widget* widget, const void* group);
+  /// Forget the driver wherever it is `widget`; called from the Bar's destructor.
+  void clearDriver(Gtk::Widget* widget);
+
+ private:
+  struct Group {
+    std::unordered_map<const void*, std::function<void()>> dirty;
+    bool flush_pending = false;
+    Gtk::Widget* driver = nullptr;
+  };
+
+  UpdateCoalescer() = default;
+  void flush(Group& group);
+
+  std::unordered_map<const void*, Group> groups_;
+};
+
+}  // namespace waybar::util
@@ -1,5 +1,12 @@
 #pragma once
 #include <glibmm/ustring.h>
 
+#include <string_view>
+
+// Column width of a UTF-8 buffer (wide code points count double). ASCII runs
+// are consumed eight bytes at a time, so long mostly-ASCII titles don't pay a
+// per-code-point decode.
+int utf8_clen(std::string_view str);
+
 // calculate column width of ustring
-int ustring_clen(const Glib::ustring &str);
\ No newline at end of file
+int ustring_clen(const Glib::ustring &str);
@@ -2,8 +2,12 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
+
 #include <util/command.hpp>
 
+#include "util/timer_scheduler.hpp"
+
 namespace waybar {
 
 ALabel::ALabel(const Json::Value& config, const std::string& name, const std::string& id,
@@ -15,7 +19,17 @@ ALabel::ALabel(const Json::Value& config, const std::string& name, const std::st
                     ? std::chrono::seconds(100000000)
                     : std::chrono::seconds(
                           config_["interval"].isUInt() ? config_["interval"].asUInt() : interval)),
-      default_format_(format_) {
+      default_format_(format_),
+      width_hysteresis_(config_["width-hysteresis"].isBool() && config_["width-hysteresis"].asBool()) {
+  if (config_["width-hysteresis-timeout"].isUInt()) {
+    width_relax_ = std::chrono::seconds(config_["width-hysteresis-timeout"].asUInt());
+  }
+  if (config_["format-alt-click"].isUInt()) {
+    format_alt_click_ = config_["format-alt-click"].asUInt();
+  }
+  if (config_["format-alt"].isString()) {
+    format_alt_ = config_["format-alt"].asString();
+  }
   label_.set_name(name);
   if (!id.empty()) {
     label_.get_style_context()->add_class(id);
@@ -49,10 +63,189 @@ ALabel::ALabel(const Json::Value& config, const std::string& name, const std::st
       label_.set_xalign(align);
     }
   }
+
+  if (config_["states"].isObject()) {
+    // Deferred until the first map: selector matching depends on the widget's
+    // ancestry, which is only final once the label is rooted in the bar.
+    label_.signal_map().connect(sigc::mem_fun(*this, &ALabel::prewarmStateStyles));
+  }
 }
 
 auto ALabel::update() -> void { AModule::update(); }
 
+void ALabel::setMarkup(std::string_view markup) {
+  if (markup != last_markup_) {
+    last_markup_.assign(markup);
+    gtk_label_set_markup(label_.gobj(), last_markup_.c_str());
+    adaptiveTick(true);
+  } else {
+    adaptiveTick(false);
+  }
+  // evaluated even for unchanged markup: the relax timer has to keep running
+  // while narrow content merely persists
+  if (width_hysteresis_) {
+    stabilizeWidth();
+  }
+}
+
+bool ALabel::formatFieldReferenced(std::string_view field) const {
+  // "{field" rather than "{field}", so "{signalStrength:>3}" style format
+  // specs and prefix families like "bandwidth" match too
+  std::string needle = "{";
+  needle += field;
+  if (default_format_.find(needle) != std::string::npos) {
+    return true;
+  }
+  for (const auto& key : config_.getMemberNames()) {
+    if (key.rfind("format", 0) != 0 && key.rfind("tooltip-format", 0) != 0) {
+      continue;
+    }
+    if (config_[key].isString() && config_[key].asString().find(needle) != std::string::npos) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ALabel::enableAdaptiveInterval(util::IntervalWorker& worker) {
+  // remembered even when adaptive polling is not configured: peek mode uses
+  // the same handle to stretch the cadence while the bar is hidden
+  adaptive_worker_ = &worker;
+  if (!config_["adaptive-interval"].isUInt()) {
+    return;
+  }
+  auto cap = std::chrono::seconds(config_["adaptive-interval"].asUInt());
+  if (cap <= interval_) {
+    return;
+  }
+  adaptive_cap_ = cap;
+  adaptive_current_ = interval_;
+  // the pointer entering the module means someone is looking: go back to the
+  // base cadence and refresh right away
+  event_box_.add_events(Gdk::ENTER_NOTIFY_MASK);
+  event_box_.signal_enter_notify_event().connect([this](GdkEventCrossing*) {
+    if (adaptive_current_ != interval_) {
+      unchanged_streak_ = 0;
+      adaptive_current_ = interval_;
+      adaptive_worker_->set_interval(interval_);
+      adaptive_worker_->wake_up();
+    }
+    return false;
+  });
+}
+
+void ALabel::onPeek(bool peek, std::chrono::seconds cadence) {
+  peeking_ = peek;
+  if (adaptive_worker_ == nullptr) {
+    return;  // event-driven module; it simply keeps updating while hidden
+  }
+  if (peek) {
+    adaptive_worker_->set_interval(std::max(cadence, interval_));
+  } else {
+    // no wake_up(): the label stayed warm, the reveal remains a pure map and
+    // the next refresh comes on the module's regular beat
+    unchanged_streak_ = 0;
+    adaptive_current_ = interval_;
+    adaptive_worker_->set_interval(interval_);
+  }
+}
+
+void ALabel::adaptiveTick(bool changed) {
+  if (adaptive_worker_ == nullptr || adaptive_cap_.count() == 0 || peeking_) {
+    return;
+  }
+  if (changed) {
+    unchanged_streak_ = 0;
+    if (adaptive_current_ != interval_) {
+      adaptive_current_ = interval_;
+      adaptive_worker_->set_interval(interval_);
+    }
+    return;
+  }
+  // a couple of identical renders before the first stretch, then geometric
+  if (++unchanged_streak_ < 3) {
+    return;
+  }
+  auto next = std::min(adaptive_current_ * 2, adaptive_cap_);
+  if (next != adaptive_current_) {
+    adaptive_current_ = next;
+    adaptive_worker_->set_interval(next);
+  }
+}
+
+void ALabel::stabilizeWidth() {
+  auto layout = label_.get_layout();
+  if (!layout) {
+    return;
+  }
+  if (digit_width_ == 0) {
+    for (char digit = '0'; digit <= '9'; ++digit) {
+      int w, h;
+      label_.create_pango_layout(std::string(1, digit))->get_pixel_size(w, h);
+      digit_width_ = std::max(digit_width_, w);
+    }
+    digit_width_ = std::max(digit_width_, 1);
+  }
+  int width, height;
+  layout->get_pixel_size(width, height);
+  // Quantize to whole digit cells: "42%" and "58%" land on the same request,
+  // so numeric jitter never changes the allocation and the bar boxes are not
+  // re-laid out every tick.
+  width = (width + digit_width_ - 1) / digit_width_ * digit_width_;
+  if (width >= stable_width_) {
+    if (width > stable_width_) {
+      stable_width_ = width;
+      label_.set_size_request(stable_width_, -1);
+    }
+    narrower_since_ = {};
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+  if (narrower_since_ == std::chrono::steady_clock::time_point{}) {
+    narrower_since_ = now;
+  } else if (now - narrower_since_ >= width_relax_) {
+    // content stayed narrower for the whole hysteresis window; let the
+    // reserved width go in one step
+    stable_width_ = width;
+    label_.set_size_request(stable_width_ > 0 ? stable_width_ : -1, -1);
+    narrower_since_ = {};
+  }
+}
+
+void ALabel::setTooltipGenerator(std::function<std::string()> generator, bool markup) {
+  tooltip_generator_ = std::move(generator);
+  tooltip_generator_markup_ = markup;
+  if (!tooltip_query_connected_) {
+    label_.set_has_tooltip(true);
+    label_.signal_query_tooltip().connect(sigc::mem_fun(*this, &ALabel::onQueryTooltip), false);
+    tooltip_query_connected_ = true;
+  }
+}
+
+bool ALabel::onQueryTooltip(int, int, bool, const Glib::RefPtr<Gtk::Tooltip>& tooltip) {
+  if (!tooltip_generator_) {
+    return false;
+  }
+  auto text = tooltip_generator_();
+  if (text.empty()) {
+    return false;
+  }
+  if (tooltip_generator_markup_) {
+    tooltip->set_markup(text);
+  } else {
+    tooltip->set_text(text);
+  }
+  return true;
+}
+
+void ALabel::setTooltipText(std::string_view tooltip) {
+  if (tooltip == last_tooltip_) {
+    return;
+  }
+  last_tooltip_.assign(tooltip);
+  gtk_widget_set_tooltip_text(GTK_WIDGET(label_.gobj()), last_tooltip_.c_str());
+}
+
 std::string ALabel::getIcon(uint16_t percentage, const std::string& alt, uint16_t max) {
   auto format_icons = config_["format-icons"];
   if (format_icons.isObject()) {
@@ -102,44 +295,127 @@ std::string ALabel::getIcon(uint16_t percentage, const std::vector<std::string>&
 }
 
 bool waybar::ALabel::handleToggle(GdkEventButton* const& e) {
-  if (config_["format-alt-click"].isUInt() && e->button == config_["format-alt-click"].asUInt()) {
+  if (format_alt_click_ != 0 && e->button == format_alt_click_) {
     alt_ = !alt_;
-    if (alt_ && config_["format-alt"].isString()) {
-      format_ = config_["format-alt"].asString();
-    } else {
-      format_ = default_format_;
-    }
+    format_ = (alt_ && !format_alt_.empty()) ? format_alt_ : default_format_;
   }
   return AModule::handleToggle(e);
 }
 
-std::string ALabel::getState(uint8_t value, bool lesser) {
-  if (!config_["states"].isObject()) {
-    return "";
+size_t ALabel::addFormatSlotPair(const std::optional<std::string>& state_format) {
+  size_t base = format_slots_.size();
+  const std::string& normal = state_format ? *state_format : default_format_;
+  const std::string& alt =
+      state_format ? *state_format : (!format_alt_.empty() ? format_alt_ : default_format_);
+  format_slots_.push_back({normal, util::CompiledFormat(normal)});
+  format_slots_.push_back({alt, util::CompiledFormat(alt)});
+  return base;
+}
+
+size_t ALabel::formatSlotPair(const std::string& state) {
+  // Pair 0 is built on first use rather than in the constructor so subclasses
+  // that rewrite default_format_ during their own setup are picked up.
+  if (format_slots_.empty()) {
+    addFormatSlotPair(std::nullopt);
   }
-  // Get current state
-  std::vector<std::pair<std::string, uint8_t>> states;
+  if (state.empty()) {
+    return 0;
+  }
+  auto it = format_slot_index_.find(state);
+  if (it == format_slot_index_.end()) {
+    const auto& cfg = config_["format-" + state];
+    std::optional<std::string> state_format;
+    if (cfg.isString()) {
+      state_format = cfg.asString();
+    }
+    // states without an override share the stateless pair
+    it = format_slot_index_.emplace(state, state_format ? addFormatSlotPair(state_format) : 0)
+             .first;
+  }
+  return it->second;
+}
+
+const std::string& ALabel::getFormatForState(const std::string& state) {
+  return format_slots_[formatSlotPair(state) + (alt_ ? 1 : 0)].text;
+}
+
+const util::CompiledFormat& ALabel::getCompiledFormatForState(const std::string& state) {
+  return format_slots_[formatSlotPair(state) + (alt_ ? 1 : 0)].compiled;
+}
+
+void ALabel::ensureStateThresholds() {
+  if (state_thresholds_) {
+    return;
+  }
+  // Materialize and sort the "states" map once; update() paths then only
+  // binary-search a flat array
+  state_thresholds_.emplace();
   if (config_["states"].isObject()) {
     for (auto it = config_["states"].begin(); it != config_["states"].end(); ++it) {
       if (it->isUInt() && it.key().isString()) {
-        states.emplace_back(it.key().asString(), it->asUInt());
+        state_thresholds_->push_back({it.key().asString(), static_cast<uint8_t>(it->asUInt())});
       }
     }
   }
-  // Sort states
-  std::sort(states.begin(), states.end(), [&lesser](auto& a, auto& b) {
-    return lesser ? a.second < b.second : a.second > b.second;
-  });
-  std::string valid_state;
-  for (auto const& state : states) {
-    if ((lesser ? value <= state.second : value >= state.second) && valid_state.empty()) {
-      label_.get_style_context()->add_class(state.first);
-      valid_state = state.first;
-    } else {
-      label_.get_style_context()->remove_class(state.first);
+  std::sort(state_thresholds_->begin(), state_thresholds_->end(),
+            [](const auto& a, const auto& b) { return a.threshold < b.threshold; });
+}
+
+void ALabel::prewarmStateStyles() {
+  if (states_prewarmed_) {
+    return;
+  }
+  states_prewarmed_ = true;
+  ensureStateThresholds();
+  auto context = label_.get_style_context();
+  for (int i = 0; i < static_cast<int>(state_thresholds_->size()); ++i) {
+    if (state_applied_ && i == current_state_) {
+      continue;  // already applied and resolved by a pre-map update
+    }
+    const auto& name = (*state_thresholds_)[i].name;
+    context->add_class(name);
+    // an actual property lookup forces GTK to compute (and cache) the style
+    // for this class set; add/remove alone only marks the node dirty
+    context->get_color(context->get_state());
+    context->remove_class(name);
+  }
+}
+
+std::string ALabel::getState(uint8_t value, bool lesser) {
+  ensureStateThresholds();
+  auto& states = *state_thresholds_;
+  if (states.empty()) {
+    return "";
+  }
+  int match = -1;
+  if (lesser) {
+    // smallest threshold >= value
+    auto it = std::lower_bound(states.begin(), states.end(), value,
+                               [](const StateThreshold& s, uint8_t v) { return s.threshold < v; });
+    if (it != states.end()) {
+      match = it - states.begin();
+    }
+  } else {
+    // largest threshold <= value
+    auto it = std::upper_bound(states.begin(), states.end(), value,
+                               [](uint8_t v, const StateThreshold& s) { return v < s.threshold; });
+    if (it != states.begin()) {
+      match = (it - states.begin()) - 1;
+    }
+  }
+  // Only touch the style context on an actual transition; every add/remove
+  // triggers a full CSS re-match in GTK
+  if (!state_applied_ || match != current_state_) {
+    if (state_applied_ && current_state_ >= 0) {
+      label_.get_style_context()->remove_class(states[current_state_].name);
+    }
+    if (match >= 0) {
+      label_.get_style_context()->add_class(states[match].name);
     }
+    current_state_ = match;
+    state_applied_ = true;
   }
-  return valid_state;
+  return match >= 0 ? states[match].name : "";
 }
 
 }  // namespace waybar
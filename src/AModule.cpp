@@ -1,40 +1,85 @@
 #include "AModule.hpp"
 
 #include <fmt/format.h>
+#include <glibmm/main.h>
 
+#include <array>
+#include <cstdlib>
+#include <string_view>
 #include <util/command.hpp>
 
+#include "signal_router.hpp"
+#include "util/update_coalescer.hpp"
+
+namespace {
+
+struct ClickEventDef {
+  uint button;
+  GdkEventType type;
+  const char* name;
+};
+
+// The full set of named click config keys, indexed by (button, press type).
+constexpr std::array<ClickEventDef, 15> click_event_defs{{
+    {1, GDK_BUTTON_PRESS, "on-click"},
+    {1, GDK_2BUTTON_PRESS, "on-double-click"},
+    {1, GDK_3BUTTON_PRESS, "on-triple-click"},
+    {2, GDK_BUTTON_PRESS, "on-click-middle"},
+    {2, GDK_2BUTTON_PRESS, "on-double-click-middle"},
+    {2, GDK_3BUTTON_PRESS, "on-triple-click-middle"},
+    {3, GDK_BUTTON_PRESS, "on-click-right"},
+    {3, GDK_2BUTTON_PRESS, "on-double-click-right"},
+    {3, GDK_3BUTTON_PRESS, "on-triple-click-right"},
+    {8, GDK_BUTTON_PRESS, "on-click-backward"},
+    {8, GDK_2BUTTON_PRESS, "on-double-click-backward"},
+    {8, GDK_3BUTTON_PRESS, "on-triple-click-backward"},
+    {9, GDK_BUTTON_PRESS, "on-click-forward"},
+    {9, GDK_2BUTTON_PRESS, "on-double-click-forward"},
+    {9, GDK_3BUTTON_PRESS, "on-triple-click-forward"},
+}};
+
+}  // namespace
+
 namespace waybar {
 
 AModule::AModule(const Json::Value& config, const std::string& name, const std::string& id,
                  bool enable_click, bool enable_scroll)
-    : name_(std::move(name)),
+    : name_(util::intern(name)),
       config_(std::move(config)),
+      tooltip_enabled_(config_["tooltip"].isBool() ? config_["tooltip"].asBool() : true),
       distance_scrolled_y_(0.0),
       distance_scrolled_x_(0.0) {
   // configure events' user commands
-  if (enable_click) {
+  resolveClickActions();
+  if (enable_click || !click_actions_.empty()) {
     event_box_.add_events(Gdk::BUTTON_PRESS_MASK);
     event_box_.signal_button_press_event().connect(sigc::mem_fun(*this, &AModule::handleToggle));
-  } else {
-    std::map<std::pair<uint, GdkEventType>, std::string>::const_iterator it{eventMap_.cbegin()};
-    while (it != eventMap_.cend()) {
-      if (config_[it->second].isString()) {
-        event_box_.add_events(Gdk::BUTTON_PRESS_MASK);
-        event_box_.signal_button_press_event().connect(
-            sigc::mem_fun(*this, &AModule::handleToggle));
-        break;
-      }
-      ++it;
-    }
   }
-  if (config_["on-scroll-up"].isString() || config_["on-scroll-down"].isString() || enable_scroll) {
+  if (config_["on-scroll-up"].isString()) {
+    on_scroll_up_ = config_["on-scroll-up"].asString();
+  }
+  if (config_["on-scroll-down"].isString()) {
+    on_scroll_down_ = config_["on-scroll-down"].asString();
+  }
+  if (config_["on-update"].isString()) {
+    on_update_ = config_["on-update"].asString();
+  }
+  if (config_["smooth-scrolling-threshold"].isNumeric()) {
+    smooth_scrolling_threshold_ = config_["smooth-scrolling-threshold"].asDouble();
+  }
+  if (!on_scroll_up_.empty() || !on_scroll_down_.empty() || enable_scroll) {
     event_box_.add_events(Gdk::SCROLL_MASK | Gdk::SMOOTH_SCROLL_MASK);
     event_box_.signal_scroll_event().connect(sigc::mem_fun(*this, &AModule::handleScroll));
   }
+  if (config_["signal"].isInt()) {
+    SignalRouter::instance().subscribe(config_["signal"].asInt(), this);
+  }
 }
 
 AModule::~AModule() {
+  scroll_flush_timer_.disconnect();
+  SignalRouter::instance().unsubscribe(this);
+  util::UpdateCoalescer::instance().discard(this);
   for (const auto& pid : pid_) {
     if (pid != -1) {
       killpg(pid, SIGTERM);
@@ -42,27 +87,60 @@ AModule::~AModule() {
   }
 }
 
+void AModule::setSuspended(bool suspended) {
+  if (suspended == suspended_) {
+    return;
+  }
+  suspended_ = suspended;
+  onSuspended(suspended);
+  if (!suspended && refresh_deferred_) {
+    refresh_deferred_ = false;
+    dp.emit();
+  }
+}
+
+void AModule::setPeek(bool peek, std::chrono::seconds cadence) {
+  // a peeking module is never suspended; no cold refresh happens on reveal
+  // because the data never went cold
+  setSuspended(false);
+  onPeek(peek, cadence);
+}
+
 auto AModule::update() -> void {
   // Run user-provided update handler if configured
-  if (config_["on-update"].isString()) {
-    pid_.push_back(util::command::forkExec(config_["on-update"].asString()));
+  if (!on_update_.empty()) {
+    pid_.push_back(util::command::forkExec(on_update_));
   }
 }
 
-bool AModule::handleToggle(GdkEventButton* const& e) {
-  const std::map<std::pair<uint, GdkEventType>, std::string>::const_iterator& rec{
-      eventMap_.find(std::pair(e->button, e->type))};
-  std::string format{(rec != eventMap_.cend()) ? rec->second : std::string{""}};
-
-  if (!format.empty()) {
-    if (config_[format].isString())
-      format = config_[format].asString();
-    else
-      format.clear();
+void AModule::resolveClickActions() {
+  for (const auto& def : click_event_defs) {
+    if (config_[def.name].isString()) {
+      click_actions_.push_back({def.button, def.type, config_[def.name].asString()});
+    }
+  }
+  // Extra buttons beyond the named set: "on-click-button<N>" binds a single
+  // press of button N without growing the static table.
+  constexpr std::string_view prefix{"on-click-button"};
+  for (const auto& key : config_.getMemberNames()) {
+    if (key.compare(0, prefix.size(), prefix) != 0 || !config_[key].isString()) {
+      continue;
+    }
+    char* end = nullptr;
+    auto button = std::strtoul(key.c_str() + prefix.size(), &end, 10);
+    if (end != nullptr && *end == '\0' && button > 0) {
+      click_actions_.push_back(
+          {static_cast<uint>(button), GDK_BUTTON_PRESS, config_[key].asString()});
+    }
   }
+}
 
-  if (!format.empty()) {
-    pid_.push_back(util::command::forkExec(format));
+bool AModule::handleToggle(GdkEventButton* const& e) {
+  for (const auto& action : click_actions_) {
+    if (action.button == e->button && action.type == e->type) {
+      pid_.push_back(util::command::forkExec(action.command));
+      break;
+    }
   }
   dp.emit();
   return true;
@@ -84,10 +162,7 @@ AModule::SCROLL_DIR AModule::getScrollDir(GdkEventScroll* e) {
       distance_scrolled_y_ += e->delta_y;
       distance_scrolled_x_ += e->delta_x;
 
-      gdouble threshold = 0;
-      if (config_["smooth-scrolling-threshold"].isNumeric()) {
-        threshold = config_["smooth-scrolling-threshold"].asDouble();
-      }
+      const gdouble threshold = smooth_scrolling_threshold_;
 
       if (distance_scrolled_y_ < -threshold) {
         dir = SCROLL_DIR::UP;
@@ -122,19 +197,43 @@ AModule::SCROLL_DIR AModule::getScrollDir(GdkEventScroll* e) {
 
 bool AModule::handleScroll(GdkEventScroll* e) {
   auto dir = getScrollDir(e);
-  if (dir == SCROLL_DIR::UP && config_["on-scroll-up"].isString()) {
-    pid_.push_back(util::command::forkExec(config_["on-scroll-up"].asString()));
-  } else if (dir == SCROLL_DIR::DOWN && config_["on-scroll-down"].isString()) {
-    pid_.push_back(util::command::forkExec(config_["on-scroll-down"].asString()));
+  if (dir != SCROLL_DIR::UP && dir != SCROLL_DIR::DOWN) {
+    dp.emit();
+    return true;
+  }
+  scroll_steps_ += dir == SCROLL_DIR::UP ? 1 : -1;
+  if (!scroll_flush_pending_) {
+    scroll_flush_pending_ = true;
+    scroll_flush_timer_ = Glib::signal_timeout().connect(
+        [this] {
+          flushScroll();
+          return false;
+        },
+        SCROLL_FLUSH_MS);
   }
-  dp.emit();
   return true;
 }
 
-bool AModule::tooltipEnabled() {
-  return config_["tooltip"].isBool() ? config_["tooltip"].asBool() : true;
+void AModule::flushScroll() {
+  scroll_flush_pending_ = false;
+  const int steps = scroll_steps_;
+  scroll_steps_ = 0;
+  if (steps != 0) {
+    applyScroll(steps);
+  }
+  dp.emit();
+}
+
+void AModule::applyScroll(int steps) {
+  if (steps > 0 && !on_scroll_up_.empty()) {
+    pid_.push_back(util::command::forkExec(on_scroll_up_));
+  } else if (steps < 0 && !on_scroll_down_.empty()) {
+    pid_.push_back(util::command::forkExec(on_scroll_down_));
+  }
 }
 
+bool AModule::tooltipEnabled() { return tooltip_enabled_; }
+
 AModule::operator Gtk::Widget&() { return event_box_; }
 
 }  // namespace waybar
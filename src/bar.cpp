@@ -4,12 +4,19 @@
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <future>
 #include <type_traits>
 
 #include "bar.hpp"
 #include "client.hpp"
 #include "factory.hpp"
 #include "group.hpp"
+#include "util/alloc_track.hpp"
+#include "util/perf_counters.hpp"
+#include "util/startup_profiler.hpp"
+#include "util/trace.hpp"
+#include "util/update_coalescer.hpp"
 #include "wlr-layer-shell-unstable-v1-client-protocol.h"
 
 #ifdef HAVE_SWAY
@@ -182,6 +189,11 @@ struct GLSSurfaceImpl : public BarSurface, public sigc::trackable {
     window_.set_size_request(width_, height_);
   };
 
+  void setOutput(struct waybar_output& output) override {
+    output_name_ = output.name;
+    gtk_layer_set_monitor(window_.gobj(), output.monitor->gobj());
+  }
+
  private:
   Gtk::Window& window_;
   std::string output_name_;
@@ -193,6 +205,7 @@ struct GLSSurfaceImpl : public BarSurface, public sigc::trackable {
   void onMap(GdkEventAny* ev) { setPassThrough(passthrough_); }
 
   void onConfigure(GdkEventConfigure* ev) {
+    WAYBAR_TRACE2(bar_configure, ev->width, ev->height);
     /*
      * GTK wants new size for the window.
      * Actual resizing and management of the exclusve zone is handled within the gtk-layer-shell
@@ -247,7 +260,7 @@ struct RawSurfaceImpl : public BarSurface, public sigc::trackable {
           zone += (anchor_ & ZWLR_LAYER_SURFACE_V1_ANCHOR_TOP) ? margins_.bottom : margins_.top;
         }
       }
-      spdlog::debug("Set exclusive zone {} for output {}", zone, output_name_);
+      SPDLOG_DEBUG("Set exclusive zone {} for output {}", zone, output_name_);
       zwlr_layer_surface_v1_set_exclusive_zone(layer_surface_.get(), zone);
     }
   }
@@ -316,6 +329,14 @@ struct RawSurfaceImpl : public BarSurface, public sigc::trackable {
     window_.set_size_request(width, height);
   };
 
+  void setOutput(struct waybar_output& output) override {
+    output_ = gdk_wayland_monitor_get_wl_output(output.monitor->gobj());
+    output_name_ = output.name;
+    // the old surface died with its output; the next map creates a fresh one
+    layer_surface_.reset();
+    surface_ = nullptr;
+  }
+
   void commit() override {
     if (surface_) {
       wl_surface_commit(surface_);
@@ -381,6 +402,7 @@ struct RawSurfaceImpl : public BarSurface, public sigc::trackable {
   }
 
   void onConfigure(GdkEventConfigure* ev) {
+    WAYBAR_TRACE2(bar_configure, ev->width, ev->height);
     /*
      * GTK wants new size for the window.
      *
@@ -438,7 +460,7 @@ struct RawSurfaceImpl : public BarSurface, public sigc::trackable {
         width += margins_.right + margins_.left;
       }
     }
-    spdlog::debug("Set surface size {}x{} for output {}", width, height, output_name_);
+    SPDLOG_DEBUG("Set surface size {}x{} for output {}", width, height, output_name_);
     zwlr_layer_surface_v1_set_size(layer_surface_.get(), width, height);
   }
 
@@ -495,6 +517,22 @@ waybar::Bar::Bar(struct waybar_output* w_output, const Json::Value& w_config)
   center_.get_style_context()->add_class("modules-center");
   right_.get_style_context()->add_class("modules-right");
 
+  // With GTK's default redraw-on-allocate, a one-pixel change in any module
+  // re-allocates its box and invalidates the container's entire extent, so a
+  // clock tick damaged the full bar width. Turning it off confines damage to
+  // the rectangles that actually changed; the module boxes paint at most a
+  // background, for which redrawing only the new portion is correct. Paired
+  // with "width-hysteresis" (stable label allocations) a typical tick now
+  // damages one module, not the whole surface.
+  box_.set_redraw_on_allocate(false);
+  left_.set_redraw_on_allocate(false);
+  center_.set_redraw_on_allocate(false);
+  right_.set_redraw_on_allocate(false);
+
+  if (config["peek-interval"].isUInt()) {
+    peek_cadence_ = std::chrono::seconds(config["peek-interval"].asUInt());
+  }
+
   if (config["spacing"].isInt()) {
     int spacing = config["spacing"].asInt();
     left_.set_spacing(spacing);
@@ -602,19 +640,33 @@ waybar::Bar::Bar(struct waybar_output* w_output, const Json::Value& w_config)
   setupWidgets();
   window.show_all();
 
+  // Any mapped bar window on this output works as its group's frame-clock
+  // source; the most recently created one wins.
+  util::UpdateCoalescer::instance().setDriver(&window,
+                                              output->monitor ? output->monitor->gobj() : nullptr);
+
+  // Pointer events that land on the bar background (padding above/below the
+  // labels, spacing between modules) reach the window instead of a module's
+  // event box; the hit-test index routes them to the module whose extent on
+  // the bar axis contains the pointer, without any widget-tree pick.
+  window.add_events(Gdk::SCROLL_MASK | Gdk::SMOOTH_SCROLL_MASK);
+  window.signal_scroll_event().connect(sigc::mem_fun(*this, &Bar::handleBackgroundScroll));
+  box_.signal_size_allocate().connect_notify(
+      [this](Gtk::Allocation&) { hit_index_dirty_ = true; });
+
   if (spdlog::should_log(spdlog::level::debug)) {
     // Unfortunately, this function isn't in the C++ bindings, so we have to call the C version.
     char* gtk_tree = gtk_style_context_to_string(
         window.get_style_context()->gobj(),
         (GtkStyleContextPrintFlags)(GTK_STYLE_CONTEXT_PRINT_RECURSE |
                                     GTK_STYLE_CONTEXT_PRINT_SHOW_STYLE));
-    spdlog::debug("GTK widget tree:\n{}", gtk_tree);
+    SPDLOG_DEBUG("GTK widget tree:\n{}", gtk_tree);
     g_free(gtk_tree);
   }
 }
 
 /* Need to define it here because of forward declared members */
-waybar::Bar::~Bar() = default;
+waybar::Bar::~Bar() { util::UpdateCoalescer::instance().clearDriver(&window); }
 
 void waybar::Bar::setMode(const std::string_view& mode) {
   using namespace std::literals::string_literals;
@@ -652,6 +704,7 @@ void waybar::Bar::setMode(const struct bar_mode& mode) {
 }
 
 void waybar::Bar::onMap(GdkEventAny*) {
+  util::StartupProfiler::instance().instant("bar.onMap");
   /*
    * Obtain a pointer to the custom layer surface for modules that require it (idle_inhibitor).
    */
@@ -666,14 +719,37 @@ void waybar::Bar::setVisible(bool value) {
   } else {
     setMode(visible ? MODE_DEFAULT : MODE_INVISIBLE);
   }
+  // A hidden bar renders nothing; stop its pollers instead of formatting
+  // labels nobody can see. Modules replay one deferred update on resume.
+  // With a peek cadence configured, modules stay warm at that slowed pace
+  // instead, so the reveal is a pure surface map without the resume herd.
+  for (auto& module : modules_all_) {
+    if (peek_cadence_.count() > 0) {
+      module->setPeek(!visible, peek_cadence_);
+    } else {
+      module->setSuspended(!visible);
+    }
+  }
 }
 
 void waybar::Bar::toggle() { setVisible(!visible); }
 
+void waybar::Bar::setOutput(struct waybar_output* w_output) {
+  window.get_style_context()->remove_class(output->name);
+  output = w_output;
+  window.get_style_context()->add_class(output->name);
+  surface_impl_->setOutput(*output);
+  window.show_all();
+  // re-home the window as a frame-clock source for the new output's group
+  util::UpdateCoalescer::instance().clearDriver(&window);
+  util::UpdateCoalescer::instance().setDriver(&window,
+                                              output->monitor ? output->monitor->gobj() : nullptr);
+}
+
 // Converting string to button code rn as to avoid doing it later
-void waybar::Bar::setupAltFormatKeyForModule(const std::string& module_name) {
-  if (config.isMember(module_name)) {
-    Json::Value& module = config[module_name];
+void waybar::Bar::setupAltFormatKeyForModule(Json::Value& conf, const std::string& module_name) {
+  if (conf.isMember(module_name)) {
+    Json::Value& module = conf[module_name];
     if (module.isMember("format-alt")) {
       if (module.isMember("format-alt-click")) {
         Json::Value& click = module["format-alt-click"];
@@ -699,47 +775,97 @@ void waybar::Bar::setupAltFormatKeyForModule(const std::string& module_name) {
   }
 }
 
-void waybar::Bar::setupAltFormatKeyForModuleList(const char* module_list_name) {
-  if (config.isMember(module_list_name)) {
-    Json::Value& modules = config[module_list_name];
+void waybar::Bar::setupAltFormatKeyForModuleList(Json::Value& conf, const char* module_list_name) {
+  if (conf.isMember(module_list_name)) {
+    Json::Value& modules = conf[module_list_name];
     for (const Json::Value& module_name : modules) {
       if (module_name.isString()) {
-        setupAltFormatKeyForModule(module_name.asString());
+        setupAltFormatKeyForModule(conf, module_name.asString());
       }
     }
   }
 }
 
-void waybar::Bar::handleSignal(int signal) {
-  for (auto& module : modules_all_) {
-    auto* custom = dynamic_cast<waybar::modules::Custom*>(module.get());
-    if (custom != nullptr) {
-      custom->refresh(signal);
-    }
-  }
+waybar::AModule* waybar::Bar::getModule(const std::string& name) {
+  auto it = modules_by_name_.find(name);
+  return it != modules_by_name_.end() ? it->second.get() : nullptr;
 }
 
 void waybar::Bar::getModules(const Factory& factory, const std::string& pos,
-                             Gtk::Box* group = nullptr) {
+                             Group* group = nullptr) {
   auto module_list = group ? config[pos]["modules"] : config[pos];
   if (module_list.isArray()) {
-    for (const auto& name : module_list) {
+    // Construct independent modules concurrently: tray, network or mpd block on
+    // DBus/netlink/socket connects in their constructors and paying for those
+    // serially dominates cold start. Results are collected in config order below,
+    // so layout and signal wiring are unchanged.
+    std::vector<std::future<AModule*>> futures(module_list.size());
+    for (Json::ArrayIndex i = 0; i < module_list.size(); i++) {
+      auto ref = module_list[i].asString();
+      if (ref.compare(0, 6, "group/") == 0 && ref.size() > 6) {
+        // Groups recurse into getModules and must stay on this thread.
+        continue;
+      }
+      if (recycled_.count(ref) != 0) {
+        // carried over from the previous config during a reload
+        continue;
+      }
+      futures[i] = std::async(std::launch::async,
+                              [&factory, ref] { return factory.makeModule(ref); });
+    }
+    for (Json::ArrayIndex i = 0; i < module_list.size(); i++) {
+      const auto& name = module_list[i];
       try {
         auto ref = name.asString();
-        AModule* module;
-
-        if (ref.compare(0, 6, "group/") == 0 && ref.size() > 6) {
+        AModule* module = nullptr;
+        std::shared_ptr<AModule> module_sp;
+
+        if (auto rec = recycled_.find(ref); rec != recycled_.end()) {
+          module_sp = std::move(rec->second);
+          module = module_sp.get();
+          recycled_.erase(rec);
+        } else if (ref.compare(0, 6, "group/") == 0 && ref.size() > 6) {
           auto group_module = new waybar::Group(ref, *this, config[ref]);
-          getModules(factory, ref, &group_module->box);
+          getModules(factory, ref, group_module);
           module = group_module;
+        } else if (futures[i].valid()) {
+          module = futures[i].get();
         } else {
+          // no future was launched for this slot (duplicate module name whose
+          // first occurrence was recycled); construct synchronously
           module = factory.makeModule(ref);
         }
 
-        std::shared_ptr<AModule> module_sp(module);
+        if (!module_sp) {
+          // newly constructed; a recycled module keeps its original connection
+          module_sp.reset(module);
+          module->dp.connect([this, module, name] {
+            WAYBAR_TRACE1(dispatch, name.asCString());
+            if (module->isSuspended()) {
+              module->deferRefresh();
+              return;
+            }
+            // Coalesce bursts: storms of emissions within one frame budget run a
+            // single update() per module. Grouped by this bar's monitor, looked
+            // up per dispatch so output hotplug re-targeting is followed.
+            util::UpdateCoalescer::instance().markDirty(
+                module, output->monitor ? output->monitor->gobj() : nullptr, [module, name] {
+                  WAYBAR_TRACE1(module_update_begin, name.asCString());
+                  try {
+                    util::PerfCounters::Scope perf("update/" + name.asString());
+                    WAYBAR_ALLOC_SCOPE(name.asString());
+                    module->update();
+                  } catch (const std::exception& e) {
+                    spdlog::error("{}: {}", name.asString(), e.what());
+                  }
+                  WAYBAR_TRACE1(module_update_end, name.asCString());
+                });
+          });
+        }
         modules_all_.emplace_back(module_sp);
+        modules_by_name_.emplace(ref, module_sp);
         if (group) {
-          group->pack_start(*module, false, false);
+          group->addChild(module_sp);
         } else {
           if (pos == "modules-left") {
             modules_left_.emplace_back(module_sp);
@@ -751,13 +877,6 @@ void waybar::Bar::getModules(const Factory& factory, const std::string& pos,
             modules_right_.emplace_back(module_sp);
           }
         }
-        module->dp.connect([module, name] {
-          try {
-            module->update();
-          } catch (const std::exception& e) {
-            spdlog::error("{}: {}", name.asString(), e.what());
-          }
-        });
       } catch (const std::exception& e) {
         spdlog::warn("module {}: {}", name.asString(), e.what());
       }
@@ -766,7 +885,6 @@ void waybar::Bar::getModules(const Factory& factory, const std::string& pos,
 }
 
 auto waybar::Bar::setupWidgets() -> void {
-  window.add(box_);
   box_.pack_start(left_, false, false);
   if (config["fixed-center"].isBool() ? config["fixed-center"].asBool() : true) {
     box_.set_center_widget(center_);
@@ -776,14 +894,23 @@ auto waybar::Bar::setupWidgets() -> void {
   box_.pack_end(right_, false, false);
 
   // Convert to button code for every module that is used.
-  setupAltFormatKeyForModuleList("modules-left");
-  setupAltFormatKeyForModuleList("modules-right");
-  setupAltFormatKeyForModuleList("modules-center");
+  setupAltFormatKeyForModuleList(config, "modules-left");
+  setupAltFormatKeyForModuleList(config, "modules-right");
+  setupAltFormatKeyForModuleList(config, "modules-center");
 
   Factory factory(*this, config);
   getModules(factory, "modules-left");
   getModules(factory, "modules-center");
   getModules(factory, "modules-right");
+  packModules();
+
+  // Root the subtree only once it is fully assembled and every widget carries
+  // its final classes: attaching last means GTK runs a single style-cascade
+  // invalidation over the tree instead of one per pack on a rooted box.
+  window.add(box_);
+}
+
+void waybar::Bar::packModules() {
   for (auto const& module : modules_left_) {
     left_.pack_start(*module, false, false);
   }
@@ -794,4 +921,108 @@ auto waybar::Bar::setupWidgets() -> void {
   for (auto const& module : modules_right_) {
     right_.pack_end(*module, false, false);
   }
+  hit_index_dirty_ = true;
+}
+
+waybar::AModule* waybar::Bar::moduleAt(int pos) {
+  if (hit_index_dirty_) {
+    hit_index_.clear();
+    for (auto const& module : modules_all_) {
+      Gtk::Widget& widget = *module;
+      if (!widget.get_visible()) {
+        continue;
+      }
+      int x = 0;
+      int y = 0;
+      if (!widget.translate_coordinates(window, 0, 0, x, y)) {
+        continue;
+      }
+      const auto alloc = widget.get_allocation();
+      const int start = vertical ? y : x;
+      const int extent = vertical ? alloc.get_height() : alloc.get_width();
+      hit_index_.push_back({start, start + extent, module.get()});
+    }
+    std::sort(hit_index_.begin(), hit_index_.end(),
+              [](const HitInterval& a, const HitInterval& b) { return a.start < b.start; });
+    hit_index_dirty_ = false;
+  }
+  // last interval starting at or before pos; extents never overlap, so one
+  // end check suffices
+  auto it = std::upper_bound(
+      hit_index_.begin(), hit_index_.end(), pos,
+      [](int value, const HitInterval& iv) { return value < iv.start; });
+  if (it == hit_index_.begin()) {
+    return nullptr;
+  }
+  --it;
+  return pos < it->end ? it->module : nullptr;
+}
+
+bool waybar::Bar::handleBackgroundScroll(GdkEventScroll* e) {
+  auto* module = moduleAt(vertical ? static_cast<int>(e->y) : static_cast<int>(e->x));
+  if (module == nullptr) {
+    return false;
+  }
+  return module->routeScroll(e);
+}
+
+void waybar::Bar::reloadConfig(Json::Value new_config) {
+  // normalize click bindings the way setupWidgets does, so the diff below
+  // compares like with like
+  setupAltFormatKeyForModuleList(new_config, "modules-left");
+  setupAltFormatKeyForModuleList(new_config, "modules-right");
+  setupAltFormatKeyForModuleList(new_config, "modules-center");
+
+  // detach every module widget so the boxes can be refilled without the
+  // containers destroying them
+  for (auto& module : modules_all_) {
+    Gtk::Widget& widget = *module;
+    if (auto* parent = dynamic_cast<Gtk::Container*>(widget.get_parent())) {
+      parent->remove(widget);
+    }
+  }
+
+  // modules with unchanged settings survive with their threads, caches and
+  // widget; groups are cheap containers and always rebuilt
+  recycled_.clear();
+  for (auto& [name, module] : modules_by_name_) {
+    if (name.compare(0, 6, "group/") == 0) {
+      continue;
+    }
+    if (config.get(name, Json::Value::nullSingleton()) ==
+        new_config.get(name, Json::Value::nullSingleton())) {
+      recycled_.emplace(name, module);
+    }
+  }
+  modules_by_name_.clear();
+  modules_left_.clear();
+  modules_center_.clear();
+  modules_right_.clear();
+  modules_all_.clear();
+
+  /* Merge key by key, leaving unchanged subtrees in place: AModule::config_
+   * is a reference into this tree, so a recycled module's node must not be
+   * reallocated. */
+  for (const auto& key : new_config.getMemberNames()) {
+    if (!config.isMember(key) || config[key] != new_config[key]) {
+      config[key] = new_config[key];
+    }
+  }
+  for (const auto& key : config.getMemberNames()) {
+    if (!new_config.isMember(key)) {
+      config.removeMember(key);
+    }
+  }
+
+  Factory factory(*this, config);
+  getModules(factory, "modules-left");
+  getModules(factory, "modules-center");
+  getModules(factory, "modules-right");
+  // whatever was not reclaimed is gone from the config; drop it here
+  recycled_.clear();
+  packModules();
+  window.show_all();
+  for (auto& module : modules_all_) {
+    module->dp.emit();
+  }
 }
@@ -2,11 +2,18 @@
 
 #include <fmt/ostream.h>
 #include <spdlog/spdlog.h>
+#include <sys/inotify.h>
+#include <unistd.h>
 
+#include <fstream>
 #include <iostream>
+#include <thread>
 
 #include "idle-inhibit-unstable-v1-client-protocol.h"
+#include "signal_router.hpp"
 #include "util/clara.hpp"
+#include "util/sleeper_thread.hpp"
+#include "util/startup_profiler.hpp"
 #include "wlr-layer-shell-unstable-v1-client-protocol.h"
 
 waybar::Client *waybar::Client::inst() {
@@ -79,7 +86,19 @@ void waybar::Client::handleOutputDone(void *data, struct zxdg_output_v1 * /*xdg_
      */
     if (output.xdg_output) {
       output.xdg_output.reset();
-      spdlog::debug("Output detection done: {} ({})", output.name, output.identifier);
+      SPDLOG_DEBUG("Output detection done: {} ({})", output.name, output.identifier);
+
+      // A re-plugged output (dock, DPMS cycle) gets its parked bars back
+      // instead of a full module rebuild. If the corresponding removal is
+      // still sitting in the debounce window, flush it first so the old bar
+      // is parked and found below rather than duplicated.
+      if (!client->pending_removals_.empty()) {
+        client->hotplug_timer_.disconnect();
+        client->reconcileOutputs();
+      }
+      if (client->reattachBars(output)) {
+        return;
+      }
 
       auto configs = client->getOutputConfigs(output);
       if (!configs.empty()) {
@@ -126,29 +145,239 @@ void waybar::Client::handleMonitorAdded(Glib::RefPtr<Gdk::Monitor> monitor) {
 }
 
 void waybar::Client::handleMonitorRemoved(Glib::RefPtr<Gdk::Monitor> monitor) {
-  spdlog::debug("Output removed: {} {}", monitor->get_manufacturer(), monitor->get_model());
-  /* This event can be triggered from wl_display_roundtrip called by GTK or our code.
-   * Defer destruction of bars for the output to the next iteration of the event loop to avoid
-   * deleting objects referenced by currently executed code.
+  SPDLOG_DEBUG("Output removed: {} {}", monitor->get_manufacturer(), monitor->get_model());
+  /* This event can be triggered from wl_display_roundtrip called by GTK or our code, so bars
+   * must not be touched from the current stack frame. Docking yanks several outputs in one
+   * burst; collect them and run a single reconcile pass once the topology settles.
    */
-  Glib::signal_idle().connect_once(
-      sigc::bind(sigc::mem_fun(*this, &Client::handleDeferredMonitorRemoval), monitor),
-      Glib::PRIORITY_HIGH_IDLE);
-}
-
-void waybar::Client::handleDeferredMonitorRemoval(Glib::RefPtr<Gdk::Monitor> monitor) {
-  for (auto it = bars.begin(); it != bars.end();) {
-    if ((*it)->output->monitor == monitor) {
-      auto output_name = (*it)->output->name;
-      (*it)->window.hide();
-      gtk_app->remove_window((*it)->window);
-      it = bars.erase(it);
-      spdlog::info("Bar removed from output: {}", output_name);
+  pending_removals_.push_back(monitor);
+  hotplug_timer_.disconnect();
+  hotplug_timer_ = Glib::signal_timeout().connect(
+      [this] {
+        reconcileOutputs();
+        return false;
+      },
+      hotplug_debounce_.count());
+}
+
+void waybar::Client::reconcileOutputs() {
+  for (const auto &monitor : pending_removals_) {
+    bool detached = false;
+    for (auto it = bars.begin(); it != bars.end();) {
+      if ((*it)->output->monitor == monitor) {
+        auto &output = *(*it)->output;
+        /* Park the bar instead of destroying it: module construction (netlink, DBus, script
+         * spawns) dominates the rebuild cost and the output usually comes right back. */
+        (*it)->setVisible(false);
+        (*it)->window.hide();
+        detached_bars_.push_back(
+            {std::move(*it), output.name, output.identifier, monitor, std::chrono::steady_clock::now()});
+        it = bars.erase(it);
+        detached = true;
+        spdlog::info("Bar detached from output: {}", output.name);
+      } else {
+        ++it;
+      }
+    }
+    if (detached) {
+      /* The stale outputs_ entry stays alive while a detached bar points at it;
+       * pruneDetachedBars or reattachBars clean it up. */
+      Glib::signal_timeout().connect_once(
+          sigc::mem_fun(*this, &Client::pruneDetachedBars),
+          std::chrono::duration_cast<std::chrono::milliseconds>(detach_retention_).count() + 100);
+    } else {
+      outputs_.remove_if([&monitor](const auto &output) { return output.monitor == monitor; });
+    }
+  }
+  pending_removals_.clear();
+}
+
+bool waybar::Client::reattachBars(struct waybar_output &output) {
+  bool reattached = false;
+  for (auto it = detached_bars_.begin(); it != detached_bars_.end();) {
+    if (it->output_name == output.name && it->output_identifier == output.identifier) {
+      auto old_monitor = it->old_monitor;
+      it->bar->setOutput(&output);
+      it->bar->setVisible(true);
+      bars.push_back(std::move(it->bar));
+      it = detached_bars_.erase(it);
+      outputs_.remove_if(
+          [&old_monitor](const auto &entry) { return entry.monitor == old_monitor; });
+      reattached = true;
+      spdlog::info("Bar reattached to output: {}", output.name);
     } else {
       ++it;
     }
   }
-  outputs_.remove_if([&monitor](const auto &output) { return output.monitor == monitor; });
+  return reattached;
+}
+
+void waybar::Client::pruneDetachedBars() {
+  auto now = std::chrono::steady_clock::now();
+  for (auto it = detached_bars_.begin(); it != detached_bars_.end();) {
+    if (now - it->detached_at >= detach_retention_) {
+      auto old_monitor = it->old_monitor;
+      gtk_app->remove_window(it->bar->window);
+      spdlog::info("Bar removed from output: {}", it->output_name);
+      it = detached_bars_.erase(it);
+      outputs_.remove_if(
+          [&old_monitor](const auto &entry) { return entry.monitor == old_monitor; });
+    } else {
+      ++it;
+    }
+  }
+}
+
+void waybar::Client::setupConfigWatch() {
+  if (config_inotify_fd_ >= 0) {
+    // re-arm after a reload: the include set may have changed
+    config_io_watch_.disconnect();
+    close(config_inotify_fd_);
+    config_watch_dirs_.clear();
+    config_watch_files_.clear();
+  }
+  config_inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (config_inotify_fd_ < 0) {
+    spdlog::warn("Unable to watch config files; hot reload disabled");
+    return;
+  }
+  auto files = config.getSourceFiles();
+  if (!css_file_.empty()) {
+    files.push_back(css_file_);
+  }
+  for (const auto &file : files) {
+    config_watch_files_.insert(file);
+    auto slash = file.rfind('/');
+    auto dir = slash == std::string::npos ? std::string(".") : file.substr(0, slash);
+    auto wd =
+        inotify_add_watch(config_inotify_fd_, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if (wd >= 0) {
+      config_watch_dirs_.emplace(wd, dir);
+    }
+  }
+  config_io_watch_ = Glib::signal_io().connect(sigc::mem_fun(*this, &Client::onConfigDirEvent),
+                                               config_inotify_fd_, Glib::IO_IN);
+}
+
+bool waybar::Client::onConfigDirEvent(Glib::IOCondition /*cond*/) {
+  char buf[4096] __attribute__((aligned(alignof(struct inotify_event))));
+  bool relevant = false;
+  ssize_t len;
+  while ((len = read(config_inotify_fd_, buf, sizeof(buf))) > 0) {
+    for (char *ptr = buf; ptr < buf + len;) {
+      const auto *event = reinterpret_cast<struct inotify_event *>(ptr);
+      if (event->len > 0) {
+        auto it = config_watch_dirs_.find(event->wd);
+        if (it != config_watch_dirs_.end()) {
+          auto path = it->second + '/' + event->name;
+          if (config_watch_files_.count(path) != 0) {
+            relevant = true;
+            if (path == css_file_) {
+              css_dirty_ = true;
+            } else {
+              config_dirty_ = true;
+              dirty_config_files_.insert(path);
+            }
+          }
+        }
+      }
+      ptr += sizeof(struct inotify_event) + event->len;
+    }
+  }
+  if (relevant) {
+    // editors fire several events per save; reload once after it settles
+    config_reload_timer_.disconnect();
+    config_reload_timer_ = Glib::signal_timeout().connect(
+        [this] {
+          if (css_dirty_) {
+            css_dirty_ = false;
+            reloadCss();
+          }
+          if (config_dirty_) {
+            config_dirty_ = false;
+            auto changed = std::move(dirty_config_files_);
+            dirty_config_files_.clear();
+            reloadConfig(changed);
+          }
+          return false;
+        },
+        250);
+  }
+  return true;
+}
+
+void waybar::Client::reloadConfig(const std::set<std::string> &changed_files) {
+  // A change confined to known source files is re-merged from the parse
+  // cache: only the touched fragments are re-read, and the per-bar module
+  // diff below leaves every module outside the fragment's keys untouched.
+  bool partial = !changed_files.empty();
+  if (partial) {
+    try {
+      for (const auto &file : changed_files) {
+        if (!config.reloadFile(file)) {
+          partial = false;
+          break;
+        }
+      }
+    } catch (const std::exception &e) {
+      spdlog::error("Config reload failed, keeping the previous one: {}", e.what());
+      return;
+    }
+  }
+  if (partial) {
+    spdlog::info("Re-merged {} changed configuration fragment(s)", changed_files.size());
+  } else {
+    spdlog::info("Reloading configuration");
+    try {
+      config.load(config_opt_);
+    } catch (const std::exception &e) {
+      spdlog::error("Config reload failed, keeping the previous one: {}", e.what());
+      return;
+    }
+  }
+  setupConfigWatch();
+
+  // bars parked for hotplug were built from the old config; drop them
+  for (auto &detached : detached_bars_) {
+    auto old_monitor = detached.old_monitor;
+    gtk_app->remove_window(detached.bar->window);
+    detached.bar.reset();
+    outputs_.remove_if([&old_monitor](const auto &entry) { return entry.monitor == old_monitor; });
+  }
+  detached_bars_.clear();
+
+  for (auto &output : outputs_) {
+    if (output.name.empty()) {
+      continue;  // still waiting for xdg_output events
+    }
+    auto configs = getOutputConfigs(output);
+    std::vector<Bar *> output_bars;
+    for (auto &bar : bars) {
+      if (bar->output == &output) {
+        output_bars.push_back(bar.get());
+      }
+    }
+    if (output_bars.size() == configs.size()) {
+      // diff at module granularity; untouched modules keep their instance
+      for (size_t i = 0; i < configs.size(); ++i) {
+        output_bars[i]->reloadConfig(configs[i]);
+      }
+    } else {
+      // the set of bars itself changed; rebuild this output from scratch
+      for (auto it = bars.begin(); it != bars.end();) {
+        if ((*it)->output == &output) {
+          (*it)->window.hide();
+          gtk_app->remove_window((*it)->window);
+          it = bars.erase(it);
+        } else {
+          ++it;
+        }
+      }
+      for (const auto &bar_config : configs) {
+        bars.emplace_back(std::make_unique<Bar>(&output, bar_config));
+      }
+    }
+  }
 }
 
 const std::string waybar::Client::getStyle(const std::string &style) {
@@ -163,6 +392,7 @@ const std::string waybar::Client::getStyle(const std::string &style) {
 auto waybar::Client::setupCss(const std::string &css_file) -> void {
   css_provider_ = Gtk::CssProvider::create();
   style_context_ = Gtk::StyleContext::create();
+  css_file_ = css_file;
 
   // Load our css file, wherever that may be hiding
   if (!css_provider_->load_from_path(css_file)) {
@@ -173,6 +403,40 @@ auto waybar::Client::setupCss(const std::string &css_file) -> void {
                                           GTK_STYLE_PROVIDER_PRIORITY_USER);
 }
 
+void waybar::Client::reloadCss() {
+  /* Read the file in a worker so a slow disk never stalls the bar; the
+   * provider itself belongs to the GTK thread, so the compile and the swap are
+   * dispatched back to an idle callback. The swap is atomic from the screen's
+   * point of view: the new provider is compiled and only then replaces the old
+   * one, and a parse error keeps the previous style. */
+  std::thread([this, file = css_file_] {
+    std::ifstream stream(file);
+    if (!stream.is_open()) {
+      spdlog::error("Can't open style file {}", file);
+      return;
+    }
+    std::string data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    Glib::signal_idle().connect_once([this, data = std::move(data)] {
+      auto provider = Gtk::CssProvider::create();
+      try {
+        if (!provider->load_from_data(data)) {
+          spdlog::error("CSS reload failed, keeping previous style");
+          return;
+        }
+      } catch (const Glib::Error &e) {
+        spdlog::error("CSS reload failed, keeping previous style: {}", std::string(e.what()));
+        return;
+      }
+      auto screen = Gdk::Screen::get_default();
+      style_context_->remove_provider_for_screen(screen, css_provider_);
+      css_provider_ = provider;
+      style_context_->add_provider_for_screen(screen, css_provider_,
+                                              GTK_STYLE_PROVIDER_PRIORITY_USER);
+      spdlog::info("Style reloaded");
+    });
+  }).detach();
+}
+
 void waybar::Client::bindInterfaces() {
   registry = wl_display_get_registry(wl_display);
   static const struct wl_registry_listener registry_listener = {
@@ -200,6 +464,7 @@ int waybar::Client::main(int argc, char *argv[]) {
   std::string config_opt;
   std::string style_opt;
   std::string log_level;
+  bool profile_startup = false;
   auto cli = clara::detail::Help(show_help) |
              clara::detail::Opt(show_version)["-v"]["--version"]("Show version") |
              clara::detail::Opt(config_opt, "config")["-c"]["--config"]("Config path") |
@@ -207,7 +472,9 @@ int waybar::Client::main(int argc, char *argv[]) {
              clara::detail::Opt(
                  log_level,
                  "trace|debug|info|warning|error|critical|off")["-l"]["--log-level"]("Log level") |
-             clara::detail::Opt(bar_id, "id")["-b"]["--bar"]("Bar id");
+             clara::detail::Opt(bar_id, "id")["-b"]["--bar"]("Bar id") |
+             clara::detail::Opt(profile_startup)["--profile-startup"](
+                 "Record startup phases and dump a chrome-trace timeline");
   auto res = cli.parse(clara::detail::Args(argc, argv));
   if (!res) {
     spdlog::error("Error in command line: {}", res.errorMessage());
@@ -224,6 +491,9 @@ int waybar::Client::main(int argc, char *argv[]) {
   if (!log_level.empty()) {
     spdlog::set_level(spdlog::level::from_str(log_level));
   }
+  if (profile_startup) {
+    util::StartupProfiler::instance().enable();
+  }
   gtk_app = Gtk::Application::create(argc, argv, "fr.arouillard.waybar",
                                      Gio::APPLICATION_HANDLES_COMMAND_LINE);
   gdk_display = Gdk::Display::get_default();
@@ -234,12 +504,27 @@ int waybar::Client::main(int argc, char *argv[]) {
     throw std::runtime_error("Bar need to run under Wayland");
   }
   wl_display = gdk_wayland_display_get_wl_display(gdk_display->gobj());
-  config.load(config_opt);
+  config_opt_ = config_opt;
+  {
+    util::StartupProfiler::Scope scope("config.load");
+    config.load(config_opt);
+  }
+  setupConfigWatch();
+  if (!control_server_) {
+    control_server_ = std::make_unique<ControlServer>();
+  }
+  SignalRouter::instance().start();
   auto css_file = getStyle(style_opt);
-  setupCss(css_file);
+  {
+    util::StartupProfiler::Scope scope("setupCss");
+    setupCss(css_file);
+  }
   bindInterfaces();
   gtk_app->hold();
   gtk_app->run();
+  // Signal every module worker before the first destructor joins one, so the
+  // threads unwind in parallel and a reload doesn't pay for them serially.
+  util::SleeperThread::stopAll();
   bars.clear();
   return 0;
 }
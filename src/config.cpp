@@ -5,9 +5,11 @@
 #include <unistd.h>
 #include <wordexp.h>
 
+#include <algorithm>
 #include <fstream>
 #include <stdexcept>
 
+#include "util/config_cache.hpp"
 #include "util/json.hpp"
 
 namespace waybar {
@@ -43,9 +45,10 @@ std::optional<std::string> Config::findConfigPath(const std::vector<std::string>
   return std::nullopt;
 }
 
-void Config::setupConfig(Json::Value &dst, const std::string &config_file, int depth) {
-  if (depth > 100) {
-    throw std::runtime_error("Aborting due to likely recursive include in config files");
+Json::Value Config::parseSourceFile(const std::string &config_file) {
+  auto it = parsed_cache_.find(config_file);
+  if (it != parsed_cache_.end()) {
+    return it->second;
   }
   std::ifstream file(config_file);
   if (!file.is_open()) {
@@ -53,7 +56,23 @@ void Config::setupConfig(Json::Value &dst, const std::string &config_file, int d
   }
   std::string str((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
   util::JsonParser parser;
-  Json::Value tmp_config = parser.parse(str);
+  return parsed_cache_.emplace(config_file, parser.parse(str)).first->second;
+}
+
+void Config::setupConfig(Json::Value &dst, const std::string &config_file, int depth) {
+  if (depth > 100) {
+    throw std::runtime_error("Aborting due to likely recursive include in config files");
+  }
+  // a copy, since include resolution merges the included trees into it
+  Json::Value tmp_config = parseSourceFile(config_file);
+  source_files_.push_back(config_file);
+  if (tmp_config.isObject()) {
+    // first definer wins, matching the merge precedence below; multi-bar
+    // array configs are not tracked
+    for (const auto &key : tmp_config.getMemberNames()) {
+      key_sources_.emplace(key, config_file);
+    }
+  }
   if (tmp_config.isArray()) {
     for (auto &config_part : tmp_config) {
       resolveConfigIncludes(config_part, depth);
@@ -91,7 +110,7 @@ void Config::mergeConfig(Json::Value &a_config_, Json::Value &b_config_) {
         // do not allow overriding value set by top or previously included config
         a_config_[key] = b_config_[key];
       } else {
-        spdlog::trace("Option {} is already set; ignoring value {}", key, b_config_[key]);
+        SPDLOG_TRACE("Option {} is already set; ignoring value {}", key, b_config_[key]);
       }
     }
   } else {
@@ -128,7 +147,57 @@ void Config::load(const std::string &config) {
   }
   config_file_ = file.value();
   spdlog::info("Using configuration file {}", config_file_);
+  // load() may run again for a hot reload
+  config_ = Json::Value();
+  source_files_.clear();
+  parsed_cache_.clear();
+  key_sources_.clear();
+  if (auto cached = util::ConfigCache::load(config_file_, &source_files_)) {
+    SPDLOG_DEBUG("Using cached configuration");
+    config_ = std::move(*cached);
+    return;
+  }
   setupConfig(config_, config_file_, 0);
+  util::ConfigCache::store(config_file_, source_files_, config_);
+}
+
+bool Config::reloadFile(const std::string &path) {
+  if (parsed_cache_.erase(path) == 0) {
+    // not one of our source files, or the tree was restored from the binary
+    // cache and no parses are held
+    return false;
+  }
+  auto old_sources = std::move(source_files_);
+  auto old_key_sources = std::move(key_sources_);
+  source_files_.clear();
+  key_sources_.clear();
+  Json::Value fresh;
+  try {
+    setupConfig(fresh, config_file_, 0);
+  } catch (...) {
+    source_files_ = std::move(old_sources);
+    key_sources_ = std::move(old_key_sources);
+    // the failed re-read may have cached a broken parse; force a fresh read
+    // on the next attempt
+    parsed_cache_.erase(path);
+    throw;
+  }
+  config_ = std::move(fresh);
+  // drop parses of fragments the changed file no longer includes
+  for (auto it = parsed_cache_.begin(); it != parsed_cache_.end();) {
+    if (std::find(source_files_.begin(), source_files_.end(), it->first) == source_files_.end()) {
+      it = parsed_cache_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  for (const auto &[key, source] : key_sources_) {
+    if (source == path) {
+      SPDLOG_DEBUG("Fragment {} owns option {}", path, key);
+    }
+  }
+  util::ConfigCache::store(config_file_, source_files_, config_);
+  return true;
 }
 
 std::vector<Json::Value> Config::getOutputConfigs(const std::string &name,
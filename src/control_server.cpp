@@ -0,0 +1,215 @@
+#include "control_server.hpp"
+
+#include <spdlog/spdlog.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include "client.hpp"
+#include "util/perf_counters.hpp"
+
+namespace waybar {
+
+std::string ControlServer::socketPath() {
+  const char *runtime_dir = getenv("XDG_RUNTIME_DIR");
+  const char *display = getenv("WAYLAND_DISPLAY");
+  std::string dir = runtime_dir != nullptr ? runtime_dir : "/tmp";
+  return dir + "/waybar-" + (display != nullptr ? display : "wayland-0") + ".sock";
+}
+
+ControlServer::ControlServer() {
+  fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+  if (fd_ < 0) {
+    spdlog::warn("control socket: {}", strerror(errno));
+    return;
+  }
+  auto path = socketPath();
+  struct sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    spdlog::warn("control socket: path too long: {}", path);
+    close(fd_);
+    fd_ = -1;
+    return;
+  }
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+  // a previous instance may have died without cleaning up
+  unlink(path.c_str());
+  if (bind(fd_, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0 ||
+      listen(fd_, 4) < 0) {
+    spdlog::warn("control socket {}: {}", path, strerror(errno));
+    close(fd_);
+    fd_ = -1;
+    return;
+  }
+  accept_watch_ =
+      Glib::signal_io().connect(sigc::mem_fun(*this, &ControlServer::onConnect), fd_, Glib::IO_IN);
+  SPDLOG_DEBUG("control socket listening on {}", path);
+}
+
+ControlServer::~ControlServer() {
+  accept_watch_.disconnect();
+  for (auto &[fd, conn] : connections_) {
+    conn.watch.disconnect();
+    close(fd);
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+    unlink(socketPath().c_str());
+  }
+}
+
+bool ControlServer::onConnect(Glib::IOCondition /*cond*/) {
+  int cfd;
+  while ((cfd = accept4(fd_, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK)) >= 0) {
+    auto &conn = connections_[cfd];
+    conn.watch = Glib::signal_io().connect(
+        sigc::bind(sigc::mem_fun(*this, &ControlServer::onData), cfd), cfd,
+        Glib::IO_IN | Glib::IO_HUP | Glib::IO_ERR);
+  }
+  return true;
+}
+
+bool ControlServer::onData(Glib::IOCondition /*cond*/, int fd) {
+  auto it = connections_.find(fd);
+  if (it == connections_.end()) {
+    return false;
+  }
+  char buf[1024];
+  ssize_t n;
+  while ((n = read(fd, buf, sizeof(buf))) > 0) {
+    it->second.buffer.append(buf, n);
+  }
+  if (n < 0 && errno == EAGAIN && it->second.buffer.find('\n') == std::string::npos) {
+    return true;  // command not complete yet
+  }
+  auto line = it->second.buffer.substr(0, it->second.buffer.find('\n'));
+  auto reply = handleCommand(line);
+  if (write(fd, reply.c_str(), reply.size()) < 0) {
+    SPDLOG_DEBUG("control socket reply: {}", strerror(errno));
+  }
+  closeConnection(fd);
+  return false;
+}
+
+void ControlServer::closeConnection(int fd) {
+  auto it = connections_.find(fd);
+  if (it != connections_.end()) {
+    it->second.watch.disconnect();
+    connections_.erase(it);
+  }
+  close(fd);
+}
+
+std::string ControlServer::handleCommand(const std::string &line) {
+  std::istringstream iss(line);
+  std::string cmd, arg;
+  iss >> cmd >> arg;
+  auto client = Client::inst();
+
+  if (cmd == "refresh") {
+    if (arg.empty()) {
+      return "error: refresh needs a module name\n";
+    }
+    auto found = false;
+    for (auto &bar : client->bars) {
+      if (auto *module = bar->getModule(arg)) {
+        module->refresh(0);
+        found = true;
+      }
+    }
+    return found ? "ok\n" : "error: no such module: " + arg + "\n";
+  }
+  if (cmd == "show" || cmd == "hide" || cmd == "toggle") {
+    if (arg.empty()) {
+      for (auto &bar : client->bars) {
+        if (cmd == "toggle") {
+          bar->toggle();
+        } else {
+          bar->setVisible(cmd == "show");
+        }
+      }
+      return "ok\n";
+    }
+    auto found = false;
+    for (auto &bar : client->bars) {
+      if (auto *module = bar->getModule(arg)) {
+        Gtk::Widget &widget = *module;
+        if (cmd == "toggle") {
+          widget.set_visible(!widget.get_visible());
+        } else {
+          widget.set_visible(cmd == "show");
+        }
+        found = true;
+      }
+    }
+    return found ? "ok\n" : "error: no such module: " + arg + "\n";
+  }
+  if (cmd == "perf") {
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "  ";
+    return Json::writeString(builder, util::PerfCounters::instance().toJson()) + "\n";
+  }
+  if (cmd == "set-mode") {
+    if (arg.empty()) {
+      return "error: set-mode needs a mode name\n";
+    }
+    for (auto &bar : client->bars) {
+      bar->setMode(arg);
+    }
+    return "ok\n";
+  }
+  return "error: unknown command: " + cmd + "\n";
+}
+
+int ControlServer::clientMain(int argc, char *argv[]) {
+  if (argc < 1) {
+    std::cerr << "usage: waybar ctl <refresh|show|hide|toggle|set-mode> [arg]" << std::endl;
+    return 1;
+  }
+  std::string line;
+  for (auto i = 0; i < argc; ++i) {
+    if (i > 0) {
+      line += ' ';
+    }
+    line += argv[i];
+  }
+  line += '\n';
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    std::cerr << "waybar ctl: " << strerror(errno) << std::endl;
+    return 1;
+  }
+  auto path = socketPath();
+  struct sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+  if (connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+    std::cerr << "waybar ctl: cannot connect to " << path << ": " << strerror(errno) << std::endl;
+    close(fd);
+    return 1;
+  }
+  if (write(fd, line.c_str(), line.size()) < 0) {
+    std::cerr << "waybar ctl: " << strerror(errno) << std::endl;
+    close(fd);
+    return 1;
+  }
+  shutdown(fd, SHUT_WR);
+
+  std::string reply;
+  char buf[1024];
+  ssize_t n;
+  while ((n = read(fd, buf, sizeof(buf))) > 0) {
+    reply.append(buf, n);
+  }
+  close(fd);
+  std::cout << reply;
+  return reply.compare(0, 2, "ok") == 0 ? 0 : 1;
+}
+
+}  // namespace waybar
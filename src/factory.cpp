@@ -1,5 +1,9 @@
 #include "factory.hpp"
 
+#include <unordered_map>
+
+#include "util/startup_profiler.hpp"
+
 waybar::Factory::Factory(const Bar& bar, const Json::Value& config) : bar_(bar), config_(config) {}
 
 waybar::AModule* waybar::Factory::makeModule(const std::string& name) const {
@@ -7,114 +11,162 @@ waybar::AModule* waybar::Factory::makeModule(const std::string& name) const {
     auto hash_pos = name.find('#');
     auto ref = name.substr(0, hash_pos);
     auto id = hash_pos != std::string::npos ? name.substr(hash_pos + 1) : "";
+
+    using ModuleCtor = AModule* (*)(const Factory&, const std::string&, const Json::Value&);
+    // Constructor table built once; lookup is a single hash instead of a linear
+    // if-chain over every known module name.
+    static const std::unordered_map<std::string, ModuleCtor> registry = {
 #if defined(__linux__) && !defined(NO_FILESYSTEM)
-    if (ref == "battery") {
-      return new waybar::modules::Battery(id, config_[name]);
-    }
+        {"battery",
+         [](const Factory&, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::Battery(id, config);
+         }},
 #endif
 #ifdef HAVE_UPOWER
-    if (ref == "upower") {
-      return new waybar::modules::upower::UPower(id, config_[name]);
-    }
+        {"upower",
+         [](const Factory&, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::upower::UPower(id, config);
+         }},
 #endif
 #ifdef HAVE_SWAY
-    if (ref == "sway/mode") {
-      return new waybar::modules::sway::Mode(id, config_[name]);
-    }
-    if (ref == "sway/workspaces") {
-      return new waybar::modules::sway::Workspaces(id, bar_, config_[name]);
-    }
-    if (ref == "sway/window") {
-      return new waybar::modules::sway::Window(id, bar_, config_[name]);
-    }
-    if (ref == "sway/language") {
-      return new waybar::modules::sway::Language(id, config_[name]);
-    }
+        {"sway/mode",
+         [](const Factory&, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::sway::Mode(id, config);
+         }},
+        {"sway/workspaces",
+         [](const Factory& f, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::sway::Workspaces(id, f.bar_, config);
+         }},
+        {"sway/window",
+         [](const Factory& f, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::sway::Window(id, f.bar_, config);
+         }},
+        {"sway/language",
+         [](const Factory&, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::sway::Language(id, config);
+         }},
 #endif
 #ifdef HAVE_WLR
-    if (ref == "wlr/taskbar") {
-      return new waybar::modules::wlr::Taskbar(id, bar_, config_[name]);
-    }
+        {"wlr/taskbar",
+         [](const Factory& f, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::wlr::Taskbar(id, f.bar_, config);
+         }},
 #ifdef USE_EXPERIMENTAL
-    if (ref == "wlr/workspaces") {
-      return new waybar::modules::wlr::WorkspaceManager(id, bar_, config_[name]);
-    }
+        {"wlr/workspaces",
+         [](const Factory& f, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::wlr::WorkspaceManager(id, f.bar_, config);
+         }},
 #endif
 #endif
 #ifdef HAVE_RIVER
-    if (ref == "river/tags") {
-      return new waybar::modules::river::Tags(id, bar_, config_[name]);
-    }
-#endif
-    if (ref == "idle_inhibitor") {
-      return new waybar::modules::IdleInhibitor(id, bar_, config_[name]);
-    }
+        {"river/tags",
+         [](const Factory& f, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::river::Tags(id, f.bar_, config);
+         }},
+#endif
+        {"idle_inhibitor",
+         [](const Factory& f, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::IdleInhibitor(id, f.bar_, config);
+         }},
 #if defined(HAVE_MEMORY_LINUX) || defined(HAVE_MEMORY_BSD)
-    if (ref == "memory") {
-      return new waybar::modules::Memory(id, config_[name]);
-    }
+        {"memory",
+         [](const Factory&, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::Memory(id, config);
+         }},
 #endif
 #if defined(HAVE_CPU_LINUX) || defined(HAVE_CPU_BSD)
-    if (ref == "cpu") {
-      return new waybar::modules::Cpu(id, config_[name]);
-    }
-#endif
-    if (ref == "clock") {
-      return new waybar::modules::Clock(id, config_[name]);
-    }
-    if (ref == "disk") {
-      return new waybar::modules::Disk(id, config_[name]);
-    }
+        {"cpu",
+         [](const Factory&, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::Cpu(id, config);
+         }},
+#endif
+        {"clock",
+         [](const Factory&, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::Clock(id, config);
+         }},
+        {"disk",
+         [](const Factory&, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::Disk(id, config);
+         }},
+        {"mpris",
+         [](const Factory&, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::Mpris(id, config);
+         }},
+        {"systemd-failed-units",
+         [](const Factory&, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::SystemdFailedUnits(id, config);
+         }},
+        {"waybar/perf",
+         [](const Factory&, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::Perf(id, config);
+         }},
 #ifdef HAVE_DBUSMENU
-    if (ref == "tray") {
-      return new waybar::modules::SNI::Tray(id, bar_, config_[name]);
-    }
+        {"tray",
+         [](const Factory& f, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::SNI::Tray(id, f.bar_, config);
+         }},
 #endif
 #ifdef HAVE_LIBNL
-    if (ref == "network") {
-      return new waybar::modules::Network(id, config_[name]);
-    }
+        {"network",
+         [](const Factory&, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::Network(id, config);
+         }},
 #endif
 #ifdef HAVE_LIBUDEV
-    if (ref == "backlight") {
-      return new waybar::modules::Backlight(id, config_[name]);
-    }
+        {"backlight",
+         [](const Factory&, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::Backlight(id, config);
+         }},
 #endif
 #ifdef HAVE_LIBEVDEV
-    if (ref == "keyboard-state") {
-      return new waybar::modules::KeyboardState(id, bar_, config_[name]);
-    }
+        {"keyboard-state",
+         [](const Factory& f, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::KeyboardState(id, f.bar_, config);
+         }},
 #endif
 #ifdef HAVE_LIBPULSE
-    if (ref == "pulseaudio") {
-      return new waybar::modules::Pulseaudio(id, config_[name]);
-    }
+        {"pulseaudio",
+         [](const Factory&, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::Pulseaudio(id, config);
+         }},
 #endif
 #ifdef HAVE_LIBMPDCLIENT
-    if (ref == "mpd") {
-      return new waybar::modules::MPD(id, config_[name]);
-    }
+        {"mpd",
+         [](const Factory&, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::MPD(id, config);
+         }},
 #endif
 #ifdef HAVE_LIBSNDIO
-    if (ref == "sndio") {
-      return new waybar::modules::Sndio(id, config_[name]);
-    }
+        {"sndio",
+         [](const Factory&, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::Sndio(id, config);
+         }},
 #endif
 #ifdef HAVE_GIO_UNIX
-    if (ref == "inhibitor") {
-      return new waybar::modules::Inhibitor(id, bar_, config_[name]);
-    }
-#endif
-    if (ref == "temperature") {
-      return new waybar::modules::Temperature(id, config_[name]);
-    }
+        {"inhibitor",
+         [](const Factory& f, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::Inhibitor(id, f.bar_, config);
+         }},
+#endif
+        {"temperature",
+         [](const Factory&, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::Temperature(id, config);
+         }},
 #if defined(__linux__)
 #ifdef WANT_RFKILL
-    if (ref == "bluetooth") {
-      return new waybar::modules::Bluetooth(id, config_[name]);
-    }
+        {"bluetooth",
+         [](const Factory&, const std::string& id, const Json::Value& config) -> AModule* {
+           return new waybar::modules::Bluetooth(id, config);
+         }},
 #endif
 #endif
+    };
+
+    auto it = registry.find(ref);
+    if (it != registry.end()) {
+      util::StartupProfiler::Scope scope("makeModule:" + name);
+      return it->second(*this, id, config_[name]);
+    }
     if (ref.compare(0, 7, "custom/") == 0 && ref.size() > 7) {
       return new waybar::modules::Custom(ref.substr(7), id, config_[name]);
     }
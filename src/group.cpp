@@ -8,12 +8,70 @@ namespace waybar {
 
 Group::Group(const std::string& name, const Bar& bar, const Json::Value& config)
     : AModule(config, name, "", false, false),
-      box{bar.vertical ? Gtk::ORIENTATION_HORIZONTAL : Gtk::ORIENTATION_VERTICAL, 0} {}
+      box{bar.vertical ? Gtk::ORIENTATION_HORIZONTAL : Gtk::ORIENTATION_VERTICAL, 0},
+      drawer_(config["drawer"].isBool() && config["drawer"].asBool()),
+      drawer_box_{box.get_orientation(), 0} {
+  if (drawer_) {
+    revealer_.add(drawer_box_);
+    revealer_.set_transition_type(box.get_orientation() == Gtk::ORIENTATION_HORIZONTAL
+                                      ? Gtk::REVEALER_TRANSITION_TYPE_SLIDE_RIGHT
+                                      : Gtk::REVEALER_TRANSITION_TYPE_SLIDE_DOWN);
+    revealer_.set_transition_duration(
+        config["transition-duration"].isUInt() ? config["transition-duration"].asUInt() : 300);
+    revealer_.set_reveal_child(false);
+    event_box_.add(box);
+    event_box_.add_events(Gdk::BUTTON_PRESS_MASK);
+    event_box_.signal_button_press_event().connect([this](GdkEventButton* e) {
+      if (e->button == 1 && e->type == GDK_BUTTON_PRESS) {
+        setExpanded(!expanded_);
+        return true;
+      }
+      return false;
+    });
+  }
+}
+
+void Group::addChild(const std::shared_ptr<AModule>& child) {
+  if (drawer_ && !children_.empty()) {
+    if (children_.size() == 1) {
+      // first hidden child: the revealer goes in right after the handle
+      box.pack_start(revealer_, false, false);
+    }
+    drawer_box_.pack_start(*child, false, false);
+    child->setSuspended(true);
+  } else {
+    box.pack_start(*child, false, false);
+  }
+  children_.push_back(child);
+}
+
+void Group::setExpanded(bool expanded) {
+  expanded_ = expanded;
+  revealer_.set_reveal_child(expanded);
+  for (size_t i = 1; i < children_.size(); ++i) {
+    children_[i]->setSuspended(!expanded);
+    if (expanded) {
+      // make the revealed state current, even if nothing was deferred
+      children_[i]->refresh(0);
+    }
+  }
+}
+
+void Group::onSuspended(bool suspended) {
+  // The Bar resumes every module when it becomes visible again; children of
+  // a collapsed drawer go back to sleep (the Bar walks children before their
+  // group, so this runs last).
+  if (!suspended && drawer_ && !expanded_) {
+    for (size_t i = 1; i < children_.size(); ++i) {
+      children_[i]->setSuspended(true);
+    }
+  }
+}
 
 auto Group::update() -> void {
   // noop
 }
 
-Group::operator Gtk::Widget&() { return box; }
+Group::operator Gtk::Widget&() { return drawer_ ? static_cast<Gtk::Widget&>(event_box_) : box; }
 
 }  // namespace waybar
@@ -1,12 +1,18 @@
+#include <spdlog/async.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
 #include <spdlog/spdlog.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 
 #include <csignal>
+#include <cstring>
 #include <list>
 #include <mutex>
 
 #include "client.hpp"
+#include "control_server.hpp"
+#include "signal_router.hpp"
+#include "util/prefetch.hpp"
 
 std::mutex reap_mtx;
 std::list<pid_t> reap;
@@ -27,12 +33,12 @@ void* signalThread(void* args) {
 
     switch (signum) {
       case SIGCHLD:
-        spdlog::debug("Received SIGCHLD in signalThread");
+        SPDLOG_DEBUG("Received SIGCHLD in signalThread");
         if (!reap.empty()) {
           reap_mtx.lock();
           for (auto it = reap.begin(); it != reap.end(); ++it) {
             if (waitpid(*it, nullptr, WNOHANG) == *it) {
-              spdlog::debug("Reaped child with PID: {}", *it);
+              SPDLOG_DEBUG("Reaped child with PID: {}", *it);
               it = reap.erase(it);
             }
           }
@@ -40,7 +46,7 @@ void* signalThread(void* args) {
         }
         break;
       default:
-        spdlog::debug("Received signal with number {}, but not handling", signum);
+        SPDLOG_DEBUG("Received signal with number {}, but not handling", signum);
         break;
     }
   }
@@ -70,7 +76,19 @@ void startSignalThread(void) {
 }
 
 int main(int argc, char* argv[]) {
+  if (argc > 1 && strcmp(argv[1], "ctl") == 0) {
+    return waybar::ControlServer::clientMain(argc - 2, argv + 2);
+  }
   try {
+    // Bounded async logger: formatting and sink I/O run on a worker thread
+    // instead of whatever module thread happens to log. When the ring buffer
+    // fills, the oldest entries are overrun rather than blocking the caller.
+    spdlog::init_thread_pool(1024, 1);
+    spdlog::set_default_logger(std::make_shared<spdlog::async_logger>(
+        "waybar", std::make_shared<spdlog::sinks::stdout_color_sink_mt>(), spdlog::thread_pool(),
+        spdlog::async_overflow_policy::overrun_oldest));
+    spdlog::flush_on(spdlog::level::err);
+
     auto client = waybar::Client::inst();
 
     std::signal(SIGUSR1, [](int /*signal*/) {
@@ -85,15 +103,17 @@ int main(int argc, char* argv[]) {
       waybar::Client::inst()->reset();
     });
 
-    for (int sig = SIGRTMIN + 1; sig <= SIGRTMAX; ++sig) {
-      std::signal(sig, [](int sig) {
-        for (auto& bar : waybar::Client::inst()->bars) {
-          bar->handleSignal(sig);
-        }
-      });
-    }
+    // The real-time range is routed through a signalfd on the main loop;
+    // block it here so every thread inherits the mask.
+    waybar::SignalRouter::instance().block();
     startSignalThread();
 
+    // Overlap cold-cache disk reads (config and includes, style.css, icon
+    // theme indexes, tzdata) with GTK initialization; by the time anything
+    // opens these the pages are already in flight. After the mask setup so
+    // the worker inherits the blocked signals like every other thread.
+    waybar::util::prefetchStartupFiles();
+
     auto ret = 0;
     do {
       reload = false;
@@ -101,6 +121,7 @@ int main(int argc, char* argv[]) {
     } while (reload);
 
     delete client;
+    spdlog::shutdown();  // drain the async queue before exit
     return ret;
   } catch (const std::exception& e) {
     spdlog::error("{}", e.what());
@@ -2,38 +2,14 @@
 
 #include <fmt/format.h>
 #include <libudev.h>
-#include <sys/epoll.h>
-#include <unistd.h>
 
 #include <algorithm>
-#include <chrono>
+#include <cstring>
 #include <memory>
 
-namespace {
-class FileDescriptor {
- public:
-  explicit FileDescriptor(int fd) : fd_(fd) {}
-  FileDescriptor(const FileDescriptor &other) = delete;
-  FileDescriptor(FileDescriptor &&other) noexcept = delete;
-  FileDescriptor &operator=(const FileDescriptor &other) = delete;
-  FileDescriptor &operator=(FileDescriptor &&other) noexcept = delete;
-  ~FileDescriptor() {
-    if (fd_ != -1) {
-      if (close(fd_) != 0) {
-        fmt::print(stderr, "Failed to close fd: {}\n", errno);
-      }
-    }
-  }
-  int get() const { return fd_; }
-
- private:
-  int fd_;
-};
-
-struct UdevDeleter {
-  void operator()(udev *ptr) { udev_unref(ptr); }
-};
+#include "util/udev_watcher.hpp"
 
+namespace {
 struct UdevDeviceDeleter {
   void operator()(udev_device *ptr) { udev_device_unref(ptr); }
 };
@@ -42,30 +18,6 @@ struct UdevEnumerateDeleter {
   void operator()(udev_enumerate *ptr) { udev_enumerate_unref(ptr); }
 };
 
-struct UdevMonitorDeleter {
-  void operator()(udev_monitor *ptr) { udev_monitor_unref(ptr); }
-};
-
-void check_eq(int rc, int expected, const char *message = "eq, rc was: ") {
-  if (rc != expected) {
-    throw std::runtime_error(fmt::format(message, rc));
-  }
-}
-
-void check_neq(int rc, int bad_rc, const char *message = "neq, rc was: ") {
-  if (rc == bad_rc) {
-    throw std::runtime_error(fmt::format(message, rc));
-  }
-}
-
-void check0(int rc, const char *message = "rc wasn't 0") { check_eq(rc, 0, message); }
-
-void check_gte(int rc, int gte, const char *message = "rc was: ") {
-  if (rc < gte) {
-    throw std::runtime_error(fmt::format(message, rc));
-  }
-}
-
 void check_nn(const void *ptr, const char *message = "ptr was null") {
   if (ptr == nullptr) {
     throw std::runtime_error(message);
@@ -90,78 +42,54 @@ waybar::modules::Backlight::Backlight(const std::string &id, const Json::Value &
     : ALabel(config, "backlight", id, "{percent}%", 2),
       preferred_device_(config["device"].isString() ? config["device"].asString() : "") {
   // Get initial state
-  {
-    std::unique_ptr<udev, UdevDeleter> udev_check{udev_new()};
-    check_nn(udev_check.get(), "Udev check new failed");
-    enumerate_devices(devices_.begin(), devices_.end(), std::back_inserter(devices_),
-                      udev_check.get());
-    if (devices_.empty()) {
-      throw std::runtime_error("No backlight found");
-    }
-    dp.emit();
+  enumerate_devices(devices_.begin(), devices_.end(), std::back_inserter(devices_),
+                    util::UdevWatcher::instance().context());
+  if (devices_.empty()) {
+    throw std::runtime_error("No backlight found");
   }
-
-  udev_thread_ = [this] {
-    std::unique_ptr<udev, UdevDeleter> udev{udev_new()};
-    check_nn(udev.get(), "Udev new failed");
-
-    std::unique_ptr<udev_monitor, UdevMonitorDeleter> mon{
-        udev_monitor_new_from_netlink(udev.get(), "udev")};
-    check_nn(mon.get(), "udev monitor new failed");
-    check_gte(udev_monitor_filter_add_match_subsystem_devtype(mon.get(), "backlight", nullptr), 0,
-              "udev failed to add monitor filter: ");
-    udev_monitor_enable_receiving(mon.get());
-
-    auto udev_fd = udev_monitor_get_fd(mon.get());
-
-    auto epoll_fd = FileDescriptor{epoll_create1(EPOLL_CLOEXEC)};
-    check_neq(epoll_fd.get(), -1, "epoll init failed: ");
-    epoll_event ctl_event{};
-    ctl_event.events = EPOLLIN;
-    ctl_event.data.fd = udev_fd;
-
-    check0(epoll_ctl(epoll_fd.get(), EPOLL_CTL_ADD, ctl_event.data.fd, &ctl_event),
-           "epoll_ctl failed: {}");
-    epoll_event events[EPOLL_MAX_EVENTS];
-
-    while (udev_thread_.isRunning()) {
-      const int event_count = epoll_wait(epoll_fd.get(), events, EPOLL_MAX_EVENTS,
-                                         std::chrono::milliseconds{interval_}.count());
-      if (!udev_thread_.isRunning()) {
-        break;
-      }
-      decltype(devices_) devices;
-      {
-        std::scoped_lock<std::mutex> lock(udev_thread_mutex_);
-        devices = devices_;
-      }
-      for (int i = 0; i < event_count; ++i) {
-        const auto &event = events[i];
-        check_eq(event.data.fd, udev_fd, "unexpected udev fd");
-        std::unique_ptr<udev_device, UdevDeviceDeleter> dev{udev_monitor_receive_device(mon.get())};
-        check_nn(dev.get(), "epoll dev was null");
-        upsert_device(devices.begin(), devices.end(), std::back_inserter(devices), dev.get());
-      }
-
-      // Refresh state if timed out
-      if (event_count == 0) {
-        enumerate_devices(devices.begin(), devices.end(), std::back_inserter(devices), udev.get());
-      }
-      {
-        std::scoped_lock<std::mutex> lock(udev_thread_mutex_);
-        devices_ = devices;
-      }
-      dp.emit();
-    }
-  };
+  dp.emit();
+
+  // The device list was enumerated once above and is kept fresh from monitor
+  // events alone; the shared watcher hands over everything that was queued on
+  // the socket, so a brightness-key storm is still a single publish.
+  udev_token_ = util::UdevWatcher::instance().subscribe(
+      "backlight", [this](const std::vector<udev_device *> &batch) {
+        decltype(devices_) devices;
+        {
+          std::scoped_lock<std::mutex> lock(udev_mutex_);
+          devices = devices_;
+        }
+        for (udev_device *dev : batch) {
+          const char *action = udev_device_get_action(dev);
+          if (action != nullptr && strcmp(action, "remove") == 0) {
+            const char *name = udev_device_get_sysname(dev);
+            if (name != nullptr) {
+              devices.erase(std::remove_if(devices.begin(), devices.end(),
+                                           [name](const auto &device) {
+                                             return device.name() == name;
+                                           }),
+                            devices.end());
+            }
+          } else {
+            upsert_device(devices.begin(), devices.end(), std::back_inserter(devices), dev);
+          }
+        }
+        {
+          std::scoped_lock<std::mutex> lock(udev_mutex_);
+          devices_ = devices;
+        }
+        dp.emit();
+      });
 }
 
-waybar::modules::Backlight::~Backlight() = default;
+waybar::modules::Backlight::~Backlight() {
+  util::UdevWatcher::instance().unsubscribe(udev_token_);
+}
 
 auto waybar::modules::Backlight::update() -> void {
   decltype(devices_) devices;
   {
-    std::scoped_lock<std::mutex> lock(udev_thread_mutex_);
+    std::scoped_lock<std::mutex> lock(udev_mutex_);
     devices = devices_;
   }
 
@@ -174,14 +102,14 @@ auto waybar::modules::Backlight::update() -> void {
 
     const uint8_t percent =
         best->get_max() == 0 ? 100 : round(best->get_actual() * 100.0f / best->get_max());
-    label_.set_markup(fmt::format(format_, fmt::arg("percent", std::to_string(percent)),
+    setMarkup(fmt::format(format_, fmt::arg("percent", std::to_string(percent)),
                                   fmt::arg("icon", getIcon(percent))));
     getState(percent);
   } else {
     if (!previous_best_.has_value()) {
       return;
     }
-    label_.set_markup("");
+    setMarkup("");
   }
   previous_best_ = best == nullptr ? std::nullopt : std::optional{*best};
   previous_format_ = format_;
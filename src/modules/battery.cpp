@@ -1,6 +1,12 @@
 #include "modules/battery.hpp"
 
+#include <fmt/compile.h>
 #include <spdlog/spdlog.h>
+#include <sys/epoll.h>
+
+#include <cmath>
+
+#include "util/state_cache.hpp"
 
 waybar::modules::Battery::Battery(const std::string& id, const Json::Value& config)
     : ALabel(config, "battery", id, "{capacity}%", 60) {
@@ -21,10 +27,59 @@ waybar::modules::Battery::Battery(const std::string& id, const Json::Value& conf
   }
 
   refreshBatteries();
+
+  // resume the power smoothing from the last run; on a clean restart the
+  // first {time} estimate is as stable as the last one was
+  auto prefix = id.empty() ? std::string("battery") : "battery." + id;
+  power_ema_slot_ = util::StateCache::instance().slot(prefix + ".power_ema");
+  power_ema_dir_slot_ = util::StateCache::instance().slot(prefix + ".power_ema_dir");
+  if (power_ema_slot_ != nullptr && power_ema_dir_slot_ != nullptr &&
+      !std::isnan(*power_ema_slot_)) {
+    smoothed_power_ = *power_ema_slot_;
+    smoothed_status_ = *power_ema_dir_slot_ == 2.0 ? "Charging" : "Discharging";
+    last_power_sample_ = std::chrono::steady_clock::now();
+  }
+
+  resume_listener_ = util::TimerScheduler::instance().addResumeListener(
+      [this](std::chrono::milliseconds) { resumed_.store(true); });
+
+  if (tooltipEnabled()) {
+    // update() captures the values; the fmt call runs on hover only
+    setTooltipGenerator([this] {
+      const auto& ctx = tooltip_ctx_;
+      std::string tooltip_text_default;
+      std::string tooltip_format = "{timeTo}";
+      if (ctx.time_remaining != 0) {
+        std::string time_to =
+            std::string("Time to ") + ((ctx.time_remaining > 0) ? "empty" : "full");
+        tooltip_text_default = time_to + ": " + ctx.time_formatted;
+      } else {
+        tooltip_text_default = ctx.status_pretty;
+      }
+      if (!ctx.state.empty() &&
+          config_["tooltip-format-" + ctx.status + "-" + ctx.state].isString()) {
+        tooltip_format = config_["tooltip-format-" + ctx.status + "-" + ctx.state].asString();
+      } else if (config_["tooltip-format-" + ctx.status].isString()) {
+        tooltip_format = config_["tooltip-format-" + ctx.status].asString();
+      } else if (!ctx.state.empty() && config_["tooltip-format-" + ctx.state].isString()) {
+        tooltip_format = config_["tooltip-format-" + ctx.state].asString();
+      } else if (config_["tooltip-format"].isString()) {
+        tooltip_format = config_["tooltip-format"].asString();
+      }
+      return fmt::format(tooltip_format, fmt::arg("timeTo", tooltip_text_default),
+                         fmt::arg("capacity", ctx.capacity),
+                         fmt::arg("time", ctx.time_formatted));
+    });
+  }
+
   worker();
 }
 
 waybar::modules::Battery::~Battery() {
+  util::TimerScheduler::instance().removeResumeListener(resume_listener_);
+  util::FdReactor::instance().remove(battery_watch_fd_);
+  util::FdReactor::instance().remove(global_watch_fd_);
+
   std::lock_guard<std::mutex> guard(battery_list_mutex_);
 
   if (global_watch >= 0) {
@@ -33,7 +88,7 @@ waybar::modules::Battery::~Battery() {
   close(global_watch_fd_);
 
   for (auto it = batteries_.cbegin(); it != batteries_.cend(); it++) {
-    auto watch_id = (*it).second;
+    auto watch_id = (*it).second->wd;
     if (watch_id >= 0) {
       inotify_rm_watch(battery_watch_fd_, watch_id);
     }
@@ -50,25 +105,34 @@ void waybar::modules::Battery::worker() {
     dp.emit();
     thread_timer_.sleep_for(interval_);
   };
-  thread_ = [this] {
+  // Per-battery uevent changes and plug/unplug events are watched on the shared
+  // reactor instead of two dedicated blocking-read threads.
+  util::FdReactor::instance().add(battery_watch_fd_, EPOLLIN, [this](uint32_t) {
     struct inotify_event event = {0};
     int nbytes = read(battery_watch_fd_, &event, sizeof(event));
     if (nbytes != sizeof(event) || event.mask & IN_IGNORED) {
-      thread_.stop();
+      util::FdReactor::instance().remove(battery_watch_fd_);
+      return;
+    }
+    // Our own uevent reads raise IN_ACCESS too; ignore events right after
+    // one so an update cannot re-trigger itself forever.
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    if (now - std::chrono::steady_clock::duration(last_uevent_read_.load()) <
+        std::chrono::milliseconds(50)) {
       return;
     }
     dp.emit();
-  };
-  thread_battery_update_ = [this] {
+  });
+  util::FdReactor::instance().add(global_watch_fd_, EPOLLIN, [this](uint32_t) {
     struct inotify_event event = {0};
     int nbytes = read(global_watch_fd_, &event, sizeof(event));
     if (nbytes != sizeof(event) || event.mask & IN_IGNORED) {
-      thread_.stop();
+      util::FdReactor::instance().remove(global_watch_fd_);
       return;
     }
     refreshBatteries();
     dp.emit();
-  };
+  });
 }
 
 void waybar::modules::Battery::refreshBatteries() {
@@ -104,7 +168,7 @@ void waybar::modules::Battery::refreshBatteries() {
             if (wd < 0) {
               throw std::runtime_error("Could not watch events for " + node.path().string());
             }
-            batteries_[node.path()] = wd;
+            batteries_[node.path()] = std::make_unique<BatterySource>(node.path(), wd);
           }
         }
       }
@@ -128,7 +192,7 @@ void waybar::modules::Battery::refreshBatteries() {
   // Remove any batteries that are no longer present and unwatch them
   for (auto const& check : check_map) {
     if (!check.second) {
-      auto watch_id = batteries_[check.first];
+      auto watch_id = batteries_[check.first]->wd;
       if (watch_id >= 0) {
         inotify_rm_watch(battery_watch_fd_, watch_id);
       }
@@ -137,6 +201,52 @@ void waybar::modules::Battery::refreshBatteries() {
   }
 }
 
+waybar::modules::Battery::UeventValues waybar::modules::Battery::parseUevent(
+    std::string_view contents) {
+  UeventValues values;
+  constexpr std::string_view prefix = "POWER_SUPPLY_";
+  size_t pos = 0;
+  while (pos < contents.size()) {
+    auto eol = contents.find('\n', pos);
+    if (eol == std::string_view::npos) {
+      eol = contents.size();
+    }
+    auto line = contents.substr(pos, eol - pos);
+    pos = eol + 1;
+    if (line.compare(0, prefix.size(), prefix) != 0) {
+      continue;
+    }
+    auto eq = line.find('=', prefix.size());
+    if (eq == std::string_view::npos) {
+      continue;
+    }
+    auto key = line.substr(prefix.size(), eq - prefix.size());
+    auto value = line.substr(eq + 1);
+    if (key == "STATUS") {
+      values.status = std::string(value);
+      continue;
+    }
+    int64_t* field = key == "CAPACITY"             ? &values.capacity
+                     : key == "VOLTAGE_NOW"        ? &values.voltage_now
+                     : key == "VOLTAGE_AVG"        ? &values.voltage_avg
+                     : key == "CURRENT_NOW"        ? &values.current_now
+                     : key == "CURRENT_AVG"        ? &values.current_avg
+                     : key == "CHARGE_NOW"         ? &values.charge_now
+                     : key == "CHARGE_FULL"        ? &values.charge_full
+                     : key == "CHARGE_FULL_DESIGN" ? &values.charge_full_design
+                     : key == "ENERGY_NOW"         ? &values.energy_now
+                     : key == "ENERGY_FULL"        ? &values.energy_full
+                     : key == "ENERGY_FULL_DESIGN" ? &values.energy_full_design
+                     : key == "POWER_NOW"          ? &values.power_now
+                                                   : nullptr;
+    if (field != nullptr) {
+      const char* p = value.data();
+      *field = static_cast<int64_t>(util::parseUnsigned(p, value.data() + value.size()));
+    }
+  }
+  return values;
+}
+
 // Unknown > Full > Not charging > Discharging > Charging
 static bool status_gt(const std::string& a, const std::string& b) {
   if (a == b)
@@ -163,54 +273,45 @@ const std::tuple<uint8_t, float, std::string, float> waybar::modules::Battery::g
     uint32_t total_capacity{0};
     std::string status = "Unknown";
     for (auto const& item : batteries_) {
-      auto bat = item.first;
+      // One pread() on the cached uevent fd carries every key at once; the
+      // old code opened half a dozen sysfs files per battery per tick.
+      auto values = parseUevent(item.second->uevent.read());
       uint32_t power_now;
       uint32_t energy_full;
       uint32_t energy_now;
       uint32_t energy_full_design;
       uint32_t capacity{0};
-      std::string _status;
-      std::getline(std::ifstream(bat / "status"), _status);
+      const std::string& _status = values.status;
 
       // Some battery will report current and charge in μA/μAh.
       // Scale these by the voltage to get μW/μWh.
-      if (fs::exists(bat / "current_now") || fs::exists(bat / "current_avg")) {
-        uint32_t voltage_now;
-        uint32_t current_now;
-        uint32_t charge_now;
-        uint32_t charge_full;
-        uint32_t charge_full_design;
+      if (values.current_now >= 0 || values.current_avg >= 0) {
         // Some batteries have only *_avg, not *_now
-        if (fs::exists(bat / "voltage_now"))
-          std::ifstream(bat / "voltage_now") >> voltage_now;
-        else
-          std::ifstream(bat / "voltage_avg") >> voltage_now;
-        if (fs::exists(bat / "current_now"))
-          std::ifstream(bat / "current_now") >> current_now;
-        else
-          std::ifstream(bat / "current_avg") >> current_now;
-        std::ifstream(bat / "charge_full") >> charge_full;
-        std::ifstream(bat / "charge_full_design") >> charge_full_design;
-        if (fs::exists(bat / "charge_now"))
-          std::ifstream(bat / "charge_now") >> charge_now;
-        else {
+        uint64_t voltage_now = values.voltage_now >= 0 ? values.voltage_now
+                               : values.voltage_avg >= 0 ? values.voltage_avg : 0;
+        uint64_t current_now = values.current_now >= 0 ? values.current_now : values.current_avg;
+        uint64_t charge_full = values.charge_full >= 0 ? values.charge_full : 0;
+        uint64_t charge_full_design =
+            values.charge_full_design >= 0 ? values.charge_full_design : 0;
+        uint64_t charge_now;
+        if (values.charge_now >= 0) {
+          charge_now = values.charge_now;
+        } else {
           // charge_now is missing on some systems, estimate using capacity.
-          uint32_t capacity;
-          std::ifstream(bat / "capacity") >> capacity;
-          charge_now = (capacity * charge_full) / 100;
+          charge_now = (std::max<int64_t>(values.capacity, 0) * charge_full) / 100;
         }
-        power_now = ((uint64_t)current_now * (uint64_t)voltage_now) / 1000000;
-        energy_now = ((uint64_t)charge_now * (uint64_t)voltage_now) / 1000000;
-        energy_full = ((uint64_t)charge_full * (uint64_t)voltage_now) / 1000000;
-        energy_full_design = ((uint64_t)charge_full_design * (uint64_t)voltage_now) / 1000000;
+        power_now = (current_now * voltage_now) / 1000000;
+        energy_now = (charge_now * voltage_now) / 1000000;
+        energy_full = (charge_full * voltage_now) / 1000000;
+        energy_full_design = (charge_full_design * voltage_now) / 1000000;
       }  // Gamepads such as PS Dualshock provide the only capacity
-      else if (fs::exists(bat / "energy_now") && fs::exists(bat / "energy_full")) {
-        std::ifstream(bat / "power_now") >> power_now;
-        std::ifstream(bat / "energy_now") >> energy_now;
-        std::ifstream(bat / "energy_full") >> energy_full;
-        std::ifstream(bat / "energy_full_design") >> energy_full_design;
+      else if (values.energy_now >= 0 && values.energy_full >= 0) {
+        power_now = values.power_now >= 0 ? values.power_now : 0;
+        energy_now = values.energy_now;
+        energy_full = values.energy_full;
+        energy_full_design = values.energy_full_design >= 0 ? values.energy_full_design : 0;
       } else {
-        std::ifstream(bat / "capacity") >> capacity;
+        capacity = std::max<int64_t>(values.capacity, 0);
         power_now = 0;
         energy_now = 0;
         energy_full = 0;
@@ -227,6 +328,7 @@ const std::tuple<uint8_t, float, std::string, float> waybar::modules::Battery::g
       total_energy_full_design += energy_full_design;
       total_capacity += capacity;
     }
+    last_uevent_read_.store(std::chrono::steady_clock::now().time_since_epoch().count());
     if (!adapter_.empty() && status == "Discharging") {
       bool online;
       std::ifstream(adapter_ / "online") >> online;
@@ -234,11 +336,44 @@ const std::tuple<uint8_t, float, std::string, float> waybar::modules::Battery::g
         status = "Plugged";
       }
     }
+    // Smooth the draw across updates: a browser tab spinning up during one
+    // sample would otherwise halve the {time} estimate for a minute. The
+    // time-aware exponential average converges identically however long the
+    // configured interval is, so a stable estimate costs no extra reads.
+    // The average restarts whenever the charge direction flips, and after a
+    // suspend: energy drained while the smoothing clock stood still, so the
+    // old average describes a charge level that no longer exists.
+    if (resumed_.exchange(false)) {
+      smoothed_power_ = -1.0f;
+    }
+    if ((status == "Discharging" || status == "Charging") && total_power != 0) {
+      auto sample_time = std::chrono::steady_clock::now();
+      if (smoothed_power_ < 0.0f || status != smoothed_status_) {
+        smoothed_power_ = total_power;
+      } else {
+        float dt = std::chrono::duration<float>(sample_time - last_power_sample_).count();
+        float alpha = 1.0f - std::exp(-dt / power_smoothing_tau_);
+        smoothed_power_ += alpha * ((float)total_power - smoothed_power_);
+      }
+      last_power_sample_ = sample_time;
+      smoothed_status_ = status;
+      if (power_ema_slot_ != nullptr && power_ema_dir_slot_ != nullptr) {
+        *power_ema_slot_ = smoothed_power_;
+        *power_ema_dir_slot_ = status == "Charging" ? 2.0 : 1.0;
+      }
+    } else {
+      smoothed_power_ = -1.0f;
+      if (power_ema_slot_ != nullptr) {
+        *power_ema_slot_ = NAN;
+      }
+    }
+    float power_for_estimate = smoothed_power_ > 0.0f ? smoothed_power_ : (float)total_power;
+
     float time_remaining = 0;
     if (status == "Discharging" && total_power != 0) {
-      time_remaining = (float)total_energy / total_power;
+      time_remaining = (float)total_energy / power_for_estimate;
     } else if (status == "Charging" && total_power != 0) {
-      time_remaining = -(float)(total_energy_full - total_energy) / total_power;
+      time_remaining = -(float)(total_energy_full - total_energy) / power_for_estimate;
       if (time_remaining > 0.0f) {
         // If we've turned positive it means the battery is past 100% and so
         // just report that as no time remaining
@@ -311,6 +446,24 @@ const std::string waybar::modules::Battery::formatTimeRemaining(float hoursRemai
   return fmt::format(format, fmt::arg("H", full_hours), fmt::arg("M", minutes));
 }
 
+const std::string& waybar::modules::Battery::getStatusFormat(const std::string& status,
+                                                             const std::string& state) {
+  auto& per_status = status_format_cache_[status];
+  auto it = per_status.find(state);
+  if (it == per_status.end()) {
+    std::optional<std::string> format;
+    if (!state.empty() && config_["format-" + status + "-" + state].isString()) {
+      format = config_["format-" + status + "-" + state].asString();
+    } else if (config_["format-" + status].isString()) {
+      format = config_["format-" + status].asString();
+    } else if (!state.empty() && config_["format-" + state].isString()) {
+      format = config_["format-" + state].asString();
+    }
+    it = per_status.emplace(state, std::move(format)).first;
+  }
+  return it->second ? *it->second : format_;
+}
+
 auto waybar::modules::Battery::update() -> void {
   if (batteries_.empty()) {
     event_box_.hide();
@@ -324,49 +477,29 @@ auto waybar::modules::Battery::update() -> void {
   // Transform to lowercase  and replace space with dash
   std::transform(status.begin(), status.end(), status.begin(),
                  [](char ch) { return ch == ' ' ? '-' : std::tolower(ch); });
-  auto format = format_;
   auto state = getState(capacity, true);
   auto time_remaining_formatted = formatTimeRemaining(time_remaining);
   if (tooltipEnabled()) {
-    std::string tooltip_text_default;
-    std::string tooltip_format = "{timeTo}";
-    if (time_remaining != 0) {
-      std::string time_to = std::string("Time to ") + ((time_remaining > 0) ? "empty" : "full");
-      tooltip_text_default = time_to + ": " + time_remaining_formatted;
-    } else {
-      tooltip_text_default = status_pretty;
-    }
-    if (!state.empty() && config_["tooltip-format-" + status + "-" + state].isString()) {
-      tooltip_format = config_["tooltip-format-" + status + "-" + state].asString();
-    } else if (config_["tooltip-format-" + status].isString()) {
-      tooltip_format = config_["tooltip-format-" + status].asString();
-    } else if (!state.empty() && config_["tooltip-format-" + state].isString()) {
-      tooltip_format = config_["tooltip-format-" + state].asString();
-    } else if (config_["tooltip-format"].isString()) {
-      tooltip_format = config_["tooltip-format"].asString();
-    }
-    label_.set_tooltip_text(fmt::format(tooltip_format, fmt::arg("timeTo", tooltip_text_default),
-                                        fmt::arg("capacity", capacity),
-                                        fmt::arg("time", time_remaining_formatted)));
+    tooltip_ctx_ = {capacity, time_remaining, status, status_pretty, state,
+                    time_remaining_formatted};
   }
   if (!old_status_.empty()) {
     label_.get_style_context()->remove_class(old_status_);
   }
   label_.get_style_context()->add_class(status);
   old_status_ = status;
-  if (!state.empty() && config_["format-" + status + "-" + state].isString()) {
-    format = config_["format-" + status + "-" + state].asString();
-  } else if (config_["format-" + status].isString()) {
-    format = config_["format-" + status].asString();
-  } else if (!state.empty() && config_["format-" + state].isString()) {
-    format = config_["format-" + state].asString();
-  }
+  const auto& format = getStatusFormat(status, state);
   if (format.empty()) {
     event_box_.hide();
+  } else if (format == "{capacity}%") {
+    // The out-of-the-box format, compiled at build time; the icon list and
+    // the runtime template parse are skipped entirely.
+    event_box_.show();
+    setMarkup(fmt::format(FMT_COMPILE("{}%"), static_cast<unsigned>(capacity)));
   } else {
     event_box_.show();
     auto icons = std::vector<std::string>{status + "-" + state, status, state};
-    label_.set_markup(fmt::format(format, fmt::arg("capacity", capacity), fmt::arg("power", power),
+    setMarkup(fmt::format(format, fmt::arg("capacity", capacity), fmt::arg("power", power),
                                   fmt::arg("icon", getIcon(capacity, icons)),
                                   fmt::arg("time", time_remaining_formatted)));
   }
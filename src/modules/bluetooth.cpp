@@ -1,30 +1,254 @@
 #include "modules/bluetooth.hpp"
 
 #include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include <cstring>
+
+#include "util/dbus_manager.hpp"
+
+namespace {
+
+// carries the async GetManagedObjects reply back to the module; `cancellable`
+// outlives the module and tells the callback whether `self` may be touched
+struct CallContext {
+  waybar::modules::Bluetooth* self;
+  ::GCancellable* cancellable;
+};
+
+}  // namespace
 
 waybar::modules::Bluetooth::Bluetooth(const std::string& id, const Json::Value& config)
     : ALabel(config, "bluetooth", id, "{icon}", 10), rfkill_{RFKILL_TYPE_BLUETOOTH} {
   rfkill_.on_update.connect(sigc::hide(sigc::mem_fun(*this, &Bluetooth::update)));
+
+  bus_ = util::DBusManager::instance().raw(Gio::DBus::BUS_TYPE_SYSTEM);
+  if (bus_ == nullptr) {
+    spdlog::warn("bluetooth: no system bus, connection info unavailable");
+    return;
+  }
+  cancellable_ = g_cancellable_new();
+
+  signal_subs_.push_back(g_dbus_connection_signal_subscribe(
+      bus_, "org.bluez", "org.freedesktop.DBus.ObjectManager", "InterfacesAdded", nullptr, nullptr,
+      G_DBUS_SIGNAL_FLAGS_NONE, &Bluetooth::onInterfacesAdded, this, nullptr));
+  signal_subs_.push_back(g_dbus_connection_signal_subscribe(
+      bus_, "org.bluez", "org.freedesktop.DBus.ObjectManager", "InterfacesRemoved", nullptr,
+      nullptr, G_DBUS_SIGNAL_FLAGS_NONE, &Bluetooth::onInterfacesRemoved, this, nullptr));
+  // arg0 is the interface whose properties changed; two filtered subscriptions
+  // keep unrelated BlueZ chatter (discovery RSSI updates on Adapter1, media
+  // transports) out of the process
+  for (const char* iface : {"org.bluez.Device1", "org.bluez.Battery1"}) {
+    signal_subs_.push_back(g_dbus_connection_signal_subscribe(
+        bus_, "org.bluez", "org.freedesktop.DBus.Properties", "PropertiesChanged", nullptr, iface,
+        G_DBUS_SIGNAL_FLAGS_NONE, &Bluetooth::onPropertiesChanged, this, nullptr));
+  }
+
+  // one full dump at startup; the signals keep the table current afterwards
+  g_dbus_connection_call(bus_, "org.bluez", "/", "org.freedesktop.DBus.ObjectManager",
+                         "GetManagedObjects", nullptr, G_VARIANT_TYPE("(a{oa{sa{sv}}})"),
+                         G_DBUS_CALL_FLAGS_NONE, -1, cancellable_, &Bluetooth::onManagedObjects,
+                         new CallContext{this, G_CANCELLABLE(g_object_ref(cancellable_))});
+}
+
+waybar::modules::Bluetooth::~Bluetooth() {
+  for (guint sub : signal_subs_) {
+    g_dbus_connection_signal_unsubscribe(bus_, sub);
+  }
+  if (cancellable_ != nullptr) {
+    g_cancellable_cancel(cancellable_);
+    g_object_unref(cancellable_);
+  }
+}
+
+void waybar::modules::Bluetooth::onManagedObjects(::GObject* source, ::GAsyncResult* result,
+                                                  void* data) {
+  auto* ctx = static_cast<CallContext*>(data);
+  GError* error = nullptr;
+  auto* reply = g_dbus_connection_call_finish(G_DBUS_CONNECTION(source), result, &error);
+  if (error != nullptr) {
+    if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+      spdlog::warn("bluetooth: GetManagedObjects failed: {}", error->message);
+    }
+    g_error_free(error);
+  } else if (!g_cancellable_is_cancelled(ctx->cancellable)) {
+    auto* self = ctx->self;
+    GVariantIter* objects;
+    g_variant_get(reply, "(a{oa{sa{sv}}})", &objects);
+    const gchar* path;
+    GVariantIter* interfaces;
+    while (g_variant_iter_loop(objects, "{&oa{sa{sv}}}", &path, &interfaces)) {
+      const gchar* iface;
+      GVariant* props;
+      while (g_variant_iter_loop(interfaces, "{&s@a{sv}}", &iface, &props)) {
+        self->applyProperties(path, iface, props);
+      }
+    }
+    g_variant_iter_free(objects);
+    self->dp.emit();
+  }
+  if (reply != nullptr) {
+    g_variant_unref(reply);
+  }
+  g_object_unref(ctx->cancellable);
+  delete ctx;
+}
+
+void waybar::modules::Bluetooth::onInterfacesAdded(::GDBusConnection*, const gchar*, const gchar*,
+                                                   const gchar*, const gchar*, ::GVariant* params,
+                                                   void* data) {
+  auto* self = static_cast<Bluetooth*>(data);
+  const gchar* path;
+  GVariantIter* interfaces;
+  g_variant_get(params, "(&oa{sa{sv}})", &path, &interfaces);
+  const gchar* iface;
+  GVariant* props;
+  bool changed = false;
+  while (g_variant_iter_loop(interfaces, "{&s@a{sv}}", &iface, &props)) {
+    changed |= self->applyProperties(path, iface, props);
+  }
+  g_variant_iter_free(interfaces);
+  if (changed) {
+    self->dp.emit();
+  }
+}
+
+void waybar::modules::Bluetooth::onInterfacesRemoved(::GDBusConnection*, const gchar*, const gchar*,
+                                                     const gchar*, const gchar*, ::GVariant* params,
+                                                     void* data) {
+  auto* self = static_cast<Bluetooth*>(data);
+  const gchar* path;
+  GVariantIter* interfaces;
+  g_variant_get(params, "(&oas)", &path, &interfaces);
+  const gchar* iface;
+  bool changed = false;
+  while (g_variant_iter_loop(interfaces, "&s", &iface)) {
+    if (strcmp(iface, "org.bluez.Device1") == 0) {
+      changed |= self->devices_.erase(path) > 0;
+    } else if (strcmp(iface, "org.bluez.Battery1") == 0) {
+      auto it = self->devices_.find(path);
+      if (it != self->devices_.end() && it->second.battery != -1) {
+        it->second.battery = -1;
+        changed = true;
+      }
+    }
+  }
+  g_variant_iter_free(interfaces);
+  if (changed) {
+    self->dp.emit();
+  }
+}
+
+void waybar::modules::Bluetooth::onPropertiesChanged(::GDBusConnection*, const gchar*,
+                                                     const gchar* object_path, const gchar*,
+                                                     const gchar*, ::GVariant* params, void* data) {
+  auto* self = static_cast<Bluetooth*>(data);
+  const gchar* iface;
+  GVariant* props;
+  GVariantIter* invalidated;
+  g_variant_get(params, "(&s@a{sv}as)", &iface, &props, &invalidated);
+  g_variant_iter_free(invalidated);
+  if (self->applyProperties(object_path, iface, props)) {
+    self->dp.emit();
+  }
+  g_variant_unref(props);
+}
+
+bool waybar::modules::Bluetooth::applyProperties(const char* path, const char* interface,
+                                                 ::GVariant* props) {
+  bool changed = false;
+  if (strcmp(interface, "org.bluez.Device1") == 0) {
+    auto& dev = devices_[path];
+    GVariant* v = g_variant_lookup_value(props, "Connected", G_VARIANT_TYPE_BOOLEAN);
+    if (v != nullptr) {
+      bool connected = g_variant_get_boolean(v) != FALSE;
+      changed |= connected != dev.connected;
+      dev.connected = connected;
+      g_variant_unref(v);
+    }
+    v = g_variant_lookup_value(props, "Alias", G_VARIANT_TYPE_STRING);
+    if (v != nullptr) {
+      const char* alias = g_variant_get_string(v, nullptr);
+      changed |= dev.alias != alias;
+      dev.alias = alias;
+      g_variant_unref(v);
+    }
+  } else if (strcmp(interface, "org.bluez.Battery1") == 0) {
+    GVariant* v = g_variant_lookup_value(props, "Percentage", G_VARIANT_TYPE_BYTE);
+    if (v != nullptr) {
+      int battery = g_variant_get_byte(v);
+      auto& dev = devices_[path];
+      changed |= battery != dev.battery;
+      dev.battery = battery;
+      g_variant_unref(v);
+    }
+  }
+  return changed;
 }
 
 auto waybar::modules::Bluetooth::update() -> void {
-  std::string status = rfkill_.getState() ? "disabled" : "enabled";
+  int num_connections = 0;
+  const Device* shown = nullptr;
+  for (const auto& [path, dev] : devices_) {
+    if (!dev.connected) {
+      continue;
+    }
+    ++num_connections;
+    // prefer a device that reports a battery for the format fields
+    if (shown == nullptr || (shown->battery == -1 && dev.battery != -1)) {
+      shown = &dev;
+    }
+  }
+
+  std::string status = rfkill_.getState() ? "disabled"
+                       : num_connections > 0 ? "connected"
+                                             : "enabled";
 
-  label_.set_markup(
-      fmt::format(format_, fmt::arg("status", status), fmt::arg("icon", getIcon(0, status))));
-  if (status == "disabled") {
-    label_.get_style_context()->add_class("disabled");
-  } else {
-    label_.get_style_context()->remove_class("disabled");
+  std::string format = getFormatForState(status);
+  if (status == "connected" && shown != nullptr && shown->battery != -1 &&
+      config_["format-connected-battery"].isString()) {
+    format = config_["format-connected-battery"].asString();
+  }
+
+  setMarkup(fmt::format(
+      format, fmt::arg("status", status), fmt::arg("icon", getIcon(0, status)),
+      fmt::arg("num_connections", num_connections),
+      fmt::arg("device_alias", shown != nullptr ? shown->alias : ""),
+      fmt::arg("device_battery_percentage", shown != nullptr && shown->battery != -1
+                                                ? shown->battery
+                                                : 0)));
+  if (status != status_class_) {
+    if (!status_class_.empty()) {
+      label_.get_style_context()->remove_class(status_class_);
+    }
+    label_.get_style_context()->add_class(status);
+    status_class_ = status;
   }
 
   if (tooltipEnabled()) {
     if (config_["tooltip-format"].isString()) {
       auto tooltip_format = config_["tooltip-format"].asString();
-      auto tooltip_text = fmt::format(tooltip_format, status, fmt::arg("status", status));
-      label_.set_tooltip_text(tooltip_text);
+      auto tooltip_text =
+          fmt::format(tooltip_format, status, fmt::arg("status", status),
+                      fmt::arg("num_connections", num_connections),
+                      fmt::arg("device_alias", shown != nullptr ? shown->alias : ""),
+                      fmt::arg("device_battery_percentage",
+                               shown != nullptr && shown->battery != -1 ? shown->battery : 0));
+      setTooltipText(tooltip_text);
+    } else if (num_connections > 0) {
+      std::string text;
+      for (const auto& [path, dev] : devices_) {
+        if (!dev.connected) {
+          continue;
+        }
+        if (!text.empty()) {
+          text += '\n';
+        }
+        text += dev.battery != -1 ? fmt::format("{} ({}%)", dev.alias, dev.battery) : dev.alias;
+      }
+      setTooltipText(text);
     } else {
-      label_.set_tooltip_text(status);
+      setTooltipText(status);
     }
   }
 }
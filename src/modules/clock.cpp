@@ -9,8 +9,10 @@
 
 #include <ctime>
 #include <sstream>
+#include <thread>
 #include <type_traits>
 
+#include "util/clock_interval.hpp"
 #include "util/ustring_clen.hpp"
 #include "util/waybar_time.hpp"
 #ifdef HAVE_LANGINFO_1STDAY
@@ -21,29 +23,42 @@
 using waybar::waybar_time;
 
 waybar::modules::Clock::Clock(const std::string& id, const Json::Value& config)
-    : ALabel(config, "clock", id, "{:%H:%M}", 60, false, false, true),
+    : ALabel(config, "clock", id, "{:%H:%M}", util::clock_default_interval(config), false, false,
+             true),
       current_time_zone_idx_(0),
       is_calendar_in_tooltip_(false),
       is_timezoned_list_in_tooltip_(false) {
   if (config_["timezones"].isArray() && !config_["timezones"].empty()) {
     for (const auto& zone_name : config_["timezones"]) {
       if (!zone_name.isString() || zone_name.asString().empty()) {
-        time_zones_.push_back(nullptr);
+        time_zone_names_.emplace_back();
         continue;
       }
-      time_zones_.push_back(date::locate_zone(zone_name.asString()));
+      time_zone_names_.push_back(zone_name.asString());
     }
   } else if (config_["timezone"].isString() && !config_["timezone"].asString().empty()) {
-    time_zones_.push_back(date::locate_zone(config_["timezone"].asString()));
+    time_zone_names_.push_back(config_["timezone"].asString());
   }
 
-  // If all timezones are parsed and no one is good, add nullptr to the timezones vector, to mark
-  // that local time should be shown.
-  if (!time_zones_.size()) {
-    time_zones_.push_back(nullptr);
+  // An empty name means local time should be shown.
+  if (!time_zone_names_.size()) {
+    time_zone_names_.emplace_back();
   }
+  // Zone pointers are resolved on first use; parsing tzdata costs ~100ms, so
+  // warm the database off the construction path instead of stalling startup
+  // (or the first tooltip) on it.
+  time_zones_.assign(time_zone_names_.size(), nullptr);
+  std::thread([] {
+    try {
+      date::get_tzdb();
+      date::current_zone();
+    } catch (const std::exception& e) {
+      spdlog::warn("Timezone DB preload: {}", e.what());
+    }
+  }).detach();
 
-  if (!is_timezone_fixed()) {
+  // checked on the name so construction never resolves a zone itself
+  if (time_zone_names_[current_time_zone_idx_].empty()) {
     spdlog::warn(
         "As using a timezone, some format args may be missing as the date library haven't got a "
         "release since 2018.");
@@ -70,6 +85,12 @@ waybar::modules::Clock::Clock(const std::string& id, const Json::Value& config)
     locale_ = std::locale("");
   }
 
+  if (tooltipEnabled() && config_["tooltip-format"].isString()) {
+    // composed on hover only; the calendar is by far the most expensive
+    // text this module can render and it was rebuilt every tick
+    setTooltipGenerator([this] { return tooltip_text(); }, true);
+  }
+
   thread_ = [this] {
     dp.emit();
     auto now = std::chrono::system_clock::now();
@@ -79,13 +100,32 @@ waybar::modules::Clock::Clock(const std::string& id, const Json::Value& config)
   };
 }
 
+const date::time_zone* waybar::modules::Clock::zone_at(size_t idx) {
+  if (time_zones_[idx] == nullptr && !time_zone_names_[idx].empty()) {
+    try {
+      time_zones_[idx] = date::locate_zone(time_zone_names_[idx]);
+    } catch (const std::exception& e) {
+      spdlog::warn("Unknown timezone {}: {}", time_zone_names_[idx], e.what());
+      // fall back to local time instead of retrying every update
+      time_zone_names_[idx].clear();
+    }
+  }
+  return time_zones_[idx];
+}
+
 const date::time_zone* waybar::modules::Clock::current_timezone() {
-  return time_zones_[current_time_zone_idx_] ? time_zones_[current_time_zone_idx_]
-                                             : date::current_zone();
+  auto* zone = zone_at(current_time_zone_idx_);
+  if (zone != nullptr) {
+    return zone;
+  }
+  if (local_zone_ == nullptr) {
+    local_zone_ = date::current_zone();
+  }
+  return local_zone_;
 }
 
 bool waybar::modules::Clock::is_timezone_fixed() {
-  return time_zones_[current_time_zone_idx_] != nullptr;
+  return zone_at(current_time_zone_idx_) != nullptr;
 }
 
 auto waybar::modules::Clock::update() -> void {
@@ -102,30 +142,31 @@ auto waybar::modules::Clock::update() -> void {
   } else {
     text = fmt::format(format_, wtime);
   }
-  label_.set_markup(text);
-
-  if (tooltipEnabled()) {
-    if (config_["tooltip-format"].isString()) {
-      std::string calendar_lines = "";
-      std::string timezoned_time_lines = "";
-      if (is_calendar_in_tooltip_) {
-        calendar_lines = calendar_text(wtime);
-      }
-      if (is_timezoned_list_in_tooltip_) {
-        timezoned_time_lines = timezones_text(&now);
-      }
-      auto tooltip_format = config_["tooltip-format"].asString();
-      text =
-          fmt::format(tooltip_format, wtime, fmt::arg(kCalendarPlaceholder.c_str(), calendar_lines),
-                      fmt::arg(KTimezonedTimeListPlaceholder.c_str(), timezoned_time_lines));
-      label_.set_tooltip_markup(text);
-    }
-  }
+  setMarkup(text);
 
   // Call parent update
   ALabel::update();
 }
 
+auto waybar::modules::Clock::tooltip_text() -> std::string {
+  auto time_zone = current_timezone();
+  auto now = std::chrono::system_clock::now();
+  waybar_time wtime = {locale_,
+                       date::make_zoned(time_zone, date::floor<std::chrono::seconds>(now))};
+  std::string calendar_lines = "";
+  std::string timezoned_time_lines = "";
+  if (is_calendar_in_tooltip_) {
+    calendar_lines = calendar_text(wtime);
+  }
+  if (is_timezoned_list_in_tooltip_) {
+    timezoned_time_lines = timezones_text(&now);
+  }
+  auto tooltip_format = config_["tooltip-format"].asString();
+  return fmt::format(tooltip_format, wtime,
+                     fmt::arg(kCalendarPlaceholder.c_str(), calendar_lines),
+                     fmt::arg(KTimezonedTimeListPlaceholder.c_str(), timezoned_time_lines));
+}
+
 bool waybar::modules::Clock::handleScroll(GdkEventScroll* e) {
   // defer to user commands if set
   if (config_["on-scroll-up"].isString() || config_["on-scroll-down"].isString()) {
@@ -163,6 +204,47 @@ auto waybar::modules::Clock::calendar_text(const waybar_time& wtime) -> std::str
   const date::year_month ym(ymd.year(), ymd.month());
   const auto curr_day = ymd.day();
 
+  // The month grid is rendered once per (year, month); a day change only
+  // splices the "today" highlight into the stable buffer
+  const auto& month = cached_month(ym);
+  const auto [offset, length] = month.day_spans[unsigned(curr_day) - 1];
+  std::string today;
+  if (config_["today-format"].isString()) {
+    auto today_format = config_["today-format"].asString();
+    today = fmt::format(today_format, date::format("%e", curr_day));
+  } else {
+    today = "<b><u>" + date::format("%e", curr_day) + "</u></b>";
+  }
+  std::string result;
+  result.reserve(month.grid.size() + today.size());
+  result.append(month.grid, 0, offset);
+  result += today;
+  result.append(month.grid, offset + length, std::string::npos);
+
+  cached_calendar_ymd_ = ymd;
+  cached_calendar_text_ = result;
+  return result;
+}
+
+auto waybar::modules::Clock::cached_month(const date::year_month& ym) -> const CachedMonth& {
+  auto it = month_cache_.find(ym);
+  if (it == month_cache_.end()) {
+    if (month_cache_.size() > 6) {
+      month_cache_.clear();
+    }
+    it = month_cache_.emplace(ym, render_month(ym)).first;
+    // pre-render the neighbours so stepping across a month boundary (or
+    // scrolling through months) never renders on demand
+    auto prev = ym - date::months(1);
+    auto next = ym + date::months(1);
+    month_cache_.emplace(prev, render_month(prev));
+    month_cache_.emplace(next, render_month(next));
+  }
+  return it->second;
+}
+
+auto waybar::modules::Clock::render_month(const date::year_month& ym) -> CachedMonth {
+  CachedMonth month;
   std::stringstream os;
   const auto first_dow = first_day_of_week();
   weekdays_header(first_dow, os);
@@ -180,22 +262,14 @@ auto waybar::modules::Clock::calendar_text(const waybar_time& wtime) -> std::str
     } else if (unsigned(d) != 1) {
       os << '\n';
     }
-    if (d == curr_day) {
-      if (config_["today-format"].isString()) {
-        auto today_format = config_["today-format"].asString();
-        os << fmt::format(today_format, date::format("%e", d));
-      } else {
-        os << "<b><u>" << date::format("%e", d) << "</u></b>";
-      }
-    } else {
-      os << date::format("%e", d);
-    }
+    auto cell = date::format("%e", d);
+    month.day_spans[unsigned(d) - 1] = {static_cast<uint16_t>(os.tellp()),
+                                        static_cast<uint16_t>(cell.size())};
+    os << cell;
   }
 
-  auto result = os.str();
-  cached_calendar_ymd_ = ymd;
-  cached_calendar_text_ = result;
-  return result;
+  month.grid = os.str();
+  return month;
 }
 
 auto waybar::modules::Clock::weekdays_header(const date::weekday& first_dow, std::ostream& os)
@@ -228,9 +302,12 @@ auto waybar::modules::Clock::timezones_text(std::chrono::system_clock::time_poin
     if (static_cast<int>(time_zone_idx) == current_time_zone_idx_) {
       continue;
     }
-    const date::time_zone* timezone = time_zones_[time_zone_idx];
+    const date::time_zone* timezone = zone_at(time_zone_idx);
     if (!timezone) {
-      timezone = date::current_zone();
+      if (local_zone_ == nullptr) {
+        local_zone_ = date::current_zone();
+      }
+      timezone = local_zone_;
     }
     wtime = {locale_, date::make_zoned(timezone, date::floor<std::chrono::seconds>(*now))};
     os << fmt::format(format_, wtime) << "\n";
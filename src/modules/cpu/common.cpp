@@ -8,32 +8,60 @@
 #else
 #include <fmt/core.h>
 #endif
+#include <fmt/compile.h>
 
 waybar::modules::Cpu::Cpu(const std::string& id, const Json::Value& config)
     : ALabel(config, "cpu", id, "{usage}%", 10) {
-  thread_ = [this] {
-    dp.emit();
-    thread_.sleep_for(interval_);
-  };
+  worker_.start(interval_, [this] { dp.emit(); });
+  enableAdaptiveInterval(worker_);
+  wants_frequency_ = formatFieldReferenced("max_frequency") ||
+                     formatFieldReferenced("min_frequency") ||
+                     formatFieldReferenced("avg_frequency");
+}
+
+void waybar::modules::Cpu::onSuspended(bool suspended) {
+  suspended ? worker_.pause() : worker_.resume();
 }
 
 auto waybar::modules::Cpu::update() -> void {
   // TODO: as creating dynamic fmt::arg arrays is buggy we have to calc both
   auto cpu_load = getCpuLoad();
   auto [cpu_usage, tooltip] = getCpuUsage();
-  auto [max_frequency, min_frequency, avg_frequency] = getCpuFrequency();
+  auto [max_frequency, min_frequency, avg_frequency] =
+      wants_frequency_ ? getCpuFrequency() : std::tuple<float, float, float>{0, 0, 0};
   if (tooltipEnabled()) {
-    label_.set_tooltip_text(tooltip);
+    setTooltipText(tooltip);
   }
-  auto format = format_;
   auto total_usage = cpu_usage.empty() ? 0 : cpu_usage[0];
-  auto state = getState(total_usage);
-  if (!state.empty() && config_["format-" + state].isString()) {
-    format = config_["format-" + state].asString();
+
+  // Maintain a fixed ring of overall-usage samples with a running sum, so the
+  // averaged field costs one subtraction and one addition per tick.
+  if (usage_history_.empty()) {
+    auto depth = config_["history-depth"].isUInt() ? config_["history-depth"].asUInt() : 5;
+    usage_history_.assign(std::max(1U, depth), 0);
   }
+  history_sum_ -= usage_history_[history_pos_];
+  usage_history_[history_pos_] = total_usage;
+  history_sum_ += total_usage;
+  history_pos_ = (history_pos_ + 1) % usage_history_.size();
+  if (history_len_ < usage_history_.size()) {
+    ++history_len_;
+  }
+  uint16_t avg_usage = history_sum_ / history_len_;
+  uint16_t max_core = cpu_usage.size() > 1
+                          ? *std::max_element(cpu_usage.begin() + 1, cpu_usage.end())
+                          : total_usage;
+
+  auto state = getState(total_usage);
+  auto format = getFormatForState(state);
 
   if (format.empty()) {
     event_box_.hide();
+  } else if (format == "{usage}%") {
+    // The out-of-the-box format: the template is compiled at build time, no
+    // argument store is assembled and the per-core args are never rendered.
+    event_box_.show();
+    setMarkup(fmt::format(FMT_COMPILE("{}%"), total_usage));
   } else {
     event_box_.show();
     auto icons = std::vector<std::string>{state};
@@ -41,6 +69,8 @@ auto waybar::modules::Cpu::update() -> void {
     store.push_back(fmt::arg("load", cpu_load));
     store.push_back(fmt::arg("load", cpu_load));
     store.push_back(fmt::arg("usage", total_usage));
+    store.push_back(fmt::arg("avg_usage", avg_usage));
+    store.push_back(fmt::arg("max_core", max_core));
     store.push_back(fmt::arg("icon", getIcon(total_usage, icons)));
     store.push_back(fmt::arg("max_frequency", max_frequency));
     store.push_back(fmt::arg("min_frequency", min_frequency));
@@ -52,7 +82,7 @@ auto waybar::modules::Cpu::update() -> void {
       auto icon_format = fmt::format("icon{}", core_i);
       store.push_back(fmt::arg(icon_format.c_str(), getIcon(cpu_usage[i], icons)));
     }
-    label_.set_markup(fmt::vformat(format, store));
+    setMarkup(fmt::vformat(format, store));
   }
 
   // Call parent update
@@ -1,36 +1,78 @@
+#include <cstring>
 #include <filesystem>
 
 #include "modules/cpu.hpp"
 
 std::vector<std::tuple<size_t, size_t>> waybar::modules::Cpu::parseCpuinfo() {
-  const std::string data_dir_ = "/proc/stat";
-  std::ifstream info(data_dir_);
-  if (!info.is_open()) {
-    throw std::runtime_error("Can't open " + data_dir_);
+  // One shared sweep serves every /proc consumer within the freshness window
+  auto snapshot = util::ProcSampler::instance().sample();
+  const auto& data = snapshot->stat;
+  if (data.empty()) {
+    throw std::runtime_error("Can't open /proc/stat");
   }
   std::vector<std::tuple<size_t, size_t>> cpuinfo;
-  std::string line;
-  while (getline(info, line)) {
-    if (line.substr(0, 3).compare("cpu") != 0) {
-      break;
+  const char* p = data.data();
+  const char* end = p + data.size();
+  while (end - p > 3 && p[0] == 'c' && p[1] == 'p' && p[2] == 'u') {
+    const char* nl = static_cast<const char*>(memchr(p, '\n', end - p));
+    if (nl == nullptr) {
+      nl = end;
+    }
+    // skip the "cpuN" token
+    while (p != nl && *p != ' ') {
+      ++p;
     }
-    std::stringstream sline(line.substr(5));
-    std::vector<size_t> times;
-    for (size_t time = 0; sline >> time; times.push_back(time))
-      ;
-
     size_t idle_time = 0;
     size_t total_time = 0;
-    if (times.size() >= 4) {
-      idle_time = times[3];
-      total_time = std::accumulate(times.begin(), times.end(), 0);
+    for (size_t i = 0;; ++i) {
+      while (p != nl && *p == ' ') {
+        ++p;
+      }
+      if (p == nl || *p < '0' || *p > '9') {
+        break;
+      }
+      size_t time = util::parseUnsigned(p, nl);
+      if (i == 3) {
+        idle_time = time;
+      }
+      total_time += time;
     }
     cpuinfo.emplace_back(idle_time, total_time);
+    p = nl == end ? end : nl + 1;
   }
   return cpuinfo;
 }
 
 std::vector<float> waybar::modules::Cpu::parseCpuFrequencies() {
+  // Fast path: one small pread() per core from cached scaling_cur_freq fds. Scanning
+  // all of /proc/cpuinfo is ~200KB of seq_file work on large machines and only falls
+  // back in when cpufreq is unavailable.
+  if (!freq_files_init_) {
+    freq_files_init_ = true;
+    for (int core = 0;; ++core) {
+      auto path = fmt::format("/sys/devices/system/cpu/cpu{}/cpufreq/scaling_cur_freq", core);
+      if (!std::filesystem::exists(path)) {
+        break;
+      }
+      freq_files_.push_back(std::make_unique<util::PollableFile>(path));
+    }
+  }
+  if (!freq_files_.empty()) {
+    std::vector<float> frequencies;
+    frequencies.reserve(freq_files_.size());
+    for (auto& file : freq_files_) {
+      auto data = file->read();
+      const char* p = data.data();
+      auto khz = util::parseUnsigned(p, p + data.size());
+      if (khz > 0) {
+        frequencies.push_back(khz / 1000.0f);
+      }
+    }
+    if (!frequencies.empty()) {
+      return frequencies;
+    }
+  }
+
   const std::string file_path_ = "/proc/cpuinfo";
   std::ifstream info(file_path_);
   if (!info.is_open()) {
@@ -1,23 +1,80 @@
 #include "modules/custom.hpp"
 
+#include <poll.h>
 #include <spdlog/spdlog.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+#include <cstdlib>
+
+#include "util/perf_counters.hpp"
 
 waybar::modules::Custom::Custom(const std::string& name, const std::string& id,
                                 const Json::Value& config)
-    : ALabel(config, "custom-" + name, id, "{}"), name_(name), fp_(nullptr), pid_(-1) {
+    : ALabel(config, "custom-" + name, id, "{}", config["exec-native"].isString() ? 30 : 0),
+      name_(name),
+      fp_(nullptr),
+      max_line_bytes_(config["max-output-bytes"].isUInt() ? config["max-output-bytes"].asUInt()
+                                                          : (1 << 20)),
+      pid_(-1) {
+  if (config_["exec-native"].isString()) {
+    native_ = std::make_unique<util::NativeExpr>(config_["exec-native"].asString());
+  }
   dp.emit();
   if (interval_.count() > 0) {
-    delayWorker();
+    if (native_ || (!config_["exec"].isString() && !config_["exec-if"].isString())) {
+      delayWorker();
+    } else {
+      // Bars on other outputs with an identical config share this poller, so
+      // the script runs once per tick regardless of monitor count.
+      poller_ = util::ScriptPoller::acquire(
+          config_["exec"].isString() ? config_["exec"].asString() : "",
+          config_["exec-if"].isString() ? config_["exec-if"].asString() : "", interval_,
+          std::chrono::seconds(
+              config_["exec-if-ttl"].isUInt() ? config_["exec-if-ttl"].asUInt() : 0));
+      subscription_ = poller_->subscribe([this](const util::command::res& res) {
+        output_ = res;
+        dp.emit();
+      });
+    }
   } else if (config_["exec"].isString()) {
     continuousWorker();
   }
 }
 
 waybar::modules::Custom::~Custom() {
+  if (poller_) {
+    poller_->unsubscribe(subscription_);
+  }
   if (pid_ != -1) {
     killpg(pid_, SIGTERM);
     pid_ = -1;
   }
+  free(buff_);
+}
+
+// Whether another getline() would return without blocking, either from the
+// stdio buffer (a burst usually arrives in one read) or from the pipe itself.
+static bool hasPendingLine(FILE* fp) {
+#ifdef __GLIBC__
+  if (fp->_IO_read_ptr < fp->_IO_read_end) {
+    return true;
+  }
+#endif
+  struct pollfd pfd = {fileno(fp), POLLIN, 0};
+  return poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLIN);
+}
+
+// For interval scripts this skips whole exec cycles; a continuous script keeps
+// running but blocks on a full pipe once the reader is parked, which throttles
+// it just as well. Backlogged lines are drained in one burst on resume.
+void waybar::modules::Custom::onSuspended(bool suspended) {
+  if (poller_) {
+    poller_->setSuspended(subscription_, suspended);
+  } else {
+    suspended ? thread_.suspend() : thread_.resume();
+  }
 }
 
 void waybar::modules::Custom::delayWorker() {
@@ -31,7 +88,14 @@ void waybar::modules::Custom::delayWorker() {
       }
     }
     if (can_update) {
-      if (config_["exec"].isString()) {
+      if (native_) {
+        try {
+          output_ = {0, native_->eval()};
+        } catch (const std::exception& e) {
+          spdlog::error("custom/{}: {}", name_, e.what());
+          output_ = {1, ""};
+        }
+      } else if (config_["exec"].isString()) {
         output_ = util::command::exec(config_["exec"].asString());
       }
       dp.emit();
@@ -40,6 +104,35 @@ void waybar::modules::Custom::delayWorker() {
   };
 }
 
+// getline() grows the buffer to fit whatever the script emits; a single
+// runaway line would otherwise stay parked in the allocator arena for the
+// lifetime of the bar. Lines are capped at max_line_bytes_, the oversized
+// buffer is dropped afterwards and glibc is asked to give the pages back.
+// Returns false on EOF or error.
+bool waybar::modules::Custom::getLineBounded(std::string& line) {
+  auto len = getline(&buff_, &buff_len_, fp_);
+  if (len < 0) {
+    return false;
+  }
+  if (max_line_bytes_ == 0 || static_cast<size_t>(len) <= max_line_bytes_) {
+    line.assign(buff_, len);
+    return true;
+  }
+  line.assign(buff_, max_line_bytes_);
+  if (++truncated_lines_ == 1) {
+    spdlog::warn("custom/{}: output line exceeded {} bytes, truncating", name_, max_line_bytes_);
+  }
+  util::PerfCounters::instance().gauge("truncated/custom-" + name_, truncated_lines_);
+  free(buff_);
+  buff_ = nullptr;
+  buff_len_ = 0;
+#ifdef __GLIBC__
+  // shrinking the buffer alone keeps the pages in the arena; hand them back
+  malloc_trim(0);
+#endif
+  return true;
+}
+
 void waybar::modules::Custom::continuousWorker() {
   auto cmd = config_["exec"].asString();
   pid_ = -1;
@@ -48,9 +141,20 @@ void waybar::modules::Custom::continuousWorker() {
     throw std::runtime_error("Unable to open " + cmd);
   }
   thread_ = [this, cmd] {
-    char* buff = nullptr;
-    size_t len = 0;
-    if (getline(&buff, &len, fp_) == -1) {
+    // Block in poll() instead of getline() so stop() can interrupt through
+    // the exit fd; a closed pipe raises POLLHUP and falls through to the
+    // EOF/restart path below.
+    if (!hasPendingLine(fp_)) {
+      struct pollfd fds[] = {{fileno(fp_), POLLIN, 0}, {thread_.exitFd(), POLLIN, 0}};
+      if (poll(fds, 2, -1) < 0) {
+        return;  // EINTR; retry on the next iteration
+      }
+      if (fds[1].revents != 0) {
+        return;  // stop() requested
+      }
+    }
+    std::string line;
+    if (!getLineBounded(line)) {
       int exit_code = 1;
       if (fp_) {
         exit_code = WEXITSTATUS(util::command::close(fp_, pid_));
@@ -73,7 +177,17 @@ void waybar::modules::Custom::continuousWorker() {
         return;
       }
     } else {
-      std::string output = buff;
+      // Drain a burst of lines and only render the newest one, so a producer
+      // writing 50 lines at once costs a single redraw
+      std::string output = std::move(line);
+      while (hasPendingLine(fp_)) {
+        if (!getLineBounded(line)) {
+          // EOF mid-burst; keep the last complete line and let the next
+          // iteration take the restart path
+          break;
+        }
+        output = std::move(line);
+      }
 
       // Remove last newline
       if (!output.empty() && output[output.length() - 1] == '\n') {
@@ -86,14 +200,14 @@ void waybar::modules::Custom::continuousWorker() {
 }
 
 void waybar::modules::Custom::refresh(int sig) {
-  if (sig == SIGRTMIN + config_["signal"].asInt()) {
-    thread_.wake_up();
+  if (sig == 0 || sig == SIGRTMIN + config_["signal"].asInt()) {
+    poller_ ? poller_->wakeUp() : thread_.wake_up();
   }
 }
 
 void waybar::modules::Custom::handleEvent() {
   if (!config_["exec-on-event"].isBool() || config_["exec-on-event"].asBool()) {
-    thread_.wake_up();
+    poller_ ? poller_->wakeUp() : thread_.wake_up();
   }
 }
 
@@ -122,11 +236,12 @@ auto waybar::modules::Custom::update() -> void {
     }
     auto str = fmt::format(format_, text_, fmt::arg("alt", alt_),
                            fmt::arg("icon", getIcon(percentage_, alt_)),
-                           fmt::arg("percentage", percentage_));
+                           fmt::arg("percentage", percentage_),
+                           fmt::arg("exit_code", output_.exit_code));
     if (str.empty()) {
       event_box_.hide();
     } else {
-      label_.set_markup(str);
+      setMarkup(str);
       if (tooltipEnabled()) {
         if (text_ == tooltip_) {
           if (label_.get_tooltip_markup() != str) {
@@ -177,6 +292,70 @@ void waybar::modules::Custom::parseOutputRaw() {
 }
 
 void waybar::modules::Custom::parseOutputJson() {
+  // Only the first line is meaningful, like the DOM path below
+  std::string_view line(output_.out);
+  auto eol = line.find('\n');
+  if (eol != std::string_view::npos) {
+    line = line.substr(0, eol);
+  }
+  bool escape = config_["escape"].isBool() && config_["escape"].asBool();
+  class_.clear();
+  text_.clear();
+  alt_.clear();
+  tooltip_.clear();
+  percentage_ = 0;
+  try {
+    // Pull the few known fields straight out of the line; no DOM is built in
+    // the steady state of a fast-ticking module
+    util::JsonCursor cursor(line);
+    cursor.expect('{');
+    if (!cursor.tryConsume('}')) {
+      do {
+        auto key = cursor.parseString();
+        cursor.expect(':');
+        if (key == "text") {
+          auto value = cursor.parseString();
+          text_ = escape ? Glib::Markup::escape_text(value) : value;
+        } else if (key == "alt") {
+          auto value = cursor.parseString();
+          alt_ = escape ? Glib::Markup::escape_text(value) : value;
+        } else if (key == "tooltip") {
+          tooltip_ = cursor.parseString();
+        } else if (key == "class") {
+          if (cursor.peek() == '[') {
+            cursor.expect('[');
+            if (!cursor.tryConsume(']')) {
+              do {
+                class_.push_back(cursor.parseString());
+              } while (cursor.tryConsume(','));
+              cursor.expect(']');
+            }
+          } else if (cursor.peek() == '"') {
+            class_.push_back(cursor.parseString());
+          } else {
+            cursor.skipValue();
+          }
+        } else if (key == "percentage") {
+          if (cursor.peek() == '-' || (cursor.peek() >= '0' && cursor.peek() <= '9')) {
+            auto value = cursor.parseInt();
+            percentage_ = value > 0 ? value : 0;
+          } else {
+            cursor.skipValue();
+          }
+        } else {
+          cursor.skipValue();
+        }
+      } while (cursor.tryConsume(','));
+      cursor.expect('}');
+    }
+    return;
+  } catch (const std::exception& e) {
+    SPDLOG_DEBUG("custom/{}: falling back to DOM JSON parsing: {}", name_, e.what());
+  }
+  parseOutputJsonDom();
+}
+
+void waybar::modules::Custom::parseOutputJsonDom() {
   std::istringstream output(output_.out);
   std::string line;
   class_.clear();
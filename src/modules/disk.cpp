@@ -1,34 +1,170 @@
 #include "modules/disk.hpp"
 
+#include <fcntl.h>
+#include <glibmm/main.h>
+#include <spdlog/spdlog.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if __has_include(<fmt/args.h>)
+// fmt >= 8 moved dynamic_format_arg_store out of core.h
+#include <fmt/args.h>
+#endif
+
+#include <map>
+#include <thread>
+
 using namespace waybar::util;
 
 waybar::modules::Disk::Disk(const std::string& id, const Json::Value& config)
-    : ALabel(config, "disk", id, "{}%", 30), path_("/") {
-  thread_ = [this] {
-    dp.emit();
-    thread_.sleep_for(interval_);
-  };
-  if (config["path"].isString()) {
-    path_ = config["path"].asString();
+    : ALabel(config, "disk", id, "{}%", 30) {
+  if (config["paths"].isArray()) {
+    for (const auto& path : config["paths"]) {
+      if (path.isString()) {
+        paths_.push_back(path.asString());
+      }
+    }
+  } else if (config["path"].isString()) {
+    paths_.push_back(config["path"].asString());
+  }
+  if (paths_.empty()) {
+    paths_.emplace_back("/");
+  }
+
+  notifier_ = std::make_shared<Notifier>();
+  notifier_->fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (notifier_->fd >= 0) {
+    probe_watch_ = Glib::signal_io().connect(sigc::mem_fun(*this, &Disk::onProbeDone),
+                                             notifier_->fd, Glib::IO_IN);
+  }
+
+  // The kernel signals mount table changes on /proc/self/mounts with
+  // POLLERR | POLLPRI, so remount/unmount refreshes immediately instead of
+  // waiting out the interval.
+  mounts_fd_ = open("/proc/self/mounts", O_RDONLY | O_CLOEXEC);
+  if (mounts_fd_ >= 0) {
+    mounts_watch_ = Glib::signal_io().connect(sigc::mem_fun(*this, &Disk::onMountsChanged),
+                                              mounts_fd_, Glib::IO_ERR | Glib::IO_PRI);
+  }
+
+  worker_.start(interval_, [this] { startProbe(); });
+  enableAdaptiveInterval(worker_);
+}
+
+waybar::modules::Disk::~Disk() {
+  worker_.stop();
+  probe_watch_.disconnect();
+  mounts_watch_.disconnect();
+  if (mounts_fd_ >= 0) {
+    close(mounts_fd_);
   }
 }
 
+void waybar::modules::Disk::onSuspended(bool suspended) {
+  suspended ? worker_.pause() : worker_.resume();
+}
+
+waybar::modules::Disk::Notifier::~Notifier() {
+  if (fd >= 0) {
+    close(fd);
+  }
+}
+
+void waybar::modules::Disk::startProbe() {
+  std::unique_lock lock(mutex_);
+  if (probe_ && !probe_->done.load(std::memory_order_acquire)) {
+    // previous statvfs still hung (stale NFS, dead automount); fall back to
+    // the last good numbers instead of queueing more blocked threads
+    if (std::chrono::steady_clock::now() - probe_started_ > probe_timeout_ && !stale_) {
+      stale_ = true;
+      spdlog::warn("disk: statvfs on {} did not answer within {}s, rendering stale data",
+                   paths_.front(), probe_timeout_.count());
+      lock.unlock();
+      dp.emit();
+    }
+    return;
+  }
+  probe_ = std::make_shared<Probe>();
+  probe_started_ = std::chrono::steady_clock::now();
+  lock.unlock();
+
+  // The thread owns its own references; if the module is torn down first the
+  // result is simply dropped. One pass covers every configured path, with
+  // paths resolved to their device first so filesystems shared between paths
+  // cost a single statvfs call.
+  std::thread([probe = probe_, notifier = notifier_, paths = paths_] {
+    probe->errs.assign(paths.size(), -1);
+    probe->stats.resize(paths.size());
+    probe->primary.assign(paths.size(), false);
+    std::map<dev_t, size_t> seen;  // device -> index of its first path
+    for (size_t i = 0; i < paths.size(); ++i) {
+      struct stat st;
+      if (stat(paths[i].c_str(), &st) == 0) {
+        auto [it, inserted] = seen.emplace(st.st_dev, i);
+        if (!inserted) {
+          probe->errs[i] = probe->errs[it->second];
+          probe->stats[i] = probe->stats[it->second];
+          continue;
+        }
+      }
+      probe->errs[i] = statvfs(paths[i].c_str(), &probe->stats[i]);
+      probe->primary[i] = true;
+    }
+    probe->done.store(true, std::memory_order_release);
+    uint64_t one = 1;
+    if (notifier->fd >= 0 && write(notifier->fd, &one, sizeof(one)) < 0) {
+      // nothing to do; the next interval tick picks the result up
+    }
+  }).detach();
+}
+
+bool waybar::modules::Disk::onProbeDone(Glib::IOCondition /*cond*/) {
+  uint64_t count = 0;
+  if (read(notifier_->fd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+    return true;
+  }
+  {
+    std::lock_guard lock(mutex_);
+    if (!probe_ || !probe_->done.load(std::memory_order_acquire)) {
+      return true;
+    }
+    errs_ = probe_->errs;
+    stats_ = probe_->stats;
+    primary_ = probe_->primary;
+    has_stats_ = !errs_.empty() && errs_.front() == 0;
+    stale_ = false;
+  }
+  dp.emit();
+  return true;
+}
+
+bool waybar::modules::Disk::onMountsChanged(Glib::IOCondition /*cond*/) {
+  // rearm the poll notification by re-reading the table
+  char buf[4096];
+  lseek(mounts_fd_, 0, SEEK_SET);
+  while (read(mounts_fd_, buf, sizeof(buf)) > 0) {
+  }
+  startProbe();
+  return true;
+}
+
 auto waybar::modules::Disk::update() -> void {
-  struct statvfs /* {
-      unsigned long  f_bsize;    // filesystem block size
-      unsigned long  f_frsize;   // fragment size
-      fsblkcnt_t     f_blocks;   // size of fs in f_frsize units
-      fsblkcnt_t     f_bfree;    // # free blocks
-      fsblkcnt_t     f_bavail;   // # free blocks for unprivileged users
-      fsfilcnt_t     f_files;    // # inodes
-      fsfilcnt_t     f_ffree;    // # free inodes
-      fsfilcnt_t     f_favail;   // # free inodes for unprivileged users
-      unsigned long  f_fsid;     // filesystem ID
-      unsigned long  f_flag;     // mount flags
-      unsigned long  f_namemax;  // maximum filename length
-  }; */
-      stats;
-  int err = statvfs(path_.c_str(), &stats);
+  std::vector<int> errs;
+  std::vector<struct statvfs> stats_list;
+  std::vector<bool> primary;
+  bool stale;
+  {
+    std::lock_guard lock(mutex_);
+    if (!has_stats_) {
+      event_box_.hide();
+      return;
+    }
+    errs = errs_;
+    stats_list = stats_;
+    primary = primary_;
+    stale = stale_;
+  }
 
   /* Conky options
     fs_bar - Bar that shows how much space is used
@@ -38,31 +174,67 @@ auto waybar::modules::Disk::update() -> void {
     fs_used - File system used space
   */
 
-  if (err != 0) {
-    event_box_.hide();
-    return;
-  }
-
+  // the plain fields keep describing the first path, which also drives the
+  // module state; extra paths get indexed fields and feed the aggregates
+  const auto& stats = stats_list.front();
   auto free = pow_format(stats.f_bavail * stats.f_frsize, "B", true);
   auto used = pow_format((stats.f_blocks - stats.f_bfree) * stats.f_frsize, "B", true);
   auto total = pow_format(stats.f_blocks * stats.f_frsize, "B", true);
   auto percentage_used = (stats.f_blocks - stats.f_bfree) * 100 / stats.f_blocks;
 
-  auto format = format_;
-  auto state = getState(percentage_used);
-  if (!state.empty() && config_["format-" + state].isString()) {
-    format = config_["format-" + state].asString();
+  fmt::dynamic_format_arg_store<fmt::format_context> store;
+  store.push_back(stats.f_bavail * 100 / stats.f_blocks);
+  store.push_back(fmt::arg("free", free));
+  store.push_back(fmt::arg("percentage_free", stats.f_bavail * 100 / stats.f_blocks));
+  store.push_back(fmt::arg("used", used));
+  store.push_back(fmt::arg("percentage_used", percentage_used));
+  store.push_back(fmt::arg("total", total));
+  store.push_back(fmt::arg("path", paths_.front()));
+
+  uint64_t agg_used = 0;
+  uint64_t agg_free = 0;
+  uint64_t agg_total = 0;
+  for (size_t i = 0; i < stats_list.size(); ++i) {
+    if (errs[i] != 0) {
+      continue;
+    }
+    const auto& s = stats_list[i];
+    if (primary[i]) {
+      // first path of its filesystem; duplicates would double-count
+      agg_used += (s.f_blocks - s.f_bfree) * s.f_frsize;
+      agg_free += s.f_bavail * s.f_frsize;
+      agg_total += s.f_blocks * s.f_frsize;
+    }
+    store.push_back(fmt::arg(fmt::format("free{}", i).c_str(),
+                             pow_format(s.f_bavail * s.f_frsize, "B", true)));
+    store.push_back(fmt::arg(fmt::format("used{}", i).c_str(),
+                             pow_format((s.f_blocks - s.f_bfree) * s.f_frsize, "B", true)));
+    store.push_back(fmt::arg(fmt::format("total{}", i).c_str(),
+                             pow_format(s.f_blocks * s.f_frsize, "B", true)));
+    store.push_back(fmt::arg(fmt::format("percentage_used{}", i).c_str(),
+                             (s.f_blocks - s.f_bfree) * 100 / s.f_blocks));
+    store.push_back(fmt::arg(fmt::format("percentage_free{}", i).c_str(),
+                             s.f_bavail * 100 / s.f_blocks));
+    store.push_back(fmt::arg(fmt::format("path{}", i).c_str(), paths_[i]));
   }
+  store.push_back(fmt::arg("total_used", pow_format(agg_used, "B", true)));
+  store.push_back(fmt::arg("total_free", pow_format(agg_free, "B", true)));
+  store.push_back(fmt::arg("total_size", pow_format(agg_total, "B", true)));
+
+  auto state = getState(percentage_used);
+  auto format = getFormatForState(state);
 
   if (format.empty()) {
     event_box_.hide();
   } else {
     event_box_.show();
-    label_.set_markup(
-        fmt::format(format, stats.f_bavail * 100 / stats.f_blocks, fmt::arg("free", free),
-                    fmt::arg("percentage_free", stats.f_bavail * 100 / stats.f_blocks),
-                    fmt::arg("used", used), fmt::arg("percentage_used", percentage_used),
-                    fmt::arg("total", total), fmt::arg("path", path_)));
+    setMarkup(fmt::vformat(format, store));
+  }
+
+  if (stale) {
+    label_.get_style_context()->add_class("stale");
+  } else {
+    label_.get_style_context()->remove_class("stale");
   }
 
   if (tooltipEnabled()) {
@@ -70,11 +242,7 @@ auto waybar::modules::Disk::update() -> void {
     if (config_["tooltip-format"].isString()) {
       tooltip_format = config_["tooltip-format"].asString();
     }
-    label_.set_tooltip_text(
-        fmt::format(tooltip_format, stats.f_bavail * 100 / stats.f_blocks, fmt::arg("free", free),
-                    fmt::arg("percentage_free", stats.f_bavail * 100 / stats.f_blocks),
-                    fmt::arg("used", used), fmt::arg("percentage_used", percentage_used),
-                    fmt::arg("total", total), fmt::arg("path", path_)));
+    setTooltipText(fmt::vformat(tooltip_format, store));
   }
   // Call parent update
   ALabel::update();
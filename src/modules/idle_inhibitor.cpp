@@ -1,17 +1,10 @@
 #include "modules/idle_inhibitor.hpp"
 
-#include "idle-inhibit-unstable-v1-client-protocol.h"
 #include "util/command.hpp"
 
-std::list<waybar::AModule*> waybar::modules::IdleInhibitor::modules;
-bool waybar::modules::IdleInhibitor::status = false;
-
 waybar::modules::IdleInhibitor::IdleInhibitor(const std::string& id, const Bar& bar,
                                               const Json::Value& config)
-    : ALabel(config, "idle_inhibitor", id, "{status}"),
-      bar_(bar),
-      idle_inhibitor_(nullptr),
-      pid_(-1) {
+    : ALabel(config, "idle_inhibitor", id, "{status}"), bar_(bar), pid_(-1) {
   if (waybar::Client::inst()->idle_inhibit_manager == nullptr) {
     throw std::runtime_error("idle-inhibit not available");
   }
@@ -20,20 +13,16 @@ waybar::modules::IdleInhibitor::IdleInhibitor(const std::string& id, const Bar&
   event_box_.signal_button_press_event().connect(
       sigc::mem_fun(*this, &IdleInhibitor::handleToggle));
 
-  // Add this to the modules list
-  waybar::modules::IdleInhibitor::modules.push_back(this);
+  // The manager owns the single protocol inhibitor; this widget only
+  // renders the shared state and gets poked when it flips.
+  subscription_ =
+      util::IdleInhibitManager::instance().subscribe(bar_.surface, [this] { dp.emit(); });
 
   dp.emit();
 }
 
 waybar::modules::IdleInhibitor::~IdleInhibitor() {
-  if (idle_inhibitor_ != nullptr) {
-    zwp_idle_inhibitor_v1_destroy(idle_inhibitor_);
-    idle_inhibitor_ = nullptr;
-  }
-
-  // Remove this from the modules list
-  waybar::modules::IdleInhibitor::modules.remove(this);
+  util::IdleInhibitManager::instance().unsubscribe(subscription_);
 
   if (pid_ != -1) {
     kill(-pid_, 9);
@@ -42,27 +31,15 @@ waybar::modules::IdleInhibitor::~IdleInhibitor() {
 }
 
 auto waybar::modules::IdleInhibitor::update() -> void {
-  // Check status
-  if (status) {
-    label_.get_style_context()->remove_class("deactivated");
-    if (idle_inhibitor_ == nullptr) {
-      idle_inhibitor_ = zwp_idle_inhibit_manager_v1_create_inhibitor(
-          waybar::Client::inst()->idle_inhibit_manager, bar_.surface);
-    }
-  } else {
-    label_.get_style_context()->remove_class("activated");
-    if (idle_inhibitor_ != nullptr) {
-      zwp_idle_inhibitor_v1_destroy(idle_inhibitor_);
-      idle_inhibitor_ = nullptr;
-    }
-  }
+  bool status = util::IdleInhibitManager::instance().active();
 
+  label_.get_style_context()->remove_class(status ? "deactivated" : "activated");
   std::string status_text = status ? "activated" : "deactivated";
-  label_.set_markup(fmt::format(format_, fmt::arg("status", status_text),
+  setMarkup(fmt::format(format_, fmt::arg("status", status_text),
                                 fmt::arg("icon", getIcon(0, status_text))));
   label_.get_style_context()->add_class(status_text);
   if (tooltipEnabled()) {
-    label_.set_tooltip_text(status_text);
+    setTooltipText(status_text);
   }
   // Call parent update
   ALabel::update();
@@ -70,14 +47,9 @@ auto waybar::modules::IdleInhibitor::update() -> void {
 
 bool waybar::modules::IdleInhibitor::handleToggle(GdkEventButton* const& e) {
   if (e->button == 1) {
-    status = !status;
-
-    // Make all other idle inhibitor modules update
-    for (auto const& module : waybar::modules::IdleInhibitor::modules) {
-      if (module != this) {
-        module->update();
-      }
-    }
+    // flips the single shared inhibitor and notifies every subscribed
+    // widget, including this one
+    util::IdleInhibitManager::instance().toggle();
   }
 
   ALabel::handleToggle(e);
@@ -4,56 +4,16 @@
 #include <gio/gunixfdlist.h>
 #include <spdlog/spdlog.h>
 
-namespace {
-
-using DBus = std::unique_ptr<GDBusConnection, void (*)(GDBusConnection*)>;
-
-auto dbus() -> DBus {
-  GError* error = nullptr;
-  GDBusConnection* connection = g_bus_get_sync(G_BUS_TYPE_SYSTEM, NULL, &error);
-
-  if (error) {
-    spdlog::error("g_bus_get_sync() failed: {}", error->message);
-    g_error_free(error);
-    connection = nullptr;
-  }
+#include "util/dbus_manager.hpp"
 
-  auto destructor = [](GDBusConnection* connection) {
-    GError* error = nullptr;
-    g_dbus_connection_close_sync(connection, nullptr, &error);
-    if (error) {
-      spdlog::error("g_bus_connection_close_sync failed(): {}", error->message);
-      g_error_free(error);
-    }
-  };
-
-  return DBus{connection, destructor};
-}
-
-auto getLocks(const DBus& bus, const std::string& inhibitors) -> int {
-  GError* error = nullptr;
-  GUnixFDList* fd_list;
-  int handle;
-
-  auto reply = g_dbus_connection_call_with_unix_fd_list_sync(
-      bus.get(), "org.freedesktop.login1", "/org/freedesktop/login1",
-      "org.freedesktop.login1.Manager", "Inhibit",
-      g_variant_new("(ssss)", inhibitors.c_str(), "waybar", "Asked by user", "block"),
-      G_VARIANT_TYPE("(h)"), G_DBUS_CALL_FLAGS_NONE, -1, nullptr, &fd_list, nullptr, &error);
-  if (error) {
-    spdlog::error("g_dbus_connection_call_with_unix_fd_list_sync() failed: {}", error->message);
-    g_error_free(error);
-    handle = -1;
-  } else {
-    gint index;
-    g_variant_get(reply, "(h)", &index);
-    g_variant_unref(reply);
-    handle = g_unix_fd_list_get(fd_list, index, nullptr);
-    g_object_unref(fd_list);
-  }
+namespace {
 
-  return handle;
-}
+// carries the async Inhibit reply back to the module; `cancellable` outlives
+// the module and tells the callback whether `self` may still be touched
+struct InhibitContext {
+  waybar::modules::Inhibitor* self;
+  ::GCancellable* cancellable;
+};
 
 auto checkInhibitor(const std::string& inhibitor) -> const std::string& {
   static const auto inhibitors = std::array{"idle",
@@ -99,14 +59,16 @@ namespace waybar::modules {
 
 Inhibitor::Inhibitor(const std::string& id, const Bar& bar, const Json::Value& config)
     : ALabel(config, "inhibitor", id, "{status}", true),
-      dbus_(::dbus()),
-      inhibitors_(::getInhibitors(config)) {
+      inhibitors_(::getInhibitors(config)),
+      cancellable_(g_cancellable_new()) {
   event_box_.add_events(Gdk::BUTTON_PRESS_MASK);
   event_box_.signal_button_press_event().connect(sigc::mem_fun(*this, &Inhibitor::handleToggle));
   dp.emit();
 }
 
 Inhibitor::~Inhibitor() {
+  g_cancellable_cancel(cancellable_);
+  g_object_unref(cancellable_);
   if (handle_ != -1) {
     ::close(handle_);
   }
@@ -118,26 +80,79 @@ auto Inhibitor::update() -> void {
   std::string status_text = activated() ? "activated" : "deactivated";
 
   label_.get_style_context()->remove_class(activated() ? "deactivated" : "activated");
-  label_.set_markup(fmt::format(format_, fmt::arg("status", status_text),
+  setMarkup(fmt::format(format_, fmt::arg("status", status_text),
                                 fmt::arg("icon", getIcon(0, status_text))));
   label_.get_style_context()->add_class(status_text);
 
   if (tooltipEnabled()) {
-    label_.set_tooltip_text(status_text);
+    setTooltipText(status_text);
   }
 
   return ALabel::update();
 }
 
-auto Inhibitor::handleToggle(GdkEventButton* const& e) -> bool {
-  if (e->button == 1) {
+void Inhibitor::onInhibitReady(::GObject* source, ::GAsyncResult* result, void* data) {
+  auto* ctx = static_cast<InhibitContext*>(data);
+
+  GError* error = nullptr;
+  GUnixFDList* fd_list = nullptr;
+  int handle = -1;
+  auto* reply = g_dbus_connection_call_with_unix_fd_list_finish(G_DBUS_CONNECTION(source), &fd_list,
+                                                                result, &error);
+  if (error != nullptr) {
+    if (!g_error_matches(error, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+      spdlog::error("cannot get inhibitor locks: {}", error->message);
+    }
+    g_error_free(error);
+  } else {
+    gint index;
+    g_variant_get(reply, "(h)", &index);
+    g_variant_unref(reply);
+    handle = g_unix_fd_list_get(fd_list, index, nullptr);
+    g_object_unref(fd_list);
+  }
+
+  // the cancellable is cancelled from the destructor on this same thread, so
+  // an uncancelled context proves the module is still alive
+  if (!g_cancellable_is_cancelled(ctx->cancellable)) {
+    ctx->self->pending_ = false;
+    if (handle != -1) {
+      ctx->self->handle_ = handle;
+    }
+    ctx->self->dp.emit();
+  } else if (handle != -1) {
+    // module is gone; release the lock we just got
+    ::close(handle);
+  }
+  g_object_unref(ctx->cancellable);
+  delete ctx;
+}
+
+auto Inhibitor::handleToggle(::GdkEventButton* const& e) -> bool {
+  if (e->button == 1 && !pending_) {
     if (activated()) {
+      // closing the fd is what releases a logind block inhibitor, so there is
+      // nothing to cache across toggles: release is just a close()
       ::close(handle_);
       handle_ = -1;
     } else {
-      handle_ = ::getLocks(dbus_, inhibitors_);
-      if (handle_ == -1) {
-        spdlog::error("cannot get inhibitor locks");
+      // borrowed from the shared manager; the old per-module connection was
+      // close_sync()'d on destruction, which tore down the GIO singleton bus
+      // under every other module
+      auto* bus = util::DBusManager::instance().raw(Gio::DBus::BUS_TYPE_SYSTEM);
+      if (bus == nullptr) {
+        spdlog::error("cannot get inhibitor locks: no system bus");
+      } else {
+        // async: the reply (and its fd) lands back on the main loop instead of
+        // stalling it for a logind round-trip on every click
+        pending_ = true;
+        auto* ctx = new InhibitContext{this, G_CANCELLABLE(g_object_ref(cancellable_))};
+        g_dbus_connection_call_with_unix_fd_list(
+            bus, "org.freedesktop.login1", "/org/freedesktop/login1",
+            "org.freedesktop.login1.Manager", "Inhibit",
+            g_variant_new("(ssss)", inhibitors_.c_str(), "waybar", "Asked by user", "block"),
+            G_VARIANT_TYPE("(h)"), G_DBUS_CALL_FLAGS_NONE, -1, nullptr, cancellable_,
+            &Inhibitor::onInhibitReady, ctx);
       }
     }
   }
@@ -6,8 +6,11 @@
 
 #include <filesystem>
 
+#include "util/fd_reactor.hpp"
+
 extern "C" {
 #include <fcntl.h>
+#include <sys/epoll.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 }
@@ -91,15 +94,13 @@ waybar::modules::KeyboardState::KeyboardState(const std::string& id, const Bar&
                          : config_["format"]["scrolllock"].isString()
                              ? config_["format"]["scrolllock"].asString()
                              : "{name} {icon}"),
-      interval_(
-          std::chrono::seconds(config_["interval"].isUInt() ? config_["interval"].asUInt() : 1)),
       icon_locked_(config_["format-icons"]["locked"].isString()
                        ? config_["format-icons"]["locked"].asString()
                        : "locked"),
       icon_unlocked_(config_["format-icons"]["unlocked"].isString()
                          ? config_["format-icons"]["unlocked"].asString()
                          : "unlocked"),
-      fd_(0),
+      fd_(-1),
       dev_(nullptr) {
   box_.set_name("keyboard-state");
   if (config_["numlock"].asBool()) {
@@ -116,6 +117,12 @@ waybar::modules::KeyboardState::KeyboardState(const std::string& id, const Bar&
   }
   event_box_.add(box_);
 
+  findDevice();
+  // paint the initial state; afterwards the kernel wakes us per LED event
+  dp.emit();
+}
+
+void waybar::modules::KeyboardState::findDevice() {
   if (config_["device-path"].isString()) {
     std::string dev_path = config_["device-path"].asString();
     fd_ = openFile(dev_path, O_NONBLOCK | O_CLOEXEC | O_RDONLY);
@@ -151,13 +158,42 @@ waybar::modules::KeyboardState::KeyboardState(const std::string& id, const Bar&
     }
   }
 
-  thread_ = [this] {
+  // Sleep on the device fd instead of polling: LED events arrive a handful of
+  // times a day, so the shared reactor wakes us only when one does.
+  util::FdReactor::instance().add(fd_, EPOLLIN, [this](uint32_t) { dp.emit(); });
+}
+
+void waybar::modules::KeyboardState::reacquireDevice() {
+  if (dev_ != nullptr) {
+    util::FdReactor::instance().remove(fd_);
+    libevdev_free(dev_);
+    dev_ = nullptr;
+    close(fd_);
+    fd_ = -1;
+  }
+  try {
+    findDevice();
+    retry_timer_.disconnect();
     dp.emit();
-    thread_.sleep_for(interval_);
-  };
+  } catch (const std::runtime_error& e) {
+    // unplugged; keep trying until the device (or a replacement) returns
+    if (!retry_timer_.connected()) {
+      retry_timer_ = Glib::signal_timeout().connect(
+          [this] {
+            reacquireDevice();
+            return dev_ == nullptr;
+          },
+          2000);
+    }
+  }
 }
 
 waybar::modules::KeyboardState::~KeyboardState() {
+  retry_timer_.disconnect();
+  if (dev_ == nullptr) {
+    return;
+  }
+  util::FdReactor::instance().remove(fd_);
   libevdev_free(dev_);
   try {
     closeFile(fd_);
@@ -167,6 +203,9 @@ waybar::modules::KeyboardState::~KeyboardState() {
 }
 
 auto waybar::modules::KeyboardState::update() -> void {
+  if (dev_ == nullptr) {
+    return;  // device lost; a reacquire retry is pending
+  }
   int err = LIBEVDEV_READ_STATUS_SUCCESS;
   while (err == LIBEVDEV_READ_STATUS_SUCCESS) {
     input_event ev;
@@ -175,6 +214,11 @@ auto waybar::modules::KeyboardState::update() -> void {
       err = libevdev_next_event(dev_, LIBEVDEV_READ_FLAG_SYNC, &ev);
     }
   }
+  if (-err == ENODEV) {
+    spdlog::info("keyboard-state: device disappeared, rescanning");
+    reacquireDevice();
+    return;
+  }
   if (-err != EAGAIN) {
     throw errno_error(-err, "Failed to sync evdev device");
   }
@@ -80,6 +80,8 @@ static uint64_t get_free_memory() {
 }
 
 void waybar::modules::Memory::parseMeminfo() {
-  meminfo_["MemTotal"] = get_total_memory() / 1024;
-  meminfo_["MemAvailable"] = get_free_memory() / 1024;
+  meminfo_ = {};
+  meminfo_.mem_total = get_total_memory() / 1024;
+  meminfo_.mem_available = get_free_memory() / 1024;
+  meminfo_.has_mem_available = true;
 }
@@ -2,32 +2,28 @@
 
 waybar::modules::Memory::Memory(const std::string& id, const Json::Value& config)
     : ALabel(config, "memory", id, "{}%", 30) {
-  thread_ = [this] {
-    dp.emit();
-    thread_.sleep_for(interval_);
-  };
+  worker_.start(interval_, [this] { dp.emit(); });
+  enableAdaptiveInterval(worker_);
+}
+
+void waybar::modules::Memory::onSuspended(bool suspended) {
+  suspended ? worker_.pause() : worker_.resume();
 }
 
 auto waybar::modules::Memory::update() -> void {
   parseMeminfo();
 
-  unsigned long memtotal = meminfo_["MemTotal"];
-  unsigned long swaptotal = 0;
-  if (meminfo_.count("SwapTotal")) {
-    swaptotal = meminfo_["SwapTotal"];
-  }
+  unsigned long memtotal = meminfo_.mem_total;
+  unsigned long swaptotal = meminfo_.swap_total;
+  unsigned long swapfree = meminfo_.swap_free;
   unsigned long memfree;
-  unsigned long swapfree = 0;
-  if (meminfo_.count("SwapFree")) {
-    swapfree = meminfo_["SwapFree"];
-  }
-  if (meminfo_.count("MemAvailable")) {
+  if (meminfo_.has_mem_available) {
     // New kernels (3.4+) have an accurate available memory field.
-    memfree = meminfo_["MemAvailable"] + meminfo_["zfs_size"];
+    memfree = meminfo_.mem_available + meminfo_.zfs_size;
   } else {
     // Old kernel; give a best-effort approximation of available memory.
-    memfree = meminfo_["MemFree"] + meminfo_["Buffers"] + meminfo_["Cached"] +
-              meminfo_["SReclaimable"] - meminfo_["Shmem"] + meminfo_["zfs_size"];
+    memfree = meminfo_.mem_free + meminfo_.buffers + meminfo_.cached + meminfo_.s_reclaimable -
+              meminfo_.shmem + meminfo_.zfs_size;
   }
 
   if (memtotal > 0 && memfree >= 0) {
@@ -43,30 +39,47 @@ auto waybar::modules::Memory::update() -> void {
     auto available_ram_gigabytes = memfree / std::pow(1024, 2);
     auto available_swap_gigabytes = swapfree / std::pow(1024, 2);
 
-    auto format = format_;
     auto state = getState(used_ram_percentage);
-    if (!state.empty() && config_["format-" + state].isString()) {
-      format = config_["format-" + state].asString();
-    }
+    const auto& format = getFormatForState(state);
 
     if (format.empty()) {
       event_box_.hide();
     } else {
       event_box_.show();
       auto icons = std::vector<std::string>{state};
-      label_.set_markup(fmt::format(
-          format, used_ram_percentage, fmt::arg("icon", getIcon(used_ram_percentage, icons)),
-          fmt::arg("total", total_ram_gigabytes), fmt::arg("swapTotal", total_swap_gigabytes),
-          fmt::arg("percentage", used_ram_percentage),
-          fmt::arg("swapPercentage", used_swap_percentage), fmt::arg("used", used_ram_gigabytes),
-          fmt::arg("swapUsed", used_swap_gigabytes), fmt::arg("avail", available_ram_gigabytes),
-          fmt::arg("swapAvail", available_swap_gigabytes)));
+      // Variant selection and template compilation happened up front; this is
+      // a slot lookup plus a render into the reused buffer, and only the
+      // referenced fields are materialized.
+      const auto& compiled = getCompiledFormatForState(state);
+      setMarkup(compiled.render([&](fmt::memory_buffer& out, const std::string& field,
+                                            const char* spec) {
+        auto dst = std::back_inserter(out);
+        if (field.empty() || field == "percentage") {
+          fmt::format_to(dst, spec, used_ram_percentage);
+        } else if (field == "icon") {
+          fmt::format_to(dst, spec, getIcon(used_ram_percentage, icons));
+        } else if (field == "total") {
+          fmt::format_to(dst, spec, total_ram_gigabytes);
+        } else if (field == "swapTotal") {
+          fmt::format_to(dst, spec, total_swap_gigabytes);
+        } else if (field == "swapPercentage") {
+          fmt::format_to(dst, spec, used_swap_percentage);
+        } else if (field == "used") {
+          fmt::format_to(dst, spec, used_ram_gigabytes);
+        } else if (field == "swapUsed") {
+          fmt::format_to(dst, spec, used_swap_gigabytes);
+        } else if (field == "avail") {
+          fmt::format_to(dst, spec, available_ram_gigabytes);
+        } else if (field == "swapAvail") {
+          fmt::format_to(dst, spec, available_swap_gigabytes);
+        }
+      }));
     }
 
     if (tooltipEnabled()) {
       if (config_["tooltip-format"].isString()) {
         auto tooltip_format = config_["tooltip-format"].asString();
-        label_.set_tooltip_text(fmt::format(
+        setTooltipText(fmt::format(
             tooltip_format, used_ram_percentage, fmt::arg("total", total_ram_gigabytes),
             fmt::arg("swapTotal", total_swap_gigabytes),
             fmt::arg("percentage", used_ram_percentage),
@@ -74,7 +87,7 @@ auto waybar::modules::Memory::update() -> void {
             fmt::arg("swapUsed", used_swap_gigabytes), fmt::arg("avail", available_ram_gigabytes),
             fmt::arg("swapAvail", available_swap_gigabytes)));
       } else {
-        label_.set_tooltip_text(fmt::format("{:.{}f}GiB used", used_ram_gigabytes, 1));
+        setTooltipText(fmt::format("{:.{}f}GiB used", used_ram_gigabytes, 1));
       }
     }
   } else {
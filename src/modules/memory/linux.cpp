@@ -1,5 +1,7 @@
 #include "modules/memory.hpp"
 
+#include <cstring>
+
 static unsigned zfsArcSize() {
   std::ifstream zfs_arc_stats{"/proc/spl/kstat/zfs/arcstats"};
 
@@ -22,22 +24,67 @@ static unsigned zfsArcSize() {
 }
 
 void waybar::modules::Memory::parseMeminfo() {
-  const std::string data_dir_ = "/proc/meminfo";
-  std::ifstream info(data_dir_);
-  if (!info.is_open()) {
-    throw std::runtime_error("Can't open " + data_dir_);
+  // One shared sweep serves every /proc consumer within the freshness window
+  auto snapshot = util::ProcSampler::instance().sample();
+  const auto& data = snapshot->meminfo;
+  if (data.empty()) {
+    throw std::runtime_error("Can't open /proc/meminfo");
   }
-  std::string line;
-  while (getline(info, line)) {
-    auto posDelim = line.find(':');
-    if (posDelim == std::string::npos) {
-      continue;
+  meminfo_ = {};
+  const char* p = data.data();
+  const char* end = p + data.size();
+  while (p < end) {
+    const char* nl = static_cast<const char*>(memchr(p, '\n', end - p));
+    if (nl == nullptr) {
+      nl = end;
     }
-
-    std::string name = line.substr(0, posDelim);
-    int64_t value = std::stol(line.substr(posDelim + 1));
-    meminfo_[name] = value;
+    const char* colon = static_cast<const char*>(memchr(p, ':', nl - p));
+    if (colon != nullptr) {
+      const size_t klen = colon - p;
+      const char* value = colon + 1;
+      // Dispatch on the first byte, then confirm the full key; picks out the
+      // handful of fields update() consumes without touching the rest and
+      // without allocating.
+      auto is = [p, klen](const char* key, size_t len) {
+        return klen == len && memcmp(p, key, len) == 0;
+      };
+      switch (*p) {
+        case 'M':
+          if (is("MemTotal", 8)) {
+            meminfo_.mem_total = util::parseUnsigned(value, nl);
+          } else if (is("MemFree", 7)) {
+            meminfo_.mem_free = util::parseUnsigned(value, nl);
+          } else if (is("MemAvailable", 12)) {
+            meminfo_.mem_available = util::parseUnsigned(value, nl);
+            meminfo_.has_mem_available = true;
+          }
+          break;
+        case 'S':
+          if (is("SwapTotal", 9)) {
+            meminfo_.swap_total = util::parseUnsigned(value, nl);
+          } else if (is("SwapFree", 8)) {
+            meminfo_.swap_free = util::parseUnsigned(value, nl);
+          } else if (is("SReclaimable", 12)) {
+            meminfo_.s_reclaimable = util::parseUnsigned(value, nl);
+          } else if (is("Shmem", 5)) {
+            // exact match only; ShmemHugePages/ShmemPmdMapped fall through
+            meminfo_.shmem = util::parseUnsigned(value, nl);
+          }
+          break;
+        case 'B':
+          if (is("Buffers", 7)) {
+            meminfo_.buffers = util::parseUnsigned(value, nl);
+          }
+          break;
+        case 'C':
+          if (is("Cached", 6)) {
+            meminfo_.cached = util::parseUnsigned(value, nl);
+          }
+          break;
+      }
+    }
+    p = nl == end ? end : nl + 1;
   }
 
-  meminfo_["zfs_size"] = zfsArcSize();
+  meminfo_.zfs_size = zfsArcSize();
 }
@@ -5,6 +5,7 @@
 #include <spdlog/spdlog.h>
 
 #include "modules/mpd/state.hpp"
+#include "util/pango_escape.hpp"
 #if defined(MPD_NOINLINE)
 namespace waybar::modules {
 #include "modules/mpd/state.inl.hpp"
@@ -49,10 +50,10 @@ auto waybar::modules::MPD::update() -> void {
 
 void waybar::modules::MPD::queryMPD() {
   if (connection_ != nullptr) {
-    spdlog::debug("{}: fetching state information", module_name_);
+    SPDLOG_DEBUG("{}: fetching state information", module_name_);
     try {
       fetchState();
-      spdlog::debug("{}: fetch complete", module_name_);
+      SPDLOG_DEBUG("{}: fetch complete", module_name_);
     } catch (std::exception const& e) {
       spdlog::error("{}: {}", module_name_, e.what());
       state_ = MPD_STATE_UNKNOWN;
@@ -83,7 +84,7 @@ void waybar::modules::MPD::setLabel() {
     auto format = config_["format-disconnected"].isString()
                       ? config_["format-disconnected"].asString()
                       : "disconnected";
-    label_.set_markup(format);
+    setMarkup(format);
 
     if (tooltipEnabled()) {
       std::string tooltip_format;
@@ -91,7 +92,7 @@ void waybar::modules::MPD::setLabel() {
                            ? config_["tooltip-format-disconnected"].asString()
                            : "MPD (disconnected)";
       // Nothing to format
-      label_.set_tooltip_text(tooltip_format);
+      setTooltipText(tooltip_format);
     }
     return;
   } else {
@@ -155,12 +156,12 @@ void waybar::modules::MPD::setLabel() {
   if (config_["title-len"].isInt()) title = title.substr(0, config_["title-len"].asInt());
 
   try {
-    label_.set_markup(
-        fmt::format(format, fmt::arg("artist", Glib::Markup::escape_text(artist).raw()),
-                    fmt::arg("albumArtist", Glib::Markup::escape_text(album_artist).raw()),
-                    fmt::arg("album", Glib::Markup::escape_text(album).raw()),
-                    fmt::arg("title", Glib::Markup::escape_text(title).raw()),
-                    fmt::arg("date", Glib::Markup::escape_text(date).raw()),
+    setMarkup(
+        fmt::format(format, fmt::arg("artist", util::pango_escape(artist)),
+                    fmt::arg("albumArtist", util::pango_escape(album_artist)),
+                    fmt::arg("album", util::pango_escape(album)),
+                    fmt::arg("title", util::pango_escape(title)),
+                    fmt::arg("date", util::pango_escape(date)),
                     fmt::arg("volume", volume), fmt::arg("elapsedTime", elapsedTime),
                     fmt::arg("totalTime", totalTime), fmt::arg("songPosition", song_pos),
                     fmt::arg("queueLength", queue_length), fmt::arg("stateIcon", stateIcon),
@@ -184,7 +185,7 @@ void waybar::modules::MPD::setLabel() {
                       fmt::arg("queueLength", queue_length), fmt::arg("stateIcon", stateIcon),
                       fmt::arg("consumeIcon", consumeIcon), fmt::arg("randomIcon", randomIcon),
                       fmt::arg("repeatIcon", repeatIcon), fmt::arg("singleIcon", singleIcon));
-      label_.set_tooltip_text(tooltip_text);
+      setTooltipText(tooltip_text);
     } catch (fmt::format_error const& e) {
       spdlog::warn("mpd: format error (tooltip): {}", e.what());
     }
@@ -246,7 +247,7 @@ void waybar::modules::MPD::tryConnect() {
 
   try {
     checkErrors(connection_.get());
-    spdlog::debug("{}: Connected to MPD", module_name_);
+    SPDLOG_DEBUG("{}: Connected to MPD", module_name_);
 
     if (!password_.empty()) {
       bool res = mpd_run_password(connection_.get(), password_.c_str());
@@ -285,7 +286,7 @@ void waybar::modules::MPD::checkErrors(mpd_connection* conn) {
   }
 }
 
-void waybar::modules::MPD::fetchState() {
+void waybar::modules::MPD::fetchState(enum mpd_idle events) {
   if (connection_ == nullptr) {
     spdlog::error("{}: Not connected to MPD", module_name_);
     return;
@@ -299,8 +300,12 @@ void waybar::modules::MPD::fetchState() {
   state_ = mpd_status_get_state(status_.get());
   checkErrors(conn);
 
-  song_ = detail::unique_song(mpd_run_current_song(conn), &mpd_song_free);
-  checkErrors(conn);
+  // Delta fetch: an options-only event (volume, repeat, ...) cannot change the
+  // current song, so skip that round-trip on the server.
+  if ((events & (MPD_IDLE_PLAYER | MPD_IDLE_QUEUE)) != 0 || song_ == nullptr) {
+    song_ = detail::unique_song(mpd_run_current_song(conn), &mpd_song_free);
+    checkErrors(conn);
+  }
 }
 
 bool waybar::modules::MPD::handlePlayPause(GdkEventButton* const& e) {
@@ -3,6 +3,9 @@
 #include <fmt/chrono.h>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <cstdlib>
+
 #include "modules/mpd/mpd.hpp"
 #if defined(MPD_NOINLINE)
 namespace waybar::modules {
@@ -58,7 +61,7 @@ void Idle::entry() noexcept {
     ctx_->checkErrors(conn);
     spdlog::error("mpd: Idle: failed to register for IDLE events");
   } else {
-    spdlog::debug("mpd: Idle: watching FD");
+    SPDLOG_DEBUG("mpd: Idle: watching FD");
     sigc::slot<bool, Glib::IOCondition const&> idle_slot = sigc::mem_fun(*this, &Idle::on_io);
     idle_connection_ =
         Glib::signal_io().connect(idle_slot, mpd_connection_get_fd(conn),
@@ -69,7 +72,7 @@ void Idle::entry() noexcept {
 void Idle::exit() noexcept {
   if (idle_connection_.connected()) {
     idle_connection_.disconnect();
-    spdlog::debug("mpd: Idle: unwatching FD");
+    SPDLOG_DEBUG("mpd: Idle: unwatching FD");
   }
 }
 
@@ -78,7 +81,7 @@ bool Idle::on_io(Glib::IOCondition const&) {
 
   // callback should do this:
   enum mpd_idle events = mpd_recv_idle(conn, /* ignore_timeout?= */ false);
-  spdlog::debug("mpd: Idle: recv_idle events -> {}", events);
+  SPDLOG_DEBUG("mpd: Idle: recv_idle events -> {}", events);
 
   mpd_response_finish(conn);
   try {
@@ -89,7 +92,7 @@ bool Idle::on_io(Glib::IOCondition const&) {
     return false;
   }
 
-  ctx_->fetchState();
+  ctx_->fetchState(events);
   mpd_state state = ctx_->state();
 
   if (state == MPD_STATE_STOP) {
@@ -113,13 +116,13 @@ bool Idle::on_io(Glib::IOCondition const&) {
 void Playing::entry() noexcept {
   sigc::slot<bool> timer_slot = sigc::mem_fun(*this, &Playing::on_timer);
   timer_connection_ = Glib::signal_timeout().connect(timer_slot, /* milliseconds */ 1'000);
-  spdlog::debug("mpd: Playing: enabled 1 second periodic timer.");
+  SPDLOG_DEBUG("mpd: Playing: enabled 1 second periodic timer.");
 }
 
 void Playing::exit() noexcept {
   if (timer_connection_.connected()) {
     timer_connection_.disconnect();
-    spdlog::debug("mpd: Playing: disabled 1 second periodic timer.");
+    SPDLOG_DEBUG("mpd: Playing: disabled 1 second periodic timer.");
   }
 }
 
@@ -181,13 +184,13 @@ void Playing::update() noexcept { ctx_->do_update(); }
 void Paused::entry() noexcept {
   sigc::slot<bool> timer_slot = sigc::mem_fun(*this, &Paused::on_timer);
   timer_connection_ = Glib::signal_timeout().connect(timer_slot, /* milliseconds */ 200);
-  spdlog::debug("mpd: Paused: enabled 200 ms periodic timer.");
+  SPDLOG_DEBUG("mpd: Paused: enabled 200 ms periodic timer.");
 }
 
 void Paused::exit() noexcept {
   if (timer_connection_.connected()) {
     timer_connection_.disconnect();
-    spdlog::debug("mpd: Paused: disabled 200 ms periodic timer.");
+    SPDLOG_DEBUG("mpd: Paused: disabled 200 ms periodic timer.");
   }
 }
 
@@ -252,13 +255,13 @@ void Paused::update() noexcept { ctx_->do_update(); }
 void Stopped::entry() noexcept {
   sigc::slot<bool> timer_slot = sigc::mem_fun(*this, &Stopped::on_timer);
   timer_connection_ = Glib::signal_timeout().connect(timer_slot, /* milliseconds */ 200);
-  spdlog::debug("mpd: Stopped: enabled 200 ms periodic timer.");
+  SPDLOG_DEBUG("mpd: Stopped: enabled 200 ms periodic timer.");
 }
 
 void Stopped::exit() noexcept {
   if (timer_connection_.connected()) {
     timer_connection_.disconnect();
-    spdlog::debug("mpd: Stopped: disabled 200 ms periodic timer.");
+    SPDLOG_DEBUG("mpd: Stopped: disabled 200 ms periodic timer.");
   }
 }
 
@@ -327,14 +330,14 @@ void Disconnected::arm_timer(int interval) noexcept {
   // register timer
   sigc::slot<bool> timer_slot = sigc::mem_fun(*this, &Disconnected::on_timer);
   timer_connection_ = Glib::signal_timeout().connect(timer_slot, interval);
-  spdlog::debug("mpd: Disconnected: enabled interval timer.");
+  SPDLOG_DEBUG("mpd: Disconnected: enabled interval timer.");
 }
 
 void Disconnected::disarm_timer() noexcept {
   // unregister timer, if present
   if (timer_connection_.connected()) {
     timer_connection_.disconnect();
-    spdlog::debug("mpd: Disconnected: disabled interval timer.");
+    SPDLOG_DEBUG("mpd: Disconnected: disabled interval timer.");
   }
 }
 
@@ -369,7 +372,13 @@ bool Disconnected::on_timer() {
     spdlog::warn("mpd: Disconnected: error: {}", e.what());
   }
 
-  arm_timer(ctx_->interval() * 1'000);
+  // Exponential backoff with jitter: when the server is down or the network is
+  // flaky, hammering it every interval only makes recovery slower.
+  ++retries_;
+  auto delay = ctx_->interval() * 1'000 * (1U << std::min(retries_, 5U));
+  delay = std::min<decltype(delay)>(delay, 60'000);
+  delay += std::rand() % (delay / 10 + 1);
+  arm_timer(delay);
 
   return false;
 }
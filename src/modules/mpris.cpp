@@ -0,0 +1,312 @@
+#include "modules/mpris.hpp"
+
+#include <fmt/format.h>
+#include <glibmm/convert.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+#include "util/dbus_manager.hpp"
+#include "util/icon_cache.hpp"
+
+namespace {
+
+constexpr std::string_view MPRIS_PREFIX = "org.mpris.MediaPlayer2.";
+
+bool is_mpris_name(const Glib::ustring &name) {
+  return name.raw().compare(0, MPRIS_PREFIX.size(), MPRIS_PREFIX) == 0;
+}
+
+}  // namespace
+
+namespace waybar::modules {
+
+Mpris::Mpris(const std::string &id, const Json::Value &config)
+    : AIconLabel(config, "mpris", id, "{artist} - {title}", 0, true, true),
+      preferred_player_(config_["player"].isString() ? config_["player"].asString() : ""),
+      tooltip_format_(config_["tooltip-format"].isString() ? config_["tooltip-format"].asString()
+                                                           : "") {
+  connection_ = util::DBusManager::instance().connection(Gio::DBus::BUS_TYPE_SESSION);
+  if (!connection_) {
+    throw std::runtime_error("Unable to reach the session bus");
+  }
+
+  // players come and go; NameOwnerChanged keeps the list current without polling
+  name_owner_sub_ = connection_->signal_subscribe(
+      sigc::mem_fun(*this, &Mpris::onNameOwnerChanged), "org.freedesktop.DBus",
+      "org.freedesktop.DBus", "NameOwnerChanged", "/org/freedesktop/DBus");
+
+  connection_->call(
+      "/org/freedesktop/DBus", "org.freedesktop.DBus", "ListNames", {},
+      [this](Glib::RefPtr<Gio::AsyncResult> &result) {
+        try {
+          auto reply = connection_->call_finish(result);
+          Glib::Variant<std::vector<Glib::ustring>> names;
+          reply.get_child(names, 0);
+          for (const auto &name : names.get()) {
+            if (is_mpris_name(name)) {
+              addPlayer(name);
+            }
+          }
+        } catch (const Glib::Error &e) {
+          spdlog::error("mpris: ListNames failed: {}", std::string(e.what()));
+        }
+      },
+      "org.freedesktop.DBus");
+
+  dp.emit();
+}
+
+Mpris::~Mpris() {
+  detachPlayer();
+  if (name_owner_sub_ != 0) {
+    connection_->signal_unsubscribe(name_owner_sub_);
+  }
+}
+
+void Mpris::onNameOwnerChanged(const Glib::RefPtr<Gio::DBus::Connection> &, const Glib::ustring &,
+                               const Glib::ustring &, const Glib::ustring &, const Glib::ustring &,
+                               const Glib::VariantContainerBase &params) {
+  Glib::Variant<Glib::ustring> name_v;
+  Glib::Variant<Glib::ustring> new_owner_v;
+  params.get_child(name_v, 0);
+  params.get_child(new_owner_v, 2);
+  const auto name = name_v.get();
+  if (!is_mpris_name(name)) {
+    return;
+  }
+  if (new_owner_v.get().empty()) {
+    removePlayer(name);
+  } else {
+    addPlayer(name);
+  }
+}
+
+void Mpris::addPlayer(const Glib::ustring &name) {
+  if (std::find(players_.begin(), players_.end(), name) == players_.end()) {
+    players_.push_back(name);
+  }
+  selectPlayer();
+}
+
+void Mpris::removePlayer(const Glib::ustring &name) {
+  players_.erase(std::remove(players_.begin(), players_.end(), name), players_.end());
+  if (name == current_player_) {
+    detachPlayer();
+    current_player_.clear();
+    status_.clear();
+    artist_.clear();
+    title_.clear();
+    album_.clear();
+    art_url_.clear();
+    dp.emit();
+  }
+  selectPlayer();
+}
+
+void Mpris::selectPlayer() {
+  Glib::ustring chosen;
+  if (!preferred_player_.empty()) {
+    for (const auto &name : players_) {
+      // match the suffix loosely so "player": "spotify" also catches
+      // org.mpris.MediaPlayer2.spotify.instance1234
+      if (name.raw().compare(MPRIS_PREFIX.size(), preferred_player_.size(), preferred_player_) ==
+          0) {
+        chosen = name;
+        break;
+      }
+    }
+  }
+  if (chosen.empty() && !players_.empty()) {
+    chosen = players_.front();
+  }
+  if (chosen == current_player_) {
+    return;
+  }
+  detachPlayer();
+  current_player_ = chosen;
+  if (!current_player_.empty()) {
+    attachPlayer();
+  }
+  dp.emit();
+}
+
+void Mpris::attachPlayer() {
+  player_proxy_ =
+      util::DBusManager::instance().proxy(Gio::DBus::BUS_TYPE_SESSION, current_player_,
+                                          "/org/mpris/MediaPlayer2", "org.mpris.MediaPlayer2.Player");
+  if (!player_proxy_) {
+    current_player_.clear();
+    return;
+  }
+  // GDBus tracks PropertiesChanged and keeps the shared proxy's cache warm;
+  // we only re-read the cache when it reports a change
+  props_conn_ = player_proxy_->signal_properties_changed().connect(
+      [this](const Gio::DBus::Proxy::MapChangedProperties &, const std::vector<Glib::ustring> &) {
+        if (readPlayer()) {
+          dp.emit();
+        }
+      });
+  readPlayer();
+}
+
+void Mpris::detachPlayer() {
+  props_conn_.disconnect();
+  player_proxy_.reset();
+}
+
+bool Mpris::readPlayer() {
+  std::string status;
+  std::string artist;
+  std::string title;
+  std::string album;
+  std::string art_url;
+
+  Glib::Variant<Glib::ustring> status_v;
+  player_proxy_->get_cached_property(status_v, "PlaybackStatus");
+  if (status_v.gobj() != nullptr) {
+    status = status_v.get();
+  }
+
+  Glib::Variant<std::map<Glib::ustring, Glib::VariantBase>> metadata_v;
+  player_proxy_->get_cached_property(metadata_v, "Metadata");
+  if (metadata_v.gobj() != nullptr) {
+    auto metadata = metadata_v.get();
+    auto get_string = [&metadata](const char *key) -> std::string {
+      auto it = metadata.find(key);
+      if (it == metadata.end()) {
+        return "";
+      }
+      try {
+        return Glib::VariantBase::cast_dynamic<Glib::Variant<Glib::ustring>>(it->second).get();
+      } catch (const std::bad_cast &) {
+        return "";
+      }
+    };
+    title = get_string("xesam:title");
+    album = get_string("xesam:album");
+    art_url = get_string("mpris:artUrl");
+    if (auto it = metadata.find("xesam:artist"); it != metadata.end()) {
+      try {
+        for (const auto &a :
+             Glib::VariantBase::cast_dynamic<Glib::Variant<std::vector<Glib::ustring>>>(it->second)
+                 .get()) {
+          if (!artist.empty()) {
+            artist += ", ";
+          }
+          artist += a.raw();
+        }
+      } catch (const std::bad_cast &) {
+        // some players publish the artist as a plain string
+        artist = get_string("xesam:artist");
+      }
+    }
+  }
+
+  // players re-emit the full metadata dict for every seek or position tick;
+  // don't re-render (or re-fetch the art) when nothing the bar shows changed
+  if (status == status_ && artist == artist_ && title == title_ && album == album_ &&
+      art_url == art_url_) {
+    return false;
+  }
+  status_ = std::move(status);
+  artist_ = std::move(artist);
+  title_ = std::move(title);
+  album_ = std::move(album);
+  art_url_ = std::move(art_url);
+  return true;
+}
+
+auto Mpris::update() -> void {
+  if (current_player_.empty()) {
+    event_box_.hide();
+    return;
+  }
+
+  std::string state = status_ == "Playing" ? "playing" : status_ == "Paused" ? "paused" : "stopped";
+  if (state != status_class_) {
+    if (!status_class_.empty()) {
+      label_.get_style_context()->remove_class(status_class_);
+    }
+    label_.get_style_context()->add_class(state);
+    status_class_ = state;
+  }
+
+  auto text = fmt::format(getFormatForState(state),
+                          fmt::arg("artist", artist_escape_.escape(artist_)),
+                          fmt::arg("title", title_escape_.escape(title_)),
+                          fmt::arg("album", album_escape_.escape(album_)),
+                          fmt::arg("status", status_));
+  if (text.empty()) {
+    event_box_.hide();
+    return;
+  }
+  event_box_.show();
+  setMarkup(text);
+
+  if (tooltipEnabled()) {
+    if (!tooltip_format_.empty()) {
+      setTooltipText(fmt::format(tooltip_format_, fmt::arg("artist", artist_),
+                                 fmt::arg("title", title_), fmt::arg("album", album_),
+                                 fmt::arg("status", status_)));
+    } else if (album_.empty()) {
+      setTooltipText(fmt::format("{} - {}", artist_, title_));
+    } else {
+      setTooltipText(fmt::format("{} - {} ({})", artist_, title_, album_));
+    }
+  }
+
+  if (iconEnabled()) {
+    updateArt();
+  }
+
+  AIconLabel::update();
+}
+
+void Mpris::updateArt() {
+  if (art_url_.rfind("file://", 0) != 0) {
+    image_.set_visible(false);
+    return;
+  }
+  std::string path;
+  try {
+    path = Glib::filename_from_uri(art_url_);
+  } catch (const Glib::Error &) {
+    image_.set_visible(false);
+    return;
+  }
+  int size = config_["icon-size"].isUInt() ? config_["icon-size"].asUInt() : 24;
+  auto pixbuf = util::IconCache::instance().getFile(path, size, [&path, size] {
+    try {
+      return Gdk::Pixbuf::create_from_file(path, size, size, true);
+    } catch (const Glib::Error &) {
+      return Glib::RefPtr<Gdk::Pixbuf>();
+    }
+  });
+  if (pixbuf) {
+    image_.set(pixbuf);
+    image_.set_visible(true);
+  } else {
+    image_.set_visible(false);
+  }
+}
+
+bool Mpris::handleToggle(GdkEventButton *const &e) {
+  // user-provided click actions win over the built-in control
+  if (config_["on-click"].isString()) {
+    return AIconLabel::handleToggle(e);
+  }
+  if (player_proxy_ && e->type == GDK_BUTTON_PRESS && e->button == 1) {
+    player_proxy_->call("PlayPause", [this](Glib::RefPtr<Gio::AsyncResult> &result) {
+      try {
+        player_proxy_->call_finish(result);
+      } catch (const Glib::Error &err) {
+        spdlog::warn("mpris: PlayPause failed: {}", std::string(err.what()));
+      }
+    });
+    return true;
+  }
+  return AIconLabel::handleToggle(e);
+}
+
+}  // namespace waybar::modules
@@ -1,15 +1,19 @@
 #include "modules/network.hpp"
 
 #include <linux/if.h>
+#include <linux/if_link.h>
 #include <spdlog/spdlog.h>
 #include <sys/eventfd.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <fstream>
 #include <optional>
 #include <sstream>
 
 #include "util/format.hpp"
+#include "util/proc_sampler.hpp"
 #ifdef WANT_RFKILL
 #include "util/rfkill.hpp"
 #endif
@@ -23,11 +27,22 @@ constexpr const char *NETDEV_FILE =
     "/proc/net/dev";  // std::ifstream does not take std::string_view as param
 std::optional<std::pair<unsigned long long, unsigned long long>>
 waybar::modules::Network::readBandwidthUsage() {
-  std::ifstream netdev(NETDEV_FILE);
-  if (!netdev) {
+  // Fast path: a single RTM_GETLINK query returns IFLA_STATS64 for the selected
+  // interface with no file I/O or string parsing. The /proc/net/dev walk is kept
+  // for the no-interface case (where counters of several interfaces are summed)
+  // and as a fallback.
+  if (ifid_ > 0) {
+    auto stats = readNetlinkStats();
+    if (stats.has_value()) {
+      return stats;
+    }
+  }
+  auto snapshot = util::ProcSampler::instance().sample();
+  if (snapshot->netdev.empty()) {
     spdlog::warn("Failed to open netdev file {}", NETDEV_FILE);
     return {};
   }
+  std::istringstream netdev(snapshot->netdev);
 
   std::string line;
   // skip the headers (first two lines)
@@ -77,6 +92,86 @@ waybar::modules::Network::readBandwidthUsage() {
   return {{receivedBytes, transmittedBytes}};
 }
 
+std::optional<std::pair<unsigned long long, unsigned long long>>
+waybar::modules::Network::readNetlinkStats() {
+  if (stats_fd_ == -1) {
+    stats_fd_ = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (stats_fd_ == -1) {
+      return {};
+    }
+  }
+
+  struct {
+    struct nlmsghdr nh;
+    struct ifinfomsg ifi;
+  } req = {};
+  req.nh.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+  req.nh.nlmsg_type = RTM_GETLINK;
+  req.nh.nlmsg_flags = NLM_F_REQUEST;
+  req.nh.nlmsg_seq = ++stats_seq_;
+  req.ifi.ifi_family = AF_UNSPEC;
+  req.ifi.ifi_index = ifid_;
+  if (send(stats_fd_, &req, req.nh.nlmsg_len, 0) < 0) {
+    return {};
+  }
+
+  char buf[8192];
+  ssize_t len = recv(stats_fd_, buf, sizeof(buf), 0);
+  if (len <= 0) {
+    return {};
+  }
+  for (struct nlmsghdr *nh = reinterpret_cast<struct nlmsghdr *>(buf); NLMSG_OK(nh, len);
+       nh = NLMSG_NEXT(nh, len)) {
+    if (nh->nlmsg_type == NLMSG_ERROR) {
+      return {};
+    }
+    if (nh->nlmsg_type != RTM_NEWLINK) {
+      continue;
+    }
+    auto ifi = static_cast<struct ifinfomsg *>(NLMSG_DATA(nh));
+    if (ifi->ifi_index != ifid_) {
+      continue;
+    }
+    ssize_t attrlen = IFLA_PAYLOAD(nh);
+    for (struct rtattr *ifla = IFLA_RTA(ifi); RTA_OK(ifla, attrlen);
+         ifla = RTA_NEXT(ifla, attrlen)) {
+      if (ifla->rta_type == IFLA_STATS64 &&
+          RTA_PAYLOAD(ifla) >= sizeof(struct rtnl_link_stats64)) {
+        struct rtnl_link_stats64 stats;
+        memcpy(&stats, RTA_DATA(ifla), sizeof(stats));
+        return {{stats.rx_bytes, stats.tx_bytes}};
+      }
+    }
+  }
+  return {};
+}
+
+void waybar::modules::Network::BandwidthHistory::push(unsigned long long sample) {
+  ewma = primed ? ALPHA * sample + (1.0 - ALPHA) * ewma : sample;
+  primed = true;
+  ring[head] = sample;
+  head = (head + 1) % RING_SIZE;
+  if (count < RING_SIZE) {
+    ++count;
+  }
+  peak = 0;
+  for (size_t i = 0; i < count; ++i) {
+    peak = std::max(peak, ring[i]);
+  }
+}
+
+std::string waybar::modules::Network::BandwidthHistory::sparkline() const {
+  static const char *bars[] = {"▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"};
+  std::string out;
+  out.reserve(count * 3);
+  for (size_t i = 0; i < count; ++i) {
+    auto sample = ring[(head + RING_SIZE - count + i) % RING_SIZE];
+    auto level = peak > 0 ? (sample * 7 + peak / 2) / peak : 0;
+    out += bars[std::min<unsigned long long>(level, 7)];
+  }
+  return out;
+}
+
 waybar::modules::Network::Network(const std::string &id, const Json::Value &config)
     : ALabel(config, "network", id, DEFAULT_FORMAT, 60),
       ifid_(-1),
@@ -94,20 +189,24 @@ waybar::modules::Network::Network(const std::string &id, const Json::Value &conf
       rfkill_{RFKILL_TYPE_WLAN},
 #endif
       frequency_(0.0) {
+  wants_wifi_info_ = formatNeedsWifiInfo();
+  // every bandwidth field shares the prefix, including Avg/Peak/Spark
+  wants_bandwidth_ = formatFieldReferenced("bandwidth");
 
   // Start with some "text" in the module's label_, update() will then
   // update it. Since the text should be different, update() will be able
   // to show or hide the event_box_. This is to work around the case where
   // the module start with no text, but the the event_box_ is shown.
-  label_.set_markup("<s></s>");
-
-  auto bandwidth = readBandwidthUsage();
-  if (bandwidth.has_value()) {
-    bandwidth_down_total_ = (*bandwidth).first;
-    bandwidth_up_total_ = (*bandwidth).second;
-  } else {
-    bandwidth_down_total_ = 0;
-    bandwidth_up_total_ = 0;
+  setMarkup("<s></s>");
+
+  bandwidth_down_total_ = 0;
+  bandwidth_up_total_ = 0;
+  if (wants_bandwidth_) {
+    auto bandwidth = readBandwidthUsage();
+    if (bandwidth.has_value()) {
+      bandwidth_down_total_ = (*bandwidth).first;
+      bandwidth_up_total_ = (*bandwidth).second;
+    }
   }
 
   if (!config_["interface"].isString()) {
@@ -121,6 +220,9 @@ waybar::modules::Network::Network(const std::string &id, const Json::Value &conf
     want_addr_dump_ = true;
   }
 
+  resume_listener_ = util::TimerScheduler::instance().addResumeListener(
+      [this](std::chrono::milliseconds) { rebaseline_bandwidth_.store(true); });
+
   createEventSocket();
   createInfoSocket();
 
@@ -133,12 +235,29 @@ waybar::modules::Network::Network(const std::string &id, const Json::Value &conf
 }
 
 waybar::modules::Network::~Network() {
+  util::TimerScheduler::instance().removeResumeListener(resume_listener_);
+  // Wake the worker out of epoll_wait() and join it before the descriptors
+  // it polls are closed; nothing cancels the thread for us any more.
+  thread_.stop();
+  thread_timer_.stop();
+  if (ev_fd_ > -1) {
+    uint64_t one = 1;
+    (void)!write(ev_fd_, &one, sizeof(one));
+  }
+  thread_.join();
+  thread_timer_.join();
   if (ev_fd_ > -1) {
     close(ev_fd_);
   }
   if (efd_ > -1) {
     close(efd_);
   }
+  if (stats_fd_ > -1) {
+    close(stats_fd_);
+  }
+  if (scan_msg_ != nullptr) {
+    nlmsg_free(scan_msg_);
+  }
   if (ev_sock_ != nullptr) {
     nl_socket_drop_membership(ev_sock_, RTNLGRP_LINK);
     if (family_ == AF_INET) {
@@ -293,18 +412,32 @@ auto waybar::modules::Network::update() -> void {
   std::lock_guard<std::mutex> lock(mutex_);
   std::string tooltip_format;
 
-  auto bandwidth = readBandwidthUsage();
   auto bandwidth_down = 0ull;
   auto bandwidth_up = 0ull;
-  if (bandwidth.has_value()) {
-    auto down_octets = (*bandwidth).first;
-    auto up_octets = (*bandwidth).second;
+  if (wants_bandwidth_) {
+    // skipped entirely when no format references a {bandwidth*} field
+    auto bandwidth = readBandwidthUsage();
+    if (rebaseline_bandwidth_.exchange(false)) {
+      // coming back from suspend: the octets that accumulated while asleep
+      // are not one interval's worth of traffic, start counting from here
+      if (bandwidth.has_value()) {
+        bandwidth_down_total_ = (*bandwidth).first;
+        bandwidth_up_total_ = (*bandwidth).second;
+      }
+    } else {
+      if (bandwidth.has_value()) {
+        auto down_octets = (*bandwidth).first;
+        auto up_octets = (*bandwidth).second;
 
-    bandwidth_down = down_octets - bandwidth_down_total_;
-    bandwidth_down_total_ = down_octets;
+        bandwidth_down = down_octets - bandwidth_down_total_;
+        bandwidth_down_total_ = down_octets;
 
-    bandwidth_up = up_octets - bandwidth_up_total_;
-    bandwidth_up_total_ = up_octets;
+        bandwidth_up = up_octets - bandwidth_up_total_;
+        bandwidth_up_total_ = up_octets;
+      }
+      bandwidth_down_history_.push(bandwidth_down / interval_.count());
+      bandwidth_up_history_.push(bandwidth_up / interval_.count());
+    }
   }
 
   if (!alt_) {
@@ -342,9 +475,16 @@ auto waybar::modules::Network::update() -> void {
       fmt::arg("bandwidthDownOctets", pow_format(bandwidth_down / interval_.count(), "o/s")),
       fmt::arg("bandwidthUpOctets", pow_format(bandwidth_up / interval_.count(), "o/s")),
       fmt::arg("bandwidthDownBytes", pow_format(bandwidth_down / interval_.count(), "B/s")),
-      fmt::arg("bandwidthUpBytes", pow_format(bandwidth_up / interval_.count(), "B/s")));
+      fmt::arg("bandwidthUpBytes", pow_format(bandwidth_up / interval_.count(), "B/s")),
+      fmt::arg("bandwidthDownAvg",
+               pow_format((unsigned long long)bandwidth_down_history_.ewma, "B/s")),
+      fmt::arg("bandwidthUpAvg", pow_format((unsigned long long)bandwidth_up_history_.ewma, "B/s")),
+      fmt::arg("bandwidthDownPeak", pow_format(bandwidth_down_history_.peak, "B/s")),
+      fmt::arg("bandwidthUpPeak", pow_format(bandwidth_up_history_.peak, "B/s")),
+      fmt::arg("bandwidthDownSpark", bandwidth_down_history_.sparkline()),
+      fmt::arg("bandwidthUpSpark", bandwidth_up_history_.sparkline()));
   if (text.compare(label_.get_label()) != 0) {
-    label_.set_markup(text);
+    setMarkup(text);
     if (text.empty()) {
       event_box_.hide();
     } else {
@@ -369,12 +509,20 @@ auto waybar::modules::Network::update() -> void {
           fmt::arg("bandwidthDownOctets", pow_format(bandwidth_down / interval_.count(), "o/s")),
           fmt::arg("bandwidthUpOctets", pow_format(bandwidth_up / interval_.count(), "o/s")),
           fmt::arg("bandwidthDownBytes", pow_format(bandwidth_down / interval_.count(), "B/s")),
-          fmt::arg("bandwidthUpBytes", pow_format(bandwidth_up / interval_.count(), "B/s")));
+          fmt::arg("bandwidthUpBytes", pow_format(bandwidth_up / interval_.count(), "B/s")),
+          fmt::arg("bandwidthDownAvg",
+                   pow_format((unsigned long long)bandwidth_down_history_.ewma, "B/s")),
+          fmt::arg("bandwidthUpAvg",
+                   pow_format((unsigned long long)bandwidth_up_history_.ewma, "B/s")),
+          fmt::arg("bandwidthDownPeak", pow_format(bandwidth_down_history_.peak, "B/s")),
+          fmt::arg("bandwidthUpPeak", pow_format(bandwidth_up_history_.peak, "B/s")),
+          fmt::arg("bandwidthDownSpark", bandwidth_down_history_.sparkline()),
+          fmt::arg("bandwidthUpSpark", bandwidth_up_history_.sparkline()));
       if (label_.get_tooltip_text() != tooltip_text) {
-        label_.set_tooltip_text(tooltip_text);
+        setTooltipText(tooltip_text);
       }
     } else if (label_.get_tooltip_text() != text) {
-      label_.set_tooltip_text(text);
+      setTooltipText(text);
     }
   }
 
@@ -431,11 +579,16 @@ int waybar::modules::Network::handleEvents(struct nl_msg *msg, void *data) {
       if (net->ifid_ != -1 && !(ifi->ifi_flags & IFF_UP) && !net->config_["interface"].isString()) {
         // The current interface is now down, all the routes associated with
         // it have been deleted, so start looking for a new default route.
-        spdlog::debug("network: if{} down", net->ifid_);
+        SPDLOG_DEBUG("network: if{} down", net->ifid_);
+        net->forgetRoutes(net->ifid_);
         net->clearIface();
         net->dp.emit();
-        net->want_route_dump_ = true;
-        net->askForStateDump();
+        // Another default route may already sit in the cache from earlier
+        // multicast events; only a cache miss costs a full dump.
+        if (!net->selectBestRoute()) {
+          net->want_route_dump_ = true;
+          net->askForStateDump();
+        }
         return NL_OK;
       }
 
@@ -478,7 +631,7 @@ int waybar::modules::Network::handleEvents(struct nl_msg *msg, void *data) {
         // Checking if it's an interface we care about.
         std::string new_ifname(ifname, ifname_len);
         if (net->checkInterface(new_ifname)) {
-          spdlog::debug("network: selecting new interface {}/{}", new_ifname, ifi->ifi_index);
+          SPDLOG_DEBUG("network: selecting new interface {}/{}", new_ifname, ifi->ifi_index);
 
           net->ifname_ = new_ifname;
           net->ifid_ = ifi->ifi_index;
@@ -494,7 +647,7 @@ int waybar::modules::Network::handleEvents(struct nl_msg *msg, void *data) {
         }
       } else if (is_del_event && net->ifid_ >= 0) {
         // Our interface has been deleted, start looking/waiting for one we care.
-        spdlog::debug("network: interface {}/{} deleted", net->ifname_, net->ifid_);
+        SPDLOG_DEBUG("network: interface {}/{} deleted", net->ifname_, net->ifid_);
 
         net->clearIface();
         net->dp.emit();
@@ -547,12 +700,12 @@ int waybar::modules::Network::handleEvents(struct nl_msg *msg, void *data) {
                   net->netmask_ = inet_ntop(ifa->ifa_family, &netmask, ipaddr, sizeof(ipaddr));
                 }
               }
-              spdlog::debug("network: {}, new addr {}/{}", net->ifname_, net->ipaddr_, net->cidr_);
+              SPDLOG_DEBUG("network: {}, new addr {}/{}", net->ifname_, net->ipaddr_, net->cidr_);
             } else {
               net->ipaddr_.clear();
               net->cidr_ = 0;
               net->netmask_.clear();
-              spdlog::debug("network: {} addr deleted {}/{}", net->ifname_,
+              SPDLOG_DEBUG("network: {} addr deleted {}/{}", net->ifname_,
                             inet_ntop(ifa->ifa_family, RTA_DATA(ifa_rta), ipaddr, sizeof(ipaddr)),
                             ifa->ifa_prefixlen);
             }
@@ -632,49 +785,30 @@ int waybar::modules::Network::handleEvents(struct nl_msg *msg, void *data) {
 
       // Check if we have a default route.
       if (has_gateway && !has_destination && temp_idx != -1) {
-        // Check if this is the first default route we see, or if this new
-        // route have a higher priority.
-        if (!is_del_event && ((net->ifid_ == -1) || (priority < net->route_priority))) {
-          // Clear if's state for the case were there is a higher priority
-          // route on a different interface.
-          net->clearIface();
-          net->ifid_ = temp_idx;
-          net->route_priority = priority;
-          net->gwaddr_ = temp_gw_addr;
-          spdlog::debug("network: new default route via {} on if{} metric {}", temp_gw_addr,
-                        temp_idx, priority);
-
-          /* Ask ifname associated with temp_idx as well as carrier status */
-          struct ifinfomsg ifinfo_hdr = {
-              .ifi_family = AF_UNSPEC,
-              .ifi_index = temp_idx,
-          };
-          int err;
-          err = nl_send_simple(net->ev_sock_, RTM_GETLINK, NLM_F_REQUEST, &ifinfo_hdr,
-                               sizeof(ifinfo_hdr));
-          if (err < 0) {
-            spdlog::error("network: failed to ask link info: {}", err);
-            /* Ask for a dump of all links instead */
-            net->want_link_dump_ = true;
+        if (!is_del_event) {
+          net->cacheRoute(temp_idx, priority, temp_gw_addr);
+          // Check if this is the first default route we see, or if this new
+          // route have a higher priority.
+          if ((net->ifid_ == -1) || (priority < net->route_priority)) {
+            net->adoptRoute(temp_idx, priority, temp_gw_addr);
           }
+        } else {
+          net->uncacheRoute(temp_idx, priority);
+          if (temp_idx == net->ifid_ && net->route_priority == priority) {
+            SPDLOG_DEBUG("network: default route deleted {}/if{} metric {}", net->ifname_,
+                          temp_idx, priority);
 
-          /* Also ask for the address. Asking for a addresses of a specific
-           * interface doesn't seems to work so ask for a dump of all
-           * addresses. */
-          net->want_addr_dump_ = true;
-          net->askForStateDump();
-          net->thread_timer_.wake_up();
-        } else if (is_del_event && temp_idx == net->ifid_ && net->route_priority == priority) {
-          spdlog::debug("network: default route deleted {}/if{} metric {}", net->ifname_, temp_idx,
-                        priority);
-
-          net->clearIface();
-          net->dp.emit();
-          /* Ask for a dump of all routes in case another one is already
-           * setup. If there's none, there'll be an event with new one
-           * later. */
-          net->want_route_dump_ = true;
-          net->askForStateDump();
+            net->clearIface();
+            net->dp.emit();
+            /* Another default route may already be cached from earlier
+             * multicast events; only when the cache has no answer do we pay
+             * for a dump of all routes. If there's none at all, there'll be
+             * an event with a new one later. */
+            if (!net->selectBestRoute()) {
+              net->want_route_dump_ = true;
+              net->askForStateDump();
+            }
+          }
         }
       }
       break;
@@ -719,6 +853,81 @@ int waybar::modules::Network::handleEventsDone(struct nl_msg *msg, void *data) {
   return NL_OK;
 }
 
+void waybar::modules::Network::cacheRoute(int ifindex, uint32_t priority,
+                                          const std::string &gwaddr) {
+  for (auto &route : default_routes_) {
+    if (route.ifindex == ifindex && route.priority == priority) {
+      route.gwaddr = gwaddr;
+      return;
+    }
+  }
+  default_routes_.push_back({ifindex, priority, gwaddr});
+}
+
+void waybar::modules::Network::uncacheRoute(int ifindex, uint32_t priority) {
+  for (auto it = default_routes_.begin(); it != default_routes_.end(); ++it) {
+    if (it->ifindex == ifindex && it->priority == priority) {
+      default_routes_.erase(it);
+      return;
+    }
+  }
+}
+
+void waybar::modules::Network::forgetRoutes(int ifindex) {
+  default_routes_.erase(std::remove_if(default_routes_.begin(), default_routes_.end(),
+                                       [ifindex](const auto &route) {
+                                         return route.ifindex == ifindex;
+                                       }),
+                        default_routes_.end());
+}
+
+void waybar::modules::Network::adoptRoute(int ifindex, uint32_t priority,
+                                          const std::string &gwaddr) {
+  // Clear if's state for the case were there is a higher priority
+  // route on a different interface.
+  clearIface();
+  ifid_ = ifindex;
+  route_priority = priority;
+  gwaddr_ = gwaddr;
+  SPDLOG_DEBUG("network: new default route via {} on if{} metric {}", gwaddr, ifindex, priority);
+
+  /* Ask ifname associated with ifindex as well as carrier status */
+  struct ifinfomsg ifinfo_hdr = {
+      .ifi_family = AF_UNSPEC,
+      .ifi_index = ifindex,
+  };
+  int err;
+  err = nl_send_simple(ev_sock_, RTM_GETLINK, NLM_F_REQUEST, &ifinfo_hdr, sizeof(ifinfo_hdr));
+  if (err < 0) {
+    spdlog::error("network: failed to ask link info: {}", err);
+    /* Ask for a dump of all links instead */
+    want_link_dump_ = true;
+  }
+
+  /* Also ask for the address. Asking for a addresses of a specific
+   * interface doesn't seems to work so ask for a dump of all
+   * addresses. */
+  want_addr_dump_ = true;
+  askForStateDump();
+  thread_timer_.wake_up();
+}
+
+bool waybar::modules::Network::selectBestRoute() {
+  const DefaultRoute *best = nullptr;
+  for (const auto &route : default_routes_) {
+    if (best == nullptr || route.priority < best->priority) {
+      best = &route;
+    }
+  }
+  if (best == nullptr) {
+    return false;
+  }
+  SPDLOG_DEBUG("network: cached default route via {} on if{} metric {}", best->gwaddr,
+                best->ifindex, best->priority);
+  adoptRoute(best->ifindex, best->priority, best->gwaddr);
+  return true;
+}
+
 int waybar::modules::Network::handleScan(struct nl_msg *msg, void *data) {
   auto net = static_cast<waybar::modules::Network *>(data);
   auto gnlh = static_cast<genlmsghdr *>(nlmsg_data(nlmsg_hdr(msg)));
@@ -831,18 +1040,57 @@ bool waybar::modules::Network::associatedOrJoined(struct nlattr **bss) {
   }
 }
 
+bool waybar::modules::Network::formatNeedsWifiInfo() const {
+  // The wifi/ethernet distinction itself hinges on the essid, so a
+  // state-specific format is as good as a reference to a wifi field.
+  for (const auto &key : config_.getMemberNames()) {
+    if (key.rfind("format", 0) != 0 && key.rfind("tooltip-format", 0) != 0) {
+      continue;
+    }
+    if (key.find("wifi") != std::string::npos || key.find("ethernet") != std::string::npos) {
+      return true;
+    }
+  }
+  if (formatFieldReferenced("essid") || formatFieldReferenced("signal") ||
+      formatFieldReferenced("frequency") || formatFieldReferenced("icon")) {
+    return true;
+  }
+  // "states" classes are driven by the signal strength percentage
+  return config_["states"].isObject();
+}
+
 auto waybar::modules::Network::getInfo() -> void {
-  struct nl_msg *nl_msg = nlmsg_alloc();
-  if (nl_msg == nullptr) {
+  if (!wants_wifi_info_) {
     return;
   }
-  if (genlmsg_put(nl_msg, NL_AUTO_PORT, NL_AUTO_SEQ, nl80211_id_, 0, NLM_F_DUMP,
-                  NL80211_CMD_GET_SCAN, 0) == nullptr ||
-      nla_put_u32(nl_msg, NL80211_ATTR_IFINDEX, ifid_) < 0) {
-    nlmsg_free(nl_msg);
+  // Rebuild the request only when the selected interface changes; otherwise
+  // the prebuilt message (family id and ifindex already resolved) is reused.
+  if (scan_msg_ == nullptr || scan_msg_ifid_ != ifid_) {
+    if (scan_msg_ != nullptr) {
+      nlmsg_free(scan_msg_);
+      scan_msg_ = nullptr;
+    }
+    struct nl_msg *nl_msg = nlmsg_alloc();
+    if (nl_msg == nullptr) {
+      return;
+    }
+    if (genlmsg_put(nl_msg, NL_AUTO_PORT, NL_AUTO_SEQ, nl80211_id_, 0, NLM_F_DUMP,
+                    NL80211_CMD_GET_SCAN, 0) == nullptr ||
+        nla_put_u32(nl_msg, NL80211_ATTR_IFINDEX, ifid_) < 0) {
+      nlmsg_free(nl_msg);
+      return;
+    }
+    scan_msg_ = nl_msg;
+    scan_msg_ifid_ = ifid_;
+  }
+  // nl_send_sync() would free the message; send and wait for completion
+  // ourselves. Re-arming the sequence sentinel makes nl_send_auto() stamp a
+  // fresh sequence number on each reuse.
+  nlmsg_hdr(scan_msg_)->nlmsg_seq = NL_AUTO_SEQ;
+  if (nl_send_auto(sock_, scan_msg_) < 0) {
     return;
   }
-  nl_send_sync(sock_, nl_msg);
+  nl_wait_for_ack(sock_);
 }
 
 // https://gist.github.com/rressi/92af77630faf055934c723ce93ae2495
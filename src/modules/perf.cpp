@@ -0,0 +1,32 @@
+#include "modules/perf.hpp"
+
+#include "util/perf_counters.hpp"
+
+waybar::modules::Perf::Perf(const std::string& id, const Json::Value& config)
+    : ALabel(config, "perf", id, "{worst} {p99}µs", 5) {
+  worker_.start(interval_, [this] { dp.emit(); });
+}
+
+auto waybar::modules::Perf::update() -> void {
+  auto snap = util::PerfCounters::instance().snapshot();
+  setMarkup(fmt::format(format_, fmt::arg("worst", snap.worst), fmt::arg("p99", snap.worst_p99_us),
+                        fmt::arg("updates", snap.updates), fmt::arg("rate", snap.rate)));
+  if (tooltipEnabled()) {
+    auto json = util::PerfCounters::instance().toJson();
+    std::string text;
+    for (const auto& key : json["timings"].getMemberNames()) {
+      const auto& node = json["timings"][key];
+      text += fmt::format("{}: p50 {}µs, p99 {}µs, n={}\n", key, node["p50_us"].asUInt64(),
+                          node["p99_us"].asUInt64(), node["count"].asUInt64());
+    }
+    if (!text.empty()) {
+      text.pop_back();
+    }
+    setTooltipText(text);
+  }
+  ALabel::update();
+}
+
+void waybar::modules::Perf::onSuspended(bool suspended) {
+  suspended ? worker_.pause() : worker_.resume();
+}
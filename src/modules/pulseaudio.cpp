@@ -32,7 +32,7 @@ waybar::modules::Pulseaudio::Pulseaudio(const std::string &id, const Json::Value
   }
   pa_threaded_mainloop_unlock(mainloop_);
   event_box_.add_events(Gdk::SCROLL_MASK | Gdk::SMOOTH_SCROLL_MASK);
-  event_box_.signal_scroll_event().connect(sigc::mem_fun(*this, &Pulseaudio::handleScroll));
+  event_box_.signal_scroll_event().connect(sigc::mem_fun(*this, &AModule::handleScroll));
 }
 
 waybar::modules::Pulseaudio::~Pulseaudio() {
@@ -70,22 +70,15 @@ void waybar::modules::Pulseaudio::contextStateCb(pa_context *c, void *data) {
   }
 }
 
-bool waybar::modules::Pulseaudio::handleScroll(GdkEventScroll *e) {
+void waybar::modules::Pulseaudio::applyScroll(int steps) {
   // change the pulse volume only when no user provided
   // events are configured
   if (config_["on-scroll-up"].isString() || config_["on-scroll-down"].isString()) {
-    return AModule::handleScroll(e);
-  }
-  auto dir = AModule::getScrollDir(e);
-  if (dir == SCROLL_DIR::NONE) {
-    return true;
+    AModule::applyScroll(steps);
+    return;
   }
   if (config_["reverse-scrolling"].asInt() == 1) {
-    if (dir == SCROLL_DIR::UP) {
-      dir = SCROLL_DIR::DOWN;
-    } else if (dir == SCROLL_DIR::DOWN) {
-      dir = SCROLL_DIR::UP;
-    }
+    steps = -steps;
   }
   double volume_tick = static_cast<double>(PA_VOLUME_NORM) / 100;
   pa_volume_t change = volume_tick;
@@ -94,17 +87,18 @@ bool waybar::modules::Pulseaudio::handleScroll(GdkEventScroll *e) {
   if (config_["scroll-step"].isDouble()) {
     change = round(config_["scroll-step"].asDouble() * volume_tick);
   }
-  if (dir == SCROLL_DIR::UP) {
+  // The whole gesture arrives as one batched delta; apply it in a single
+  // volume change instead of one server round trip per wheel detent.
+  if (steps > 0) {
     if (volume_ + 1 <= 100) {
-      pa_cvolume_inc(&pa_volume, change);
+      pa_cvolume_inc(&pa_volume, change * steps);
     }
-  } else if (dir == SCROLL_DIR::DOWN) {
+  } else {
     if (volume_ - 1 >= 0) {
-      pa_cvolume_dec(&pa_volume, change);
+      pa_cvolume_dec(&pa_volume, change * -steps);
     }
   }
   pa_context_set_sink_volume_by_index(context_, sink_idx_, &pa_volume, volumeModifyCb, this);
-  return true;
 }
 
 /*
@@ -154,7 +148,7 @@ void waybar::modules::Pulseaudio::sourceInfoCb(pa_context * /*context*/, const p
     pa->source_muted_ = i->mute != 0;
     pa->source_desc_ = i->description;
     pa->source_port_name_ = i->active_port != nullptr ? i->active_port->name : "Unknown";
-    pa->dp.emit();
+    pa->emitUpdate();
   }
 }
 
@@ -191,7 +185,7 @@ void waybar::modules::Pulseaudio::sinkInfoCb(pa_context * /*context*/, const pa_
     if (auto ff = pa_proplist_gets(i->proplist, PA_PROP_DEVICE_FORM_FACTOR)) {
       pa->form_factor_ = ff;
     }
-    pa->dp.emit();
+    pa->emitUpdate();
   }
 }
 
@@ -226,7 +220,27 @@ const std::vector<std::string> waybar::modules::Pulseaudio::getPulseIcon() const
   return res;
 }
 
+void waybar::modules::Pulseaudio::emitUpdate() {
+  // Dragging a volume slider produces dozens of change events in a few hundred ms;
+  // while an update is pending further events are already covered by it.
+  if (!update_pending_.exchange(true)) {
+    dp.emit();
+  }
+}
+
 auto waybar::modules::Pulseaudio::update() -> void {
+  update_pending_.store(false);
+
+  // Cheap dirty check on the rendered inputs: event storms that settle on the same
+  // state skip the whole format/GTK path.
+  auto render_key =
+      fmt::format("{}|{}|{}|{}|{}|{}|{}|{}|{}|{}", volume_, muted_, source_volume_, source_muted_,
+                  desc_, source_desc_, port_name_, form_factor_, monitor_, alt_);
+  if (render_key == last_render_key_) {
+    return;
+  }
+  last_render_key_ = std::move(render_key);
+
   auto format = format_;
   std::string tooltip_format;
   if (!alt_) {
@@ -266,7 +280,7 @@ auto waybar::modules::Pulseaudio::update() -> void {
     }
   }
   format_source = fmt::format(format_source, fmt::arg("volume", source_volume_));
-  label_.set_markup(fmt::format(
+  setMarkup(fmt::format(
       format, fmt::arg("desc", desc_), fmt::arg("volume", volume_),
       fmt::arg("format_source", format_source), fmt::arg("source_volume", source_volume_),
       fmt::arg("source_desc", source_desc_), fmt::arg("icon", getIcon(volume_, getPulseIcon()))));
@@ -277,13 +291,13 @@ auto waybar::modules::Pulseaudio::update() -> void {
       tooltip_format = config_["tooltip-format"].asString();
     }
     if (!tooltip_format.empty()) {
-      label_.set_tooltip_text(fmt::format(
+      setTooltipText(fmt::format(
           tooltip_format, fmt::arg("desc", desc_), fmt::arg("volume", volume_),
           fmt::arg("format_source", format_source), fmt::arg("source_volume", source_volume_),
           fmt::arg("source_desc", source_desc_),
           fmt::arg("icon", getIcon(volume_, getPulseIcon()))));
     } else {
-      label_.set_tooltip_text(desc_);
+      setTooltipText(desc_);
     }
   }
 
@@ -181,47 +181,35 @@ bool Tags::handle_button_press(GdkEventButton *event_button, uint32_t tag) {
   return true;
 }
 
-void Tags::handle_focused_tags(uint32_t tags) {
-  uint32_t i = 0;
-  for (auto &button : buttons_) {
-    if ((1 << i) & tags) {
-      button.get_style_context()->add_class("focused");
+void Tags::apply_tags_delta(uint32_t tags, uint32_t &cached, const char *class_name) {
+  uint32_t changed = tags ^ cached;
+  cached = tags;
+  for (uint32_t i = 0; changed != 0 && i < buttons_.size(); ++i) {
+    const uint32_t bit = 1u << i;
+    if ((changed & bit) == 0) {
+      continue;
+    }
+    changed &= ~bit;
+    if ((tags & bit) != 0) {
+      buttons_[i].get_style_context()->add_class(class_name);
     } else {
-      button.get_style_context()->remove_class("focused");
+      buttons_[i].get_style_context()->remove_class(class_name);
     }
-    ++i;
   }
 }
 
-void Tags::handle_view_tags(struct wl_array *view_tags) {
-  // First clear all occupied state
-  for (auto &button : buttons_) {
-    button.get_style_context()->remove_class("occupied");
-  }
+void Tags::handle_focused_tags(uint32_t tags) { apply_tags_delta(tags, focused_tags_, "focused"); }
 
-  // Set tags with a view to occupied
+void Tags::handle_view_tags(struct wl_array *view_tags) {
+  // fold the per-view masks into one occupancy mask, then diff it
+  uint32_t occupied = 0;
   uint32_t *start = static_cast<uint32_t *>(view_tags->data);
   for (uint32_t *tags = start; tags < start + view_tags->size / sizeof(uint32_t); ++tags) {
-    uint32_t i = 0;
-    for (auto &button : buttons_) {
-      if (*tags & (1 << i)) {
-        button.get_style_context()->add_class("occupied");
-      }
-      ++i;
-    }
+    occupied |= *tags;
   }
+  apply_tags_delta(occupied, occupied_tags_, "occupied");
 }
 
-void Tags::handle_urgent_tags(uint32_t tags) {
-  uint32_t i = 0;
-  for (auto &button : buttons_) {
-    if ((1 << i) & tags) {
-      button.get_style_context()->add_class("urgent");
-    } else {
-      button.get_style_context()->remove_class("urgent");
-    }
-    ++i;
-  }
-}
+void Tags::handle_urgent_tags(uint32_t tags) { apply_tags_delta(tags, urgent_tags_, "urgent"); }
 
 } /* namespace waybar::modules::river */
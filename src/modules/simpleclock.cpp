@@ -2,8 +2,10 @@
 
 #include <time.h>
 
+#include "util/clock_interval.hpp"
+
 waybar::modules::Clock::Clock(const std::string& id, const Json::Value& config)
-    : ALabel(config, "clock", id, "{:%H:%M}", 60) {
+    : ALabel(config, "clock", id, "{:%H:%M}", util::clock_default_interval(config)) {
   thread_ = [this] {
     dp.emit();
     auto now = std::chrono::system_clock::now();
@@ -18,15 +20,15 @@ auto waybar::modules::Clock::update() -> void {
   auto now = std::chrono::system_clock::now();
   auto localtime = fmt::localtime(std::chrono::system_clock::to_time_t(now));
   auto text = fmt::format(format_, localtime);
-  label_.set_markup(text);
+  setMarkup(text);
 
   if (tooltipEnabled()) {
     if (config_["tooltip-format"].isString()) {
       auto tooltip_format = config_["tooltip-format"].asString();
       auto tooltip_text = fmt::format(tooltip_format, localtime);
-      label_.set_tooltip_text(tooltip_text);
+      setTooltipText(tooltip_text);
     } else {
-      label_.set_tooltip_text(text);
+      setTooltipText(text);
     }
   }
   // Call parent update
@@ -3,10 +3,13 @@
 #include <fmt/format.h>
 #include <poll.h>
 #include <spdlog/spdlog.h>
+#include <sys/epoll.h>
 
 #include <algorithm>
 #include <cstdlib>
 
+#include "util/fd_reactor.hpp"
+
 namespace waybar::modules {
 
 void ondesc(void *arg, struct sioctl_desc *d, int curval) {
@@ -30,14 +33,81 @@ auto Sndio::connect_to_sndio() -> void {
   }
 
   if (sioctl_ondesc(hdl_, ondesc, this) == 0) {
+    disconnect();
     throw std::runtime_error("sioctl_ondesc() failed.");
   }
 
   if (sioctl_onval(hdl_, onval, this) == 0) {
+    disconnect();
     throw std::runtime_error("sioctl_onval() failed.");
   }
 
-  pfds_.reserve(sioctl_nfds(hdl_));
+  pfds_.resize(sioctl_nfds(hdl_));
+  int nfds = sioctl_pollfd(hdl_, pfds_.data(), POLLIN);
+  if (nfds == 0) {
+    disconnect();
+    throw std::runtime_error("sioctl_pollfd() failed.");
+  }
+  pfds_.resize(nfds);
+  for (auto &pfd : pfds_) {
+    util::FdReactor::instance().add(pfd.fd, EPOLLIN, [this](uint32_t) { onReady(); });
+    reactor_fds_.push_back(pfd.fd);
+  }
+}
+
+auto Sndio::disconnect() -> void {
+  for (int fd : reactor_fds_) {
+    util::FdReactor::instance().remove(fd);
+  }
+  reactor_fds_.clear();
+  if (hdl_ != nullptr) {
+    sioctl_close(hdl_);
+    hdl_ = nullptr;
+  }
+}
+
+void Sndio::onReady() {
+  if (hdl_ == nullptr) {
+    return;
+  }
+  // sioctl_revents wants the whole pollfd set with revents filled in; the
+  // reactor only told us about one fd, so refresh them with a zero-timeout poll
+  if (poll(pfds_.data(), pfds_.size(), 0) < 0) {
+    return;
+  }
+  int revents = sioctl_revents(hdl_, pfds_.data());
+  if (revents & POLLHUP) {
+    spdlog::warn("sndio disconnected!");
+    disconnect();
+    backoff_ticks_ = 1;
+    backoff_skip_ = 0;
+    reconnect_timer_.resume();
+    return;
+  }
+  dp.emit();
+}
+
+void Sndio::tryReconnect() {
+  if (hdl_ != nullptr) {
+    reconnect_timer_.pause();
+    return;
+  }
+  if (backoff_skip_ > 0) {
+    --backoff_skip_;
+    return;
+  }
+  try {
+    connect_to_sndio();
+  } catch (std::runtime_error const &e) {
+    // sndiod is still down; back off exponentially (1s, 2s, 4s, ... capped)
+    // instead of hammering the socket every tick
+    backoff_skip_ = backoff_ticks_;
+    backoff_ticks_ = std::min(backoff_ticks_ * 2, 32U);
+    return;
+  }
+  spdlog::warn("sndio reconnected!");
+  reconnect_timer_.pause();
+  dp.emit();
 }
 
 Sndio::Sndio(const std::string &id, const Json::Value &config)
@@ -57,48 +127,18 @@ Sndio::Sndio(const std::string &id, const Json::Value &config)
   event_box_.signal_scroll_event().connect(sigc::mem_fun(*this, &Sndio::handleScroll));
   event_box_.signal_button_press_event().connect(sigc::mem_fun(*this, &Sndio::handleToggle));
 
-  thread_ = [this] {
-    dp.emit();
-
-    int nfds = sioctl_pollfd(hdl_, pfds_.data(), POLLIN);
-    if (nfds == 0) {
-      throw std::runtime_error("sioctl_pollfd() failed.");
-    }
-    while (poll(pfds_.data(), nfds, -1) < 0) {
-      if (errno != EINTR) {
-        throw std::runtime_error("poll() failed.");
-      }
-    }
-
-    int revents = sioctl_revents(hdl_, pfds_.data());
-    if (revents & POLLHUP) {
-      spdlog::warn("sndio disconnected!");
-      sioctl_close(hdl_);
-      hdl_ = nullptr;
-
-      // reconnection loop
-      while (thread_.isRunning()) {
-        try {
-          connect_to_sndio();
-        } catch (std::runtime_error const &e) {
-          // avoid leaking hdl_
-          if (hdl_) {
-            sioctl_close(hdl_);
-            hdl_ = nullptr;
-          }
-          // rate limiting for the retries
-          thread_.sleep_for(interval_);
-          continue;
-        }
-
-        spdlog::warn("sndio reconnected!");
-        break;
-      }
-    }
-  };
+  // armed only while disconnected; the guard in tryReconnect() pauses it right
+  // away if the scheduler fires the initial tick before we do
+  reconnect_timer_.start(interval_, [this] { tryReconnect(); });
+  reconnect_timer_.pause();
+
+  dp.emit();
 }
 
-Sndio::~Sndio() { sioctl_close(hdl_); }
+Sndio::~Sndio() {
+  reconnect_timer_.stop();
+  disconnect();
+}
 
 auto Sndio::update() -> void {
   auto format = format_;
@@ -110,7 +150,7 @@ auto Sndio::update() -> void {
     label_.get_style_context()->remove_class("muted");
   }
 
-  label_.set_markup(fmt::format(format, fmt::arg("volume", vol), fmt::arg("raw_value", volume_)));
+  setMarkup(fmt::format(format, fmt::arg("volume", vol), fmt::arg("raw_value", volume_)));
 
   ALabel::update();
 }
@@ -30,6 +30,7 @@ Host::~Host() {
   g_cancellable_cancel(cancellable_);
   g_clear_object(&cancellable_);
   g_clear_object(&watcher_);
+  dropPendingItems();
 }
 
 void Host::busAcquired(const Glib::RefPtr<Gio::DBus::Connection>& conn, Glib::ustring name) {
@@ -44,6 +45,7 @@ void Host::nameAppeared(const Glib::RefPtr<Gio::DBus::Connection>& conn, const G
     // TODO
     return;
   }
+  conn_ = conn;
   cancellable_ = g_cancellable_new();
   sn_watcher_proxy_new(conn->gobj(), G_DBUS_PROXY_FLAGS_NONE, "org.kde.StatusNotifierWatcher",
                        "/StatusNotifierWatcher", cancellable_, &Host::proxyReady, this);
@@ -54,6 +56,8 @@ void Host::nameVanished(const Glib::RefPtr<Gio::DBus::Connection>& conn, const G
   g_clear_object(&cancellable_);
   g_clear_object(&watcher_);
   items_.clear();
+  dropPendingItems();
+  conn_.reset();
 }
 
 void Host::proxyReady(GObject* src, GAsyncResult* res, gpointer data) {
@@ -115,6 +119,15 @@ void Host::itemUnregistered(SnWatcher* watcher, const gchar* service, gpointer d
       break;
     }
   }
+  for (auto it = host->pending_.begin(); it != host->pending_.end(); ++it) {
+    if (it->bus_name == bus_name && it->object_path == object_path) {
+      if (host->conn_) {
+        host->conn_->signal_unsubscribe(it->signal_id);
+      }
+      host->pending_.erase(it);
+      break;
+    }
+  }
 }
 
 std::tuple<std::string, std::string> Host::getBusNameAndObjectPath(const std::string service) {
@@ -131,10 +144,108 @@ void Host::addRegisteredItem(std::string service) {
   auto it = std::find_if(items_.begin(), items_.end(), [&bus_name, &object_path](const auto& item) {
     return bus_name == item->bus_name && object_path == item->object_path;
   });
-  if (it == items_.end()) {
-    items_.emplace_back(new Item(bus_name, object_path, config_, bar_));
-    on_add_(items_.back());
+  if (it != items_.end()) {
+    return;
+  }
+  auto pending =
+      std::find_if(pending_.begin(), pending_.end(), [&bus_name, &object_path](const auto& item) {
+        return bus_name == item.bus_name && object_path == item.object_path;
+      });
+  if (pending != pending_.end()) {
+    return;
+  }
+  if (!conn_ || config_["show-passive-items"].asBool()) {
+    // passive items are rendered anyway, nothing to defer
+    materializeItem(bus_name, object_path);
+    return;
+  }
+  // Peek at Status with a single property Get before committing to a full
+  // Item; Passive registrations stay pending until they turn active, so
+  // chatty apps that register early don't serialize startup behind widget
+  // construction and icon decode for icons nobody sees.
+  auto params = Glib::VariantContainerBase::create_tuple(
+      {Glib::Variant<Glib::ustring>::create("org.kde.StatusNotifierItem"),
+       Glib::Variant<Glib::ustring>::create("Status")});
+  conn_->call(
+      object_path, "org.freedesktop.DBus.Properties", "Get", params,
+      [this, bus_name, object_path](Glib::RefPtr<Gio::AsyncResult>& result) {
+        onInitialStatus(bus_name, object_path, result);
+      },
+      bus_name);
+}
+
+void Host::onInitialStatus(const std::string& bus_name, const std::string& object_path,
+                           Glib::RefPtr<Gio::AsyncResult>& result) {
+  std::string status;
+  try {
+    auto reply = conn_->call_finish(result);
+    Glib::Variant<Glib::VariantBase> value;
+    reply.get_child(value);
+    status =
+        Glib::VariantBase::cast_dynamic<Glib::Variant<Glib::ustring>>(value.get()).get().raw();
+  } catch (const Glib::Error& err) {
+    // not every item exposes Properties cleanly; build it and let the Item
+    // level error handling deal with the rest
+    SPDLOG_DEBUG("Host: failed to query Status of {}{}: {}", bus_name, object_path,
+                  std::string(err.what()));
+  } catch (const std::exception& err) {
+    SPDLOG_DEBUG("Host: failed to query Status of {}{}: {}", bus_name, object_path, err.what());
+  }
+  if (status == "Passive") {
+    deferItem(bus_name, object_path);
+  } else {
+    materializeItem(bus_name, object_path);
+  }
+}
+
+void Host::deferItem(const std::string& bus_name, const std::string& object_path) {
+  PendingItem pending{bus_name, object_path, 0};
+  pending.signal_id =
+      conn_->signal_subscribe(sigc::mem_fun(*this, &Host::onPendingStatusChanged), bus_name,
+                              "org.kde.StatusNotifierItem", "NewStatus", object_path);
+  pending_.push_back(std::move(pending));
+}
+
+void Host::onPendingStatusChanged(const Glib::RefPtr<Gio::DBus::Connection>& conn,
+                                  const Glib::ustring& sender, const Glib::ustring& object_path,
+                                  const Glib::ustring& interface, const Glib::ustring& signal,
+                                  const Glib::VariantContainerBase& params) {
+  std::string status;
+  try {
+    Glib::Variant<Glib::ustring> value;
+    params.get_child(value, 0);
+    status = value.get().raw();
+  } catch (const std::exception& err) {
+    spdlog::warn("Host: malformed NewStatus from {}: {}", std::string(sender), err.what());
+    return;
+  }
+  if (status == "Passive") {
+    return;
+  }
+  for (auto it = pending_.begin(); it != pending_.end(); ++it) {
+    if (it->bus_name == sender.raw() && it->object_path == object_path.raw()) {
+      conn_->signal_unsubscribe(it->signal_id);
+      auto bus_name = it->bus_name;
+      auto path = it->object_path;
+      pending_.erase(it);
+      materializeItem(bus_name, path);
+      break;
+    }
+  }
+}
+
+void Host::materializeItem(const std::string& bus_name, const std::string& object_path) {
+  items_.emplace_back(new Item(bus_name, object_path, config_, bar_));
+  on_add_(items_.back());
+}
+
+void Host::dropPendingItems() {
+  if (conn_) {
+    for (const auto& pending : pending_) {
+      conn_->signal_unsubscribe(pending.signal_id);
+    }
   }
+  pending_.clear();
 }
 
 }  // namespace waybar::modules::SNI
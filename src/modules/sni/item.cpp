@@ -5,10 +5,14 @@
 #include <gtkmm/tooltip.h>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <map>
+#include <set>
 
 #include "util/format.hpp"
+#include "util/icon_cache.hpp"
 
 template <>
 struct fmt::formatter<Glib::VariantBase> : formatter<std::string> {
@@ -116,7 +120,7 @@ ToolTip get_variant<ToolTip>(const Glib::VariantBase& value) {
 
 void Item::setProperty(const Glib::ustring& name, Glib::VariantBase& value) {
   try {
-    spdlog::trace("Set tray item property: {}.{} = {}", id.empty() ? bus_name : id, name, value);
+    SPDLOG_TRACE("Set tray item property: {}.{} = {}", id.empty() ? bus_name : id, name, value);
 
     if (name == "Category") {
       category = get_variant<std::string>(value);
@@ -184,10 +188,33 @@ void Item::setStatus(const Glib::ustring& value) {
 }
 
 void Item::getUpdatedProperties() {
-  auto params = Glib::VariantContainerBase::create_tuple(
-      {Glib::Variant<Glib::ustring>::create(SNI_INTERFACE_NAME)});
-  proxy_->call("org.freedesktop.DBus.Properties.GetAll",
-               sigc::mem_fun(*this, &Item::processUpdatedProperties), params);
+  /* Pixmap-bearing updates go through one GetAll round trip; for everything
+   * else a GetAll would ship the (potentially large) pixmap arrays along with
+   * a title or tooltip change, so those are fetched individually instead. */
+  static const std::set<std::string_view> pixmap_props = {"IconPixmap", "OverlayIconPixmap",
+                                                          "AttentionIconPixmap"};
+  bool need_get_all =
+      std::any_of(update_pending_.begin(), update_pending_.end(),
+                  [](std::string_view prop) { return pixmap_props.count(prop) != 0; });
+  if (need_get_all) {
+    auto params = Glib::VariantContainerBase::create_tuple(
+        {Glib::Variant<Glib::ustring>::create(SNI_INTERFACE_NAME)});
+    proxy_->call("org.freedesktop.DBus.Properties.GetAll",
+                 sigc::mem_fun(*this, &Item::processUpdatedProperties), params);
+    return;
+  }
+  for (const auto& prop : update_pending_) {
+    Glib::ustring name{std::string{prop}};
+    auto params =
+        Glib::VariantContainerBase::create_tuple({Glib::Variant<Glib::ustring>::create(
+                                                      SNI_INTERFACE_NAME),
+                                                  Glib::Variant<Glib::ustring>::create(name)});
+    proxy_->call(
+        "org.freedesktop.DBus.Properties.Get",
+        [this, name](Glib::RefPtr<Gio::AsyncResult>& result) { processUpdatedProperty(name, result); },
+        params);
+  }
+  update_pending_.clear();
 };
 
 void Item::processUpdatedProperties(Glib::RefPtr<Gio::AsyncResult>& _result) {
@@ -198,13 +225,22 @@ void Item::processUpdatedProperties(Glib::RefPtr<Gio::AsyncResult>& _result) {
     result.get_child(properties_variant);
     auto properties = properties_variant.get();
 
+    auto old_icon_name = icon_name;
+    auto old_icon_theme_path = icon_theme_path;
+    bool pixmap_updated = false;
     for (const auto& [name, value] : properties) {
       if (update_pending_.count(name.raw())) {
+        if (name.raw() == "IconPixmap") {
+          pixmap_updated = true;
+        }
         setProperty(name, const_cast<Glib::VariantBase&>(value));
       }
     }
 
-    this->updateImage();
+    // only re-resolve the icon when something icon-related actually moved
+    if (pixmap_updated || icon_name != old_icon_name || icon_theme_path != old_icon_theme_path) {
+      this->updateImage();
+    }
   } catch (const Glib::Error& err) {
     spdlog::warn("Failed to update properties: {}", err.what());
   } catch (const std::exception& err) {
@@ -213,6 +249,28 @@ void Item::processUpdatedProperties(Glib::RefPtr<Gio::AsyncResult>& _result) {
   update_pending_.clear();
 }
 
+void Item::processUpdatedProperty(const Glib::ustring& name, Glib::RefPtr<Gio::AsyncResult>& _result) {
+  try {
+    auto result = proxy_->call_finish(_result);
+    // extract the "v" from the Get reply tuple
+    Glib::Variant<Glib::VariantBase> value_variant;
+    result.get_child(value_variant);
+    auto value = value_variant.get();
+
+    auto old_icon_name = icon_name;
+    auto old_icon_theme_path = icon_theme_path;
+    setProperty(name, value);
+    if (icon_name != old_icon_name || icon_theme_path != old_icon_theme_path ||
+        name.raw() == "Status") {
+      this->updateImage();
+    }
+  } catch (const Glib::Error& err) {
+    spdlog::warn("Failed to update property {}: {}", std::string{name}, err.what());
+  } catch (const std::exception& err) {
+    spdlog::warn("Failed to update property {}: {}", std::string{name}, err.what());
+  }
+}
+
 /**
  * Mapping from a signal name to a set of possibly changed properties.
  * Commented signals are not handled by the tray module at the moment.
@@ -230,7 +288,7 @@ static const std::map<std::string_view, std::set<std::string_view>> signal2props
 
 void Item::onSignal(const Glib::ustring& sender_name, const Glib::ustring& signal_name,
                     const Glib::VariantContainerBase& arguments) {
-  spdlog::trace("Tray item '{}' got signal {}", id, signal_name);
+  SPDLOG_TRACE("Tray item '{}' got signal {}", id, signal_name);
   auto changed = signal2props.find(signal_name.raw());
   if (changed != signal2props.end()) {
     if (update_pending_.empty()) {
@@ -257,23 +315,18 @@ Glib::RefPtr<Gdk::Pixbuf> Item::extractPixBuf(GVariant* variant) {
   gint lheight = 0;
   gint width;
   gint height;
-  guchar* array = nullptr;
+  GVariant* best = nullptr;
   while (g_variant_iter_loop(it, "(ii@ay)", &width, &height, &val)) {
     if (width > 0 && height > 0 && val != nullptr && width * height > lwidth * lheight) {
       auto size = g_variant_get_size(val);
       /* Sanity check */
       if (size == 4U * width * height) {
         /* Find the largest image */
-        gconstpointer data = g_variant_get_data(val);
-        if (data != nullptr) {
-          if (array != nullptr) {
-            g_free(array);
+        if (g_variant_get_data(val) != nullptr) {
+          if (best != nullptr) {
+            g_variant_unref(best);
           }
-#if GLIB_MAJOR_VERSION >= 2 && GLIB_MINOR_VERSION >= 68
-          array = static_cast<guchar*>(g_memdup2(data, size));
-#else
-          array = static_cast<guchar*>(g_memdup(data, size));
-#endif
+          best = g_variant_ref(val);
           lwidth = width;
           lheight = height;
         }
@@ -281,17 +334,36 @@ Glib::RefPtr<Gdk::Pixbuf> Item::extractPixBuf(GVariant* variant) {
     }
   }
   g_variant_iter_free(it);
-  if (array != nullptr) {
-    /* argb to rgba */
-    for (uint32_t i = 0; i < 4U * lwidth * lheight; i += 4) {
-      guchar alpha = array[i];
-      array[i] = array[i + 1];
-      array[i + 1] = array[i + 2];
-      array[i + 2] = array[i + 3];
-      array[i + 3] = alpha;
+  if (best != nullptr) {
+    guchar* dest;
+    Glib::RefPtr<Gdk::Pixbuf> pixbuf;
+    if (icon_pixmap && icon_pixmap->get_width() == lwidth && icon_pixmap->get_height() == lheight &&
+        icon_pixmap->get_rowstride() == 4 * lwidth && icon_pixmap->get_has_alpha()) {
+      /* Animated icons update at a steady rate with constant dimensions;
+       * rewrite the previous frame in place instead of reallocating. */
+      pixbuf = icon_pixmap;
+      dest = pixbuf->get_pixels();
+    } else {
+      dest = static_cast<guchar*>(g_malloc(4U * lwidth * lheight));
+      pixbuf = Gdk::Pixbuf::create_from_data(dest, Gdk::Colorspace::COLORSPACE_RGB, true, 8, lwidth,
+                                             lheight, 4 * lwidth, &pixbuf_data_deleter);
+    }
+    /* argb to rgba: a byte rotate of every pixel, written as a word rotate so
+     * the compiler can vectorize it (SSE2/NEON) instead of shuffling bytes */
+    const guchar* src = static_cast<const guchar*>(g_variant_get_data(best));
+    uint32_t count = static_cast<uint32_t>(lwidth) * lheight;
+    for (uint32_t i = 0; i < count; ++i) {
+      uint32_t argb;
+      memcpy(&argb, src + 4U * i, 4);
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+      uint32_t rgba = (argb >> 8) | (argb << 24);
+#else
+      uint32_t rgba = (argb << 8) | (argb >> 24);
+#endif
+      memcpy(dest + 4U * i, &rgba, 4);
     }
-    return Gdk::Pixbuf::create_from_data(array, Gdk::Colorspace::COLORSPACE_RGB, true, 8, lwidth,
-                                         lheight, 4 * lwidth, &pixbuf_data_deleter);
+    g_variant_unref(best);
+    return pixbuf;
   }
   return Glib::RefPtr<Gdk::Pixbuf>{};
 }
@@ -335,35 +407,40 @@ Glib::RefPtr<Gdk::Pixbuf> Item::getIconPixbuf() {
 }
 
 Glib::RefPtr<Gdk::Pixbuf> Item::getIconByName(const std::string& name, int request_size) {
-  int tmp_size = 0;
-  icon_theme->rescan_if_needed();
-  auto sizes = icon_theme->get_icon_sizes(name.c_str());
-
-  for (auto const& size : sizes) {
-    // -1 == scalable
-    if (size == request_size || size == -1) {
-      tmp_size = request_size;
-      break;
-    } else if (size < request_size) {
-      tmp_size = size;
-    } else if (size > tmp_size && tmp_size > 0) {
+  // every Item owns a private Gtk::IconTheme; key the cache on the default
+  // theme unless an IconThemePath makes this item's lookups actually distinct
+  const auto cache_theme = icon_theme_path.empty() ? Gtk::IconTheme::get_default() : icon_theme;
+  return util::IconCache::instance().get(cache_theme, name, request_size, [&] {
+    int tmp_size = 0;
+    icon_theme->rescan_if_needed();
+    auto sizes = icon_theme->get_icon_sizes(name.c_str());
+
+    for (auto const& size : sizes) {
+      // -1 == scalable
+      if (size == request_size || size == -1) {
+        tmp_size = request_size;
+        break;
+      } else if (size < request_size) {
+        tmp_size = size;
+      } else if (size > tmp_size && tmp_size > 0) {
+        tmp_size = request_size;
+        break;
+      }
+    }
+    if (tmp_size == 0) {
       tmp_size = request_size;
-      break;
     }
-  }
-  if (tmp_size == 0) {
-    tmp_size = request_size;
-  }
-  if (!icon_theme_path.empty() &&
-      icon_theme->lookup_icon(name.c_str(), tmp_size,
-                              Gtk::IconLookupFlags::ICON_LOOKUP_FORCE_SIZE)) {
-    return icon_theme->load_icon(name.c_str(), tmp_size,
-                                 Gtk::IconLookupFlags::ICON_LOOKUP_FORCE_SIZE);
-  }
-  Glib::RefPtr<Gtk::IconTheme> default_theme = Gtk::IconTheme::get_default();
-  default_theme->rescan_if_needed();
-  return default_theme->load_icon(name.c_str(), tmp_size,
-                                  Gtk::IconLookupFlags::ICON_LOOKUP_FORCE_SIZE);
+    if (!icon_theme_path.empty() &&
+        icon_theme->lookup_icon(name.c_str(), tmp_size,
+                                Gtk::IconLookupFlags::ICON_LOOKUP_FORCE_SIZE)) {
+      return icon_theme->load_icon(name.c_str(), tmp_size,
+                                   Gtk::IconLookupFlags::ICON_LOOKUP_FORCE_SIZE);
+    }
+    Glib::RefPtr<Gtk::IconTheme> default_theme = Gtk::IconTheme::get_default();
+    default_theme->rescan_if_needed();
+    return default_theme->load_icon(name.c_str(), tmp_size,
+                                    Gtk::IconLookupFlags::ICON_LOOKUP_FORCE_SIZE);
+  });
 }
 
 double Item::getScaledIconSize() {
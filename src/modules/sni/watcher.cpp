@@ -14,6 +14,15 @@ Watcher::Watcher()
       watcher_(sn_watcher_skeleton_new()) {}
 
 Watcher::~Watcher() {
+  if (flush_idle_id_ != 0) {
+    g_source_remove(flush_idle_id_);
+    flush_idle_id_ = 0;
+  }
+  g_slist_free(pending_watches_);  // entries are owned by hosts_/items_
+  pending_watches_ = nullptr;
+  g_slist_free_full(pending_registered_, g_free);
+  pending_registered_ = nullptr;
+
   if (hosts_ != nullptr) {
     g_slist_free_full(hosts_, gfWatchFree);
     hosts_ = nullptr;
@@ -70,6 +79,8 @@ gboolean Watcher::handleRegisterHost(Watcher* obj, GDBusMethodInvocation* invoca
   }
   watch = gfWatchNew(GF_WATCH_TYPE_HOST, service, bus_name, object_path, obj);
   obj->hosts_ = g_slist_prepend(obj->hosts_, watch);
+  obj->pending_watches_ = g_slist_prepend(obj->pending_watches_, watch);
+  obj->scheduleFlush();
   if (!sn_watcher_get_is_host_registered(obj->watcher_)) {
     sn_watcher_set_is_host_registered(obj->watcher_, TRUE);
     sn_watcher_emit_host_registered(obj->watcher_);
@@ -101,14 +112,57 @@ gboolean Watcher::handleRegisterItem(Watcher* obj, GDBusMethodInvocation* invoca
   }
   watch = gfWatchNew(GF_WATCH_TYPE_ITEM, service, bus_name, object_path, obj);
   obj->items_ = g_slist_prepend(obj->items_, watch);
-  obj->updateRegisteredItems(obj->watcher_);
-  gchar* tmp = g_strdup_printf("%s%s", bus_name, object_path);
-  sn_watcher_emit_item_registered(obj->watcher_, tmp);
-  g_free(tmp);
+  /* defer the property rebuild, the ItemRegistered emission and the
+   * name-owner watch to one idle flush; a session-start burst of
+   * registrations completes its method calls first and pays for the
+   * fan-out once */
+  obj->items_dirty_ = true;
+  obj->pending_registered_ = g_slist_prepend(obj->pending_registered_,
+                                             g_strdup_printf("%s%s", bus_name, object_path));
+  obj->pending_watches_ = g_slist_prepend(obj->pending_watches_, watch);
+  obj->scheduleFlush();
   sn_watcher_complete_register_item(obj->watcher_, invocation);
   return TRUE;
 }
 
+void Watcher::scheduleFlush() {
+  if (flush_idle_id_ == 0) {
+    flush_idle_id_ = g_idle_add(&Watcher::flushRegistrations, this);
+  }
+}
+
+gboolean Watcher::flushRegistrations(gpointer data) {
+  auto obj = static_cast<Watcher*>(data);
+  obj->flush_idle_id_ = 0;
+
+  /* start the name-owner watches only now: the GetNameOwner round trips for
+   * the whole burst go out together instead of interleaving with the
+   * RegisterStatusNotifierItem handling */
+  GSList* watches = obj->pending_watches_;
+  obj->pending_watches_ = nullptr;
+  for (GSList* l = watches; l != nullptr; l = g_slist_next(l)) {
+    auto watch = static_cast<GfWatch*>(l->data);
+    watch->watch_id = g_bus_watch_name(G_BUS_TYPE_SESSION, watch->bus_name,
+                                       G_BUS_NAME_WATCHER_FLAGS_NONE, nullptr,
+                                       &Watcher::nameVanished, watch, nullptr);
+  }
+  g_slist_free(watches);
+
+  if (obj->items_dirty_) {
+    obj->items_dirty_ = false;
+    obj->updateRegisteredItems(obj->watcher_);
+  }
+
+  GSList* registered = g_slist_reverse(obj->pending_registered_);
+  obj->pending_registered_ = nullptr;
+  for (GSList* l = registered; l != nullptr; l = g_slist_next(l)) {
+    sn_watcher_emit_item_registered(obj->watcher_, static_cast<const gchar*>(l->data));
+  }
+  g_slist_free_full(registered, g_free);
+
+  return G_SOURCE_REMOVE;
+}
+
 Watcher::GfWatch* Watcher::gfWatchFind(GSList* list, const gchar* bus_name,
                                        const gchar* object_path) {
   for (GSList* l = list; l != nullptr; l = g_slist_next(l)) {
@@ -143,8 +197,7 @@ Watcher::GfWatch* Watcher::gfWatchNew(GfWatchType type, const gchar* service, co
   watch->service = g_strdup(service);
   watch->bus_name = g_strdup(bus_name);
   watch->object_path = g_strdup(object_path);
-  watch->watch_id = g_bus_watch_name(G_BUS_TYPE_SESSION, bus_name, G_BUS_NAME_WATCHER_FLAGS_NONE,
-                                     nullptr, &Watcher::nameVanished, watch, nullptr);
+  /* watch_id stays 0 until flushRegistrations starts the name-owner watch */
   return watch;
 }
 
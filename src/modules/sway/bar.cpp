@@ -24,14 +24,6 @@ BarIpcClient::BarIpcClient(waybar::Bar& bar) : bar_{bar} {
 
   ipc_.subscribe(R"(["bar_state_update", "barconfig_update"])");
   ipc_.signal_event.connect(sigc::mem_fun(*this, &BarIpcClient::onIpcEvent));
-  // Launch worker
-  ipc_.setWorker([this] {
-    try {
-      ipc_.handleEvent();
-    } catch (const std::exception& e) {
-      spdlog::error("BarIpcClient::handleEvent {}", e.what());
-    }
-  });
 }
 
 struct swaybar_config parseConfig(const Json::Value& payload) {
@@ -62,7 +54,7 @@ void BarIpcClient::onIpcEvent(const struct Ipc::ipc_response& res) {
   try {
     auto payload = parser_.parse(res.payload);
     if (auto id = payload["id"]; id.isString() && id.asString() != bar_.bar_id) {
-      spdlog::trace("swaybar ipc: ignore event for {}", id.asString());
+      SPDLOG_TRACE("swaybar ipc: ignore event for {}", id.asString());
       return;
     }
     if (payload.isMember("visible_by_modifier")) {
@@ -86,7 +78,7 @@ void BarIpcClient::onConfigUpdate(const swaybar_config& config) {
 }
 
 void BarIpcClient::onVisibilityUpdate(bool visible_by_modifier) {
-  spdlog::debug("visiblity update for {}: {}", bar_.bar_id, visible_by_modifier);
+  SPDLOG_DEBUG("visiblity update for {}: {}", bar_.bar_id, visible_by_modifier);
   visible_by_modifier_ = visible_by_modifier;
   update();
 }
@@ -1,16 +1,62 @@
 #include "modules/sway/ipc/client.hpp"
 
 #include <fcntl.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
 
 namespace waybar::modules::sway {
 
-Ipc::Ipc() {
-  const std::string& socketPath = getSocketPath();
+Ipc::Ipc() : conn_(getConnection()) {
+  std::lock_guard<std::mutex> lock(conn_->clients_mutex_);
+  conn_->clients_.emplace_back(this, 0);
+}
+
+Ipc::~Ipc() {
+  std::lock_guard<std::mutex> lock(conn_->clients_mutex_);
+  auto it = std::find_if(conn_->clients_.begin(), conn_->clients_.end(),
+                         [this](const auto &client) { return client.first == this; });
+  if (it != conn_->clients_.end()) {
+    conn_->clients_.erase(it);
+  }
+}
+
+std::shared_ptr<Ipc::Connection> Ipc::getConnection() {
+  static std::mutex mutex;
+  static std::weak_ptr<Connection> weak;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto conn = weak.lock();
+  if (!conn) {
+    conn = std::make_shared<Connection>();
+    weak = conn;
+  }
+  return conn;
+}
+
+void Ipc::sendCmd(uint32_t type, const std::string &payload) {
+  std::lock_guard<std::mutex> lock(conn_->mutex_);
+  const auto res = conn_->send(conn_->fd_, type, payload);
+  signal_cmd.emit(res);
+}
+
+void Ipc::subscribe(const std::string &payload) { conn_->subscribe(this, payload); }
+
+Ipc::Connection::Connection() {
+  const std::string &socketPath = getSocketPath();
   fd_ = open(socketPath);
   fd_event_ = open(socketPath);
+  thread_ = [this] {
+    try {
+      handleEvent();
+    } catch (const std::exception &e) {
+      if (fd_event_ != -1) {
+        spdlog::error("sway ipc: {}", e.what());
+      }
+    }
+  };
 }
 
-Ipc::~Ipc() {
+Ipc::Connection::~Connection() {
   thread_.stop();
 
   if (fd_ > 0) {
@@ -24,19 +70,18 @@ Ipc::~Ipc() {
     close(fd_event_);
     fd_event_ = -1;
   }
+  sub_cv_.notify_all();
 }
 
-void Ipc::setWorker(std::function<void()>&& func) { thread_ = func; }
-
-const std::string Ipc::getSocketPath() const {
-  const char* env = getenv("SWAYSOCK");
+const std::string Ipc::Connection::getSocketPath() const {
+  const char *env = getenv("SWAYSOCK");
   if (env != nullptr) {
     return std::string(env);
   }
   std::string str;
   {
     std::string str_buf;
-    FILE* in;
+    FILE *in;
     char buf[512] = {0};
     if ((in = popen("sway --get-socketpath 2>/dev/null", "r")) == nullptr) {
       throw std::runtime_error("Failed to get socket path");
@@ -56,7 +101,7 @@ const std::string Ipc::getSocketPath() const {
   return str;
 }
 
-int Ipc::open(const std::string& socketPath) const {
+int Ipc::Connection::open(const std::string &socketPath) const {
   int32_t fd = socket(AF_UNIX, SOCK_STREAM, 0);
   if (fd == -1) {
     throw std::runtime_error("Unable to open Unix socket");
@@ -68,16 +113,16 @@ int Ipc::open(const std::string& socketPath) const {
   strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
   addr.sun_path[sizeof(addr.sun_path) - 1] = 0;
   int l = sizeof(struct sockaddr_un);
-  if (::connect(fd, reinterpret_cast<struct sockaddr*>(&addr), l) == -1) {
+  if (::connect(fd, reinterpret_cast<struct sockaddr *>(&addr), l) == -1) {
     throw std::runtime_error("Unable to connect to Sway");
   }
   return fd;
 }
 
-struct Ipc::ipc_response Ipc::recv(int fd) {
+struct Ipc::ipc_response Ipc::Connection::recv(int fd) {
   std::string header;
   header.resize(ipc_header_size_);
-  auto data32 = reinterpret_cast<uint32_t*>(header.data() + ipc_magic_.size());
+  auto data32 = reinterpret_cast<uint32_t *>(header.data() + ipc_magic_.size());
   size_t total = 0;
 
   while (total < ipc_header_size_) {
@@ -112,10 +157,10 @@ struct Ipc::ipc_response Ipc::recv(int fd) {
   return {data32[0], data32[1], &payload.front()};
 }
 
-struct Ipc::ipc_response Ipc::send(int fd, uint32_t type, const std::string& payload) {
+void Ipc::Connection::sendRequest(int fd, uint32_t type, const std::string &payload) {
   std::string header;
   header.resize(ipc_header_size_);
-  auto data32 = reinterpret_cast<uint32_t*>(header.data() + ipc_magic_.size());
+  auto data32 = reinterpret_cast<uint32_t *>(header.data() + ipc_magic_.size());
   memcpy(header.data(), ipc_magic_.c_str(), ipc_magic_.size());
   data32[0] = payload.size();
   data32[1] = type;
@@ -126,25 +171,82 @@ struct Ipc::ipc_response Ipc::send(int fd, uint32_t type, const std::string& pay
   if (::send(fd, payload.c_str(), payload.size(), 0) == -1) {
     throw std::runtime_error("Unable to send IPC payload");
   }
-  return Ipc::recv(fd);
 }
 
-void Ipc::sendCmd(uint32_t type, const std::string& payload) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  const auto res = Ipc::send(fd_, type, payload);
-  signal_cmd.emit(res);
+struct Ipc::ipc_response Ipc::Connection::send(int fd, uint32_t type, const std::string &payload) {
+  sendRequest(fd, type, payload);
+  return recv(fd);
 }
 
-void Ipc::subscribe(const std::string& payload) {
-  auto res = Ipc::send(fd_event_, IPC_SUBSCRIBE, payload);
-  if (res.payload != "{\"success\": true}") {
+void Ipc::Connection::subscribe(Ipc *client, const std::string &payload) {
+  static const std::pair<const char *, uint32_t> events[] = {
+      {"workspace", IPC_EVENT_WORKSPACE},
+      {"output", IPC_EVENT_OUTPUT},
+      {"mode", IPC_EVENT_MODE},
+      {"window", IPC_EVENT_WINDOW},
+      {"barconfig_update", IPC_EVENT_BARCONFIG_UPDATE},
+      {"binding", IPC_EVENT_BINDING},
+      {"shutdown", IPC_EVENT_SHUTDOWN},
+      {"tick", IPC_EVENT_TICK},
+      {"bar_state_update", IPC_EVENT_BAR_STATE_UPDATE},
+      {"input", IPC_EVENT_INPUT},
+  };
+  std::unique_lock<std::mutex> lock(sub_mutex_);
+  uint32_t mask = 0;
+  std::string missing;
+  for (const auto &[name, type] : events) {
+    if (payload.find('"' + std::string(name) + '"') == std::string::npos) {
+      continue;
+    }
+    mask |= event_mask(type);
+    if ((subscriptions_ & event_mask(type)) == 0) {
+      if (!missing.empty()) {
+        missing += ',';
+      }
+      missing += '"';
+      missing += name;
+      missing += '"';
+    }
+  }
+  {
+    std::lock_guard<std::mutex> clients_lock(clients_mutex_);
+    for (auto &client_entry : clients_) {
+      if (client_entry.first == client) {
+        client_entry.second |= mask;
+      }
+    }
+  }
+  if (missing.empty()) {
+    // Every requested event is already flowing on the shared socket.
+    return;
+  }
+  sendRequest(fd_event_, IPC_SUBSCRIBE, '[' + missing + ']');
+  sub_cv_.wait(lock, [this] { return sub_reply_ != nullptr || fd_event_ == -1; });
+  auto res = std::move(sub_reply_);
+  if (!res || res->payload != "{\"success\": true}") {
     throw std::runtime_error("Unable to subscribe ipc event");
   }
+  subscriptions_ |= mask;
 }
 
-void Ipc::handleEvent() {
-  const auto res = Ipc::recv(fd_event_);
-  signal_event.emit(res);
+void Ipc::Connection::handleEvent() {
+  const auto res = recv(fd_event_);
+  if (fd_event_ == -1) {
+    return;
+  }
+  if ((res.type & (1U << 31)) != 0) {
+    std::lock_guard<std::mutex> lock(clients_mutex_);
+    for (const auto &[client, mask] : clients_) {
+      if ((mask & event_mask(res.type)) != 0) {
+        client->signal_event.emit(res);
+      }
+    }
+  } else {
+    // Not an event: the ack for an in-flight SUBSCRIBE request.
+    std::lock_guard<std::mutex> lock(sub_mutex_);
+    sub_reply_ = std::make_unique<ipc_response>(res);
+    sub_cv_.notify_one();
+  }
 }
 
 }  // namespace waybar::modules::sway
@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "modules/sway/ipc/ipc.hpp"
+#include "util/json_sax.hpp"
 #include "util/string.hpp"
 
 namespace waybar::modules::sway {
@@ -29,18 +30,13 @@ Language::Language(const std::string& id, const Json::Value& config)
   if (config.isMember("tooltip-format")) {
     tooltip_format_ = config["tooltip-format"].asString();
   }
+  if (config_["keyboard-name"].isString()) {
+    keyboard_name_ = config_["keyboard-name"].asString();
+  }
   ipc_.subscribe(R"(["input"])");
   ipc_.signal_event.connect(sigc::mem_fun(*this, &Language::onEvent));
   ipc_.signal_cmd.connect(sigc::mem_fun(*this, &Language::onCmd));
   ipc_.sendCmd(IPC_GET_INPUTS);
-  // Launch worker
-  ipc_.setWorker([this] {
-    try {
-      ipc_.handleEvent();
-    } catch (const std::exception& e) {
-      spdlog::error("Language: {}", e.what());
-    }
-  });
   dp.emit();
 }
 
@@ -53,10 +49,14 @@ void Language::onCmd(const struct Ipc::ipc_response& res) {
     std::lock_guard<std::mutex> lock(mutex_);
     auto payload = parser_.parse(res.payload);
     std::vector<std::string> used_layouts;
-    // Display current layout of a device with a maximum count of layouts, expecting that all will
-    // be OK
+    // Prefer the configured keyboard; otherwise display the current layout of
+    // a device with a maximum count of layouts, expecting that all will be OK
     Json::ArrayIndex max_id = 0, max = 0;
     for (Json::ArrayIndex i = 0; i < payload.size(); i++) {
+      if (!keyboard_name_.empty() && payload[i]["identifier"].asString() == keyboard_name_) {
+        max_id = i;
+        break;
+      }
       auto size = payload[i][XKB_LAYOUT_NAMES_KEY].size();
       if (size > max) {
         max = size;
@@ -81,12 +81,63 @@ void Language::onEvent(const struct Ipc::ipc_response& res) {
     return;
   }
 
+  // Pull only the three fields we need out of the event with the streaming
+  // cursor; input events fire for every device change and materializing the
+  // whole device description as a DOM per event is wasted work.
+  std::string type, identifier, active;
+  bool parsed = true;
   try {
+    util::JsonCursor cur(res.payload);
+    cur.expect('{');
+    if (!cur.tryConsume('}')) {
+      do {
+        auto key = cur.parseString();
+        cur.expect(':');
+        if (key == "input" && cur.peek() == '{') {
+          cur.expect('{');
+          if (!cur.tryConsume('}')) {
+            do {
+              auto input_key = cur.parseString();
+              cur.expect(':');
+              if (input_key == "type" && cur.peek() == '"') {
+                type = cur.parseString();
+              } else if (input_key == "identifier" && cur.peek() == '"') {
+                identifier = cur.parseString();
+              } else if (input_key == XKB_ACTIVE_LAYOUT_NAME_KEY && cur.peek() == '"') {
+                active = cur.parseString();
+              } else {
+                cur.skipValue();
+              }
+            } while (cur.tryConsume(','));
+            cur.expect('}');
+          }
+        } else {
+          cur.skipValue();
+        }
+      } while (cur.tryConsume(','));
+    }
+  } catch (const std::exception&) {
+    parsed = false;
+  }
+
+  try {
+    if (!parsed) {
+      auto payload = parser_.parse(res.payload)["input"];
+      type = payload["type"].asString();
+      identifier = payload["identifier"].asString();
+      active = payload[XKB_ACTIVE_LAYOUT_NAME_KEY].asString();
+    }
+    if (type != "keyboard") {
+      return;
+    }
+    if (!keyboard_name_.empty() && identifier != keyboard_name_) {
+      return;
+    }
     std::lock_guard<std::mutex> lock(mutex_);
-    auto payload = parser_.parse(res.payload)["input"];
-    if (payload["type"].asString() == "keyboard") {
-      set_current_layout(payload[XKB_ACTIVE_LAYOUT_NAME_KEY].asString());
+    if (active.empty() || active == layout_.full_name) {
+      return;  // not a layout change; nothing to re-render
     }
+    set_current_layout(active);
     dp.emit();
   } catch (const std::exception& e) {
     spdlog::error("Language: {}", e.what());
@@ -99,7 +150,7 @@ auto Language::update() -> void {
       format_, fmt::arg("short", layout_.short_name),
       fmt::arg("shortDescription", layout_.short_description), fmt::arg("long", layout_.full_name),
       fmt::arg("variant", layout_.variant), fmt::arg("flag", layout_.country_flag())));
-  label_.set_markup(display_layout);
+  setMarkup(display_layout);
   if (tooltipEnabled()) {
     if (tooltip_format_ != "") {
       auto tooltip_display_layout = trim(
@@ -120,51 +171,64 @@ auto Language::update() -> void {
 }
 
 auto Language::set_current_layout(std::string current_layout) -> void {
-  layout_ = layouts_map_[current_layout];
+  auto it = layouts_map_.find(current_layout);
+  if (it == layouts_map_.end()) {
+    // a layout added to the sway config after startup; resolve it from the
+    // cached registry parse instead of leaving the label empty
+    for (const auto& layout : registryLayouts()) {
+      if (layout.full_name == current_layout) {
+        it = layouts_map_.emplace(current_layout, layout).first;
+        break;
+      }
+    }
+  }
+  layout_ = it != layouts_map_.end() ? it->second : Layout{current_layout, "", "", ""};
+}
+
+const std::vector<Language::Layout>& Language::registryLayouts() {
+  static const std::vector<Layout> layouts = [] {
+    std::vector<Layout> out;
+    XKBContext context;
+    for (auto* layout = context.next_layout(); layout != nullptr;
+         layout = context.next_layout()) {
+      out.push_back(*layout);
+    }
+    return out;
+  }();
+  return layouts;
 }
 
 auto Language::init_layouts_map(const std::vector<std::string>& used_layouts) -> void {
-  std::map<std::string, std::vector<Layout*>> found_by_short_names;
-  XKBContext xkb_context;
-  auto layout = xkb_context.next_layout();
-  for (; layout != nullptr; layout = xkb_context.next_layout()) {
-    if (std::find(used_layouts.begin(), used_layouts.end(), layout->full_name) ==
+  std::map<std::string, int> short_name_counts;
+  for (const auto& layout : registryLayouts()) {
+    if (std::find(used_layouts.begin(), used_layouts.end(), layout.full_name) ==
         used_layouts.end()) {
       continue;
     }
-
     if (!is_variant_displayed) {
-      auto short_name = layout->short_name;
-      if (found_by_short_names.count(short_name) > 0) {
-        found_by_short_names[short_name].push_back(layout);
-      } else {
-        found_by_short_names[short_name] = {layout};
-      }
+      ++short_name_counts[layout.short_name];
     }
-
-    layouts_map_.emplace(layout->full_name, *layout);
+    layouts_map_.emplace(layout.full_name, layout);
   }
 
-  if (is_variant_displayed || found_by_short_names.size() == 0) {
+  if (is_variant_displayed) {
     return;
   }
 
+  // Disambiguate duplicated short names ("us", "us1", ...) in config order.
   std::map<std::string, int> short_name_to_number_map;
   for (const auto& used_layout_name : used_layouts) {
     auto found = layouts_map_.find(used_layout_name);
     if (found == layouts_map_.end()) continue;
-    auto used_layout = &found->second;
-    auto layouts_with_same_name_list = found_by_short_names[used_layout->short_name];
-    if (layouts_with_same_name_list.size() < 2) {
+    auto* used_layout = &found->second;
+    // copy: the entry's own short name is appended to below
+    auto short_name = used_layout->short_name;
+    if (short_name_counts[short_name] < 2) {
       continue;
     }
 
-    if (short_name_to_number_map.count(used_layout->short_name) == 0) {
-      short_name_to_number_map[used_layout->short_name] = 1;
-    }
-
     if (displayed_short_flag != static_cast<std::byte>(0)) {
-      int& number = short_name_to_number_map[used_layout->short_name];
+      int& number = short_name_to_number_map.try_emplace(short_name, 1).first->second;
       used_layout->short_name = used_layout->short_name + std::to_string(number);
       used_layout->short_description = used_layout->short_description + std::to_string(number);
       ++number;
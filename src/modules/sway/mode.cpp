@@ -8,14 +8,6 @@ Mode::Mode(const std::string& id, const Json::Value& config)
     : ALabel(config, "mode", id, "{}", 0, true) {
   ipc_.subscribe(R"(["mode"])");
   ipc_.signal_event.connect(sigc::mem_fun(*this, &Mode::onEvent));
-  // Launch worker
-  ipc_.setWorker([this] {
-    try {
-      ipc_.handleEvent();
-    } catch (const std::exception& e) {
-      spdlog::error("Mode: {}", e.what());
-    }
-  });
   dp.emit();
 }
 
@@ -42,9 +34,9 @@ auto Mode::update() -> void {
   if (mode_.empty()) {
     event_box_.hide();
   } else {
-    label_.set_markup(fmt::format(format_, mode_));
+    setMarkup(fmt::format(format_, mode_));
     if (tooltipEnabled()) {
-      label_.set_tooltip_text(mode_);
+      setTooltipText(mode_);
     }
     event_box_.show();
   }
@@ -11,33 +11,228 @@
 #include <regex>
 #include <string>
 
+#include "util/icon_lookup_cache.hpp"
+#include "util/json_sax.hpp"
+
 namespace waybar::modules::sway {
 
+namespace {
+
+/*
+ * Streaming extraction of the focused node from a GET_TREE payload. The tree
+ * easily exceeds a megabyte on busy sessions and materializing it as a
+ * Json::Value just to find one node dominated the allocation profile on every
+ * window event. This walks the payload once with util::JsonCursor, keeping only
+ * the handful of fields the module renders. Mirrors gfnWithWorkspace() below,
+ * which stays as the fallback for payloads the scanner chokes on.
+ */
+class FocusedNodeScanner {
+ public:
+  FocusedNodeScanner(const std::string& payload, const std::string& bar_output, bool all_outputs)
+      : cursor_(payload), bar_output_(bar_output), all_outputs_(all_outputs) {}
+
+  void scan() { scanNode(0, -1); }
+
+  bool found() const { return found_; }
+  std::size_t appNb() const { return app_nb_; }
+  int id() const { return id_; }
+  const std::string& name() const { return name_; }
+  const std::string& appId() const { return app_id_; }
+
+ private:
+  // Returns the number of leaf nodes in the subtree, the same count
+  // leafNodesInWorkspace() produces on the DOM.
+  std::size_t scanNode(int depth, int workspace_depth) {
+    cursor_.expect('{');
+    bool focused = false;
+    bool has_app_id = false;
+    bool output_snapshot = false;
+    std::string type;
+    std::string node_name;
+    std::string node_app_id;
+    std::string wp_instance;
+    std::string match_output;
+    int64_t node_id = -1;
+    std::size_t field_count = 0;
+    std::size_t child_count = 0;
+    std::size_t child_leaves = 0;
+    if (!cursor_.tryConsume('}')) {
+      do {
+        auto key = cursor_.parseString();
+        cursor_.expect(':');
+        ++field_count;
+        if (key == "output" && cursor_.peek() == '"') {
+          output_ = cursor_.parseString();
+        } else if (key == "focused" && cursor_.peek() != 'n') {
+          focused = cursor_.parseBool();
+        } else if (key == "type") {
+          type = cursor_.parseString();
+        } else if (key == "app_id" && cursor_.peek() == '"') {
+          node_app_id = cursor_.parseString();
+          has_app_id = true;
+        } else if (key == "name" && cursor_.peek() == '"') {
+          node_name = cursor_.parseString();
+        } else if (key == "id" && cursor_.peek() != 'n') {
+          node_id = cursor_.parseInt();
+        } else if (key == "window_properties" && cursor_.peek() == '{') {
+          scanWindowProperties(wp_instance);
+        } else if ((key == "nodes" || key == "floating_nodes") && cursor_.peek() == '[') {
+          // the DOM walk matches against the output seen before descending
+          if (!output_snapshot) {
+            match_output = output_;
+            output_snapshot = true;
+          }
+          int child_workspace_depth = type == "workspace" ? depth : workspace_depth;
+          cursor_.expect('[');
+          if (!cursor_.tryConsume(']')) {
+            do {
+              child_leaves += scanNode(depth + 1, child_workspace_depth);
+              ++child_count;
+            } while (cursor_.tryConsume(','));
+            cursor_.expect(']');
+          }
+        } else {
+          cursor_.skipValue();
+        }
+      } while (cursor_.tryConsume(','));
+      cursor_.expect('}');
+    }
+    if (!output_snapshot) {
+      match_output = output_;
+    }
+    std::size_t leaves;
+    if (child_count == 0) {
+      leaves = type == "workspace" ? 0 : 1;
+    } else {
+      leaves = child_leaves;
+    }
+    if (!found_ && focused && (type == "con" || type == "floating_con") &&
+        (all_outputs_ || match_output == bar_output_)) {
+      found_ = true;
+      id_ = static_cast<int>(node_id);
+      name_ = node_name;
+      app_id_ = has_app_id ? node_app_id : wp_instance;
+      if (workspace_depth >= 0) {
+        pending_workspace_depth_ = workspace_depth;
+      } else {
+        app_nb_ = field_count;
+      }
+    }
+    if (found_ && pending_workspace_depth_ == depth) {
+      app_nb_ = leaves;
+      pending_workspace_depth_ = -1;
+    }
+    return leaves;
+  }
+
+  void scanWindowProperties(std::string& instance) {
+    cursor_.expect('{');
+    if (cursor_.tryConsume('}')) {
+      return;
+    }
+    do {
+      auto key = cursor_.parseString();
+      cursor_.expect(':');
+      if (key == "instance" && cursor_.peek() == '"') {
+        instance = cursor_.parseString();
+      } else {
+        cursor_.skipValue();
+      }
+    } while (cursor_.tryConsume(','));
+    cursor_.expect('}');
+  }
+
+  util::JsonCursor cursor_;
+  const std::string& bar_output_;
+  bool all_outputs_;
+  std::string output_;
+  bool found_ = false;
+  int pending_workspace_depth_ = -1;
+  std::size_t app_nb_ = 0;
+  int id_ = -1;
+  std::string name_;
+  std::string app_id_;
+};
+
+}  // namespace
+
 Window::Window(const std::string& id, const Bar& bar, const Json::Value& config)
     : AIconLabel(config, "window", id, "{}", 0, true), bar_(bar), windowId_(-1) {
+  const auto& rules = config_["rewrite"];
+  if (rules.isObject()) {
+    for (auto it = rules.begin(); it != rules.end(); ++it) {
+      if (it.key().isString() && it->isString()) {
+        try {
+          // malformated regexes will cause an exception.
+          // in this case, log error and try the next rule.
+          rewrite_rules_.emplace_back(std::regex{it.key().asString()}, it->asString());
+        } catch (const std::regex_error& e) {
+          spdlog::error("Invalid rule {}: {}", it.key().asString(), e.what());
+        }
+      }
+    }
+  }
+  if (config_["debounce"].isUInt()) {
+    debounce_ms_ = config_["debounce"].asUInt();
+  }
   ipc_.subscribe(R"(["window","workspace"])");
   ipc_.signal_event.connect(sigc::mem_fun(*this, &Window::onEvent));
   ipc_.signal_cmd.connect(sigc::mem_fun(*this, &Window::onCmd));
   // Get Initial focused window
   getTree();
-  // Launch worker
-  ipc_.setWorker([this] {
-    try {
-      ipc_.handleEvent();
-    } catch (const std::exception& e) {
-      spdlog::error("Window: {}", e.what());
-    }
-  });
 }
 
-void Window::onEvent(const struct Ipc::ipc_response& res) { getTree(); }
+Window::~Window() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  debounce_timer_.disconnect();
+}
+
+void Window::onEvent(const struct Ipc::ipc_response& res) {
+  if (debounce_ms_ == 0) {
+    getTree();
+    return;
+  }
+  // Terminals rewrite their title per shell command and browsers per page-load
+  // step, tens of events a second; fetch the tree once per burst instead. The
+  // trailing edge sees the final state, so nothing is rendered stale.
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (tree_pending_) {
+    return;
+  }
+  tree_pending_ = true;
+  debounce_timer_ = Glib::signal_timeout().connect(
+      [this] {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          tree_pending_ = false;
+        }
+        getTree();
+        return false;
+      },
+      debounce_ms_);
+}
 
 void Window::onCmd(const struct Ipc::ipc_response& res) {
   try {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto payload = parser_.parse(res.payload);
-    auto output = payload["output"].isString() ? payload["output"].asString() : "";
-    std::tie(app_nb_, windowId_, window_, app_id_) = getFocusedNode(payload["nodes"], output);
+    try {
+      FocusedNodeScanner scanner(res.payload, bar_.output->name, config_["all-outputs"].asBool());
+      scanner.scan();
+      const std::string& title = title_escape_.escape(scanner.name());
+      if (windowId_ == scanner.id() && app_nb_ == scanner.appNb() && window_ == title &&
+          app_id_ == scanner.appId()) {
+        return;  // same focused window, same title; nothing to re-render
+      }
+      app_nb_ = scanner.appNb();
+      windowId_ = scanner.id();
+      window_ = title;
+      app_id_ = scanner.appId();
+    } catch (const std::exception& e) {
+      SPDLOG_DEBUG("Window: streaming tree parse failed ({}), falling back to DOM", e.what());
+      auto payload = parser_.parse(res.payload);
+      auto output = payload["output"].isString() ? payload["output"].asString() : "";
+      std::tie(app_nb_, windowId_, window_, app_id_) = getFocusedNode(payload["nodes"], output);
+    }
     updateAppIcon();
     dp.emit();
   } catch (const std::exception& e) {
@@ -46,10 +241,15 @@ void Window::onCmd(const struct Ipc::ipc_response& res) {
 }
 
 std::optional<std::string> getDesktopFilePath(const std::string& app_id) {
+  auto& cache = util::IconLookupCache::instance();
+  if (auto cached = cache.lookup("desktop:" + app_id)) {
+    return cached;
+  }
   const auto data_dirs = Glib::get_system_data_dirs();
   for (const auto& data_dir : data_dirs) {
     const auto desktop_file_path = data_dir + "applications/" + app_id + ".desktop";
     if (std::filesystem::exists(desktop_file_path)) {
+      cache.store("desktop:" + app_id, desktop_file_path);
       return desktop_file_path;
     }
   }
@@ -114,10 +314,10 @@ auto Window::update() -> void {
     bar_.window.get_style_context()->remove_class("solo");
     bar_.window.get_style_context()->remove_class("empty");
   }
-  label_.set_markup(
-      fmt::format(format_, fmt::arg("title", rewriteTitle(window_)), fmt::arg("app_id", app_id_)));
+  setMarkup(fmt::format(format_, fmt::arg("title", rewriteTitleCached(window_)),
+                                fmt::arg("app_id", app_id_)));
   if (tooltipEnabled()) {
-    label_.set_tooltip_text(window_);
+    setTooltipText(window_);
   }
   // Call parent update
   AIconLabel::update();
@@ -157,7 +357,7 @@ std::tuple<std::size_t, int, std::string, std::string> gfnWithWorkspace(
                                                 : node["window_properties"]["instance"].asString();
         int nb = node.size();
         if (parentWorkspace != 0) nb = leafNodesInWorkspace(parentWorkspace);
-        return {nb, node["id"].asInt(), Glib::Markup::escape_text(node["name"].asString()), app_id};
+        return {nb, node["id"].asInt(), util::pango_escape(node["name"].asString()), app_id};
       }
     }
     // iterate
@@ -192,29 +392,24 @@ void Window::getTree() {
 }
 
 std::string Window::rewriteTitle(const std::string& title) {
-  const auto& rules = config_["rewrite"];
-  if (!rules.isObject()) {
-    return title;
-  }
-
   std::string res = title;
-
-  for (auto it = rules.begin(); it != rules.end(); ++it) {
-    if (it.key().isString() && it->isString()) {
-      try {
-        // malformated regexes will cause an exception.
-        // in this case, log error and try the next rule.
-        const std::regex rule{it.key().asString()};
-        if (std::regex_match(title, rule)) {
-          res = std::regex_replace(res, rule, it->asString());
-        }
-      } catch (const std::regex_error& e) {
-        spdlog::error("Invalid rule {}: {}", it.key().asString(), e.what());
-      }
+  for (const auto& [rule, replacement] : rewrite_rules_) {
+    if (std::regex_match(title, rule)) {
+      res = std::regex_replace(res, rule, replacement);
     }
   }
-
   return res;
 }
 
+const std::string& Window::rewriteTitleCached(const std::string& title) {
+  // update() reruns on every bar-wide redraw; the regex pass only needs to
+  // when the title actually changed
+  if (!rewrite_cached_ || title != rewrite_input_) {
+    rewrite_input_ = title;
+    rewrite_output_ = rewriteTitle(title);
+    rewrite_cached_ = true;
+  }
+  return rewrite_output_;
+}
+
 }  // namespace waybar::modules::sway
@@ -42,14 +42,6 @@ Workspaces::Workspaces(const std::string &id, const Bar &bar, const Json::Value
     window.add_events(Gdk::SCROLL_MASK | Gdk::SMOOTH_SCROLL_MASK);
     window.signal_scroll_event().connect(sigc::mem_fun(*this, &Workspaces::handleScroll));
   }
-  // Launch worker
-  ipc_.setWorker([this] {
-    try {
-      ipc_.handleEvent();
-    } catch (const std::exception &e) {
-      spdlog::error("Workspaces: {}", e.what());
-    }
-  });
 }
 
 void Workspaces::onEvent(const struct Ipc::ipc_response &res) {
@@ -173,6 +165,13 @@ bool Workspaces::filterButtons() {
                            [it](const auto &node) { return node["name"].asString() == it->first; });
     if (ws == workspaces_.end() ||
         (!config_["all-outputs"].asBool() && (*ws)["output"].asString() != bar_.output->name)) {
+      // recycle the widget instead of destroying it; workspaces come and go
+      // constantly and rebuilding a button invalidates the whole row layout
+      auto &entry = it->second;
+      entry.handler.disconnect();
+      entry.button->hide();
+      entry.label.clear();
+      button_pool_.emplace_back(std::move(entry));
       it = buttons_.erase(it);
       needReorder = true;
     } else {
@@ -182,6 +181,21 @@ bool Workspaces::filterButtons() {
   return needReorder;
 }
 
+namespace {
+
+void toggleClass(Gtk::Button &button, const char *cls, bool on) {
+  auto context = button.get_style_context();
+  if (on) {
+    if (!context->has_class(cls)) {
+      context->add_class(cls);
+    }
+  } else if (context->has_class(cls)) {
+    context->remove_class(cls);
+  }
+}
+
+}  // namespace
+
 auto Workspaces::update() -> void {
   std::lock_guard<std::mutex> lock(mutex_);
   bool needReorder = filterButtons();
@@ -190,36 +204,14 @@ auto Workspaces::update() -> void {
     if (bit == buttons_.end()) {
       needReorder = true;
     }
-    auto &button = bit == buttons_.end() ? addButton(*it) : bit->second;
-    if ((*it)["focused"].asBool()) {
-      button.get_style_context()->add_class("focused");
-    } else {
-      button.get_style_context()->remove_class("focused");
-    }
-    if ((*it)["visible"].asBool()) {
-      button.get_style_context()->add_class("visible");
-    } else {
-      button.get_style_context()->remove_class("visible");
-    }
-    if ((*it)["urgent"].asBool()) {
-      button.get_style_context()->add_class("urgent");
-    } else {
-      button.get_style_context()->remove_class("urgent");
-    }
-    if ((*it)["target_output"].isString()) {
-      button.get_style_context()->add_class("persistent");
-    } else {
-      button.get_style_context()->remove_class("persistent");
-    }
-    if ((*it)["output"].isString()) {
-      if (((*it)["output"].asString()) == bar_.output->name) {
-        button.get_style_context()->add_class("current_output");
-      } else {
-        button.get_style_context()->remove_class("current_output");
-      }
-    } else {
-      button.get_style_context()->remove_class("current_output");
-    }
+    auto &entry = bit == buttons_.end() ? addButton(*it) : bit->second;
+    auto &button = *entry.button;
+    toggleClass(button, "focused", (*it)["focused"].asBool());
+    toggleClass(button, "visible", (*it)["visible"].asBool());
+    toggleClass(button, "urgent", (*it)["urgent"].asBool());
+    toggleClass(button, "persistent", (*it)["target_output"].isString());
+    toggleClass(button, "current_output",
+                (*it)["output"].isString() && (*it)["output"].asString() == bar_.output->name);
     if (needReorder) {
       box_.reorder_child(button, it - workspaces_.begin());
     }
@@ -230,10 +222,15 @@ auto Workspaces::update() -> void {
                            fmt::arg("value", output), fmt::arg("name", trimWorkspaceName(output)),
                            fmt::arg("index", (*it)["num"].asString()));
     }
-    if (!config_["disable-markup"].asBool()) {
-      static_cast<Gtk::Label *>(button.get_children()[0])->set_markup(output);
-    } else {
-      button.set_label(output);
+    bool markup = !config_["disable-markup"].asBool();
+    if (output != entry.label || markup != entry.markup) {
+      if (markup) {
+        static_cast<Gtk::Label *>(button.get_children()[0])->set_markup(output);
+      } else {
+        button.set_label(output);
+      }
+      entry.label = std::move(output);
+      entry.markup = markup;
     }
     onButtonReady(*it, button);
   }
@@ -241,14 +238,25 @@ auto Workspaces::update() -> void {
   AModule::update();
 }
 
-Gtk::Button &Workspaces::addButton(const Json::Value &node) {
-  auto pair = buttons_.emplace(node["name"].asString(), node["name"].asString());
-  auto &&button = pair.first->second;
-  box_.pack_start(button, false, false, 0);
-  button.set_name("sway-workspace-" + node["name"].asString());
+Workspaces::WorkspaceButton &Workspaces::addButton(const Json::Value &node) {
+  auto name = node["name"].asString();
+  WorkspaceButton entry;
+  if (!button_pool_.empty()) {
+    // pooled buttons are still packed in the box, just hidden and disconnected
+    entry = std::move(button_pool_.back());
+    button_pool_.pop_back();
+    entry.button->set_label(name);
+  } else {
+    entry.button = std::make_unique<Gtk::Button>(name);
+    box_.pack_start(*entry.button, false, false, 0);
+  }
+  auto pair = buttons_.emplace(name, std::move(entry));
+  auto &workspace_button = pair.first->second;
+  auto &button = *workspace_button.button;
+  button.set_name("sway-workspace-" + name);
   button.set_relief(Gtk::RELIEF_NONE);
   if (!config_["disable-click"].asBool()) {
-    button.signal_pressed().connect([this, node] {
+    workspace_button.handler = button.signal_pressed().connect([this, node] {
       try {
         if (node["target_output"].isString()) {
           ipc_.sendCmd(IPC_COMMAND,
@@ -269,7 +277,7 @@ Gtk::Button &Workspaces::addButton(const Json::Value &node) {
       }
     });
   }
-  return button;
+  return workspace_button;
 }
 
 std::string Workspaces::getIcon(const std::string &name, const Json::Value &node) {
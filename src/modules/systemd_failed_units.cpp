@@ -0,0 +1,139 @@
+#include "modules/systemd_failed_units.hpp"
+
+#include <fmt/format.h>
+#include <glibmm/main.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+#include "util/dbus_manager.hpp"
+
+namespace waybar::modules {
+
+SystemdFailedUnits::SystemdFailedUnits(const std::string &id, const Json::Value &config)
+    : ALabel(config, "systemd-failed-units", id, "{nr_failed} failed", 0),
+      format_ok_(config_["format-ok"].isString() ? config_["format-ok"].asString() : "") {
+  auto bus_type = config_["bus"].isString() && config_["bus"].asString() == "session"
+                      ? Gio::DBus::BUS_TYPE_SESSION
+                      : Gio::DBus::BUS_TYPE_SYSTEM;
+  connection_ = util::DBusManager::instance().connection(bus_type);
+  if (!connection_) {
+    throw std::runtime_error("Unable to reach the bus");
+  }
+  manager_proxy_ = util::DBusManager::instance().proxy(
+      bus_type, "org.freedesktop.systemd1", "/org/freedesktop/systemd1",
+      "org.freedesktop.systemd1.Manager");
+  if (!manager_proxy_) {
+    throw std::runtime_error("Unable to create the systemd manager proxy");
+  }
+
+  // systemd only emits its signals to clients that asked for them
+  manager_proxy_->call("Subscribe", [this](Glib::RefPtr<Gio::AsyncResult> &result) {
+    try {
+      manager_proxy_->call_finish(result);
+    } catch (const Glib::Error &e) {
+      spdlog::warn("systemd-failed-units: Subscribe failed: {}", std::string(e.what()));
+    }
+  });
+
+  // unit state changes surface as JobRemoved (end of a start/stop/restart
+  // transaction) and UnitFilesChanged (daemon-reload, enable/disable); both
+  // just mark the module dirty
+  for (const char *signal : {"JobRemoved", "UnitFilesChanged", "Reloading"}) {
+    signal_subs_.push_back(connection_->signal_subscribe(
+        [this](const Glib::RefPtr<Gio::DBus::Connection> &, const Glib::ustring &,
+               const Glib::ustring &, const Glib::ustring &, const Glib::ustring &,
+               const Glib::VariantContainerBase &) { invalidate(); },
+        "org.freedesktop.systemd1", "org.freedesktop.systemd1.Manager", signal,
+        "/org/freedesktop/systemd1"));
+  }
+
+  queryFailed();
+}
+
+SystemdFailedUnits::~SystemdFailedUnits() {
+  for (guint sub : signal_subs_) {
+    connection_->signal_unsubscribe(sub);
+  }
+}
+
+void SystemdFailedUnits::invalidate() {
+  if (query_pending_) {
+    return;
+  }
+  query_pending_ = true;
+  Glib::signal_timeout().connect_once([this] { queryFailed(); }, BATCH_MS);
+}
+
+void SystemdFailedUnits::queryFailed() {
+  query_pending_ = false;
+  auto filter = Glib::VariantContainerBase::create_tuple(
+      Glib::Variant<std::vector<Glib::ustring>>::create({"failed"}));
+  manager_proxy_->call(
+      "ListUnitsFiltered",
+      [this](Glib::RefPtr<Gio::AsyncResult> &result) {
+        std::vector<std::string> failed;
+        try {
+          auto reply = manager_proxy_->call_finish(result);
+          auto units = Glib::VariantBase::cast_dynamic<Glib::VariantContainerBase>(
+              reply.get_child(0));
+          for (gsize i = 0; i < units.get_n_children(); ++i) {
+            auto unit = Glib::VariantBase::cast_dynamic<Glib::VariantContainerBase>(
+                units.get_child(i));
+            failed.push_back(
+                Glib::VariantBase::cast_dynamic<Glib::Variant<Glib::ustring>>(unit.get_child(0))
+                    .get());
+          }
+        } catch (const Glib::Error &e) {
+          spdlog::warn("systemd-failed-units: ListUnitsFiltered failed: {}",
+                       std::string(e.what()));
+          return;
+        } catch (const std::bad_cast &) {
+          spdlog::warn("systemd-failed-units: unexpected ListUnitsFiltered reply type");
+          return;
+        }
+        std::sort(failed.begin(), failed.end());
+        if (failed == failed_units_) {
+          return;
+        }
+        failed_units_ = std::move(failed);
+        nr_failed_ = failed_units_.size();
+        dp.emit();
+      },
+      filter);
+}
+
+auto SystemdFailedUnits::update() -> void {
+  if (nr_failed_ == 0) {
+    label_.get_style_context()->remove_class("degraded");
+    if (format_ok_.empty()) {
+      event_box_.hide();
+      return;
+    }
+    event_box_.show();
+    setMarkup(fmt::format(format_ok_, fmt::arg("nr_failed", nr_failed_)));
+  } else {
+    label_.get_style_context()->add_class("degraded");
+    event_box_.show();
+    setMarkup(fmt::format(format_, fmt::arg("nr_failed", nr_failed_)));
+  }
+
+  if (tooltipEnabled()) {
+    if (failed_units_.empty()) {
+      setTooltipText("All units OK");
+    } else {
+      std::string text;
+      for (const auto &unit : failed_units_) {
+        if (!text.empty()) {
+          text += '\n';
+        }
+        text += unit;
+      }
+      setTooltipText(text);
+    }
+  }
+
+  ALabel::update();
+}
+
+}  // namespace waybar::modules
@@ -1,32 +1,63 @@
 #include "modules/temperature.hpp"
 
+#if __has_include(<fmt/args.h>)
+// fmt >= 8 moved dynamic_format_arg_store out of core.h
+#include <fmt/args.h>
+#endif
+#include <fmt/compile.h>
+
+#include <algorithm>
 #include <filesystem>
+#include <numeric>
 
 waybar::modules::Temperature::Temperature(const std::string& id, const Json::Value& config)
     : ALabel(config, "temperature", id, "{temperatureC}°C", 10) {
+  std::vector<std::string> paths;
   if (config_["hwmon-path"].isString()) {
-    file_path_ = config_["hwmon-path"].asString();
+    paths.push_back(config_["hwmon-path"].asString());
+  } else if (config_["hwmon-path"].isArray()) {
+    // multi-sensor mode: every input is read in one batched sweep and
+    // aggregated into {temperatureC} (max), {avgC} and per-sensor fields
+    for (const auto& path : config_["hwmon-path"]) {
+      paths.push_back(path.asString());
+    }
   } else if (config_["hwmon-path-abs"].isString() && config_["input-filename"].isString()) {
-    file_path_ = (*std::filesystem::directory_iterator(config_["hwmon-path-abs"].asString()))
-                     .path()
-                     .string() +
-                 "/" + config_["input-filename"].asString();
+    paths.push_back((*std::filesystem::directory_iterator(config_["hwmon-path-abs"].asString()))
+                        .path()
+                        .string() +
+                    "/" + config_["input-filename"].asString());
   } else {
     auto zone = config_["thermal-zone"].isInt() ? config_["thermal-zone"].asInt() : 0;
-    file_path_ = fmt::format("/sys/class/thermal/thermal_zone{}/temp", zone);
+    paths.push_back(fmt::format("/sys/class/thermal/thermal_zone{}/temp", zone));
   }
-  std::ifstream temp(file_path_);
-  if (!temp.is_open()) {
-    throw std::runtime_error("Can't open " + file_path_);
+  if (paths.empty()) {
+    throw std::runtime_error("No hwmon input configured");
+  }
+  for (auto& path : paths) {
+    std::ifstream temp(path);
+    if (!temp.is_open()) {
+      throw std::runtime_error("Can't open " + path);
+    }
+    sensors_.push_back(std::make_unique<util::PollableFile>(path));
   }
-  thread_ = [this] {
-    dp.emit();
-    thread_.sleep_for(interval_);
-  };
+  worker_.start(interval_, [this] { dp.emit(); });
+  enableAdaptiveInterval(worker_);
+}
+
+void waybar::modules::Temperature::onSuspended(bool suspended) {
+  suspended ? worker_.pause() : worker_.resume();
 }
 
 auto waybar::modules::Temperature::update() -> void {
-  auto temperature = getTemperature();
+  auto temperatures = readTemperatures();
+  if (temperatures.empty()) {
+    event_box_.hide();
+    return;
+  }
+  // the hottest sensor drives the critical threshold and the default fields
+  auto temperature = *std::max_element(temperatures.begin(), temperatures.end());
+  auto average =
+      std::accumulate(temperatures.begin(), temperatures.end(), 0.0F) / temperatures.size();
   uint16_t temperature_c = std::round(temperature);
   uint16_t temperature_f = std::round(temperature * 1.8 + 32);
   uint16_t temperature_k = std::round(temperature + 273.15);
@@ -46,17 +77,41 @@ auto waybar::modules::Temperature::update() -> void {
     event_box_.show();
   }
 
-  auto max_temp = config_["critical-threshold"].isInt() ? config_["critical-threshold"].asInt() : 0;
-  label_.set_markup(fmt::format(format, fmt::arg("temperatureC", temperature_c),
-                                fmt::arg("temperatureF", temperature_f),
-                                fmt::arg("temperatureK", temperature_k),
-                                fmt::arg("icon", getIcon(temperature_c, "", max_temp))));
+  if (format == "{temperatureC}°C") {
+    // The out-of-the-box format, compiled at build time; no icon lookup, no
+    // runtime template parse.
+    setMarkup(fmt::format(FMT_COMPILE("{}°C"), temperature_c));
+  } else if (auto icon = getIcon(
+                 temperature_c, "",
+                 config_["critical-threshold"].isInt() ? config_["critical-threshold"].asInt() : 0);
+             sensors_.size() == 1) {
+    setMarkup(fmt::format(format, fmt::arg("temperatureC", temperature_c),
+                                  fmt::arg("temperatureF", temperature_f),
+                                  fmt::arg("temperatureK", temperature_k),
+                                  fmt::arg("icon", icon)));
+  } else {
+    fmt::dynamic_format_arg_store<fmt::format_context> store;
+    store.push_back(fmt::arg("temperatureC", temperature_c));
+    store.push_back(fmt::arg("temperatureF", temperature_f));
+    store.push_back(fmt::arg("temperatureK", temperature_k));
+    store.push_back(fmt::arg("maxC", temperature_c));
+    store.push_back(fmt::arg("avgC", static_cast<uint16_t>(std::round(average))));
+    store.push_back(fmt::arg("icon", icon));
+    // per-sensor fields, in configuration order: {temperatureC0}, {temperatureC1}, ...
+    std::vector<std::string> names(temperatures.size());
+    for (size_t i = 0; i < temperatures.size(); ++i) {
+      names[i] = fmt::format("temperatureC{}", i);
+      store.push_back(
+          fmt::arg(names[i].c_str(), static_cast<uint16_t>(std::round(temperatures[i]))));
+    }
+    setMarkup(fmt::vformat(format, store));
+  }
   if (tooltipEnabled()) {
     std::string tooltip_format = "{temperatureC}°C";
     if (config_["tooltip-format"].isString()) {
       tooltip_format = config_["tooltip-format"].asString();
     }
-    label_.set_tooltip_text(fmt::format(tooltip_format, fmt::arg("temperatureC", temperature_c),
+    setTooltipText(fmt::format(tooltip_format, fmt::arg("temperatureC", temperature_c),
                                         fmt::arg("temperatureF", temperature_f),
                                         fmt::arg("temperatureK", temperature_k)));
   }
@@ -64,18 +119,17 @@ auto waybar::modules::Temperature::update() -> void {
   ALabel::update();
 }
 
-float waybar::modules::Temperature::getTemperature() {
-  std::ifstream temp(file_path_);
-  if (!temp.is_open()) {
-    throw std::runtime_error("Can't open " + file_path_);
-  }
-  std::string line;
-  if (temp.good()) {
-    getline(temp, line);
+std::vector<float> waybar::modules::Temperature::readTemperatures() {
+  std::vector<float> temperatures;
+  temperatures.reserve(sensors_.size());
+  for (auto& sensor : sensors_) {
+    auto contents = sensor->read();
+    if (contents.empty()) {
+      continue;
+    }
+    temperatures.push_back(std::strtol(contents.data(), nullptr, 10) / 1000.0);
   }
-  temp.close();
-  auto temperature_c = std::strtol(line.c_str(), nullptr, 10) / 1000.0;
-  return temperature_c;
+  return temperatures;
 }
 
 bool waybar::modules::Temperature::isCritical(uint16_t temperature_c) {
@@ -9,6 +9,7 @@
 #include "gtkmm/label.h"
 #include "gtkmm/tooltip.h"
 #include "modules/upower/upower_tooltip.hpp"
+#include "util/dbus_manager.hpp"
 
 namespace waybar::modules::upower {
 UPower::UPower(const std::string& id, const Json::Value& config)
@@ -78,8 +79,9 @@ UPower::UPower(const std::string& id, const Json::Value& config)
     throw std::runtime_error("Unable to create UPower client!");
   }
 
-  // Connect to Login1 PrepareForSleep signal
-  login1_connection = g_bus_get_sync(G_BUS_TYPE_SYSTEM, NULL, &error);
+  // Connect to Login1 PrepareForSleep signal; the connection is the shared
+  // one from the manager, borrowed for the lifetime of the process
+  login1_connection = util::DBusManager::instance().raw(Gio::DBus::BUS_TYPE_SYSTEM);
   if (!login1_connection) {
     throw std::runtime_error("Unable to connect to the SYSTEM Bus!...");
   } else {
@@ -229,7 +231,10 @@ void UPower::resetDevices() {
 }
 
 bool UPower::show_tooltip_callback(int, int, bool, const Glib::RefPtr<Gtk::Tooltip>& tooltip) {
-  return true;
+  // rows are patched on hover only; device notify storms no longer touch
+  // the tooltip widgets at all
+  std::lock_guard<std::mutex> guard(m_Mutex);
+  return upower_tooltip->updateTooltip(devices) > 0;
 }
 
 const std::string UPower::getDeviceStatus(UpDeviceState& state) {
@@ -309,13 +314,6 @@ auto UPower::update() -> void {
 
   event_box_.set_visible(true);
 
-  // Tooltip
-  if (tooltip_enabled) {
-    uint tooltipCount = upower_tooltip->updateTooltip(devices);
-    // Disable the tooltip if there aren't any devices in the tooltip
-    box_.set_has_tooltip(!devices.empty() && tooltipCount > 0);
-  }
-
   // Set percentage
   std::string percentString = "";
   if (displayDeviceValid) {
@@ -346,7 +344,7 @@ auto UPower::update() -> void {
     onlySpaces = false;
     break;
   }
-  label_.set_markup(onlySpaces ? "" : label_format);
+  setMarkup(onlySpaces ? "" : label_format);
 
   // Set icon
   if (icon_name == NULL || !Gtk::IconTheme::get_default()->has_icon(icon_name)) {
@@ -1,5 +1,7 @@
 #include "modules/upower/upower_tooltip.hpp"
 
+#include <unordered_set>
+
 #include "gtkmm/box.h"
 #include "gtkmm/enums.h"
 #include "gtkmm/icontheme.h"
@@ -24,24 +26,54 @@ UPowerTooltip::UPowerTooltip(uint iconSize_, uint tooltipSpacing_, uint tooltipP
   contentBox->show();
 }
 
-UPowerTooltip::~UPowerTooltip() {}
+UPowerTooltip::~UPowerTooltip() {
+  for (auto& pair : rows_) {
+    delete pair.second.box;
+  }
+  delete contentBox;
+}
 
-uint UPowerTooltip::updateTooltip(Devices& devices) {
-  // Removes all old devices
-  for (auto child : contentBox->get_children()) {
-    child->~Widget();
+UPowerTooltip::Row& UPowerTooltip::getRow(const std::string& objectPath) {
+  auto it = rows_.find(objectPath);
+  if (it != rows_.end()) {
+    return it->second;
   }
 
+  // build the row once; later updates only patch its labels and icons
+  Row row;
+  row.box = new Gtk::Box(Gtk::ORIENTATION_HORIZONTAL, tooltipSpacing);
+
+  Gtk::Box* modelBox = Gtk::manage(new Gtk::Box(Gtk::ORIENTATION_HORIZONTAL));
+  row.box->add(*modelBox);
+  row.deviceIcon = Gtk::manage(new Gtk::Image());
+  row.deviceIcon->set_pixel_size(iconSize);
+  modelBox->add(*row.deviceIcon);
+  row.modelLabel = Gtk::manage(new Gtk::Label());
+  modelBox->add(*row.modelLabel);
+
+  Gtk::Box* chargeBox = Gtk::manage(new Gtk::Box(Gtk::ORIENTATION_HORIZONTAL));
+  row.box->add(*chargeBox);
+  row.chargeIcon = Gtk::manage(new Gtk::Image());
+  row.chargeIcon->set_pixel_size(iconSize);
+  chargeBox->add(*row.chargeIcon);
+  row.percentLabel = Gtk::manage(new Gtk::Label());
+  chargeBox->add(*row.percentLabel);
+
+  contentBox->add(*row.box);
+  row.box->show_all();
+  return rows_.emplace(objectPath, row).first->second;
+}
+
+uint UPowerTooltip::updateTooltip(Devices& devices) {
   uint deviceCount = 0;
-  // Adds all valid devices
+  std::unordered_set<std::string> seen;
+
   for (auto pair : devices) {
     UpDevice* device = pair.second;
-    std::string objectPath = pair.first;
+    const std::string& objectPath = pair.first;
 
     if (!G_IS_OBJECT(device)) continue;
 
-    Gtk::Box* box = new Gtk::Box(Gtk::ORIENTATION_HORIZONTAL, tooltipSpacing);
-
     UpDeviceKind kind;
     double percentage;
     gchar* native_path;
@@ -56,46 +88,52 @@ uint UPowerTooltip::updateTooltip(Devices& devices) {
         strcmp(native_path, "BAT0") == 0)
       continue;
 
-    Gtk::Box* modelBox = new Gtk::Box(Gtk::ORIENTATION_HORIZONTAL);
-    box->add(*modelBox);
-    // Set device icon
+    seen.insert(objectPath);
+    Row& row = getRow(objectPath);
+
     std::string deviceIconName = getDeviceIcon(kind);
-    Gtk::Image* deviceIcon = new Gtk::Image();
-    deviceIcon->set_pixel_size(iconSize);
     if (!Gtk::IconTheme::get_default()->has_icon(deviceIconName)) {
       deviceIconName = "battery-missing-symbolic";
     }
-    deviceIcon->set_from_icon_name(deviceIconName, Gtk::ICON_SIZE_INVALID);
-    modelBox->add(*deviceIcon);
+    if (deviceIconName != row.deviceIconName) {
+      row.deviceIcon->set_from_icon_name(deviceIconName, Gtk::ICON_SIZE_INVALID);
+      row.deviceIconName = deviceIconName;
+    }
 
-    // Set model
     if (model == NULL) model = (gchar*)"";
-    Gtk::Label* modelLabel = new Gtk::Label(model);
-    modelBox->add(*modelLabel);
-
-    Gtk::Box* chargeBox = new Gtk::Box(Gtk::ORIENTATION_HORIZONTAL);
-    box->add(*chargeBox);
+    if (row.model != model) {
+      row.modelLabel->set_text(model);
+      row.model = model;
+    }
 
-    // Set icon
-    Gtk::Image* icon = new Gtk::Image();
-    icon->set_pixel_size(iconSize);
     if (icon_name == NULL || !Gtk::IconTheme::get_default()->has_icon(icon_name)) {
       icon_name = (char*)"battery-missing-symbolic";
     }
-    icon->set_from_icon_name(icon_name, Gtk::ICON_SIZE_INVALID);
-    chargeBox->add(*icon);
+    if (row.chargeIconName != icon_name) {
+      row.chargeIcon->set_from_icon_name(icon_name, Gtk::ICON_SIZE_INVALID);
+      row.chargeIconName = icon_name;
+    }
 
-    // Set percentage
     std::string percentString = std::to_string(int(percentage + 0.5)) + "%";
-    Gtk::Label* percentLabel = new Gtk::Label(percentString);
-    chargeBox->add(*percentLabel);
-
-    contentBox->add(*box);
+    if (row.percent != percentString) {
+      row.percentLabel->set_text(percentString);
+      row.percent = percentString;
+    }
 
     deviceCount++;
   }
 
-  contentBox->show_all();
+  // drop rows for devices that unplugged (or stopped qualifying)
+  for (auto it = rows_.begin(); it != rows_.end();) {
+    if (seen.count(it->first) == 0) {
+      contentBox->remove(*it->second.box);
+      delete it->second.box;
+      it = rows_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
   return deviceCount;
 }
 
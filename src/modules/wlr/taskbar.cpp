@@ -1,6 +1,7 @@
 #include "modules/wlr/taskbar.hpp"
 
 #include <fmt/core.h>
+#include <gdkmm/frameclock.h>
 #include <gdkmm/monitor.h>
 #include <gio/gdesktopappinfo.h>
 #include <giomm/desktopappinfo.h>
@@ -13,12 +14,15 @@
 #include <cstring>
 #include <memory>
 #include <sstream>
+#include <unordered_map>
 #include <utility>
 
 #include "glibmm/error.h"
 #include "glibmm/fileutils.h"
 #include "glibmm/refptr.h"
 #include "util/format.hpp"
+#include "util/icon_cache.hpp"
+#include "util/icon_lookup_cache.hpp"
 #include "util/string.hpp"
 
 namespace waybar::modules::wlr {
@@ -47,7 +51,7 @@ static std::vector<std::string> search_prefix() {
   std::string home_dir = std::getenv("HOME");
   prefixes.push_back(home_dir + "/.local/share/");
 
-  for (auto &p : prefixes) spdlog::debug("Using 'desktop' search path prefix: {}", p);
+  for (auto &p : prefixes) SPDLOG_DEBUG("Using 'desktop' search path prefix: {}", p);
 
   return prefixes;
 }
@@ -64,6 +68,14 @@ static Glib::RefPtr<Gdk::Pixbuf> load_icon_from_file(std::string icon_path, int
 static Glib::RefPtr<Gio::DesktopAppInfo> get_app_info_by_name(const std::string &app_id) {
   static std::vector<std::string> prefixes = search_prefix();
 
+  auto &cache = util::IconLookupCache::instance();
+  if (auto cached = cache.lookup("desktop:" + app_id)) {
+    auto app_info_ = Gio::DesktopAppInfo::create_from_filename(*cached);
+    if (app_info_) {
+      return app_info_;
+    }
+  }
+
   std::vector<std::string> app_folders = {"", "applications/", "applications/kde/",
                                           "applications/org.kde."};
 
@@ -78,6 +90,7 @@ static Glib::RefPtr<Gio::DesktopAppInfo> get_app_info_by_name(const std::string
           continue;
         }
 
+        cache.store("desktop:" + app_id, app_info_->get_filename());
         return app_info_;
       }
     }
@@ -116,38 +129,68 @@ Glib::RefPtr<Gio::DesktopAppInfo> get_desktop_app_info(const std::string &app_id
   return get_app_info_by_name(desktop_file);
 }
 
-void Task::set_app_info_from_app_id_list(const std::string &app_id_list) {
+static Glib::RefPtr<Gio::DesktopAppInfo> resolve_app_info_from_list(const std::string &app_id_list) {
   std::string app_id;
   std::istringstream stream(app_id_list);
+  Glib::RefPtr<Gio::DesktopAppInfo> app_info;
 
   /* Wayfire sends a list of app-id's in space separated format, other compositors
    * send a single app-id, but in any case this works fine */
   while (stream >> app_id) {
-    app_info_ = get_desktop_app_info(app_id);
-    if (app_info_) {
-      return;
+    app_info = get_desktop_app_info(app_id);
+    if (app_info) {
+      return app_info;
     }
 
     auto lower_app_id = app_id;
     std::transform(lower_app_id.begin(), lower_app_id.end(), lower_app_id.begin(),
                    [](char c) { return std::tolower(c); });
-    app_info_ = get_desktop_app_info(lower_app_id);
-    if (app_info_) {
-      return;
+    app_info = get_desktop_app_info(lower_app_id);
+    if (app_info) {
+      return app_info;
     }
 
     size_t start = 0, end = app_id.size();
     start = app_id.rfind(".", end);
     std::string app_name = app_id.substr(start + 1, app_id.size());
-    app_info_ = get_desktop_app_info(app_name);
-    if (app_info_) {
-      return;
+    app_info = get_desktop_app_info(app_name);
+    if (app_info) {
+      return app_info;
     }
 
     start = app_id.find("-");
     app_name = app_id.substr(0, start);
-    app_info_ = get_desktop_app_info(app_name);
+    app_info = get_desktop_app_info(app_name);
+    if (app_info) {
+      return app_info;
+    }
   }
+  return app_info;
+}
+
+void Task::set_app_info_from_app_id_list(const std::string &app_id_list) {
+  /* Resolution is a pure function of the installed desktop entries, and with
+   * all-outputs each bar runs its own Task per toplevel — memoize process-wide
+   * and drop the table when GIO reports the desktop database changed. */
+  static std::unordered_map<std::string, Glib::RefPtr<Gio::DesktopAppInfo>> app_info_cache;
+  static GAppInfoMonitor *monitor = []() {
+    auto *m = g_app_info_monitor_get();
+    g_signal_connect(m, "changed",
+                     G_CALLBACK(+[](GAppInfoMonitor *, gpointer data) {
+                       static_cast<std::unordered_map<std::string, Glib::RefPtr<Gio::DesktopAppInfo>>
+                                       *>(data)
+                           ->clear();
+                     }),
+                     &app_info_cache);
+    return m;
+  }();
+  (void)monitor;
+
+  auto it = app_info_cache.find(app_id_list);
+  if (it == app_info_cache.end()) {
+    it = app_info_cache.emplace(app_id_list, resolve_app_info_from_list(app_id_list)).first;
+  }
+  app_info_ = it->second;
 }
 
 static std::string get_icon_name_from_icon_theme(const Glib::RefPtr<Gtk::IconTheme> &icon_theme,
@@ -172,19 +215,23 @@ bool Task::image_load_icon(Gtk::Image &image, const Glib::RefPtr<Gtk::IconTheme>
     }
   }
 
-  Glib::RefPtr<Gdk::Pixbuf> pixbuf;
-
-  try {
-    pixbuf = icon_theme->load_icon(ret_icon_name, size, Gtk::ICON_LOOKUP_FORCE_SIZE);
-  } catch (...) {
-    if (Glib::file_test(ret_icon_name, Glib::FILE_TEST_EXISTS))
-      pixbuf = load_icon_from_file(ret_icon_name, size);
-    else
-      pixbuf = {};
-  }
+  /* decode at the output scale, then hand every task the same immutable
+   * surface: one decode and one conversion per (icon, scale), shared bytes
+   * for all windows of the app */
+  int scale = image.get_scale_factor();
+  int scaled_size = size * scale;
+  auto pixbuf = util::IconCache::instance().get(icon_theme, ret_icon_name, scaled_size, [&] {
+    try {
+      return icon_theme->load_icon(ret_icon_name, scaled_size, Gtk::ICON_LOOKUP_FORCE_SIZE);
+    } catch (...) {
+      if (Glib::file_test(ret_icon_name, Glib::FILE_TEST_EXISTS))
+        return load_icon_from_file(ret_icon_name, scaled_size);
+      return Glib::RefPtr<Gdk::Pixbuf>{};
+    }
+  });
 
   if (pixbuf) {
-    image.set(pixbuf);
+    image.set(util::IconCache::instance().surface(pixbuf, scale));
     return true;
   }
 
@@ -342,8 +389,8 @@ std::string Task::state_string(bool shortened) const {
 }
 
 void Task::handle_title(const char *title) {
-  title_ = title;
-  hide_if_ignored();
+  pending_title_ = title;
+  title_changed_ = true;
 }
 
 void Task::hide_if_ignored() {
@@ -351,26 +398,31 @@ void Task::hide_if_ignored() {
     ignored_ = true;
     if (button_visible_) {
       auto output = gdk_wayland_monitor_get_wl_output(bar_.output->monitor->gobj());
-      handle_output_leave(output);
+      apply_output_leave(output);
     }
   } else {
     bool is_was_ignored = ignored_;
     ignored_ = false;
     if (is_was_ignored) {
       auto output = gdk_wayland_monitor_get_wl_output(bar_.output->monitor->gobj());
-      handle_output_enter(output);
+      apply_output_enter(output);
     }
   }
 }
 
 void Task::handle_app_id(const char *app_id) {
-  app_id_ = app_id;
+  pending_app_id_ = app_id;
+  app_id_changed_ = true;
+}
+
+void Task::apply_app_id() {
+  app_id_ = std::move(pending_app_id_);
   hide_if_ignored();
 
   auto ids_replace_map = tbar_->app_ids_replace_map();
   if (ids_replace_map.count(app_id_)) {
     auto replaced_id = ids_replace_map[app_id_];
-    spdlog::debug(
+    SPDLOG_DEBUG(
         fmt::format("Task ({}) [{}] app_id was replaced with {}", id_, app_id_, replaced_id));
     app_id_ = replaced_id;
   }
@@ -380,7 +432,7 @@ void Task::handle_app_id(const char *app_id) {
   }
 
   set_app_info_from_app_id_list(app_id_);
-  name_ = app_info_ ? app_info_->get_display_name() : app_id;
+  name_ = app_info_ ? app_info_->get_display_name() : app_id_;
 
   if (!with_icon_) {
     return;
@@ -398,35 +450,46 @@ void Task::handle_app_id(const char *app_id) {
   if (found)
     icon_.show();
   else
-    spdlog::debug("Couldn't find icon for {}", app_id_);
+    SPDLOG_DEBUG("Couldn't find icon for {}", app_id_);
 }
 
 void Task::handle_output_enter(struct wl_output *output) {
+  pending_outputs_.emplace_back(output, true);
+}
+
+void Task::handle_output_leave(struct wl_output *output) {
+  pending_outputs_.emplace_back(output, false);
+}
+
+void Task::apply_output_enter(struct wl_output *output) {
   if (ignored_) {
-    spdlog::debug("{} is ignored", repr());
+    SPDLOG_DEBUG("{} is ignored", repr());
     return;
   }
 
-  spdlog::debug("{} entered output {}", repr(), (void *)output);
+  SPDLOG_DEBUG("{} entered output {}", repr(), (void *)output);
 
   if (!button_visible_ && (tbar_->all_outputs() || tbar_->show_output(output))) {
     /* The task entered the output of the current bar make the button visible */
     tbar_->add_button(button_);
     button_.show();
     button_visible_ = true;
-    spdlog::debug("{} now visible on {}", repr(), bar_.output->name);
+    if (int slot = tbar_->sorted_slot(*this); slot >= 0) {
+      tbar_->move_button(button_, slot);
+    }
+    SPDLOG_DEBUG("{} now visible on {}", repr(), bar_.output->name);
   }
 }
 
-void Task::handle_output_leave(struct wl_output *output) {
-  spdlog::debug("{} left output {}", repr(), (void *)output);
+void Task::apply_output_leave(struct wl_output *output) {
+  SPDLOG_DEBUG("{} left output {}", repr(), (void *)output);
 
   if (button_visible_ && !tbar_->all_outputs() && tbar_->show_output(output)) {
     /* The task left the output of the current bar, make the button invisible */
     tbar_->remove_button(button_);
     button_.hide();
     button_visible_ = false;
-    spdlog::debug("{} now invisible on {}", repr(), bar_.output->name);
+    SPDLOG_DEBUG("{} now invisible on {}", repr(), bar_.output->name);
   }
 }
 
@@ -443,7 +506,35 @@ void Task::handle_state(struct wl_array *state) {
 }
 
 void Task::handle_done() {
-  spdlog::debug("{} changed", repr());
+  SPDLOG_DEBUG("{} changed", repr());
+
+  // apply the batch the protocol just closed; each field costs its widget
+  // work once, however many events announced it
+  bool sort_key_changed = title_changed_ || app_id_changed_;
+  if (title_changed_) {
+    title_ = std::move(pending_title_);
+    title_changed_ = false;
+    hide_if_ignored();
+  }
+  if (app_id_changed_) {
+    app_id_changed_ = false;
+    apply_app_id();
+  }
+  if (sort_key_changed) {
+    // bounded reposition: a no-op unless the new key crosses a neighbour,
+    // and the box child only moves when its visible slot actually differs
+    if (int slot = tbar_->reposition_task(*this); slot >= 0 && button_visible_) {
+      tbar_->move_button(button_, slot);
+    }
+  }
+  for (const auto &[output, enter] : pending_outputs_) {
+    if (enter) {
+      apply_output_enter(output);
+    } else {
+      apply_output_leave(output);
+    }
+  }
+  pending_outputs_.clear();
 
   if (state_ & MAXIMIZED) {
     button_.get_style_context()->add_class("maximized");
@@ -469,14 +560,16 @@ void Task::handle_done() {
     button_.get_style_context()->remove_class("fullscreen");
   }
 
-  if (config_["active-first"].isBool() && config_["active-first"].asBool() && active())
+  // active-first fights a maintained sort order; the explicit sort wins
+  if (config_["active-first"].isBool() && config_["active-first"].asBool() && active() &&
+      !tbar_->sorting())
     tbar_->move_button(button_, 0);
 
-  tbar_->dp.emit();
+  tbar_->schedule_update();
 }
 
 void Task::handle_closed() {
-  spdlog::debug("{} closed", repr());
+  SPDLOG_DEBUG("{} closed", repr());
   zwlr_foreign_toplevel_handle_v1_destroy(handle_);
   handle_ = nullptr;
   if (button_visible_) {
@@ -530,9 +623,9 @@ void Task::update() {
   std::string name = name_;
   std::string app_id = app_id_;
   if (markup) {
-    title = Glib::Markup::escape_text(title);
-    name = Glib::Markup::escape_text(name);
-    app_id = Glib::Markup::escape_text(app_id);
+    title = title_escape_.escape(title);
+    name = name_escape_.escape(name);
+    app_id = app_id_escape_.escape(app_id);
   }
   if (!format_before_.empty()) {
     auto txt = fmt::format(format_before_, fmt::arg("title", title), fmt::arg("name", name),
@@ -648,7 +741,7 @@ Taskbar::Taskbar(const std::string &id, const waybar::Bar &bar, const Json::Valu
 
       auto it = Gtk::IconTheme::create();
       it->set_custom_theme(it_name);
-      spdlog::debug("Use custom icon theme: {}", it_name);
+      SPDLOG_DEBUG("Use custom icon theme: {}", it_name);
 
       icon_themes_.push_back(it);
     }
@@ -657,11 +750,18 @@ Taskbar::Taskbar(const std::string &id, const waybar::Bar &bar, const Json::Valu
 
     auto it = Gtk::IconTheme::create();
     it->set_custom_theme(it_name);
-    spdlog::debug("Use custom icon theme: {}", it_name);
+    SPDLOG_DEBUG("Use custom icon theme: {}", it_name);
 
     icon_themes_.push_back(it);
   }
 
+  if (config_["sort-by-app-id"].isBool()) {
+    sort_by_app_id_ = config_["sort-by-app-id"].asBool();
+  }
+  if (config_["sort-by-title"].isBool()) {
+    sort_by_title_ = config_["sort-by-title"].asBool();
+  }
+
   // Load ignore-list
   if (config_["ignore-list"].isArray()) {
     for (auto &app_name : config_["ignore-list"]) {
@@ -743,7 +843,7 @@ void Taskbar::register_manager(struct wl_registry *registry, uint32_t name, uint
   if (manager_)
     zwlr_foreign_toplevel_manager_v1_add_listener(manager_, &toplevel_manager_impl, this);
   else
-    spdlog::debug("Failed to register manager");
+    SPDLOG_DEBUG("Failed to register manager");
 }
 
 void Taskbar::register_seat(struct wl_registry *registry, uint32_t name, uint32_t version) {
@@ -757,7 +857,17 @@ void Taskbar::register_seat(struct wl_registry *registry, uint32_t name, uint32_
 }
 
 void Taskbar::handle_toplevel_create(struct zwlr_foreign_toplevel_handle_v1 *tl_handle) {
-  tasks_.push_back(std::make_unique<Task>(bar_, config_, this, tl_handle, seat_));
+  auto task = std::make_unique<Task>(bar_, config_, this, tl_handle, seat_);
+  if (sorting()) {
+    // binary-search insertion; the keys are still empty here, the first
+    // `done` batch repositions the task once title/app_id arrive
+    auto pos = std::lower_bound(
+        std::begin(tasks_), std::end(tasks_), task,
+        [this](const TaskPtr &a, const TaskPtr &b) { return task_before(*a, *b); });
+    tasks_.insert(pos, std::move(task));
+  } else {
+    tasks_.push_back(std::move(task));
+  }
 }
 
 void Taskbar::handle_finished() {
@@ -783,6 +893,93 @@ void Taskbar::remove_task(uint32_t id) {
   tasks_.erase(it);
 }
 
+bool Taskbar::task_before(const Task &a, const Task &b) const {
+  if (sort_by_app_id_) {
+    if (int c = a.app_id().compare(b.app_id()); c != 0) return c < 0;
+  }
+  if (sort_by_title_) {
+    if (int c = a.title().compare(b.title()); c != 0) return c < 0;
+  }
+  /* equal keys keep creation order */
+  return a.id() < b.id();
+}
+
+int Taskbar::sorted_slot(const Task &task) const {
+  if (!sorting()) {
+    return -1;
+  }
+  /* the box slot is the number of visible tasks preceding it in tasks_ */
+  int slot = -1;
+  int visible = 0;
+  for (const auto &t : tasks_) {
+    if (t.get() == &task) {
+      slot = visible;
+    }
+    if (t->visible()) {
+      ++visible;
+    }
+  }
+  /* pack_start appended the button, so the last slot needs no reorder */
+  return slot == visible - 1 ? -1 : slot;
+}
+
+int Taskbar::reposition_task(const Task &task) {
+  if (!sorting()) {
+    return -1;
+  }
+
+  auto it = std::find_if(std::begin(tasks_), std::end(tasks_),
+                         [&task](const TaskPtr &p) { return p.get() == &task; });
+  if (it == std::end(tasks_)) {
+    return -1;
+  }
+
+  /* still between its neighbours: the order is intact, nothing to move */
+  if ((it == std::begin(tasks_) || !task_before(task, **std::prev(it))) &&
+      (std::next(it) == std::end(tasks_) || !task_before(**std::next(it), task))) {
+    return -1;
+  }
+
+  int old_slot = 0;
+  for (auto i = std::begin(tasks_); i != it; ++i) {
+    if ((*i)->visible()) ++old_slot;
+  }
+
+  auto ptr = std::move(*it);
+  tasks_.erase(it);
+  auto pos =
+      std::lower_bound(std::begin(tasks_), std::end(tasks_), ptr,
+                       [this](const TaskPtr &a, const TaskPtr &b) { return task_before(*a, *b); });
+  int new_slot = 0;
+  for (auto i = std::begin(tasks_); i != pos; ++i) {
+    if ((*i)->visible()) ++new_slot;
+  }
+  tasks_.insert(pos, std::move(ptr));
+
+  /* invisible buttons don't occupy a box slot; equal slots mean the keys
+   * only moved past hidden tasks and the box is already right */
+  return !task.visible() || new_slot == old_slot ? -1 : new_slot;
+}
+
+void Taskbar::schedule_update() {
+  if (update_scheduled_) {
+    return;
+  }
+  if (!event_box_.get_mapped()) {
+    // no frame clock to align with while hidden
+    dp.emit();
+    return;
+  }
+  update_scheduled_ = true;
+  // one-shot tick: an alt-tab storm over 40 toplevels collapses into a
+  // single render at the next output frame
+  event_box_.add_tick_callback([this](const Glib::RefPtr<Gdk::FrameClock> &) {
+    update_scheduled_ = false;
+    dp.emit();
+    return false;
+  });
+}
+
 bool Taskbar::show_output(struct wl_output *output) const {
   return output == gdk_wayland_monitor_get_wl_output(bar_.output->monitor->gobj());
 }
@@ -120,7 +120,7 @@ auto WorkspaceManager::handle_workspace_group_create(
   auto new_id = ++group_global_id;
   groups_.push_back(
       std::make_unique<WorkspaceGroup>(bar_, box_, config_, *this, workspace_group_handle, new_id));
-  spdlog::debug("Workspace group {} created", new_id);
+  SPDLOG_DEBUG("Workspace group {} created", new_id);
 }
 
 auto WorkspaceManager::handle_finished() -> void {
@@ -168,6 +168,29 @@ auto WorkspaceManager::remove_workspace_group(uint32_t id) -> void {
 }
 auto WorkspaceManager::commit() -> void { zext_workspace_manager_v1_commit(workspace_manager_); }
 
+auto WorkspaceManager::acquire_button() -> std::unique_ptr<ButtonBundle> {
+  if (!button_pool_.empty()) {
+    auto bundle = std::move(button_pool_.back());
+    button_pool_.pop_back();
+    return bundle;
+  }
+  auto bundle = std::make_unique<ButtonBundle>();
+  bundle->button.set_relief(Gtk::RELIEF_NONE);
+  bundle->content.set_center_widget(bundle->label);
+  bundle->button.add(bundle->content);
+  return bundle;
+}
+
+auto WorkspaceManager::release_button(std::unique_ptr<ButtonBundle> bundle) -> void {
+  bundle->button.hide();
+  if (auto *parent = dynamic_cast<Gtk::Container *>(bundle->button.get_parent())) {
+    parent->remove(bundle->button);
+  }
+  if (button_pool_.size() < MAX_POOLED_BUTTONS) {
+    button_pool_.push_back(std::move(bundle));
+  }
+}
+
 WorkspaceGroup::WorkspaceGroup(const Bar &bar, Gtk::Box &box, const Json::Value &config,
                                WorkspaceManager &manager,
                                zext_workspace_group_handle_v1 *workspace_group_handle, uint32_t id)
@@ -201,7 +224,9 @@ WorkspaceGroup::~WorkspaceGroup() {
 auto WorkspaceGroup::handle_workspace_create(zext_workspace_handle_v1 *workspace) -> void {
   auto new_id = ++workspace_global_id;
   workspaces_.push_back(std::make_unique<Workspace>(bar_, config_, *this, workspace, new_id));
-  spdlog::debug("Workspace {} created", new_id);
+  // the fresh button is packed at the end of the box; reorder on the next done
+  set_need_to_sort();
+  SPDLOG_DEBUG("Workspace {} created", new_id);
 }
 
 auto WorkspaceGroup::handle_remove() -> void {
@@ -211,7 +236,7 @@ auto WorkspaceGroup::handle_remove() -> void {
 }
 
 auto WorkspaceGroup::handle_output_enter(wl_output *output) -> void {
-  spdlog::debug("Output {} assigned to {} group", (void *)output, id_);
+  SPDLOG_DEBUG("Output {} assigned to {} group", (void *)output, id_);
   output_ = output;
 
   if (!is_visible() || workspace_manager_.creation_delayed()) {
@@ -230,7 +255,7 @@ auto WorkspaceGroup::is_visible() const -> bool {
 }
 
 auto WorkspaceGroup::handle_output_leave() -> void {
-  spdlog::debug("Output {} remove from {} group", (void *)output_, id_);
+  SPDLOG_DEBUG("Output {} remove from {} group", (void *)output_, id_);
   output_ = nullptr;
 
   if (output_ != gdk_wayland_monitor_get_wl_output(bar_.output->monitor->gobj())) {
@@ -268,7 +293,6 @@ auto WorkspaceGroup::remove_workspace(uint32_t id) -> void {
 }
 
 auto WorkspaceGroup::handle_done() -> void {
-  need_to_sort = false;
   if (!is_visible()) {
     return;
   }
@@ -281,10 +305,15 @@ auto WorkspaceGroup::handle_done() -> void {
     return;
   }
 
-  if (!workspace_manager_.all_outputs()) {
-    sort_workspaces();
-  } else {
-    workspace_manager_.sort_workspaces();
+  // events in the burst flagged whether anything order-relevant changed;
+  // a focus-only change doesn't pay for a re-sort and reorder pass
+  if (need_to_sort) {
+    need_to_sort = false;
+    if (!workspace_manager_.all_outputs()) {
+      sort_workspaces();
+    } else {
+      workspace_manager_.sort_workspaces();
+    }
   }
 }
 
@@ -320,28 +349,27 @@ Workspace::Workspace(const Bar &bar, const Json::Value &config, WorkspaceGroup &
     }
   }
 
+  bundle_ = workspace_group.manager().acquire_button();
+
   /* Handle click events if configured */
   if (config_["on-click"].isString() || config_["on-click-middle"].isString() ||
       config_["on-click-right"].isString()) {
-    button_.add_events(Gdk::BUTTON_PRESS_MASK);
-    button_.signal_button_press_event().connect(sigc::mem_fun(*this, &Workspace::handle_clicked),
-                                                false);
+    bundle_->button.add_events(Gdk::BUTTON_PRESS_MASK);
+    click_connection_ = bundle_->button.signal_button_press_event().connect(
+        sigc::mem_fun(*this, &Workspace::handle_clicked), false);
   }
 
-  button_.set_relief(Gtk::RELIEF_NONE);
-  content_.set_center_widget(label_);
-  button_.add(content_);
-
   if (!workspace_group.is_visible()) {
     return;
   }
 
-  workspace_group.add_button(button_);
-  button_.show_all();
+  workspace_group.add_button(bundle_->button);
+  bundle_->button.show_all();
 }
 
 Workspace::~Workspace() {
-  workspace_group_.remove_button(button_);
+  click_connection_.disconnect();
+  workspace_group_.manager().release_button(std::move(bundle_));
   if (!workspace_handle_) {
     return;
   }
@@ -351,8 +379,12 @@ Workspace::~Workspace() {
 }
 
 auto Workspace::update() -> void {
-  label_.set_markup(fmt::format(format_, fmt::arg("name", name_),
-                                fmt::arg("icon", with_icon_ ? get_icon() : "")));
+  auto markup = fmt::format(format_, fmt::arg("name", name_),
+                            fmt::arg("icon", with_icon_ ? get_icon() : ""));
+  if (markup != last_markup_) {
+    bundle_->label.set_markup(markup);
+    last_markup_ = std::move(markup);
+  }
 }
 
 auto Workspace::handle_state(const std::vector<uint32_t> &state) -> void {
@@ -381,27 +413,32 @@ auto Workspace::handle_remove() -> void {
 auto add_or_remove_class(Glib::RefPtr<Gtk::StyleContext> context, bool condition,
                          const std::string &class_name) {
   if (condition) {
-    context->add_class(class_name);
-  } else {
+    if (!context->has_class(class_name)) {
+      context->add_class(class_name);
+    }
+  } else if (context->has_class(class_name)) {
     context->remove_class(class_name);
   }
 }
 
 auto Workspace::handle_done() -> void {
-  spdlog::debug("Workspace {} changed to state {}", id_, state_);
-  auto style_context = button_.get_style_context();
-  add_or_remove_class(style_context, is_active(), "active");
-  add_or_remove_class(style_context, is_urgent(), "urgent");
-  add_or_remove_class(style_context, is_hidden(), "hidden");
+  if (state_ != last_rendered_state_) {
+    SPDLOG_DEBUG("Workspace {} changed to state {}", id_, state_);
+    auto style_context = bundle_->button.get_style_context();
+    add_or_remove_class(style_context, is_active(), "active");
+    add_or_remove_class(style_context, is_urgent(), "urgent");
+    add_or_remove_class(style_context, is_hidden(), "hidden");
+    last_rendered_state_ = state_;
+  }
 
   if (workspace_group_.creation_delayed()) {
     return;
   }
 
   if (workspace_group_.active_only() && (is_active() || is_urgent())) {
-    button_.show_all();
+    bundle_->button.show_all();
   } else if (workspace_group_.active_only() && !(is_active() || is_urgent())) {
-    button_.hide();
+    bundle_->button.hide();
   }
 }
 
@@ -451,8 +488,8 @@ auto Workspace::handle_clicked(GdkEventButton *bt) -> bool {
   return true;
 }
 
-auto Workspace::show() -> void { button_.show_all(); }
-auto Workspace::hide() -> void { button_.hide(); }
+auto Workspace::show() -> void { bundle_->button.show_all(); }
+auto Workspace::hide() -> void { bundle_->button.hide(); }
 
 auto Workspace::handle_name(const std::string &name) -> void {
   if (name_ != name) {
@@ -0,0 +1,88 @@
+#include "signal_router.hpp"
+
+#include <spdlog/spdlog.h>
+#include <sys/signalfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+
+#include "AModule.hpp"
+
+namespace waybar {
+
+namespace {
+
+sigset_t rtSignalMask() {
+  sigset_t mask;
+  sigemptyset(&mask);
+  for (int sig = SIGRTMIN + 1; sig <= SIGRTMAX; ++sig) {
+    sigaddset(&mask, sig);
+  }
+  return mask;
+}
+
+}  // namespace
+
+SignalRouter &SignalRouter::instance() {
+  static SignalRouter router;
+  return router;
+}
+
+SignalRouter::SignalRouter() : table_(SIGRTMAX - SIGRTMIN + 1) {}
+
+void SignalRouter::block() {
+  auto mask = rtSignalMask();
+  if (pthread_sigmask(SIG_BLOCK, &mask, nullptr) != 0) {
+    spdlog::error("signal router: pthread_sigmask: {}", strerror(errno));
+  }
+}
+
+void SignalRouter::start() {
+  if (fd_ >= 0) {
+    return;
+  }
+  auto mask = rtSignalMask();
+  fd_ = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+  if (fd_ < 0) {
+    spdlog::warn("signal router: signalfd: {}", strerror(errno));
+    return;
+  }
+  watch_ =
+      Glib::signal_io().connect(sigc::mem_fun(*this, &SignalRouter::onSignal), fd_, Glib::IO_IN);
+}
+
+bool SignalRouter::onSignal(Glib::IOCondition /*cond*/) {
+  struct signalfd_siginfo info;
+  while (read(fd_, &info, sizeof(info)) == sizeof(info)) {
+    size_t offset = info.ssi_signo - SIGRTMIN;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (offset >= table_.size()) {
+      continue;
+    }
+    for (auto *module : table_[offset]) {
+      module->refresh(info.ssi_signo);
+    }
+  }
+  return true;
+}
+
+void SignalRouter::subscribe(int offset, AModule *module) {
+  if (offset <= 0 || offset > SIGRTMAX - SIGRTMIN) {
+    spdlog::warn("signal router: SIGRTMIN+{} is out of range", offset);
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  table_[offset].push_back(module);
+}
+
+void SignalRouter::unsubscribe(AModule *module) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto &subscribers : table_) {
+    subscribers.erase(std::remove(subscribers.begin(), subscribers.end(), module),
+                      subscribers.end());
+  }
+}
+
+}  // namespace waybar
@@ -0,0 +1,49 @@
+#include "util/alloc_track.hpp"
+
+#ifdef HAVE_ALLOC_TRACK
+
+#include <cstdlib>
+#include <new>
+
+#include "util/perf_counters.hpp"
+
+namespace {
+
+thread_local uint64_t thread_allocs = 0;
+
+}  // namespace
+
+// Counting replacements for the global allocation functions. Only the count
+// is tracked; the allocations themselves go straight to malloc, so the audit
+// build stays usable as a daily driver.
+
+void* operator new(std::size_t size) {
+  ++thread_allocs;
+  if (void* ptr = std::malloc(size != 0 ? size : 1)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace waybar::util::alloc_track {
+
+uint64_t threadAllocCount() { return thread_allocs; }
+
+Scope::Scope(std::string name) : name_(std::move(name)), start_(thread_allocs) {}
+
+Scope::~Scope() {
+  uint64_t count = thread_allocs - start_;
+  // building the gauge key allocates too; it lands outside this span
+  PerfCounters::instance().gauge("alloc/" + name_, count);
+}
+
+}  // namespace waybar::util::alloc_track
+
+#endif  // HAVE_ALLOC_TRACK
@@ -0,0 +1,254 @@
+#include "util/config_cache.hpp"
+
+#include <spdlog/spdlog.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+namespace waybar::util {
+
+namespace {
+
+constexpr uint32_t MAGIC = 0x46434257;  // "WBCF"
+constexpr uint32_t VERSION = 1;
+
+enum class Tag : uint8_t {
+  Null = 0,
+  False = 1,
+  True = 2,
+  Int = 3,
+  UInt = 4,
+  Real = 5,
+  String = 6,
+  Array = 7,
+  Object = 8,
+};
+
+template <typename T>
+void put(std::ostream& os, const T& value) {
+  os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T get(std::istream& is) {
+  T value{};
+  is.read(reinterpret_cast<char*>(&value), sizeof(value));
+  if (!is) {
+    throw std::runtime_error("truncated config cache");
+  }
+  return value;
+}
+
+void putString(std::ostream& os, const std::string& str) {
+  put<uint32_t>(os, str.size());
+  os.write(str.data(), str.size());
+}
+
+std::string getString(std::istream& is) {
+  auto size = get<uint32_t>(is);
+  std::string str(size, '\0');
+  is.read(str.data(), size);
+  if (!is) {
+    throw std::runtime_error("truncated config cache");
+  }
+  return str;
+}
+
+void putValue(std::ostream& os, const Json::Value& value) {
+  switch (value.type()) {
+    case Json::nullValue:
+      put(os, Tag::Null);
+      break;
+    case Json::booleanValue:
+      put(os, value.asBool() ? Tag::True : Tag::False);
+      break;
+    case Json::intValue:
+      put(os, Tag::Int);
+      put<int64_t>(os, value.asInt64());
+      break;
+    case Json::uintValue:
+      put(os, Tag::UInt);
+      put<uint64_t>(os, value.asUInt64());
+      break;
+    case Json::realValue:
+      put(os, Tag::Real);
+      put<double>(os, value.asDouble());
+      break;
+    case Json::stringValue:
+      put(os, Tag::String);
+      putString(os, value.asString());
+      break;
+    case Json::arrayValue:
+      put(os, Tag::Array);
+      put<uint32_t>(os, value.size());
+      for (const auto& item : value) {
+        putValue(os, item);
+      }
+      break;
+    case Json::objectValue:
+      put(os, Tag::Object);
+      put<uint32_t>(os, value.size());
+      for (const auto& key : value.getMemberNames()) {
+        putString(os, key);
+        putValue(os, value[key]);
+      }
+      break;
+  }
+}
+
+Json::Value getValue(std::istream& is) {
+  switch (get<Tag>(is)) {
+    case Tag::Null:
+      return Json::Value();
+    case Tag::False:
+      return Json::Value(false);
+    case Tag::True:
+      return Json::Value(true);
+    case Tag::Int:
+      return Json::Value(static_cast<Json::Int64>(get<int64_t>(is)));
+    case Tag::UInt:
+      return Json::Value(static_cast<Json::UInt64>(get<uint64_t>(is)));
+    case Tag::Real:
+      return Json::Value(get<double>(is));
+    case Tag::String:
+      return Json::Value(getString(is));
+    case Tag::Array: {
+      Json::Value value(Json::arrayValue);
+      auto size = get<uint32_t>(is);
+      for (uint32_t i = 0; i < size; ++i) {
+        value.append(getValue(is));
+      }
+      return value;
+    }
+    case Tag::Object: {
+      Json::Value value(Json::objectValue);
+      auto size = get<uint32_t>(is);
+      for (uint32_t i = 0; i < size; ++i) {
+        auto key = getString(is);
+        value[key] = getValue(is);
+      }
+      return value;
+    }
+  }
+  throw std::runtime_error("corrupt config cache");
+}
+
+struct SourceStamp {
+  int64_t mtime;
+  uint64_t size;
+};
+
+std::optional<SourceStamp> stampOf(const std::string& path) {
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0) {
+    return std::nullopt;
+  }
+  return SourceStamp{int64_t(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec,
+                     uint64_t(st.st_size)};
+}
+
+void makeDirs(const std::string& path) {
+  for (auto pos = path.find('/', 1); pos != std::string::npos; pos = path.find('/', pos + 1)) {
+    mkdir(path.substr(0, pos).c_str(), 0755);
+  }
+  mkdir(path.c_str(), 0755);
+}
+
+std::string cacheDir() {
+  if (const char* cache_home = std::getenv("XDG_CACHE_HOME");
+      cache_home != nullptr && cache_home[0] != '\0') {
+    return std::string(cache_home) + "/waybar";
+  }
+  if (const char* home = std::getenv("HOME"); home != nullptr && home[0] != '\0') {
+    return std::string(home) + "/.cache/waybar";
+  }
+  return "/tmp/waybar-cache";
+}
+
+}  // namespace
+
+std::string ConfigCache::cachePath(const std::string& main_file) {
+  // one cache entry per main config path, so alternating -c flags don't thrash
+  char name[32];
+  snprintf(name, sizeof(name), "config-%016zx.bin", std::hash<std::string>{}(main_file));
+  return cacheDir() + '/' + name;
+}
+
+std::optional<Json::Value> ConfigCache::load(const std::string& main_file,
+                                             std::vector<std::string>* sources) {
+  auto path = cachePath(main_file);
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    return std::nullopt;
+  }
+  try {
+    if (get<uint32_t>(file) != MAGIC || get<uint32_t>(file) != VERSION) {
+      return std::nullopt;
+    }
+    auto nsources = get<uint32_t>(file);
+    std::vector<std::string> seen;
+    for (uint32_t i = 0; i < nsources; ++i) {
+      auto source = getString(file);
+      auto mtime = get<int64_t>(file);
+      auto size = get<uint64_t>(file);
+      auto stamp = stampOf(source);
+      if (!stamp || stamp->mtime != mtime || stamp->size != size) {
+        SPDLOG_DEBUG("Config cache stale: {} changed", source);
+        return std::nullopt;
+      }
+      seen.push_back(std::move(source));
+    }
+    if (sources != nullptr) {
+      *sources = std::move(seen);
+    }
+    return getValue(file);
+  } catch (const std::exception& e) {
+    SPDLOG_DEBUG("Config cache unusable: {}", e.what());
+    return std::nullopt;
+  }
+}
+
+void ConfigCache::store(const std::string& main_file, const std::vector<std::string>& sources,
+                        const Json::Value& config) {
+  makeDirs(cacheDir());
+  auto path = cachePath(main_file);
+  auto tmp_path = path + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+      SPDLOG_DEBUG("Unable to write config cache {}", tmp_path);
+      return;
+    }
+    put<uint32_t>(file, MAGIC);
+    put<uint32_t>(file, VERSION);
+    put<uint32_t>(file, sources.size());
+    for (const auto& source : sources) {
+      auto stamp = stampOf(source);
+      if (!stamp) {
+        // sources must be re-checkable or the cache can never be trusted
+        file.close();
+        unlink(tmp_path.c_str());
+        return;
+      }
+      putString(file, source);
+      put<int64_t>(file, stamp->mtime);
+      put<uint64_t>(file, stamp->size);
+    }
+    putValue(file, config);
+    if (!file) {
+      file.close();
+      unlink(tmp_path.c_str());
+      return;
+    }
+  }
+  // atomic swap so a concurrent start never sees a half-written cache
+  if (rename(tmp_path.c_str(), path.c_str()) != 0) {
+    unlink(tmp_path.c_str());
+  }
+}
+
+}  // namespace waybar::util
@@ -0,0 +1,63 @@
+#include "util/dbus_manager.hpp"
+
+#include <spdlog/spdlog.h>
+
+namespace waybar::util {
+
+DBusManager& DBusManager::instance() {
+  static DBusManager manager;
+  return manager;
+}
+
+Glib::RefPtr<Gio::DBus::Connection> DBusManager::connection(Gio::DBus::BusType type) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = connections_.find(type);
+  if (it != connections_.end()) {
+    return it->second;
+  }
+  try {
+    auto conn = Gio::DBus::Connection::get_sync(type);
+    connections_.emplace(type, conn);
+    return conn;
+  } catch (const Glib::Error& e) {
+    spdlog::error("DBusManager: can't reach bus {}: {}", static_cast<int>(type),
+                  std::string(e.what()));
+    return {};
+  }
+}
+
+GDBusConnection* DBusManager::raw(Gio::DBus::BusType type) {
+  auto conn = connection(type);
+  return conn ? conn->gobj() : nullptr;
+}
+
+Glib::RefPtr<Gio::DBus::Proxy> DBusManager::proxy(Gio::DBus::BusType type,
+                                                  const Glib::ustring& name,
+                                                  const Glib::ustring& object_path,
+                                                  const Glib::ustring& interface_name) {
+  auto key = std::to_string(static_cast<int>(type)) + '|' + name.raw() + '|' + object_path.raw() +
+             '|' + interface_name.raw();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = proxies_.find(key);
+    if (it != proxies_.end()) {
+      return it->second;
+    }
+  }
+  auto conn = connection(type);
+  if (!conn) {
+    return {};
+  }
+  try {
+    auto proxy = Gio::DBus::Proxy::create_sync(conn, name, object_path, interface_name);
+    std::lock_guard<std::mutex> lock(mutex_);
+    // a racing caller may have created it meanwhile; keep the first one
+    return proxies_.emplace(key, proxy).first->second;
+  } catch (const Glib::Error& e) {
+    spdlog::error("DBusManager: can't create proxy for {} {}: {}", std::string(name),
+                  std::string(object_path), std::string(e.what()));
+    return {};
+  }
+}
+
+}  // namespace waybar::util
@@ -0,0 +1,115 @@
+#include "util/fd_reactor.hpp"
+
+#include <spdlog/spdlog.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace waybar::util {
+
+FdReactor& FdReactor::instance() {
+  static FdReactor reactor;
+  return reactor;
+}
+
+FdReactor::FdReactor() {
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd_ == -1) {
+    throw std::runtime_error("Unable to create epoll instance");
+  }
+  wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (wake_fd_ == -1) {
+    close(epoll_fd_);
+    throw std::runtime_error("Unable to create eventfd");
+  }
+  struct epoll_event ev = {};
+  ev.events = EPOLLIN;
+  ev.data.fd = wake_fd_;
+  epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+  thread_ = std::thread([this] { run(); });
+}
+
+FdReactor::~FdReactor() {
+  uint64_t one = 1;
+  (void)!write(wake_fd_, &one, sizeof(one));
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  close(wake_fd_);
+  close(epoll_fd_);
+}
+
+void FdReactor::add(int fd, uint32_t events, Callback callback) {
+  {
+    std::lock_guard lock(mutex_);
+    auto handler = std::make_shared<Handler>();
+    handler->callback = std::move(callback);
+    handlers_[fd] = std::move(handler);
+  }
+  struct epoll_event ev = {};
+  ev.events = events;
+  ev.data.fd = fd;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) == -1) {
+    std::lock_guard lock(mutex_);
+    handlers_.erase(fd);
+    throw std::runtime_error("Unable to register fd with the reactor");
+  }
+}
+
+void FdReactor::remove(int fd) {
+  epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+  std::unique_lock lock(mutex_);
+  auto it = handlers_.find(fd);
+  if (it == handlers_.end()) {
+    return;
+  }
+  auto handler = it->second;
+  handlers_.erase(it);
+  if (std::this_thread::get_id() != thread_.get_id()) {
+    // The fd owner is usually tearing down; don't let it close the fd while the
+    // callback is still on the reactor thread.
+    idle_condvar_.wait(lock, [&handler] { return !handler->running; });
+  }
+}
+
+void FdReactor::run() {
+  std::array<struct epoll_event, 16> events;
+  while (true) {
+    int n = epoll_wait(epoll_fd_, events.data(), events.size(), -1);
+    if (n == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      spdlog::error("FdReactor: epoll_wait failed: {}", strerror(errno));
+      return;
+    }
+    for (int i = 0; i < n; ++i) {
+      if (events[i].data.fd == wake_fd_) {
+        return;
+      }
+      std::shared_ptr<Handler> handler;
+      {
+        std::lock_guard lock(mutex_);
+        auto it = handlers_.find(events[i].data.fd);
+        if (it == handlers_.end()) {
+          continue;
+        }
+        handler = it->second;
+        handler->running = true;
+      }
+      handler->callback(events[i].events);
+      {
+        std::lock_guard lock(mutex_);
+        handler->running = false;
+      }
+      idle_condvar_.notify_all();
+    }
+  }
+}
+
+}  // namespace waybar::util
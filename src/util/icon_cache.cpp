@@ -0,0 +1,76 @@
+#include "util/icon_cache.hpp"
+
+#include <gdk/gdk.h>
+
+namespace waybar::util {
+
+IconCache& IconCache::instance() {
+  static IconCache cache;
+  return cache;
+}
+
+Glib::RefPtr<Gdk::Pixbuf> IconCache::get(const Glib::RefPtr<Gtk::IconTheme>& theme,
+                                         const std::string& name, int size, const Loader& loader) {
+  watchTheme(theme);
+  return lookup({theme->gobj(), name, size}, loader);
+}
+
+Glib::RefPtr<Gdk::Pixbuf> IconCache::getFile(const std::string& path, int size,
+                                             const Loader& loader) {
+  return lookup({nullptr, path, size}, loader);
+}
+
+Glib::RefPtr<Gdk::Pixbuf> IconCache::lookup(Key key, const Loader& loader) {
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->second;
+  }
+  auto pixbuf = loader();
+  lru_.emplace_front(key, pixbuf);
+  entries_.emplace(std::move(key), lru_.begin());
+  if (entries_.size() > MAX_ENTRIES) {
+    entries_.erase(lru_.back().first);
+    lru_.pop_back();
+  }
+  return pixbuf;
+}
+
+Cairo::RefPtr<Cairo::Surface> IconCache::surface(const Glib::RefPtr<Gdk::Pixbuf>& pixbuf,
+                                                 int scale) {
+  SurfaceKey key{pixbuf->gobj(), scale};
+  auto it = surfaces_.find(key);
+  if (it != surfaces_.end()) {
+    surface_lru_.splice(surface_lru_.begin(), surface_lru_, it->second);
+    return it->second->surface;
+  }
+  auto* c_surface = gdk_cairo_surface_create_from_pixbuf(pixbuf->gobj(), scale, nullptr);
+  auto surface = Cairo::RefPtr<Cairo::Surface>(new Cairo::Surface(c_surface, true));
+  surface_lru_.push_front({key, pixbuf, surface});
+  surfaces_.emplace(key, surface_lru_.begin());
+  if (surfaces_.size() > MAX_ENTRIES) {
+    surfaces_.erase(surface_lru_.back().key);
+    surface_lru_.pop_back();
+  }
+  return surface;
+}
+
+void IconCache::watchTheme(const Glib::RefPtr<Gtk::IconTheme>& theme) {
+  const void* handle = theme->gobj();
+  if (watched_themes_.insert(handle).second) {
+    theme->signal_changed().connect([this, handle] { invalidateTheme(handle); });
+  }
+}
+
+void IconCache::invalidateTheme(const void* theme) {
+  for (auto it = lru_.begin(); it != lru_.end();) {
+    if (it->first.theme == theme) {
+      entries_.erase(it->first);
+      it = lru_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+}  // namespace waybar::util
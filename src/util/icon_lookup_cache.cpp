@@ -0,0 +1,118 @@
+#include "util/icon_lookup_cache.hpp"
+
+#include <spdlog/spdlog.h>
+#include <sys/stat.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace waybar::util {
+
+IconLookupCache& IconLookupCache::instance() {
+  static IconLookupCache cache;
+  return cache;
+}
+
+std::string IconLookupCache::cachePath() {
+  const char* cache_home = std::getenv("XDG_CACHE_HOME");
+  std::string base;
+  if (cache_home != nullptr && cache_home[0] != '\0') {
+    base = cache_home;
+  } else {
+    const char* home = std::getenv("HOME");
+    if (home == nullptr) {
+      return {};
+    }
+    base = std::string(home) + "/.cache";
+  }
+  return base + "/waybar/icons.cache";
+}
+
+IconLookupCache::IconLookupCache() {
+  auto path = cachePath();
+  if (path.empty()) {
+    return;
+  }
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line)) {
+    auto tab1 = line.find('\t');
+    auto tab2 = line.find('\t', tab1 + 1);
+    if (tab1 == std::string::npos || tab2 == std::string::npos) {
+      continue;
+    }
+    Entry entry;
+    entry.path = line.substr(tab1 + 1, tab2 - tab1 - 1);
+    entry.mtime = std::strtoll(line.c_str() + tab2 + 1, nullptr, 10);
+    entries_.emplace(line.substr(0, tab1), std::move(entry));
+  }
+}
+
+IconLookupCache::~IconLookupCache() {
+  if (unsaved_ > 0) {
+    save();
+  }
+}
+
+std::optional<std::string> IconLookupCache::lookup(const std::string& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return std::nullopt;
+  }
+  struct stat st;
+  if (stat(it->second.path.c_str(), &st) != 0 || st.st_mtime != it->second.mtime) {
+    entries_.erase(it);
+    return std::nullopt;
+  }
+  return it->second.path;
+}
+
+void IconLookupCache::store(const std::string& key, const std::string& path) {
+  if (key.find('\t') != std::string::npos || path.find('\t') != std::string::npos ||
+      path.find('\n') != std::string::npos) {
+    return;
+  }
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& entry = entries_[key];
+  if (entry.path == path && entry.mtime == st.st_mtime) {
+    return;
+  }
+  entry.path = path;
+  entry.mtime = st.st_mtime;
+  if (++unsaved_ >= FLUSH_THRESHOLD) {
+    save();
+  }
+}
+
+void IconLookupCache::save() {
+  auto path = cachePath();
+  if (path.empty()) {
+    return;
+  }
+  try {
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path());
+    auto tmp = path + ".tmp";
+    {
+      std::ofstream file(tmp, std::ios::trunc);
+      for (const auto& [key, entry] : entries_) {
+        file << key << '\t' << entry.path << '\t' << entry.mtime << '\n';
+      }
+      if (!file) {
+        return;
+      }
+    }
+    std::filesystem::rename(tmp, path);
+    unsaved_ = 0;
+  } catch (const std::exception& e) {
+    SPDLOG_DEBUG("IconLookupCache: failed to save {}: {}", path, e.what());
+  }
+}
+
+}  // namespace waybar::util
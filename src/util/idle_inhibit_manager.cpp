@@ -0,0 +1,63 @@
+#include "util/idle_inhibit_manager.hpp"
+
+#include "client.hpp"
+#include "idle-inhibit-unstable-v1-client-protocol.h"
+
+namespace waybar::util {
+
+IdleInhibitManager& IdleInhibitManager::instance() {
+  static IdleInhibitManager manager;
+  return manager;
+}
+
+int IdleInhibitManager::subscribe(struct wl_surface* surface, std::function<void()> on_change) {
+  int id = next_id_++;
+  subscribers_.emplace(id, Subscriber{surface, std::move(on_change)});
+  // inhibition may be active with no backing surface after a config reload
+  sync();
+  return id;
+}
+
+void IdleInhibitManager::unsubscribe(int id) {
+  auto it = subscribers_.find(id);
+  if (it == subscribers_.end()) {
+    return;
+  }
+  bool backing = it->second.surface == inhibitor_surface_;
+  subscribers_.erase(it);
+  if (backing && inhibitor_ != nullptr) {
+    // the surface backing the inhibitor is going away; recreate it on any
+    // remaining subscriber so inhibition survives the bar teardown
+    zwp_idle_inhibitor_v1_destroy(inhibitor_);
+    inhibitor_ = nullptr;
+    inhibitor_surface_ = nullptr;
+    sync();
+  }
+}
+
+void IdleInhibitManager::set(bool active) {
+  if (active == active_) {
+    return;
+  }
+  active_ = active;
+  sync();
+  for (const auto& [id, subscriber] : subscribers_) {
+    subscriber.on_change();
+  }
+}
+
+void IdleInhibitManager::sync() {
+  if (active_ && inhibitor_ == nullptr && !subscribers_.empty()) {
+    auto* manager = Client::inst()->idle_inhibit_manager;
+    if (manager != nullptr) {
+      inhibitor_surface_ = subscribers_.begin()->second.surface;
+      inhibitor_ = zwp_idle_inhibit_manager_v1_create_inhibitor(manager, inhibitor_surface_);
+    }
+  } else if (!active_ && inhibitor_ != nullptr) {
+    zwp_idle_inhibitor_v1_destroy(inhibitor_);
+    inhibitor_ = nullptr;
+    inhibitor_surface_ = nullptr;
+  }
+}
+
+}  // namespace waybar::util
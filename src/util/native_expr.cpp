@@ -0,0 +1,309 @@
+#include "util/native_expr.hpp"
+
+#include <fmt/format.h>
+#if __has_include(<fmt/args.h>)
+// fmt >= 8 moved dynamic_format_arg_store out of core.h
+#include <fmt/args.h>
+#endif
+
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace {
+
+std::string trimmed(std::string text) {
+  while (!text.empty() && (text.back() == '\n' || text.back() == ' ' || text.back() == '\t')) {
+    text.pop_back();
+  }
+  return text;
+}
+
+}  // namespace
+
+namespace waybar::util {
+
+struct NativeExpr::Parser {
+  const std::string& src;
+  size_t pos = 0;
+
+  explicit Parser(const std::string& src) : src(src) {}
+
+  [[noreturn]] void fail(const std::string& what) const {
+    throw std::runtime_error(
+        fmt::format("native expression: {} at offset {} in \"{}\"", what, pos, src));
+  }
+
+  void skipSpace() {
+    while (pos < src.size() && (src[pos] == ' ' || src[pos] == '\t' || src[pos] == '\n')) {
+      ++pos;
+    }
+  }
+
+  char peek() {
+    skipSpace();
+    return pos < src.size() ? src[pos] : '\0';
+  }
+
+  bool consume(char c) {
+    if (peek() == c) {
+      ++pos;
+      return true;
+    }
+    return false;
+  }
+
+  Node parseExpr() {
+    auto node = parseTerm();
+    while (true) {
+      char c = peek();
+      if (c != '+' && c != '-') {
+        return node;
+      }
+      ++pos;
+      Node parent{Node::Kind::BinOp};
+      parent.op = c;
+      parent.args.push_back(std::move(node));
+      parent.args.push_back(parseTerm());
+      node = std::move(parent);
+    }
+  }
+
+  Node parseTerm() {
+    auto node = parseUnary();
+    while (true) {
+      char c = peek();
+      if (c != '*' && c != '/' && c != '%') {
+        return node;
+      }
+      ++pos;
+      Node parent{Node::Kind::BinOp};
+      parent.op = c;
+      parent.args.push_back(std::move(node));
+      parent.args.push_back(parseUnary());
+      node = std::move(parent);
+    }
+  }
+
+  Node parseUnary() {
+    if (consume('-')) {
+      // represent as 0 - x
+      Node zero{Node::Kind::Number};
+      Node parent{Node::Kind::BinOp};
+      parent.op = '-';
+      parent.args.push_back(std::move(zero));
+      parent.args.push_back(parseUnary());
+      return parent;
+    }
+    return parsePrimary();
+  }
+
+  Node parsePrimary() {
+    char c = peek();
+    if (c == '(') {
+      ++pos;
+      auto node = parseExpr();
+      if (!consume(')')) {
+        fail("expected ')'");
+      }
+      return node;
+    }
+    if (c == '\'' || c == '"') {
+      return parseString(c);
+    }
+    if ((c >= '0' && c <= '9') || c == '.') {
+      return parseNumber();
+    }
+    if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_') {
+      return parseCall();
+    }
+    fail("unexpected character");
+  }
+
+  Node parseString(char quote) {
+    ++pos;  // opening quote
+    Node node{Node::Kind::String};
+    while (pos < src.size() && src[pos] != quote) {
+      if (src[pos] == '\\' && pos + 1 < src.size()) {
+        ++pos;
+        switch (src[pos]) {
+          case 'n':
+            node.text += '\n';
+            break;
+          case 't':
+            node.text += '\t';
+            break;
+          default:
+            node.text += src[pos];
+            break;
+        }
+      } else {
+        node.text += src[pos];
+      }
+      ++pos;
+    }
+    if (pos == src.size()) {
+      fail("unterminated string");
+    }
+    ++pos;  // closing quote
+    return node;
+  }
+
+  Node parseNumber() {
+    Node node{Node::Kind::Number};
+    char* end = nullptr;
+    node.number = std::strtod(src.c_str() + pos, &end);
+    if (end == src.c_str() + pos) {
+      fail("bad number");
+    }
+    pos = end - src.c_str();
+    return node;
+  }
+
+  Node parseCall() {
+    Node node{Node::Kind::Call};
+    while (pos < src.size() && ((src[pos] >= 'a' && src[pos] <= 'z') ||
+                                (src[pos] >= 'A' && src[pos] <= 'Z') || src[pos] == '_')) {
+      node.text += src[pos];
+      ++pos;
+    }
+    if (!consume('(')) {
+      fail("expected '(' after function name");
+    }
+    if (!consume(')')) {
+      do {
+        node.args.push_back(parseExpr());
+      } while (consume(','));
+      if (!consume(')')) {
+        fail("expected ')'");
+      }
+    }
+    if (node.text == "file") {
+      if (node.args.size() != 1) {
+        fail("file() takes one argument");
+      }
+      if (node.args[0].kind == Node::Kind::String) {
+        node.file = std::make_shared<PollableFile>(node.args[0].text);
+      }
+    } else if (node.text == "regex") {
+      if (node.args.size() != 2) {
+        fail("regex() takes two arguments");
+      }
+      if (node.args[1].kind == Node::Kind::String) {
+        node.pattern = std::make_shared<std::regex>(node.args[1].text);
+      }
+    } else if (node.text == "num") {
+      if (node.args.size() != 1) {
+        fail("num() takes one argument");
+      }
+    } else if (node.text == "format") {
+      if (node.args.empty()) {
+        fail("format() needs a format string");
+      }
+    } else {
+      fail("unknown function '" + node.text + "'");
+    }
+    return node;
+  }
+};
+
+NativeExpr::NativeExpr(const std::string& source) {
+  Parser parser(source);
+  root_ = parser.parseExpr();
+  if (parser.peek() != '\0') {
+    parser.fail("trailing characters");
+  }
+}
+
+NativeExpr::~NativeExpr() = default;
+
+double NativeExpr::toNumber(const Value& value) {
+  if (std::holds_alternative<double>(value)) {
+    return std::get<double>(value);
+  }
+  return std::strtod(std::get<std::string>(value).c_str(), nullptr);
+}
+
+std::string NativeExpr::toString(const Value& value) {
+  if (std::holds_alternative<std::string>(value)) {
+    return std::get<std::string>(value);
+  }
+  auto number = std::get<double>(value);
+  if (number == std::floor(number) && std::fabs(number) < 1e15) {
+    return fmt::format("{}", static_cast<int64_t>(number));
+  }
+  return fmt::format("{}", number);
+}
+
+NativeExpr::Value NativeExpr::evalNode(Node& node) {
+  switch (node.kind) {
+    case Node::Kind::Number:
+      return node.number;
+    case Node::Kind::String:
+      return node.text;
+    case Node::Kind::BinOp: {
+      auto lhs = toNumber(evalNode(node.args[0]));
+      auto rhs = toNumber(evalNode(node.args[1]));
+      switch (node.op) {
+        case '+':
+          return lhs + rhs;
+        case '-':
+          return lhs - rhs;
+        case '*':
+          return lhs * rhs;
+        case '/':
+          return rhs != 0 ? lhs / rhs : 0.0;
+        case '%':
+          return rhs != 0 ? std::fmod(lhs, rhs) : 0.0;
+      }
+      return 0.0;
+    }
+    case Node::Kind::Call: {
+      if (node.text == "file") {
+        if (node.file) {
+          return trimmed(std::string(node.file->read()));
+        }
+        PollableFile file(toString(evalNode(node.args[0])));
+        return trimmed(std::string(file.read()));
+      }
+      if (node.text == "regex") {
+        auto input = toString(evalNode(node.args[0]));
+        std::smatch match;
+        bool found;
+        if (node.pattern) {
+          found = std::regex_search(input, match, *node.pattern);
+        } else {
+          found = std::regex_search(input, match,
+                                    std::regex(toString(evalNode(node.args[1]))));
+        }
+        if (!found) {
+          return std::string();
+        }
+        return match.size() > 1 ? match[1].str() : match[0].str();
+      }
+      if (node.text == "num") {
+        return toNumber(evalNode(node.args[0]));
+      }
+      // format
+      fmt::dynamic_format_arg_store<fmt::format_context> store;
+      std::vector<Value> values;
+      values.reserve(node.args.size() - 1);
+      for (size_t i = 1; i < node.args.size(); ++i) {
+        values.push_back(evalNode(node.args[i]));
+      }
+      for (auto& value : values) {
+        if (std::holds_alternative<double>(value)) {
+          store.push_back(std::get<double>(value));
+        } else {
+          store.push_back(std::get<std::string>(value));
+        }
+      }
+      return fmt::vformat(toString(evalNode(node.args[0])), store);
+    }
+  }
+  return 0.0;
+}
+
+std::string NativeExpr::eval() { return toString(evalNode(root_)); }
+
+}  // namespace waybar::util
@@ -0,0 +1,95 @@
+#include "util/perf_counters.hpp"
+
+namespace waybar::util {
+
+PerfCounters& PerfCounters::instance() {
+  static PerfCounters counters;
+  return counters;
+}
+
+void PerfCounters::Histogram::add(std::chrono::nanoseconds duration) {
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+  size_t bucket = 0;
+  while (bucket + 1 < kBuckets && (1L << (bucket + 1)) <= us) {
+    ++bucket;
+  }
+  ++buckets[bucket];
+  ++count;
+  total_ns += duration.count();
+  max_ns = std::max<uint64_t>(max_ns, duration.count());
+}
+
+uint64_t PerfCounters::Histogram::percentile_us(double q) const {
+  if (count == 0) {
+    return 0;
+  }
+  uint64_t rank = static_cast<uint64_t>(q * count), seen = 0;
+  for (size_t i = 0; i < kBuckets; ++i) {
+    seen += buckets[i];
+    if (seen > rank) {
+      return 1ULL << (i + 1);
+    }
+  }
+  return 1ULL << kBuckets;
+}
+
+void PerfCounters::record(const std::string& key, std::chrono::nanoseconds duration) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  histograms_[key].add(duration);
+}
+
+void PerfCounters::gauge(const std::string& key, uint64_t value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& g = gauges_[key];
+  g.last = value;
+  g.max = std::max(g.max, value);
+}
+
+PerfCounters::Snapshot PerfCounters::snapshot() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Snapshot snap;
+  for (const auto& [key, hist] : histograms_) {
+    if (key.compare(0, 7, "update/") != 0 || key == "update/waybar/perf") {
+      continue;
+    }
+    snap.updates += hist.count;
+    auto p99 = hist.percentile_us(0.99);
+    if (p99 >= snap.worst_p99_us) {
+      snap.worst_p99_us = p99;
+      snap.worst = key.substr(7);
+    }
+  }
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_);
+  if (elapsed.count() > 0) {
+    snap.rate = snap.updates / elapsed.count();
+  }
+  return snap;
+}
+
+Json::Value PerfCounters::toJson() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Json::Value root(Json::objectValue);
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_);
+  root["uptime_seconds"] = elapsed.count();
+  auto& timings = root["timings"];
+  for (const auto& [key, hist] : histograms_) {
+    auto& node = timings[key];
+    node["count"] = static_cast<Json::UInt64>(hist.count);
+    node["p50_us"] = static_cast<Json::UInt64>(hist.percentile_us(0.50));
+    node["p99_us"] = static_cast<Json::UInt64>(hist.percentile_us(0.99));
+    node["max_us"] = static_cast<Json::UInt64>(hist.max_ns / 1000);
+    node["mean_us"] =
+        static_cast<Json::UInt64>(hist.count ? hist.total_ns / hist.count / 1000 : 0);
+    if (elapsed.count() > 0) {
+      node["rate_hz"] = hist.count / elapsed.count();
+    }
+  }
+  auto& gauges = root["gauges"];
+  for (const auto& [key, g] : gauges_) {
+    gauges[key]["last"] = static_cast<Json::UInt64>(g.last);
+    gauges[key]["max"] = static_cast<Json::UInt64>(g.max);
+  }
+  return root;
+}
+
+}  // namespace waybar::util
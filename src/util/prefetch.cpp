@@ -0,0 +1,132 @@
+#include "util/prefetch.hpp"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <wordexp.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "config.hpp"
+#include "util/json.hpp"
+
+namespace waybar::util {
+
+namespace {
+
+void adviseFile(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    return;
+  }
+  struct stat st;
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+    (void)posix_fadvise(fd, 0, st.st_size, POSIX_FADV_WILLNEED);
+  }
+  close(fd);
+}
+
+// warm every theme's index; GTK stats them all while resolving inheritance,
+// and mmaps icon-theme.cache where one exists
+void adviseIconIndexes(const std::string& icons_dir) {
+  DIR* dir = opendir(icons_dir.c_str());
+  if (dir == nullptr) {
+    return;
+  }
+  while (auto* entry = readdir(dir)) {
+    if (entry->d_name[0] == '.') {
+      continue;
+    }
+    adviseFile(icons_dir + '/' + entry->d_name + "/index.theme");
+    adviseFile(icons_dir + '/' + entry->d_name + "/icon-theme.cache");
+  }
+  closedir(dir);
+}
+
+void adviseExpanded(const std::string& pattern) {
+  wordexp_t p;
+  if (wordexp(pattern.c_str(), &p, 0) == 0) {
+    for (size_t i = 0; i < p.we_wordc; ++i) {
+      adviseFile(p.we_wordv[i]);
+    }
+    wordfree(&p);
+  }
+}
+
+void adviseIncludes(const Json::Value& config) {
+  const auto& includes = config["include"];
+  if (includes.isString()) {
+    adviseExpanded(includes.asString());
+  } else if (includes.isArray()) {
+    for (const auto& include : includes) {
+      if (include.isString()) {
+        adviseExpanded(include.asString());
+      }
+    }
+  }
+}
+
+void prefetchWorker() {
+  // config, plus one level of includes: reading the file to find them warms
+  // it anyway, and deeper include chains are rare enough not to matter
+  if (auto config_path = Config::findConfigPath({"config", "config.jsonc"})) {
+    try {
+      std::ifstream file(*config_path);
+      std::string str((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+      JsonParser parser;
+      auto config = parser.parse(str);
+      if (config.isArray()) {
+        for (const auto& part : config) {
+          adviseIncludes(part);
+        }
+      } else {
+        adviseIncludes(config);
+      }
+    } catch (...) {
+      // a broken config surfaces properly in Config::load; not our problem
+    }
+  }
+
+  if (auto css_path = Config::findConfigPath({"style.css"})) {
+    adviseFile(*css_path);
+  }
+
+  // icon theme indexes in every XDG data dir
+  const char* home = getenv("HOME");
+  if (const char* data_home = getenv("XDG_DATA_HOME"); data_home != nullptr && *data_home != 0) {
+    adviseIconIndexes(std::string(data_home) + "/icons");
+  } else if (home != nullptr) {
+    adviseIconIndexes(std::string(home) + "/.local/share/icons");
+  }
+  if (home != nullptr) {
+    adviseIconIndexes(std::string(home) + "/.icons");
+  }
+  const char* data_dirs = getenv("XDG_DATA_DIRS");
+  std::string dirs = data_dirs != nullptr && *data_dirs != 0 ? data_dirs
+                                                             : "/usr/local/share:/usr/share";
+  size_t start = 0;
+  while (start < dirs.size()) {
+    auto end = dirs.find(':', start);
+    if (end == std::string::npos) {
+      end = dirs.size();
+    }
+    if (end > start) {
+      adviseIconIndexes(dirs.substr(start, end - start) + "/icons");
+    }
+    start = end + 1;
+  }
+
+  // tzdata for the clock
+  adviseFile("/etc/localtime");
+}
+
+}  // namespace
+
+void prefetchStartupFiles() { std::thread(prefetchWorker).detach(); }
+
+}  // namespace waybar::util
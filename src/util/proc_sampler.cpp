@@ -0,0 +1,26 @@
+#include "util/proc_sampler.hpp"
+
+namespace waybar::util {
+
+ProcSampler& ProcSampler::instance() {
+  static ProcSampler sampler;
+  return sampler;
+}
+
+std::shared_ptr<const ProcSampler::Snapshot> ProcSampler::sample(
+    std::chrono::milliseconds max_age) {
+  auto now = std::chrono::steady_clock::now();
+  std::lock_guard lock(mutex_);
+  if (last_ && now - last_->taken < max_age) {
+    return last_;
+  }
+  auto snapshot = std::make_shared<Snapshot>();
+  snapshot->stat = stat_.read();
+  snapshot->meminfo = meminfo_.read();
+  snapshot->netdev = netdev_.read();
+  snapshot->taken = now;
+  last_ = snapshot;
+  return last_;
+}
+
+}  // namespace waybar::util
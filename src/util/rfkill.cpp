@@ -26,7 +26,12 @@
 
 #include <cerrno>
 
-waybar::util::Rfkill::Rfkill(const enum rfkill_type rfkill_type) : rfkill_type_(rfkill_type) {
+waybar::util::RfkillManager& waybar::util::RfkillManager::instance() {
+  static RfkillManager manager;
+  return manager;
+}
+
+waybar::util::RfkillManager::RfkillManager() {
   fd_ = open("/dev/rfkill", O_RDONLY);
   if (fd_ < 0) {
     spdlog::error("Can't open RFKILL control device");
@@ -39,17 +44,17 @@ waybar::util::Rfkill::Rfkill(const enum rfkill_type rfkill_type) : rfkill_type_(
     fd_ = -1;
     return;
   }
-  Glib::signal_io().connect(sigc::mem_fun(*this, &Rfkill::on_event), fd_,
+  Glib::signal_io().connect(sigc::mem_fun(*this, &RfkillManager::on_event), fd_,
                             Glib::IO_IN | Glib::IO_ERR | Glib::IO_HUP);
 }
 
-waybar::util::Rfkill::~Rfkill() {
+waybar::util::RfkillManager::~RfkillManager() {
   if (fd_ >= 0) {
     close(fd_);
   }
 }
 
-bool waybar::util::Rfkill::on_event(Glib::IOCondition cond) {
+bool waybar::util::RfkillManager::on_event(Glib::IOCondition cond) {
   if (cond & Glib::IO_IN) {
     struct rfkill_event event;
     ssize_t len;
@@ -68,9 +73,10 @@ bool waybar::util::Rfkill::on_event(Glib::IOCondition cond) {
       return true;
     }
 
-    if (event.type == rfkill_type_ && (event.op == RFKILL_OP_ADD || event.op == RFKILL_OP_CHANGE)) {
-      state_ = event.soft || event.hard;
-      on_update.emit(event);
+    if (event.type < NUM_RFKILL_TYPES &&
+        (event.op == RFKILL_OP_ADD || event.op == RFKILL_OP_CHANGE)) {
+      states_[event.type] = event.soft || event.hard;
+      signals_[event.type].emit(event);
     }
     return true;
   } else {
@@ -79,4 +85,22 @@ bool waybar::util::Rfkill::on_event(Glib::IOCondition cond) {
   }
 }
 
-bool waybar::util::Rfkill::getState() const { return state_; }
+bool waybar::util::RfkillManager::getState(const enum rfkill_type type) const {
+  return type < NUM_RFKILL_TYPES && states_[type];
+}
+
+sigc::signal<void(struct rfkill_event&)>& waybar::util::RfkillManager::onUpdate(
+    const enum rfkill_type type) {
+  return signals_[type];
+}
+
+waybar::util::Rfkill::Rfkill(const enum rfkill_type rfkill_type) : rfkill_type_(rfkill_type) {
+  connection_ = RfkillManager::instance().onUpdate(rfkill_type_).connect(
+      [this](struct rfkill_event& event) { on_update.emit(event); });
+}
+
+waybar::util::Rfkill::~Rfkill() { connection_.disconnect(); }
+
+bool waybar::util::Rfkill::getState() const {
+  return RfkillManager::instance().getState(rfkill_type_);
+}
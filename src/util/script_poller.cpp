@@ -0,0 +1,122 @@
+#include "util/script_poller.hpp"
+
+namespace waybar::util {
+
+static std::mutex registry_mutex;
+static std::map<std::string, std::weak_ptr<ScriptPoller>> registry;
+
+std::shared_ptr<ScriptPoller> ScriptPoller::acquire(const std::string& exec,
+                                                    const std::string& exec_if,
+                                                    std::chrono::seconds interval,
+                                                    std::chrono::seconds exec_if_ttl) {
+  // '\x1f' cannot occur in a shell command line read from JSON config
+  auto key = exec + '\x1f' + exec_if + '\x1f' + std::to_string(interval.count()) + '\x1f' +
+             std::to_string(exec_if_ttl.count());
+  std::lock_guard lock(registry_mutex);
+  auto& slot = registry[key];
+  if (auto poller = slot.lock()) {
+    return poller;
+  }
+  auto poller = std::make_shared<ScriptPoller>(exec, exec_if, interval, exec_if_ttl);
+  slot = poller;
+  return poller;
+}
+
+ScriptPoller::ScriptPoller(std::string exec, std::string exec_if, std::chrono::seconds interval,
+                           std::chrono::seconds exec_if_ttl)
+    : exec_(std::move(exec)),
+      exec_if_(std::move(exec_if)),
+      interval_(interval),
+      exec_if_ttl_(exec_if_ttl) {
+  thread_ = [this] {
+    tick();
+    thread_.sleep_for(interval_);
+  };
+}
+
+ScriptPoller::Subscription ScriptPoller::subscribe(Callback cb) {
+  std::lock_guard lock(mutex_);
+  auto id = next_id_++;
+  if (has_output_) {
+    cb(last_);
+  }
+  subscribers_.emplace(id, Subscriber{std::move(cb), false});
+  return id;
+}
+
+void ScriptPoller::unsubscribe(Subscription id) {
+  // Callbacks run under mutex_, so once this lock is taken the subscriber can
+  // safely be destroyed.
+  std::lock_guard lock(mutex_);
+  subscribers_.erase(id);
+}
+
+void ScriptPoller::wakeUp() {
+  verdict_dirty_.store(true, std::memory_order_relaxed);
+  thread_.wake_up();
+}
+
+void ScriptPoller::setSuspended(Subscription id, bool suspended) {
+  std::lock_guard lock(mutex_);
+  auto it = subscribers_.find(id);
+  if (it == subscribers_.end() || it->second.suspended == suspended) {
+    return;
+  }
+  it->second.suspended = suspended;
+  bool all_suspended = true;
+  for (const auto& subscriber : subscribers_) {
+    all_suspended = all_suspended && subscriber.second.suspended;
+  }
+  if (all_suspended) {
+    thread_.suspend();
+  } else {
+    thread_.resume();
+  }
+}
+
+void ScriptPoller::tick() {
+  command::res res;
+  if (!exec_if_.empty()) {
+    auto now = std::chrono::steady_clock::now();
+    bool cached = exec_if_ttl_.count() > 0 && now < verdict_expires_ &&
+                  !verdict_dirty_.exchange(false, std::memory_order_relaxed);
+    if (cached && !verdict_ok_) {
+      // cached failure: every consumer is already hidden, spawn nothing
+      return;
+    }
+    if (!cached) {
+      res = command::execNoRead(exec_if_);
+      verdict_ok_ = res.exit_code == 0;
+      if (exec_if_ttl_.count() > 0) {
+        // a failing script chooses its own backoff: exit code N > 1 keeps the
+        // verdict for N times the configured TTL
+        auto ttl = exec_if_ttl_;
+        if (!verdict_ok_ && res.exit_code > 1) {
+          ttl *= res.exit_code;
+        }
+        verdict_expires_ = now + ttl;
+      }
+      if (!verdict_ok_) {
+        // broadcast the failure so every consumer hides, like the per-module path did
+        std::lock_guard lock(mutex_);
+        has_output_ = true;
+        last_ = res;
+        for (const auto& subscriber : subscribers_) {
+          subscriber.second.callback(last_);
+        }
+        return;
+      }
+    }
+  }
+  if (!exec_.empty()) {
+    res = command::exec(exec_);
+  }
+  std::lock_guard lock(mutex_);
+  has_output_ = true;
+  last_ = std::move(res);
+  for (const auto& subscriber : subscribers_) {
+    subscriber.second.callback(last_);
+  }
+}
+
+}  // namespace waybar::util
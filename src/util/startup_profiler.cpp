@@ -0,0 +1,68 @@
+#include "util/startup_profiler.hpp"
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+#include <unistd.h>
+
+#include <fstream>
+
+namespace waybar::util {
+
+StartupProfiler& StartupProfiler::instance() {
+  static StartupProfiler profiler;
+  return profiler;
+}
+
+StartupProfiler::Scope::~Scope() {
+  auto& profiler = StartupProfiler::instance();
+  if (profiler.enabled()) {
+    profiler.record(name_, start_, clock::now());
+  }
+}
+
+void StartupProfiler::enable() {
+  enabled_ = true;
+  origin_ = clock::now();
+}
+
+void StartupProfiler::record(const std::string& name, clock::time_point start,
+                             clock::time_point end) {
+  using namespace std::chrono;
+  std::lock_guard lock(mutex_);
+  events_.push_back({name, duration_cast<microseconds>(start - origin_).count(),
+                     duration_cast<microseconds>(end - start).count()});
+}
+
+void StartupProfiler::instant(const std::string& name) {
+  if (!enabled_) {
+    return;
+  }
+  auto now = clock::now();
+  record(name, now, now);
+  dump();
+}
+
+void StartupProfiler::dump() {
+  std::lock_guard lock(mutex_);
+  if (!enabled_ || dumped_) {
+    return;
+  }
+  dumped_ = true;
+  auto path = fmt::format("/tmp/waybar-startup-{}.json", getpid());
+  std::ofstream out(path);
+  if (!out.is_open()) {
+    spdlog::error("Unable to write startup trace to {}", path);
+    return;
+  }
+  out << "[";
+  for (size_t i = 0; i < events_.size(); ++i) {
+    const auto& ev = events_[i];
+    out << fmt::format(
+        R"({}{{"name":"{}","ph":"X","pid":1,"tid":1,"ts":{},"dur":{}}})",
+        i == 0 ? "" : ",", ev.name, ev.ts_us, ev.dur_us);
+  }
+  out << "]" << std::endl;
+  spdlog::info("Startup trace written to {}", path);
+}
+
+}  // namespace waybar::util
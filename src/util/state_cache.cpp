@@ -0,0 +1,134 @@
+#include "util/state_cache.hpp"
+
+#include <fcntl.h>
+#include <glibmm/main.h>
+#include <spdlog/spdlog.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+namespace waybar::util {
+
+namespace {
+
+std::string cachePath() {
+  const char* cache_home = getenv("XDG_CACHE_HOME");
+  if (cache_home != nullptr && *cache_home != 0) {
+    return std::string(cache_home) + "/waybar/state.bin";
+  }
+  const char* home = getenv("HOME");
+  if (home != nullptr) {
+    return std::string(home) + "/.cache/waybar/state.bin";
+  }
+  return {};
+}
+
+}  // namespace
+
+StateCache& StateCache::instance() {
+  static StateCache cache;
+  return cache;
+}
+
+StateCache::StateCache() {
+  auto path = cachePath();
+  if (path.empty()) {
+    return;
+  }
+
+  std::error_code ec;
+  std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd == -1) {
+    spdlog::warn("StateCache: can't open {}: {}", path, strerror(errno));
+    return;
+  }
+
+  map_size_ = sizeof(Header) + CAPACITY * sizeof(Record);
+  struct stat st;
+  bool fresh = fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) != map_size_;
+  if (ftruncate(fd, map_size_) != 0) {
+    spdlog::warn("StateCache: can't size {}: {}", path, strerror(errno));
+    close(fd);
+    map_size_ = 0;
+    return;
+  }
+
+  map_ = mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map_ == MAP_FAILED) {
+    spdlog::warn("StateCache: mmap failed: {}", strerror(errno));
+    map_ = nullptr;
+    map_size_ = 0;
+    return;
+  }
+
+  auto* header = static_cast<Header*>(map_);
+  if (fresh || header->magic != MAGIC || header->version != VERSION) {
+    // new file, or a layout we don't understand: start cold once
+    memset(map_, 0, map_size_);
+    header->magic = MAGIC;
+    header->version = VERSION;
+  }
+  records_ = reinterpret_cast<Record*>(header + 1);
+
+  // periodic writeback, so an unclean exit loses minutes of state, not all
+  Glib::signal_timeout().connect_seconds(
+      [this] {
+        flush();
+        return true;
+      },
+      60);
+}
+
+StateCache::~StateCache() {
+  if (map_ != nullptr) {
+    msync(map_, map_size_, MS_SYNC);
+    munmap(map_, map_size_);
+    map_ = nullptr;
+  }
+}
+
+double* StateCache::slot(const std::string& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (records_ == nullptr) {
+    return nullptr;
+  }
+  if (key.size() > MAX_KEY) {
+    spdlog::warn("StateCache: key too long: {}", key);
+    return nullptr;
+  }
+  Record* empty = nullptr;
+  for (size_t i = 0; i < CAPACITY; ++i) {
+    if (records_[i].key[0] == 0) {
+      if (empty == nullptr) {
+        empty = &records_[i];
+      }
+      continue;
+    }
+    if (strncmp(records_[i].key, key.c_str(), MAX_KEY) == 0) {
+      return &records_[i].value;
+    }
+  }
+  if (empty == nullptr) {
+    spdlog::warn("StateCache: full, dropping key {}", key);
+    return nullptr;
+  }
+  strncpy(empty->key, key.c_str(), MAX_KEY);
+  empty->value = NAN;
+  return &empty->value;
+}
+
+void StateCache::flush() {
+  if (map_ != nullptr) {
+    msync(map_, map_size_, MS_ASYNC);
+  }
+}
+
+}  // namespace waybar::util
@@ -0,0 +1,19 @@
+#include "util/string_pool.hpp"
+
+#include <mutex>
+#include <unordered_set>
+
+namespace waybar::util {
+
+const std::string& intern(std::string_view s) {
+  // unordered_set is node-based, so references stay valid across rehashes.
+  static std::mutex mutex;
+  static std::unordered_set<std::string> pool;
+  std::lock_guard<std::mutex> lock(mutex);
+  return *pool.emplace(s).first;
+}
+
+InternedString::InternedString(std::string_view s)
+    : str_(&intern(s)), hash_(std::hash<std::string_view>{}(s)) {}
+
+}  // namespace waybar::util
@@ -0,0 +1,280 @@
+#include "util/timer_scheduler.hpp"
+
+#include <poll.h>
+#include <spdlog/spdlog.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+
+#include "util/perf_counters.hpp"
+#include "util/trace.hpp"
+
+namespace waybar::util {
+
+// Two workers cover the usual polling load; a third absorbs an occasional slow read
+// (uevent scans, statvfs on network mounts) without delaying the other timers.
+static const size_t WORKER_COUNT = 3;
+
+// A boottime−monotonic gap step below this is clock noise, above it a suspend.
+static const int64_t SUSPEND_GAP_NS = 2'000'000'000;
+
+static int64_t bootMonoGapNs() {
+  struct timespec boot;
+  struct timespec mono;
+  clock_gettime(CLOCK_BOOTTIME, &boot);
+  clock_gettime(CLOCK_MONOTONIC, &mono);
+  return (boot.tv_sec - mono.tv_sec) * 1'000'000'000 + (boot.tv_nsec - mono.tv_nsec);
+}
+
+TimerScheduler& TimerScheduler::instance() {
+  static TimerScheduler scheduler;
+  return scheduler;
+}
+
+TimerScheduler::TimerScheduler() {
+  workers_.reserve(WORKER_COUNT);
+  for (size_t i = 0; i < WORKER_COUNT; ++i) {
+    workers_.emplace_back([this] { worker(); });
+  }
+  boottime_fd_ = timerfd_create(CLOCK_BOOTTIME, TFD_CLOEXEC);
+  watch_wake_fd_ = eventfd(0, EFD_CLOEXEC);
+  if (boottime_fd_ < 0 || watch_wake_fd_ < 0) {
+    spdlog::warn("timer scheduler: no suspend watch: {}", strerror(errno));
+    return;
+  }
+  boot_mono_gap_ns_ = bootMonoGapNs();
+  suspend_watch_ = std::thread([this] { suspendWatch(); });
+}
+
+TimerScheduler::~TimerScheduler() {
+  {
+    std::lock_guard lock(mutex_);
+    do_run_ = false;
+  }
+  condvar_.notify_all();
+  pokeWatch();
+  for (auto& thread : workers_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  if (suspend_watch_.joinable()) {
+    suspend_watch_.join();
+  }
+  if (boottime_fd_ > -1) {
+    close(boottime_fd_);
+  }
+  if (watch_wake_fd_ > -1) {
+    close(watch_wake_fd_);
+  }
+}
+
+void TimerScheduler::pokeWatch() {
+  if (watch_wake_fd_ > -1) {
+    uint64_t one = 1;
+    (void)!write(watch_wake_fd_, &one, sizeof(one));
+  }
+}
+
+TimerScheduler::TaskId TimerScheduler::repeat(clock::duration interval,
+                                              std::function<void()> func) {
+  std::lock_guard lock(mutex_);
+  auto id = next_id_++;
+  auto task = std::make_shared<Task>();
+  task->func = std::move(func);
+  task->interval = interval;
+  // Deterministic phase stagger: modules sharing an interval (1s, 10s, 60s defaults)
+  // would otherwise all fire on the same tick and fight for the main loop. The golden
+  // ratio sequence spreads registration order evenly across the period while keeping
+  // the offset stable for a given startup ordering.
+  constexpr double golden = 0.61803398875;
+  task->phase = std::chrono::duration_cast<clock::duration>(
+      interval * std::fmod(static_cast<double>(id) * golden, 1.0));
+  // The first tick runs immediately so the module paints at startup; the phase offset
+  // is folded in on the first rearm and only shifts the steady-state schedule.
+  task->next = clock::now();
+  tasks_.emplace(id, task);
+  queue_.push({task->next, id});
+  condvar_.notify_one();
+  pokeWatch();
+  return id;
+}
+
+void TimerScheduler::wakeUp(TaskId id) {
+  std::lock_guard lock(mutex_);
+  auto it = tasks_.find(id);
+  if (it != tasks_.end() && !it->second->running && !it->second->paused) {
+    it->second->next = clock::now();
+    queue_.push({it->second->next, id});
+    condvar_.notify_one();
+    pokeWatch();
+  }
+}
+
+void TimerScheduler::setInterval(TaskId id, clock::duration interval) {
+  std::lock_guard lock(mutex_);
+  auto it = tasks_.find(id);
+  if (it != tasks_.end()) {
+    it->second->interval = interval;
+  }
+}
+
+void TimerScheduler::pause(TaskId id) {
+  std::lock_guard lock(mutex_);
+  auto it = tasks_.find(id);
+  if (it != tasks_.end()) {
+    it->second->paused = true;
+  }
+}
+
+void TimerScheduler::resume(TaskId id) {
+  std::lock_guard lock(mutex_);
+  auto it = tasks_.find(id);
+  if (it != tasks_.end() && it->second->paused) {
+    it->second->paused = false;
+    it->second->next = clock::now() + it->second->interval;
+    queue_.push({it->second->next, id});
+    condvar_.notify_one();
+    pokeWatch();
+  }
+}
+
+void TimerScheduler::cancel(TaskId id) {
+  std::unique_lock lock(mutex_);
+  auto it = tasks_.find(id);
+  if (it == tasks_.end()) {
+    return;
+  }
+  auto task = it->second;
+  task->cancelled = true;
+  tasks_.erase(it);
+  // The module is usually being destroyed; make sure its callback is not mid-flight.
+  idle_condvar_.wait(lock, [&task] { return !task->running; });
+}
+
+TimerScheduler::ResumeListenerId TimerScheduler::addResumeListener(
+    std::function<void(std::chrono::milliseconds)> listener) {
+  std::lock_guard lock(mutex_);
+  auto id = next_listener_id_++;
+  resume_listeners_.emplace(id, std::move(listener));
+  return id;
+}
+
+void TimerScheduler::removeResumeListener(ResumeListenerId id) {
+  std::lock_guard lock(mutex_);
+  resume_listeners_.erase(id);
+}
+
+void TimerScheduler::suspendWatch() {
+  while (true) {
+    {
+      std::lock_guard lock(mutex_);
+      if (!do_run_) {
+        return;
+      }
+      // Arm to the earliest monotonic deadline, measured on CLOCK_BOOTTIME.
+      // The condvar waits below use CLOCK_MONOTONIC and stand still across a
+      // suspend; this timer keeps counting through it and fires at wake.
+      auto delay = std::chrono::nanoseconds(std::chrono::hours(1));
+      if (!queue_.empty()) {
+        delay = std::max(std::chrono::duration_cast<std::chrono::nanoseconds>(queue_.top().when -
+                                                                              clock::now()),
+                         std::chrono::nanoseconds(std::chrono::milliseconds(10)));
+      }
+      struct itimerspec spec = {};
+      spec.it_value.tv_sec = delay.count() / 1'000'000'000;
+      spec.it_value.tv_nsec = delay.count() % 1'000'000'000;
+      timerfd_settime(boottime_fd_, 0, &spec, nullptr);
+    }
+    struct pollfd fds[] = {{boottime_fd_, POLLIN, 0}, {watch_wake_fd_, POLLIN, 0}};
+    if (poll(fds, 2, -1) < 0) {
+      continue;
+    }
+    uint64_t value;
+    if ((fds[0].revents & POLLIN) != 0) {
+      (void)!read(boottime_fd_, &value, sizeof(value));
+    }
+    if ((fds[1].revents & POLLIN) != 0) {
+      (void)!read(watch_wake_fd_, &value, sizeof(value));
+    }
+    auto gap = bootMonoGapNs();
+    auto slept_ns = gap - boot_mono_gap_ns_;
+    boot_mono_gap_ns_ = gap;
+    if (slept_ns < SUSPEND_GAP_NS) {
+      continue;
+    }
+    auto slept = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::nanoseconds(slept_ns));
+    spdlog::debug("timer scheduler: resumed after {}s of suspend", slept.count() / 1000);
+    std::lock_guard lock(mutex_);
+    // Bring every task forward instead of letting it sleep out the rest of a
+    // deadline that froze hours ago with stale content on screen; the golden
+    // ratio spread over 1.5s keeps the catch-up from being one big storm.
+    constexpr double golden = 0.61803398875;
+    size_t index = 0;
+    auto now = clock::now();
+    for (auto& [id, task] : tasks_) {
+      if (task->paused || task->running) {
+        continue;
+      }
+      task->next = now + std::chrono::duration_cast<clock::duration>(
+                             std::chrono::duration<double>(
+                                 1.5 * std::fmod(static_cast<double>(++index) * golden, 1.0)));
+      queue_.push({task->next, id});
+    }
+    condvar_.notify_all();
+    for (auto& [id, listener] : resume_listeners_) {
+      listener(slept);
+    }
+  }
+}
+
+void TimerScheduler::worker() {
+  std::unique_lock lock(mutex_);
+  while (do_run_) {
+    if (queue_.empty()) {
+      condvar_.wait(lock);
+      continue;
+    }
+    auto deadline = queue_.top();
+    auto now = clock::now();
+    if (deadline.when > now) {
+      condvar_.wait_until(lock, deadline.when);
+      continue;
+    }
+    queue_.pop();
+    auto it = tasks_.find(deadline.id);
+    if (it == tasks_.end() || it->second->next != deadline.when) {
+      // Stale deadline: the task was cancelled or rescheduled by a wakeUp().
+      continue;
+    }
+    auto task = it->second;
+    if (task->paused) {
+      // Deadline dropped while suspended; resume() rearms the schedule.
+      continue;
+    }
+    task->running = true;
+    lock.unlock();
+    WAYBAR_TRACE1(timer_tick, deadline.id);
+    {
+      PerfCounters::Scope perf("worker/tick");
+      task->func();
+    }
+    lock.lock();
+    task->running = false;
+    if (!task->cancelled) {
+      task->next = clock::now() + task->interval + task->phase;
+      task->phase = clock::duration::zero();
+      queue_.push({task->next, deadline.id});
+      condvar_.notify_one();
+    }
+    idle_condvar_.notify_all();
+  }
+}
+
+}  // namespace waybar::util
@@ -0,0 +1,121 @@
+#include "util/udev_watcher.hpp"
+
+#include <libudev.h>
+#include <spdlog/spdlog.h>
+#include <sys/epoll.h>
+
+#include <stdexcept>
+
+#include "util/fd_reactor.hpp"
+
+namespace waybar::util {
+
+UdevWatcher& UdevWatcher::instance() {
+  static UdevWatcher watcher;
+  return watcher;
+}
+
+UdevWatcher::UdevWatcher() {
+  udev_ = udev_new();
+  if (udev_ == nullptr) {
+    throw std::runtime_error("Udev new failed");
+  }
+  mon_ = udev_monitor_new_from_netlink(udev_, "udev");
+  if (mon_ == nullptr) {
+    udev_unref(udev_);
+    throw std::runtime_error("udev monitor new failed");
+  }
+  udev_monitor_enable_receiving(mon_);
+  monitor_fd_ = udev_monitor_get_fd(mon_);
+  FdReactor::instance().add(monitor_fd_, EPOLLIN, [this](uint32_t) { onEvents(); });
+}
+
+UdevWatcher::~UdevWatcher() {
+  // The reactor outlives us: its instance was created from our constructor.
+  FdReactor::instance().remove(monitor_fd_);
+  udev_monitor_unref(mon_);
+  udev_unref(udev_);
+}
+
+int UdevWatcher::subscribe(std::string subsystem, Callback callback) {
+  // Narrow the kernel-side filter as well; libudev compiles the matches into
+  // the socket's BPF so uevents for unsubscribed subsystems never reach
+  // userspace. Filters are additive and stay in place after unsubscribe
+  // (libudev can only drop all of them), which merely readmits some events
+  // that the userspace fan-out below discards anyway.
+  if (udev_monitor_filter_add_match_subsystem_devtype(mon_, subsystem.c_str(), nullptr) < 0 ||
+      udev_monitor_filter_update(mon_) < 0) {
+    spdlog::warn("UdevWatcher: unable to install kernel filter for '{}'", subsystem);
+  }
+  std::lock_guard lock(mutex_);
+  auto subscription = std::make_shared<Subscription>();
+  subscription->subsystem = std::move(subsystem);
+  subscription->callback = std::move(callback);
+  int token = next_token_++;
+  subscriptions_.emplace(token, std::move(subscription));
+  return token;
+}
+
+void UdevWatcher::unsubscribe(int token) {
+  std::unique_lock lock(mutex_);
+  auto it = subscriptions_.find(token);
+  if (it == subscriptions_.end()) {
+    return;
+  }
+  auto subscription = it->second;
+  subscriptions_.erase(it);
+  if (!FdReactor::instance().onReactorThread()) {
+    // The subscriber is usually tearing down; don't let it die while its
+    // callback is still on the reactor thread.
+    idle_condvar_.wait(lock, [&subscription] { return !subscription->running; });
+  }
+}
+
+void UdevWatcher::onEvents() {
+  // Drain everything queued on the socket before dispatching: holding a
+  // brightness key queues dozens of change events, and subscribers want one
+  // batch (and thus one publish) per wakeup.
+  std::vector<udev_device*> batch;
+  while (udev_device* dev = udev_monitor_receive_device(mon_)) {
+    batch.push_back(dev);
+  }
+  if (batch.empty()) {
+    return;
+  }
+  std::vector<std::pair<int, std::shared_ptr<Subscription>>> snapshot;
+  {
+    std::lock_guard lock(mutex_);
+    snapshot.assign(subscriptions_.begin(), subscriptions_.end());
+  }
+  std::vector<udev_device*> matching;
+  for (const auto& [token, subscription] : snapshot) {
+    matching.clear();
+    for (udev_device* dev : batch) {
+      const char* subsystem = udev_device_get_subsystem(dev);
+      if (subsystem != nullptr && subscription->subsystem == subsystem) {
+        matching.push_back(dev);
+      }
+    }
+    if (matching.empty()) {
+      continue;
+    }
+    {
+      std::lock_guard lock(mutex_);
+      if (subscriptions_.find(token) == subscriptions_.end()) {
+        continue;  // unsubscribed while we were dispatching
+      }
+      subscription->running = true;
+    }
+    subscription->callback(matching);
+    {
+      std::lock_guard lock(mutex_);
+      subscription->running = false;
+    }
+    idle_condvar_.notify_all();
+  }
+  for (udev_device* dev : batch) {
+    udev_device_unref(dev);
+  }
+}
+
+}  // namespace waybar::util
@@ -0,0 +1,68 @@
+#include "util/update_coalescer.hpp"
+
+#include <gdkmm/frameclock.h>
+#include <glibmm/main.h>
+#include <gtkmm/widget.h>
+
+namespace waybar::util {
+
+// Fallback cadence when no bar window is mapped to provide a frame clock;
+// one frame at 60Hz.
+static const unsigned FLUSH_BUDGET_MS = 16;
+
+UpdateCoalescer& UpdateCoalescer::instance() {
+  static UpdateCoalescer coalescer;
+  return coalescer;
+}
+
+void UpdateCoalescer::markDirty(const void* key, const void* group_key,
+                                std::function<void()> update) {
+  auto& group = groups_[group_key];
+  group.dirty[key] = std::move(update);
+  if (group.flush_pending) {
+    return;
+  }
+  group.flush_pending = true;
+  if (group.driver != nullptr && group.driver->get_mapped()) {
+    // Flush in the frame clock's update phase, right before this frame's
+    // layout+paint: widget mutations never cause mid-frame damage and at
+    // most one paint happens per display refresh. Every bar on this output
+    // gets its updates applied in this same callback.
+    group.driver->add_tick_callback([this, group_key](const Glib::RefPtr<Gdk::FrameClock>&) {
+      flush(groups_[group_key]);
+      return false;
+    });
+  } else {
+    Glib::signal_timeout().connect_once([this, group_key] { flush(groups_[group_key]); },
+                                        FLUSH_BUDGET_MS);
+  }
+}
+
+void UpdateCoalescer::discard(const void* key) {
+  for (auto& [group_key, group] : groups_) {
+    group.dirty.erase(key);
+  }
+}
+
+void UpdateCoalescer::setDriver(Gtk::Widget* widget, const void* group) {
+  groups_[group].driver = widget;
+}
+
+void UpdateCoalescer::clearDriver(Gtk::Widget* widget) {
+  for (auto& [group_key, group] : groups_) {
+    if (group.driver == widget) {
+      group.driver = nullptr;
+    }
+  }
+}
+
+void UpdateCoalescer::flush(Group& group) {
+  group.flush_pending = false;
+  auto dirty = std::move(group.dirty);
+  group.dirty.clear();
+  for (auto& [key, update] : dirty) {
+    update();
+  }
+}
+
+}  // namespace waybar::util
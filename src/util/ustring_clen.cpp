@@ -1,9 +1,46 @@
 #include "util/ustring_clen.hpp"
 
-int ustring_clen(const Glib::ustring &str) {
+#include <glib.h>
+
+#include <cstdint>
+#include <cstring>
+
+int utf8_clen(std::string_view str) {
+  const char *p = str.data();
+  const char *end = p + str.size();
   int total = 0;
-  for (auto i = str.begin(); i != str.end(); ++i) {
-    total += g_unichar_iswide(*i) + 1;
+  while (p < end) {
+    // Word-at-a-time ASCII fast path: a whole chunk without the high bit set
+    // is eight narrow columns, no decoding needed. The memcpy loads compile
+    // to plain word loads and the loop auto-vectorizes.
+    while (end - p >= 8) {
+      uint64_t chunk;
+      std::memcpy(&chunk, p, sizeof(chunk));
+      if ((chunk & 0x8080808080808080ULL) != 0) {
+        break;
+      }
+      total += 8;
+      p += 8;
+    }
+    if (p == end) {
+      break;
+    }
+    if ((*p & 0x80) == 0) {
+      ++total;
+      ++p;
+      continue;
+    }
+    gunichar c = g_utf8_get_char_validated(p, end - p);
+    if (c == static_cast<gunichar>(-1) || c == static_cast<gunichar>(-2)) {
+      // invalid byte: count it narrow and resynchronize
+      ++total;
+      ++p;
+      continue;
+    }
+    total += g_unichar_iswide(c) + 1;
+    p = g_utf8_next_char(p);
   }
   return total;
-}
\ No newline at end of file
+}
+
+int ustring_clen(const Glib::ustring &str) { return utf8_clen(str.raw()); }
@@ -137,3 +137,43 @@ TEST_CASE_METHOD(GlibTestsFixture, "SafeSignal copy/move counter", "[signal][thr
   producer.join();
   REQUIRE(count == NUM_EVENTS);
 }
+
+/*
+ * Check that a burst of events with the same coalescing key collapses into the newest one
+ */
+TEST_CASE_METHOD(GlibTestsFixture, "SafeSignal coalescing drain", "[signal][thread][util]") {
+  const int NUM_EVENTS = 500;
+  int count = 0;
+  int last_value = 0;
+
+  SafeSignal<int, std::string> test_signal;
+  // coalesce by payload name: only the newest event per name survives a drain
+  test_signal.set_coalesce_key(
+      [](const int&, const std::string& str) { return std::hash<std::string>{}(str); });
+
+  std::thread producer;
+
+  // timeout the test in 500ms
+  setTimeout(500);
+
+  test_signal.connect([&](auto val, auto str) {
+    ++count;
+    last_value = val;
+    if (val == NUM_EVENTS) {
+      this->quit();
+    }
+  });
+
+  run([&]() {
+    producer = std::thread([&]() {
+      for (auto i = 1; i <= NUM_EVENTS; ++i) {
+        test_signal.emit(i, "title");
+      }
+    });
+  });
+  producer.join();
+  // the last event must always be delivered, and at least some of the burst
+  // must have been coalesced away
+  REQUIRE(last_value == NUM_EVENTS);
+  REQUIRE(count < NUM_EVENTS);
+}
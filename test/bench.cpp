@@ -0,0 +1,104 @@
+#include <fmt/format.h>
+
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <thread>
+
+#include "GlibTestsFixture.hpp"
+#include "util/SafeSignal.hpp"
+#include "util/compiled_format.hpp"
+#include "util/ustring_clen.hpp"
+
+using namespace waybar;
+
+/**
+ * Micro-benchmarks for proven hot paths, built into the separate waybar_bench target.
+ * Run with `waybar_bench [!benchmark]` to collect per-release regression numbers.
+ */
+
+TEST_CASE("format rendering", "[!benchmark][bench]") {
+  const std::string tmpl = "{usage}% │ {max_frequency}GHz {icon}";
+  const util::CompiledFormat compiled(tmpl);
+  int usage = 42;
+  double max_frequency = 3.5;
+  std::string icon = "";
+
+  BENCHMARK("fmt::format with raw template") {
+    return fmt::format(tmpl, fmt::arg("usage", usage), fmt::arg("max_frequency", max_frequency),
+                       fmt::arg("icon", icon));
+  };
+
+  BENCHMARK("CompiledFormat::render") {
+    return compiled.render(
+        [&](fmt::memory_buffer& out, const std::string& field, const char* spec) {
+          auto dst = std::back_inserter(out);
+          if (field == "usage") {
+            fmt::format_to(dst, spec, usage);
+          } else if (field == "max_frequency") {
+            fmt::format_to(dst, spec, max_frequency);
+          } else if (field == "icon") {
+            fmt::format_to(dst, spec, icon);
+          }
+        });
+  };
+}
+
+TEST_CASE("synthetic /proc/net/dev parse", "[!benchmark][bench]") {
+  // mirrors the istringstream column walk in Network::readBandwidthUsage
+  std::string data;
+  for (int i = 0; i < 40; ++i) {
+    data += fmt::format(
+        "  eth{}: {} 491891    0    0    0     0          0         0 {} 304372    0    0    0  "
+        "   0       0          0\n",
+        i, 1000000 + i, 2000000 + i);
+  }
+
+  BENCHMARK("istringstream column walk") {
+    std::istringstream netDev(data);
+    std::string line;
+    unsigned long long total = 0;
+    while (std::getline(netDev, line)) {
+      std::istringstream iss(line);
+      std::string ifacename;
+      iss >> ifacename;
+      unsigned long long rx = 0, tx = 0;
+      iss >> rx;
+      for (int i = 0; i < 7; ++i) {
+        unsigned long long dummy;
+        iss >> dummy;
+      }
+      iss >> tx;
+      total += rx + tx;
+    }
+    return total;
+  };
+}
+
+TEST_CASE("UTF-8 column width", "[!benchmark][bench]") {
+  // a long mostly-ASCII window title with some CJK mixed in
+  std::string title;
+  for (int i = 0; i < 20; ++i) {
+    title += "Some Editor — 本当に long/path/to/a/file_";
+    title += std::to_string(i);
+    title += ".cpp ";
+  }
+  const Glib::ustring utitle(title);
+
+  BENCHMARK("per-code-point ustring walk") {
+    int total = 0;
+    for (auto i = utitle.begin(); i != utitle.end(); ++i) {
+      total += g_unichar_iswide(*i) + 1;
+    }
+    return total;
+  };
+
+  BENCHMARK("utf8_clen word-at-a-time") { return utf8_clen(title); };
+}
+
+TEST_CASE_METHOD(GlibTestsFixture, "SafeSignal emission throughput", "[!benchmark][bench]") {
+  SafeSignal<int> test_signal;
+  int count = 0;
+  test_signal.connect([&](int) { ++count; });
+
+  BENCHMARK("main thread emit") { test_signal.emit(1); };
+}
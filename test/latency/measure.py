@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""Event injector and log reducer for the latency harness (see run.sh).
+
+Inject mode (--count): alternates sway IPC workspace switches with writes to
+the custom module FIFO, stamping each injection with CLOCK_MONOTONIC ns — the
+same clock bpftrace's nsecs uses — into --inject-log as "<ns> <source>".
+
+Report mode (--report): joins the injection log with the bpftrace probe log.
+Each injection is matched to the first module_update_end of the module it
+feeds (sway/workspaces resp. custom/latency) that fires after it; the delta is
+the end-to-end latency through IPC/pipe wakeup, dispatch, coalescing and
+update(). Prints p50/p90/p99/max per source.
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import time
+
+# injection source -> module name as it appears in the module_update_end probe
+SOURCES = {
+    "workspace": "sway/workspaces",
+    "custom": "custom/latency",
+}
+
+# spacing between injections; generous enough that one update cannot be
+# attributed to the previous injection even with coalescing in between
+GAP_SECONDS = 0.05
+
+
+def inject(count, fifo, inject_log):
+    fifo_fd = os.open(fifo, os.O_WRONLY)
+    with open(inject_log, "w") as log:
+        for i in range(count):
+            if i % 2 == 0:
+                source = "workspace"
+                stamp = time.monotonic_ns()
+                subprocess.run(
+                    ["swaymsg", "workspace", "number", str(2 + i % 4)],
+                    check=True,
+                    stdout=subprocess.DEVNULL,
+                )
+            else:
+                source = "custom"
+                stamp = time.monotonic_ns()
+                os.write(fifo_fd, b"tick %d\n" % i)
+            log.write("%d %s\n" % (stamp, source))
+            time.sleep(GAP_SECONDS)
+    os.close(fifo_fd)
+    # leave time for the tail of the probe log to flush
+    time.sleep(1)
+
+
+def percentile(sorted_values, fraction):
+    index = min(len(sorted_values) - 1, int(len(sorted_values) * fraction))
+    return sorted_values[index]
+
+
+def report(inject_log, probe_log):
+    updates = {name: [] for name in SOURCES.values()}
+    with open(probe_log) as log:
+        for line in log:
+            parts = line.split()
+            if len(parts) == 3 and parts[1] == "update_end" and parts[2] in updates:
+                updates[parts[2]].append(int(parts[0]))
+
+    latencies = {source: [] for source in SOURCES}
+    missed = {source: 0 for source in SOURCES}
+    with open(inject_log) as log:
+        for line in log:
+            stamp, source = line.split()
+            stamp = int(stamp)
+            ends = updates[SOURCES[source]]
+            match = next((t for t in ends if t > stamp), None)
+            if match is None or match - stamp > GAP_SECONDS * 1e9:
+                missed[source] += 1
+            else:
+                latencies[source].append((match - stamp) / 1e6)
+
+    status = 0
+    for source, values in latencies.items():
+        if not values:
+            print("%-10s no samples (%d injected) — probes attached?" % (source, missed[source]))
+            status = 1
+            continue
+        values.sort()
+        print(
+            "%-10s n=%-4d p50=%.2fms p90=%.2fms p99=%.2fms max=%.2fms missed=%d"
+            % (
+                source,
+                len(values),
+                percentile(values, 0.50),
+                percentile(values, 0.90),
+                percentile(values, 0.99),
+                values[-1],
+                missed[source],
+            )
+        )
+    return status
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--count", type=int, default=0)
+    parser.add_argument("--fifo")
+    parser.add_argument("--inject-log", required=True)
+    parser.add_argument("--probe-log")
+    parser.add_argument("--report", action="store_true")
+    args = parser.parse_args()
+
+    if args.report:
+        return report(args.inject_log, args.probe_log)
+    inject(args.count, args.fifo, args.inject_log)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,90 @@
+#!/bin/sh
+# End-to-end latency harness: event to module update, measured on a live bar.
+#
+# Drives a headless sway instance, starts waybar with the fixture config next
+# to this script, attaches bpftrace to the USDT tracepoints (util/trace.hpp)
+# and injects synthetic events:
+#
+#   - sway IPC workspace switches (swaymsg), matched against the
+#     sway/workspaces module_update_end probe
+#   - scripted custom-module output through a FIFO, matched against
+#     custom/latency
+#
+# measure.py joins the injection log with the probe log and prints latency
+# distributions (p50/p90/p99/max) per event source. Requires sway, swaymsg,
+# bpftrace (root or CAP_BPF+CAP_PERFMON) and a build with -Dsdt=enabled.
+#
+# Usage: run.sh [path-to-waybar] [event-count]
+# Meson: ninja -C build latency-bench
+#
+# Optional: WAYBAR_LATENCY_PROC_FIXTURES=1 bind-mounts the synthetic
+# fixtures/proc_stat over /proc/stat in a private mount namespace, so the cpu
+# module parses deterministic input instead of live load (needs unshare -m,
+# i.e. root).
+
+set -eu
+
+here=$(dirname "$(readlink -f "$0")")
+waybar=${1:-./waybar}
+count=${2:-200}
+
+for tool in sway swaymsg bpftrace; do
+    command -v "$tool" >/dev/null || { echo "$tool not found" >&2; exit 77; }
+done
+[ -x "$waybar" ] || { echo "waybar binary not found at $waybar" >&2; exit 77; }
+readelf -n "$waybar" | grep -q 'waybar' || {
+    echo "$waybar has no USDT notes; build with -Dsdt=enabled" >&2
+    exit 77
+}
+
+workdir=$(mktemp -d)
+trap 'kill $waybar_pid $bpftrace_pid $sway_pid 2>/dev/null; wait; rm -rf "$workdir"' EXIT INT TERM
+
+# --- headless sway ---------------------------------------------------------
+export WLR_BACKENDS=headless
+export WLR_LIBINPUT_NO_DEVICES=1
+sway -c "$here/sway.cfg" >"$workdir/sway.log" 2>&1 &
+sway_pid=$!
+
+SWAYSOCK=
+for _ in $(seq 50); do
+    SWAYSOCK=$(ls -t "${XDG_RUNTIME_DIR:-/run/user/$(id -u)}"/sway-ipc.*.sock 2>/dev/null |
+        head -n1)
+    [ -n "$SWAYSOCK" ] && swaymsg -s "$SWAYSOCK" -t get_version >/dev/null 2>&1 && break
+    SWAYSOCK=
+    sleep 0.1
+done
+[ -n "$SWAYSOCK" ] || { echo "sway IPC socket did not appear" >&2; exit 1; }
+export SWAYSOCK
+WAYLAND_DISPLAY=$(swaymsg -t get_version -r >/dev/null 2>&1 &&
+    ls -t "${XDG_RUNTIME_DIR:-/run/user/$(id -u)}"/wayland-* 2>/dev/null |
+        grep -v '\.lock$' | head -n1 | xargs -r basename)
+export WAYLAND_DISPLAY
+
+# --- waybar ---------------------------------------------------------------
+export WAYBAR_LATENCY_FIFO="$workdir/custom.fifo"
+mkfifo "$WAYBAR_LATENCY_FIFO"
+
+launch="$waybar -c $here/config.json -s $here/../../resources/style.css"
+if [ "${WAYBAR_LATENCY_PROC_FIXTURES:-0}" = 1 ]; then
+    launch="unshare -m sh -c 'mount --bind $here/fixtures/proc_stat /proc/stat; exec $launch'"
+fi
+eval "$launch" >"$workdir/waybar.log" 2>&1 &
+waybar_pid=$!
+sleep 2
+kill -0 "$waybar_pid" || { echo "waybar died on startup:" >&2; cat "$workdir/waybar.log" >&2; exit 1; }
+
+# --- tracepoints ----------------------------------------------------------
+sed "s|@WAYBAR@|$(readlink -f "$waybar")|" "$here/probes.bt.in" >"$workdir/probes.bt"
+bpftrace "$workdir/probes.bt" >"$workdir/probes.log" 2>"$workdir/bpftrace.err" &
+bpftrace_pid=$!
+sleep 2
+kill -0 "$bpftrace_pid" || { echo "bpftrace failed to attach:" >&2; cat "$workdir/bpftrace.err" >&2; exit 1; }
+
+# --- inject and reduce ----------------------------------------------------
+python3 "$here/measure.py" --count "$count" --fifo "$WAYBAR_LATENCY_FIFO" \
+    --inject-log "$workdir/inject.log"
+kill "$bpftrace_pid"
+wait "$bpftrace_pid" 2>/dev/null || true
+python3 "$here/measure.py" --report --inject-log "$workdir/inject.log" \
+    --probe-log "$workdir/probes.log"
@@ -0,0 +1,82 @@
+#!/bin/sh
+# Soak harness: drive a live bar hard for a long time and fail on RSS growth.
+#
+# Same orchestration as ../latency/run.sh — headless sway, waybar under test
+# with the fixture config next to this script — but instead of measuring
+# per-event latency, soak.py floods the bar with events for N iterations:
+#
+#   - sway IPC workspace churn (create/switch/destroy) against sway/workspaces
+#   - scripted custom-module output through a FIFO
+#   - tray register/unregister loops from sni_item.py, a minimal
+#     StatusNotifierItem that joins and leaves the watcher (needs python3-gi;
+#     skipped with a note when unavailable)
+#
+# while sampling VmRSS from /proc/<pid>/status. After a warmup window the
+# remaining samples must stay flat: the run fails when post-warmup growth
+# exceeds the threshold, which is how per-update string churn and heap
+# fragmentation show up. Pairs with -Dalloc_track=enabled builds: the final
+# `waybar ctl perf` snapshot is printed so per-module allocation gauges land
+# in the build log next to the RSS verdict.
+#
+# Usage: run.sh [path-to-waybar] [iterations]
+# Meson: ninja -C build soak-test
+
+set -eu
+
+here=$(dirname "$(readlink -f "$0")")
+waybar=${1:-./waybar}
+iterations=${2:-200000}
+
+for tool in sway swaymsg; do
+    command -v "$tool" >/dev/null || { echo "$tool not found" >&2; exit 77; }
+done
+[ -x "$waybar" ] || { echo "waybar binary not found at $waybar" >&2; exit 77; }
+
+workdir=$(mktemp -d)
+trap 'kill $sni_pid $waybar_pid $sway_pid 2>/dev/null; wait; rm -rf "$workdir"' EXIT INT TERM
+
+export WLR_BACKENDS=headless
+export WLR_LIBINPUT_NO_DEVICES=1
+sway -c "$here/../latency/sway.cfg" >"$workdir/sway.log" 2>&1 &
+sway_pid=$!
+
+SWAYSOCK=
+for _ in $(seq 50); do
+    SWAYSOCK=$(ls -t "${XDG_RUNTIME_DIR:-/run/user/$(id -u)}"/sway-ipc.*.sock 2>/dev/null |
+        head -n1)
+    [ -n "$SWAYSOCK" ] && swaymsg -s "$SWAYSOCK" -t get_version >/dev/null 2>&1 && break
+    SWAYSOCK=
+    sleep 0.1
+done
+[ -n "$SWAYSOCK" ] || { echo "sway IPC socket did not appear" >&2; exit 1; }
+export SWAYSOCK
+WAYLAND_DISPLAY=$(ls -t "${XDG_RUNTIME_DIR:-/run/user/$(id -u)}"/wayland-* 2>/dev/null |
+    grep -v '\.lock$' | head -n1 | xargs -r basename)
+export WAYLAND_DISPLAY
+
+export WAYBAR_SOAK_FIFO="$workdir/custom.fifo"
+mkfifo "$WAYBAR_SOAK_FIFO"
+
+"$waybar" -c "$here/config.json" -s "$here/../../resources/style.css" \
+    >"$workdir/waybar.log" 2>&1 &
+waybar_pid=$!
+sleep 2
+kill -0 "$waybar_pid" || { echo "waybar died on startup:" >&2; cat "$workdir/waybar.log" >&2; exit 1; }
+
+sni_pid=
+if python3 -c 'import gi' 2>/dev/null; then
+    python3 "$here/sni_item.py" >"$workdir/sni.log" 2>&1 &
+    sni_pid=$!
+else
+    echo "python3-gi not available; skipping tray register/unregister churn" >&2
+fi
+
+status=0
+python3 "$here/soak.py" --pid "$waybar_pid" --fifo "$WAYBAR_SOAK_FIFO" \
+    --iterations "$iterations" || status=$?
+
+# Per-module allocation gauges from the control socket; only meaningful with
+# -Dalloc_track=enabled but harmless otherwise.
+"$waybar" ctl perf 2>/dev/null || true
+
+exit "$status"
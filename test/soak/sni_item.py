@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""Tray churn for the soak harness: a minimal StatusNotifierItem that joins
+and leaves the watcher in a loop, exercising the sni::Watcher registration
+path, sni::Host item setup/teardown and the icon pipeline behind them.
+
+Runs until killed; each cycle owns a fresh org.kde.StatusNotifierItem-<pid>-<n>
+name, registers it, lets the host fetch properties, then drops off the bus.
+"""
+
+import os
+import time
+
+import gi
+
+gi.require_version("Gio", "2.0")
+from gi.repository import Gio, GLib  # noqa: E402
+
+NODE_XML = """
+<node>
+  <interface name="org.kde.StatusNotifierItem">
+    <property name="Category" type="s" access="read"/>
+    <property name="Id" type="s" access="read"/>
+    <property name="Title" type="s" access="read"/>
+    <property name="Status" type="s" access="read"/>
+    <property name="IconName" type="s" access="read"/>
+    <property name="ItemIsMenu" type="b" access="read"/>
+    <method name="Activate">
+      <arg name="x" type="i" direction="in"/>
+      <arg name="y" type="i" direction="in"/>
+    </method>
+  </interface>
+</node>
+"""
+
+PROPERTIES = {
+    "Category": GLib.Variant("s", "ApplicationStatus"),
+    "Id": GLib.Variant("s", "waybar-soak"),
+    "Title": GLib.Variant("s", "soak item"),
+    "Status": GLib.Variant("s", "Active"),
+    "IconName": GLib.Variant("s", "dialog-information"),
+    "ItemIsMenu": GLib.Variant("b", False),
+}
+
+
+def get_property(_conn, _sender, _path, _iface, name):
+    return PROPERTIES.get(name)
+
+
+def cycle(bus, node_info, n):
+    name = "org.kde.StatusNotifierItem-%d-%d" % (os.getpid(), n)
+    owner_id = Gio.bus_own_name_on_connection(bus, name, Gio.BusNameOwnerFlags.NONE, None, None)
+    reg_id = bus.register_object(
+        "/StatusNotifierItem", node_info.interfaces[0], None, get_property, None
+    )
+    try:
+        bus.call_sync(
+            "org.kde.StatusNotifierWatcher",
+            "/StatusNotifierWatcher",
+            "org.kde.StatusNotifierWatcher",
+            "RegisterStatusNotifierItem",
+            GLib.Variant("(s)", (name,)),
+            None,
+            Gio.DBusCallFlags.NONE,
+            1000,
+            None,
+        )
+    except GLib.Error:
+        pass  # watcher not up yet; the unregister path is still exercised
+    # let the host finish its property round trips before tearing down
+    ctx = GLib.MainContext.default()
+    deadline = time.monotonic() + 0.05
+    while time.monotonic() < deadline:
+        ctx.iteration(False)
+    bus.unregister_object(reg_id)
+    Gio.bus_unown_name(owner_id)
+
+
+def main():
+    bus = Gio.bus_get_sync(Gio.BusType.SESSION, None)
+    node_info = Gio.DBusNodeInfo.new_for_xml(NODE_XML)
+    n = 0
+    while True:
+        cycle(bus, node_info, n)
+        n += 1
+
+
+if __name__ == "__main__":
+    main()
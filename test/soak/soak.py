@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+"""Event flood and RSS watchdog for the soak harness (see run.sh).
+
+Alternates sway IPC workspace churn with custom-module FIFO writes for
+--iterations rounds, sampling VmRSS every SAMPLE_EVERY iterations. The first
+--warmup fraction of samples is discarded — caches (icon themes, interned
+strings, GTK CSS) legitimately fill early. Over the rest, a least-squares fit
+gives the growth slope; the run fails when either the slope exceeds
+--max-slope (KiB per thousand iterations) or total post-warmup growth exceeds
+--max-growth-pct. A leak shows up as a steady slope, fragmentation as growth
+that never flattens; a healthy bar is flat within noise after warmup.
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import time
+
+SAMPLE_EVERY = 1000
+
+
+def rss_kib(pid):
+    with open("/proc/%d/status" % pid) as status:
+        for line in status:
+            if line.startswith("VmRSS:"):
+                return int(line.split()[1])
+    raise RuntimeError("no VmRSS for pid %d" % pid)
+
+
+def flood(args):
+    samples = []  # (iteration, KiB)
+    fifo_fd = os.open(args.fifo, os.O_WRONLY)
+    swaymsg = ["swaymsg", "-q", "workspace", "number"]
+    for i in range(args.iterations):
+        if i % 2 == 0:
+            subprocess.run(swaymsg + [str(2 + i % 8)], check=True)
+        else:
+            os.write(fifo_fd, b"soak %d\n" % i)
+        if i % SAMPLE_EVERY == 0:
+            samples.append((i, rss_kib(args.pid)))
+            if i % (SAMPLE_EVERY * 20) == 0:
+                print("iter=%-8d rss=%dKiB" % samples[-1], flush=True)
+    os.close(fifo_fd)
+    time.sleep(2)  # drain queued updates before the final sample
+    samples.append((args.iterations, rss_kib(args.pid)))
+    return samples
+
+
+def slope_kib_per_kiter(samples):
+    n = len(samples)
+    mean_x = sum(s[0] for s in samples) / n
+    mean_y = sum(s[1] for s in samples) / n
+    var = sum((s[0] - mean_x) ** 2 for s in samples)
+    if var == 0:
+        return 0.0
+    cov = sum((s[0] - mean_x) * (s[1] - mean_y) for s in samples)
+    return cov / var * 1000.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--pid", type=int, required=True)
+    parser.add_argument("--fifo", required=True)
+    parser.add_argument("--iterations", type=int, default=200000)
+    parser.add_argument("--warmup", type=float, default=0.2)
+    parser.add_argument("--max-slope", type=float, default=4.0,
+                        help="KiB of RSS per thousand iterations, post-warmup")
+    parser.add_argument("--max-growth-pct", type=float, default=5.0)
+    args = parser.parse_args()
+
+    samples = flood(args)
+    steady = samples[int(len(samples) * args.warmup):]
+    if len(steady) < 2:
+        print("not enough samples past warmup; raise --iterations")
+        return 1
+
+    slope = slope_kib_per_kiter(steady)
+    growth_pct = 100.0 * (steady[-1][1] - steady[0][1]) / steady[0][1]
+    print(
+        "post-warmup: start=%dKiB end=%dKiB growth=%.1f%% slope=%.2fKiB/kiter"
+        % (steady[0][1], steady[-1][1], growth_pct, slope)
+    )
+
+    failed = False
+    if slope > args.max_slope:
+        print("FAIL: RSS slope %.2f exceeds %.2f KiB/kiter" % (slope, args.max_slope))
+        failed = True
+    if growth_pct > args.max_growth_pct:
+        print("FAIL: RSS grew %.1f%% past warmup (limit %.1f%%)"
+              % (growth_pct, args.max_growth_pct))
+        failed = True
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())